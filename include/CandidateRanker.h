@@ -0,0 +1,124 @@
+﻿// CandidateRanker.h
+// Top-k completions by frequency, kept incrementally as the word grows.
+// Ranking is best-first over the dictionary's subtree maxima: a bounded
+// heap holds the frontier - subtrees not yet opened and words not yet
+// taken - and the k most frequent words come off it first. Each prefix's
+// frontier is kept on a small stack. Extending the prefix narrows the
+// frontier of the longest stacked prefix to the new subtree instead of
+// starting at the new state; shortening it (backspace, a syllable
+// rewritten) pops back to a stacked frontier and its results as they were.
+// Portable C++17 - no Windows headers, no allocation
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Dictionary.h"
+
+// Candidates ranked per prefix
+static const size_t c_candidateTopK = 8;
+
+// Frontier entries kept per prefix; when the heap is full the least
+// promising entry is dropped. Each of the others still holds a word at
+// least as frequent, so the top k are unaffected while k is well below this.
+// A longer prefix inherits the frontier, though, so the highest dropped
+// bound is kept per branch below the prefix; a narrowed frontier whose
+// last result falls below its branch's dropped bound is ranked afresh.
+static const size_t c_candidateFrontierMax = 64;
+
+// Prefixes whose frontiers are kept for backspace
+static const size_t c_candidateLevelsMax = 8;
+
+struct CandidateEntry
+{
+    uint32_t bound;         // exact frequency of a word, subtree maximum otherwise
+    int32_t state;          // the subtree, or the last state of the word
+    uint8_t depth;          // code units from the root to 'state'
+    uint8_t fWord;          // the word ending at 'state', not its subtree
+    uint8_t branch;         // symbol of the ancestor just below the level's prefix
+    uint8_t padding;
+};
+
+// Ranked candidates with their text, copied out of a ranker
+struct CandidateList
+{
+    uint32_t cCandidates;
+    DictionaryMatch candidates[c_candidateTopK];           // most frequent first
+    char16_t text[c_candidateTopK * c_dictionaryMaxWord];
+
+    const char16_t* Text(size_t i) const { return text + candidates[i].ichWord; }
+};
+
+struct CandidateRankStats
+{
+    uint64_t restored;      // prefix shortened to a stacked one
+    uint64_t narrowed;      // frontier of a shorter prefix reused
+    uint64_t restarted;     // started at the prefix's own state
+    uint64_t expanded;      // subtrees opened
+};
+
+class CandidateRanker
+{
+public:
+    CandidateRanker() { Reset(); }
+
+    // Forgets every stacked frontier
+    void Reset()
+    {
+        _pDictionary = nullptr;
+        _cLevels = 0;
+        _iBottom = 0;
+        _cResults = 0;
+        _cchPrefix = 0;
+    }
+
+    // Ranks the completions of pch[0..cch) (the prefix itself included when
+    // it is a word), most frequent first. Returns the number ranked, up to
+    // c_candidateTopK; 0 when nothing starts with the prefix.
+    size_t Rank(const Dictionary& dictionary, const char16_t* pch, size_t cch);
+
+    // Results of the last Rank
+    size_t Count() const { return _cResults; }
+    uint32_t Frequency(size_t i) const { return _Top().results[i].bound; }
+    size_t Length(size_t i) const { return _Top().results[i].depth; }
+
+    // Writes the i-th candidate; returns its length, 0 if it does not fit
+    size_t Text(size_t i, char16_t* pch, size_t cchMax) const;
+
+    // Copies the results of the last Rank, text included
+    void GetList(CandidateList* pList) const;
+
+    const CandidateRankStats& Stats() const { return _stats; }
+
+private:
+    struct Level
+    {
+        uint8_t cchPrefix;
+        uint8_t cResults;
+        uint16_t cHeap;
+        uint32_t droppedInherited;      // dropped by shorter prefixes anywhere in this subtree
+        uint32_t droppedBranch[c_dictionaryUnitRange];  // dropped here, by branch symbol
+        CandidateEntry results[c_candidateTopK];
+        CandidateEntry heap[c_candidateFrontierMax];
+    };
+
+    Level& _Level(size_t i) { return _levels[(_iBottom + i) % c_candidateLevelsMax]; }
+    Level& _Top() { return _Level(_cLevels - 1); }
+    const Level& _Top() const { return _levels[(_iBottom + _cLevels - 1) % c_candidateLevelsMax]; }
+    Level& _Push();
+
+    void _Start(Level* pLevel, int32_t state, size_t depth, uint32_t droppedInherited) const;
+    uint32_t _Narrow(const Level& from, Level* pLevel, int32_t state, size_t depth) const;
+    void _Add(Level* pLevel, const CandidateEntry& entry) const;
+    void _Run(Level* pLevel);
+
+    const Dictionary* _pDictionary;
+    size_t _cLevels;
+    size_t _iBottom;
+    size_t _cResults;
+    size_t _cchPrefix;
+    char16_t _prefix[c_dictionaryMaxWord];
+    CandidateRankStats _stats = {};
+    Level _levels[c_candidateLevelsMax];
+};
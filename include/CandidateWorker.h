@@ -0,0 +1,116 @@
+﻿// CandidateWorker.h
+// Ranks completions on a worker thread so the key path never waits for the
+// dictionary. The UI thread posts the word with a new generation number
+// through a lock-free single-producer queue; every later keystroke bumps
+// the generation, and a request or result that is no longer the newest is
+// dropped - by the worker before and after ranking, and by Receive. Results
+// come back through a second queue, and the ready callback (once per batch)
+// tells the UI thread to collect them.
+// Portable C++17 - no Windows headers
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "CandidateRanker.h"
+#include "SpscQueue.h"
+
+static const size_t c_candidateRequestQueue = 16;
+static const size_t c_candidateResultQueue = 4;
+
+struct CandidateRequest
+{
+    uint32_t generation;
+    uint32_t cchWord;
+    uint64_t postNs;                    // LatencyNow() at Post
+    char16_t word[c_dictionaryMaxWord];
+};
+
+struct CandidateResult
+{
+    uint32_t generation;
+    uint64_t postNs;
+    CandidateList list;
+};
+
+struct CandidateWorkerStats
+{
+    uint64_t posted;                    // requests posted by the UI thread
+    uint64_t held;                      // posts that found the request queue full
+    uint64_t skipped;                   // requests the worker dropped as stale
+    uint64_t ranked;                    // results sent back
+    uint64_t stale;                     // results Receive dropped as stale
+};
+
+class CandidateWorker
+{
+public:
+    // Called on the worker thread when results are waiting and the UI has
+    // not been told yet; must only schedule a Receive on the UI thread
+    typedef void (*ReadyCallback)(void* pv);
+
+    CandidateWorker();
+    ~CandidateWorker() { Stop(); }
+
+    bool Start(const Dictionary* pDictionary, ReadyCallback pfnReady, void* pvReady);
+    void Stop();
+    bool IsRunning() const { return _thread.joinable(); }
+
+    // UI thread. Starts a new generation and asks for the word's completions;
+    // never waits for the worker. Returns the generation. Without a running
+    // worker only the generation changes.
+    uint32_t Post(const char16_t* pch, size_t cch);
+
+    // UI thread. A keystroke that changes the word without a new request:
+    // whatever is outstanding is stale.
+    void Cancel() { _generation.store(_generation.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // UI thread. Takes every result that has arrived; returns true and the
+    // newest one if it is for the current generation.
+    bool Receive(CandidateResult* pResult);
+
+    uint32_t Generation() const { return _generation.load(std::memory_order_relaxed); }
+    CandidateWorkerStats Stats() const;
+
+private:
+    bool _Flush();
+    void _Wake();
+    void _Notify();
+    bool _WaitForRequest();
+    void _Main();
+
+    const Dictionary* _pDictionary;
+    ReadyCallback _pfnReady;
+    void* _pvReady;
+    std::thread _thread;
+
+    std::atomic<uint32_t> _generation;      // newest keystroke; written by the UI thread only
+    std::atomic<bool> _stop;
+    std::atomic<bool> _sleeping;            // worker is (about to be) waiting for a request
+    std::atomic<bool> _notified;            // ready callback made, Receive not yet called
+    std::mutex _wakeLock;                   // guards the wait only, never held while ranking
+    std::condition_variable _wake;
+
+    // The newest request, when the queue was full. Written by the UI thread;
+    // the worker only looks at the flag.
+    CandidateRequest _held;
+    std::atomic<bool> _fHeld;
+
+    std::atomic<uint64_t> _posted;
+    std::atomic<uint64_t> _heldCount;
+    std::atomic<uint64_t> _skipped;
+    std::atomic<uint64_t> _ranked;
+    std::atomic<uint64_t> _stale;
+
+    SpscQueue<CandidateRequest, c_candidateRequestQueue> _requests;     // UI -> worker
+    SpscQueue<CandidateResult, c_candidateResultQueue> _results;        // worker -> UI
+
+    // Worker thread only
+    CandidateRanker _ranker;
+    CandidateResult _result;
+};
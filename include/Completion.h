@@ -0,0 +1,102 @@
+﻿// Completion.h
+// The Tamil word ending at the caret, kept from the text the key path
+// itself emits, and the latest completions ranked for it (by the candidate
+// worker - see CandidateWorker.h). Nothing is read from the document; when
+// the start of the word is not known (a deletion past it, an edit by
+// someone else) no completions are offered until the next word boundary.
+// Portable C++17 - no Windows headers, no allocation
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "CandidateRanker.h"
+
+class WordCompletion
+{
+public:
+    WordCompletion() : _cch(0), _fKnown(true) { _candidates.cCandidates = 0; }
+
+    // At a word boundary: the next letter starts a new word
+    void Reset()
+    {
+        _cch = 0;
+        _fKnown = true;
+        _candidates.cCandidates = 0;
+    }
+
+    // The caret moved or the text changed in a way we did not see: the
+    // word's start is unknown until the next boundary
+    void Invalidate()
+    {
+        _cch = 0;
+        _fKnown = false;
+        _candidates.cCandidates = 0;
+    }
+
+    // cchDelete units before the caret were replaced by pch[0..cch)
+    void Apply(size_t cchDelete, const char16_t* pch, size_t cch)
+    {
+        _candidates.cCandidates = 0;
+
+        if (cchDelete > _cch)
+            Invalidate();
+        else
+            _cch -= cchDelete;
+
+        for (size_t i = 0; i < cch; i++)
+        {
+            if (!IsWordUnit(pch[i]))
+            {
+                Reset();
+            }
+            else if (_cch + 1 >= c_dictionaryMaxWord)
+            {
+                // Longer than any dictionary word
+                Invalidate();
+            }
+            else
+            {
+                _word[_cch++] = pch[i];
+            }
+        }
+    }
+
+    // Picks up the word ending the text before the caret (see
+    // SurroundingText.h). fAtStart is true when nothing precedes pch.
+    void Resume(const char16_t* pch, size_t cch, bool fAtStart)
+    {
+        size_t ich = cch;
+        while (ich > 0 && IsWordUnit(pch[ich - 1]))
+            ich--;
+
+        if (ich == 0 && !fAtStart)
+        {
+            // The word may go on before the window
+            Invalidate();
+            return;
+        }
+
+        Reset();
+        Apply(0, pch + ich, cch - ich);
+    }
+
+    // Completions ranked for the current word
+    void SetCandidates(const CandidateList& candidates) { _candidates = candidates; }
+
+    const char16_t* Word() const { return _word; }
+    size_t Length() const { return _fKnown ? _cch : 0; }
+
+    // Completions, most frequent first; none until the worker answers
+    const CandidateList& Candidates() const { return _candidates; }
+
+    // Letters and signs; digits, symbols and anything outside the block end a word
+    static bool IsWordUnit(char16_t ch) { return ch >= 0x0B82 && ch <= 0x0BD7; }
+
+private:
+    size_t _cch;
+    bool _fKnown;               // _word starts at a word boundary
+    char16_t _word[c_dictionaryMaxWord];
+    CandidateList _candidates;
+};
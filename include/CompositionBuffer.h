@@ -0,0 +1,82 @@
+﻿// CompositionBuffer.h
+// Text of the open syllable, exactly as last written into the document's
+// composition range. An edit session combines it with a pending batch to
+// get the range's new content, so a syllable rewrite (consonant -> uyirmei,
+// pulli added or removed) replaces the whole range with one SetText and the
+// document is never read back.
+// Portable C++17 - no Windows headers, no allocation
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "PendingOutput.h"
+
+// The open syllable is short (a token or a consonant + sign); anything
+// beyond this is committed early
+static const size_t c_compositionMax = 32;
+
+// What one edit session has to do to the composition range
+struct CompositionUpdate
+{
+    uint32_t cchDeleteBefore;   // document text just before the range to delete as well
+    uint32_t cchText;           // new content of the range
+    uint32_t cchCommit;         // leading units of it that leave the composition
+    const char16_t* text;
+};
+
+class CompositionBuffer
+{
+public:
+    CompositionBuffer() : _cch(0), _cchNew(0), _cchKeep(0) {}
+
+    // Code units currently in the composition range; 0 when there is none
+    size_t Length() const { return _cch; }
+
+    // Applies a batch - cchDelete units before the caret replaced by
+    // pch[0..cch), leaving cchComposing trailing units open. Deletions
+    // first consume the range, then reach into the document before it.
+    void Apply(size_t cchDelete, const char16_t* pch, size_t cch, size_t cchComposing, CompositionUpdate* pUpdate)
+    {
+        size_t cchFromRange = (cchDelete < _cch) ? cchDelete : _cch;
+        size_t cchKept = _cch - cchFromRange;
+
+        for (size_t i = 0; i < cch; i++)
+            _text[cchKept + i] = pch[i];
+        _cchNew = cchKept + cch;
+
+        _cchKeep = (cchComposing < _cchNew) ? cchComposing : _cchNew;
+        if (_cchKeep > c_compositionMax)
+            _cchKeep = c_compositionMax;
+
+        pUpdate->cchDeleteBefore = (uint32_t)(cchDelete - cchFromRange);
+        pUpdate->cchText = (uint32_t)_cchNew;
+        pUpdate->cchCommit = (uint32_t)(_cchNew - _cchKeep);
+        pUpdate->text = _text;
+    }
+
+    // The update from Apply was written: the committed prefix is gone from
+    // the range and only the open tail remains
+    void Commit()
+    {
+        size_t cchCommit = _cchNew - _cchKeep;
+        for (size_t i = 0; i < _cchKeep; i++)
+            _text[i] = _text[cchCommit + i];
+        _cch = _cchKeep;
+    }
+
+    // The composition ended or was terminated by the application
+    void Clear()
+    {
+        _cch = 0;
+        _cchNew = 0;
+        _cchKeep = 0;
+    }
+
+private:
+    size_t _cch;
+    size_t _cchNew;             // content written by the last Apply
+    size_t _cchKeep;            // its open tail
+    char16_t _text[c_compositionMax + c_pendingBatchText];
+};
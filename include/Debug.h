@@ -6,8 +6,116 @@
 
 #define logTag L"AnjalCore"
 
+// Log levels. Anything above ANJAL_LOG_MAX_LEVEL is removed by the
+// preprocessor - the call and its arguments are never compiled in.
+// Levels at or below it can still be filtered at runtime (see Debug::LoadSettings).
+#define ANJAL_LOG_LEVEL_NONE        0
+#define ANJAL_LOG_LEVEL_ERROR       1
+#define ANJAL_LOG_LEVEL_WARNING     2
+#define ANJAL_LOG_LEVEL_INFO        3
+#define ANJAL_LOG_LEVEL_VERBOSE     4
+
+#ifndef ANJAL_LOG_MAX_LEVEL
+#ifdef _DEBUG
+#define ANJAL_LOG_MAX_LEVEL ANJAL_LOG_LEVEL_VERBOSE
+#else
+#define ANJAL_LOG_MAX_LEVEL ANJAL_LOG_LEVEL_WARNING
+#endif
+#endif
+
+// True when a level is compiled in; use with #if around diagnostic-only code
+#define ANJAL_LOG_COMPILED(level) (ANJAL_LOG_MAX_LEVEL >= ANJAL_LOG_LEVEL_##level)
+
+enum LogLevel
+{
+    LogLevelNone = ANJAL_LOG_LEVEL_NONE,
+    LogLevelError = ANJAL_LOG_LEVEL_ERROR,
+    LogLevelWarning = ANJAL_LOG_LEVEL_WARNING,
+    LogLevelInfo = ANJAL_LOG_LEVEL_INFO,
+    LogLevelVerbose = ANJAL_LOG_LEVEL_VERBOSE
+};
+
+// Log categories (bit mask)
+enum LogCategory : DWORD
+{
+    LogKeystroke = 0x0001,      // key event sink, layout mapping
+    LogEditSession = 0x0002,    // edit sessions and text insertion
+    LogRegistration = 0x0004,   // DllRegisterServer / profiles / categories
+    LogLifecycle = 0x0008,      // DLL, class factory, activation, layout switches
+    LogAllCategories = 0x000F
+};
+
+// Runtime settings, read by Debug::LoadSettings
+#define ANJAL_LOG_REG_KEY           L"Software\\Murasu\\AnjalCore"
+#define ANJAL_LOG_REG_LEVEL         L"LogLevel"
+#define ANJAL_LOG_REG_CATEGORIES    L"LogCategories"
+#define ANJAL_LOG_REG_TRACE         L"Trace"
+
 class Debug {
 public:
+    // Runtime filter for the levels that are compiled in
+    static bool IsEnabled(LogLevel level, DWORD category)
+    {
+        return level <= s_threshold && (category & s_categories) != 0;
+    }
+
+    static void SetThreshold(LogLevel level) { s_threshold = level; }
+    static void SetCategories(DWORD categories) { s_categories = categories; }
+
+    // Binary tracing (TraceRing.h) requested through the Trace DWORD
+    static bool IsTraceRequested() { return s_traceRequested; }
+
+    // Reads the optional LogLevel / LogCategories / Trace DWORDs from HKCU.
+    // Not safe to call from DllMain (loader lock), so it runs on activation.
+    // Without the key - the usual case - this is a single failed open.
+    static void LoadSettings()
+    {
+        s_traceRequested = false;
+
+        HKEY hKey;
+        if (RegOpenKeyExW(HKEY_CURRENT_USER, ANJAL_LOG_REG_KEY, 0, KEY_QUERY_VALUE, &hKey) != ERROR_SUCCESS)
+            return;
+
+        DWORD value = 0;
+        DWORD cb = sizeof(value);
+        if (RegGetValueW(hKey, NULL, ANJAL_LOG_REG_LEVEL, RRF_RT_REG_DWORD, NULL, &value, &cb) == ERROR_SUCCESS)
+        {
+            s_threshold = (LogLevel)((value < ANJAL_LOG_MAX_LEVEL) ? value : ANJAL_LOG_MAX_LEVEL);
+        }
+
+        cb = sizeof(value);
+        if (RegGetValueW(hKey, NULL, ANJAL_LOG_REG_CATEGORIES, RRF_RT_REG_DWORD, NULL, &value, &cb) == ERROR_SUCCESS)
+        {
+            s_categories = value;
+        }
+
+        cb = sizeof(value);
+        s_traceRequested = RegGetValueW(hKey, NULL, ANJAL_LOG_REG_TRACE,
+            RRF_RT_REG_DWORD, NULL, &value, &cb) == ERROR_SUCCESS && value != 0;
+
+        RegCloseKey(hKey);
+    }
+
+    // Formats tag, category and message into a single buffer. Long messages
+    // are truncated rather than raising the CRT invalid parameter handler.
+    static void Log(DWORD category, const WCHAR* szFormat, ...)
+    {
+        WCHAR szBuff[1024];
+        int cchPrefix = swprintf_s(szBuff, _countof(szBuff), L"[%s/%s] ", logTag, _CategoryName(category));
+        if (cchPrefix < 0)
+            cchPrefix = 0;
+
+        va_list arg;
+        va_start(arg, szFormat);
+        int cch = _vsnwprintf_s(szBuff + cchPrefix, _countof(szBuff) - cchPrefix - 1, _TRUNCATE, szFormat, arg);
+        va_end(arg);
+
+        size_t cchTotal = (cch < 0) ? wcslen(szBuff) : (size_t)(cchPrefix + cch);
+        szBuff[cchTotal] = L'\n';
+        szBuff[cchTotal + 1] = 0;
+        OutputDebugStringW(szBuff);
+    }
+
     // Wide string output without tag
     static void OutputW(const WCHAR* szFormat, ...)
     {
@@ -69,8 +177,55 @@ public:
             OutputDebugStringA(szTaggedBuff);
         }
     }
+
+
+private:
+    static const WCHAR* _CategoryName(DWORD category)
+    {
+        switch (category)
+        {
+        case LogKeystroke:      return L"Key";
+        case LogEditSession:    return L"Edit";
+        case LogRegistration:   return L"Reg";
+        case LogLifecycle:      return L"Life";
+        default:                return L"-";
+        }
+    }
+
+    static inline LogLevel s_threshold = (LogLevel)ANJAL_LOG_MAX_LEVEL;
+    static inline DWORD s_categories = LogAllCategories;
+    static inline bool s_traceRequested = false;
 };
 
 // Convenience macros
 #define DebugOut Debug::OutputW
 #define DebugOutA Debug::OutputA
+
+// Leveled logging: LogInfo(LogLifecycle, L"format", ...).
+// Arguments are only evaluated when the level and category are enabled.
+#define ANJAL_LOG(level, category, ...) \
+    do { if (Debug::IsEnabled(level, category)) Debug::Log(category, __VA_ARGS__); } while (0)
+
+#if ANJAL_LOG_COMPILED(ERROR)
+#define LogError(category, ...) ANJAL_LOG(LogLevelError, category, __VA_ARGS__)
+#else
+#define LogError(category, ...) ((void)0)
+#endif
+
+#if ANJAL_LOG_COMPILED(WARNING)
+#define LogWarning(category, ...) ANJAL_LOG(LogLevelWarning, category, __VA_ARGS__)
+#else
+#define LogWarning(category, ...) ((void)0)
+#endif
+
+#if ANJAL_LOG_COMPILED(INFO)
+#define LogInfo(category, ...) ANJAL_LOG(LogLevelInfo, category, __VA_ARGS__)
+#else
+#define LogInfo(category, ...) ((void)0)
+#endif
+
+#if ANJAL_LOG_COMPILED(VERBOSE)
+#define LogVerbose(category, ...) ANJAL_LOG(LogLevelVerbose, category, __VA_ARGS__)
+#else
+#define LogVerbose(category, ...) ((void)0)
+#endif
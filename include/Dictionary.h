@@ -0,0 +1,259 @@
+﻿// Dictionary.h
+// Read-only Tamil word dictionary for completion. The dictionary is one
+// blob - a header, a double-array trie over the Tamil block and the tails
+// of its single-word subtrees - that is used in place: attaching only
+// checks the header, nothing is parsed, copied or allocated. The DLL
+// carries its blob in the engine image (see EngineImage.h).
+// Portable C++17 - no Windows headers, no allocation
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+static const uint32_t c_dictionaryMagic = 0x43494441;   // "ADIC"
+static const uint16_t c_dictionaryVersion = 3;
+
+// Words are Tamil block code units only (U+0B80..U+0BFF)
+static const char16_t c_dictionaryFirstUnit = 0x0B80;
+static const size_t c_dictionaryUnitRange = 0x80;
+
+// Symbol 0 ends a word; code units map to 1..symbolCount-1
+static const uint8_t c_dictionaryEndSymbol = 0;
+
+// Longest word kept by the builder, and the depth of the enumeration stack
+static const size_t c_dictionaryMaxWord = 32;
+
+// Slots and tails are numbered in 24 bits; a free slot's parent is all ones
+static const uint32_t c_dictionaryIndexMask = 0xFFFFFF;
+static const uint32_t c_dictionaryFreeSlot = c_dictionaryIndexMask;
+
+// A slot whose info is this holds a tail, not a subtree maximum
+static const uint16_t c_dictionaryTailInfo = 0xFFFF;
+
+// States inside a tail are not slots: c_dictionaryTailState + (slot << 5) + k
+// is k symbols into the tail of 'slot', the end symbol included
+static const int32_t c_dictionaryTailState = 0x40000000;
+static const unsigned c_dictionaryTailShift = 5;
+static_assert(c_dictionaryMaxWord <= (1u << c_dictionaryTailShift), "tail offsets fit below the slot");
+static_assert(((int64_t)c_dictionaryIndexMask << c_dictionaryTailShift) < c_dictionaryTailState, "tail states fit in int32_t");
+
+// Transitions examined by one Complete call at most, so a short prefix with
+// a huge subtree costs no more than a long one
+static const size_t c_dictionaryVisitLimit = 4096;
+
+// Subtree maxima are stored in 16 bits: values below 2048 exactly, larger
+// ones as an 11-bit mantissa and an exponent, rounded up so the decoded
+// value is never below the true one (and at most 1/1024 above it)
+constexpr uint16_t DictionaryEncodeFrequency(uint32_t frequency)
+{
+    if (frequency < 2048)
+        return (uint16_t)frequency;
+
+    unsigned exponent = 0;
+    while ((frequency >> exponent) >= 2048)
+        exponent++;
+
+    uint32_t mantissa = frequency >> exponent;
+    if ((mantissa << exponent) != frequency)
+        mantissa++;
+    if (mantissa == 2048)
+    {
+        mantissa = 1024;
+        exponent++;
+    }
+
+    return (uint16_t)(2048 + (exponent - 1) * 1024 + (mantissa - 1024));
+}
+
+constexpr uint32_t DictionaryDecodeFrequency(uint16_t code)
+{
+    return (code < 2048) ? code : (uint32_t)(1024 + (code - 2048) % 1024) << ((code - 2048) / 1024 + 1);
+}
+
+static_assert(DictionaryDecodeFrequency(DictionaryEncodeFrequency(2047)) == 2047, "exact range");
+static_assert(DictionaryDecodeFrequency(DictionaryEncodeFrequency(2049)) == 2050, "rounded up");
+static_assert(DictionaryDecodeFrequency(DictionaryEncodeFrequency(4095)) == 4096, "mantissa carry");
+static_assert(DictionaryDecodeFrequency(DictionaryEncodeFrequency(1000001)) >= 1000001 &&
+    DictionaryDecodeFrequency(DictionaryEncodeFrequency(1000001)) - 1000001 < 1000001 / 1024, "relative error");
+static_assert(DictionaryDecodeFrequency(DictionaryEncodeFrequency(INT32_MAX)) >= (uint32_t)INT32_MAX, "largest frequency");
+static_assert(DictionaryEncodeFrequency(INT32_MAX) < c_dictionaryTailInfo, "no frequency reads as a tail");
+
+struct DictionaryHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t symbolCount;                       // including the end symbol
+    uint32_t wordCount;
+    uint32_t unitCount;                         // DictionaryUnit entries after the header
+    uint32_t tailCount;                         // DictionaryTail entries after the units
+    uint32_t tailSymbolCount;                   // symbols after the tails
+    uint8_t symbolOf[c_dictionaryUnitRange];    // code unit - U+0B80 -> symbol, 0 = not in any word
+    char16_t unitOf[c_dictionaryUnitRange];     // symbol -> code unit
+};
+
+// One double-array slot, 8 bytes. A child of state s on symbol c is
+// t = Base(s) + c with Parent(t) == s; the children of a state are found by
+// probing its symbols in order. Info, split over the two high bytes, is the
+// highest word frequency below the state (DictionaryEncodeFrequency) or
+// c_dictionaryTailInfo. Two kinds of slot use 'base' otherwise: the
+// end-symbol child that closes a word holds the word's frequency in all 32
+// bits, and a tail slot - the only word below it continues in one line -
+// holds the index of its DictionaryTail.
+struct DictionaryUnit
+{
+    uint32_t base;                              // base, low 24 bits; info, low byte
+    uint32_t check;                             // parent state, low 24 bits; info, high byte
+
+    uint32_t Base() const { return base & c_dictionaryIndexMask; }
+    uint32_t Parent() const { return check & c_dictionaryIndexMask; }
+    uint16_t Info() const { return (uint16_t)((base >> 24) | ((check >> 24) << 8)); }
+};
+
+// The rest of a tail slot's word: its frequency, and where its symbols
+// start in the symbol pool. They run to an end symbol. A tail that ends
+// another one is not stored again but points into it.
+struct DictionaryTail
+{
+    uint32_t frequency;
+    uint32_t iSymbol;
+};
+
+static_assert(sizeof(DictionaryHeader) % 4 == 0, "units follow the header 4-byte aligned");
+static_assert(sizeof(DictionaryUnit) == 8 && sizeof(DictionaryTail) == 8, "blob layout");
+
+struct DictionaryMatch
+{
+    uint32_t frequency;
+    uint16_t ichWord;                           // offset of the word in the caller's text buffer
+    uint16_t cchWord;
+};
+
+class Dictionary
+{
+public:
+    Dictionary() : _pHeader(nullptr), _pUnits(nullptr), _pTails(nullptr), _pSymbols(nullptr) {}
+
+    // Uses the blob in place; it must stay mapped while the dictionary is
+    // used. Returns false if the blob is not a dictionary of this version.
+    bool Attach(const void* pBlob, size_t cbBlob);
+
+    bool IsAttached() const { return _pHeader != nullptr; }
+    uint32_t WordCount() const { return _pHeader ? _pHeader->wordCount : 0; }
+    size_t BlobSize() const;
+
+    // Root state, or the state after a prefix; -1 if no word starts with it
+    static const int32_t c_root = 0;
+    int32_t Walk(int32_t state, const char16_t* pch, size_t cch) const;
+
+    // Frequency of the word ending at 'state', 0 if it is only a prefix
+    uint32_t WordFrequency(int32_t state) const;
+
+    // Tree navigation for ranked enumeration (see CandidateRanker.h).
+    // Children are listed in symbol order and include the end-symbol child
+    // of a state that ends a word; -1 ends the list.
+    int32_t FirstChild(int32_t state) const
+    {
+        if (state >= c_dictionaryTailState)
+            return IsWordEnd(state) ? -1 : state + 1;
+        if (_pUnits[state].Info() == c_dictionaryTailInfo)
+            return _TailState(state, 1);
+        return _NextChild(state, c_dictionaryEndSymbol);
+    }
+
+    int32_t NextSibling(int32_t child) const
+    {
+        return (child >= c_dictionaryTailState) ? -1 : _NextChild((int32_t)_pUnits[child].Parent(), Symbol(child) + 1);
+    }
+
+    // The same, when the caller has the parent at hand
+    int32_t NextSibling(int32_t state, int32_t child) const
+    {
+        return (child >= c_dictionaryTailState) ? -1 : _NextChild(state, child - _pUnits[state].Base() + 1);
+    }
+
+    int32_t Parent(int32_t state) const
+    {
+        if (state < c_dictionaryTailState)
+            return (int32_t)_pUnits[state].Parent();
+        return ((state & _TailOffsetMask()) == 1) ? _TailSlot(state) : state - 1;
+    }
+
+    // Symbol on the transition into a state other than the root
+    uint8_t Symbol(int32_t state) const
+    {
+        if (state >= c_dictionaryTailState)
+            return _pSymbols[_pTails[_pUnits[_TailSlot(state)].Base()].iSymbol + (state & _TailOffsetMask()) - 1];
+        return (uint8_t)(state - _pUnits[_pUnits[state].Parent()].Base());
+    }
+
+    // True for the end-symbol child that closes a word at its parent
+    bool IsWordEnd(int32_t child) const
+    {
+        if (child >= c_dictionaryTailState)
+            return Symbol(child) == c_dictionaryEndSymbol;
+        return child != c_root && _pUnits[_pUnits[child].Parent()].Base() == (uint32_t)child;
+    }
+
+    // Highest frequency of a word at or below a state - an upper bound
+    // within 1/1024 - or the exact frequency of a word end or a tail
+    uint32_t MaxFrequency(int32_t state) const
+    {
+        if (state >= c_dictionaryTailState)
+            return _pTails[_pUnits[_TailSlot(state)].Base()].frequency;
+        if (IsWordEnd(state))
+            return _pUnits[state].base;
+        uint16_t info = _pUnits[state].Info();
+        return (info == c_dictionaryTailInfo) ? _pTails[_pUnits[state].Base()].frequency : DictionaryDecodeFrequency(info);
+    }
+
+    // Writes the cchWord units that lead from the root to 'state'
+    void PathText(int32_t state, size_t cchWord, char16_t* pch) const
+    {
+        for (size_t i = cchWord; i > 0; i--)
+        {
+            pch[i - 1] = _pHeader->unitOf[Symbol(state)];
+            state = Parent(state);
+        }
+    }
+
+    // Words starting with the prefix (the prefix itself included when it is
+    // a word), in code point order. Fills up to cMatchesMax matches whose
+    // text is written to pchText[0..cchTextMax). Examines at most
+    // c_dictionaryVisitLimit transitions and never allocates.
+    size_t Complete(const char16_t* pchPrefix, size_t cchPrefix,
+        DictionaryMatch* pMatches, size_t cMatchesMax,
+        char16_t* pchText, size_t cchTextMax) const;
+
+private:
+    int32_t _Child(int32_t state, uint8_t symbol) const
+    {
+        uint32_t t = _pUnits[state].Base() + symbol;
+        return (t > 0 && t < _pHeader->unitCount && _pUnits[t].Parent() == (uint32_t)state) ? (int32_t)t : -1;
+    }
+
+    // The first child on 'symbol' or a later one, -1 if none. A state with
+    // children has a base of at least 1, so no probe lands on the root.
+    int32_t _NextChild(int32_t state, uint32_t symbol) const
+    {
+        uint32_t base = _pUnits[state].Base();
+        uint32_t tEnd = base + _pHeader->symbolCount;
+        if (tEnd > _pHeader->unitCount)
+            tEnd = _pHeader->unitCount;
+        for (uint32_t t = base + symbol; t < tEnd; t++)
+        {
+            if (_pUnits[t].Parent() == (uint32_t)state)
+                return (int32_t)t;
+        }
+        return -1;
+    }
+
+    static int32_t _TailState(int32_t slot, uint32_t k) { return c_dictionaryTailState + (slot << c_dictionaryTailShift) + (int32_t)k; }
+    static int32_t _TailSlot(int32_t state) { return (state - c_dictionaryTailState) >> c_dictionaryTailShift; }
+    static int32_t _TailOffsetMask() { return (1 << c_dictionaryTailShift) - 1; }
+
+    const DictionaryHeader* _pHeader;
+    const DictionaryUnit* _pUnits;
+    const DictionaryTail* _pTails;
+    const uint8_t* _pSymbols;
+};
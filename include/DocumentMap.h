@@ -0,0 +1,97 @@
+﻿// DocumentMap.h
+// Engine state per document, so moving focus between text boxes does not
+// lose the syllable left open in each. Open addressing with linear probing
+// over a power-of-two table, keyed by the document's identity (the
+// ITfDocumentMgr pointer, never dereferenced). The first c_documentMapInline
+// slots live inside the map, so a thread with a few documents never touches
+// the heap; past three quarters full the table moves to the heap and doubles.
+// Removal shifts the probe run back, so there are no tombstones and lookups
+// stay short under churn.
+// Portable C++17 - no Windows headers
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "KeyboardEngine.h"
+#include "SurroundingText.h"
+
+static const size_t c_documentMapInline = 16;
+
+// What a document keeps while another has focus. Plain data.
+struct DocumentState
+{
+    KeyboardEngine engine;          // open syllable as the document was left
+    SurroundingText textBefore;     // the text before the caret then
+    bool fSaved;                    // false until the document first loses focus
+
+    // True when the saved syllable can continue after textBefore: the
+    // document's current text before the caret must agree with it, over
+    // at least the units the syllable may still rewrite
+    bool Matches(const SurroundingText& current) const
+    {
+        size_t cchComposing = engine.ComposingLength();
+        if (!fSaved || cchComposing == 0)
+            return false;
+
+        size_t cch = (current.Length() < textBefore.Length()) ? current.Length() : textBefore.Length();
+        if (cch < cchComposing)
+            return false;
+
+        const char16_t* pchSaved = textBefore.Text() + textBefore.Length() - cch;
+        const char16_t* pchCurrent = current.Text() + current.Length() - cch;
+        for (size_t i = 0; i < cch; i++)
+        {
+            if (pchSaved[i] != pchCurrent[i])
+                return false;
+        }
+        return true;
+    }
+};
+
+class DocumentMap
+{
+public:
+    DocumentMap();
+    ~DocumentMap();
+
+    // The document's state, or null
+    DocumentState* Find(const void* pDocument);
+
+    // The document's state, added unsaved if it has none. Null only when
+    // the table had to grow and the allocation failed.
+    DocumentState* Insert(const void* pDocument);
+
+    void Remove(const void* pDocument);
+
+    // Forgets every document and gives back a heap table
+    void Clear();
+
+    size_t Count() const { return _cEntries; }
+    size_t Capacity() const { return _mask + 1; }
+    bool IsInline() const { return _pSlots == _inlineSlots; }
+
+private:
+    struct Slot
+    {
+        const void* pDocument;      // null when free
+        DocumentState state;
+    };
+
+    DocumentMap(const DocumentMap&) = delete;
+    DocumentMap& operator=(const DocumentMap&) = delete;
+
+    size_t _Home(const void* pDocument) const
+    {
+        return (size_t)(((uint64_t)(uintptr_t)pDocument * 0x9E3779B97F4A7C15ull) >> _shift);
+    }
+
+    bool _Grow();
+
+    Slot* _pSlots;
+    size_t _mask;
+    unsigned _shift;                // 64 - log2(capacity)
+    size_t _cEntries;
+    Slot _inlineSlots[c_documentMapInline];
+};
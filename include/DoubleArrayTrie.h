@@ -0,0 +1,135 @@
+﻿// DoubleArrayTrie.h
+// Compact double-array trie over ASCII letters, built at compile time.
+// Transitions are two array loads (base, check) with no pointers, so the
+// whole structure is a few flat arrays that fit in a handful of cache lines.
+// Portable C++17 - no Windows headers
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Alphabet: 'A'..'z' -> 1..58, anything else has no transition
+static const int c_trieAlphabetFirst = 0x40;
+static const int c_trieAlphabetLast = 0x7A;
+
+inline constexpr int TrieCode(char ch)
+{
+    return (ch > c_trieAlphabetFirst && ch <= c_trieAlphabetLast) ? ch - c_trieAlphabetFirst : 0;
+}
+
+template <size_t Capacity>
+struct DoubleArrayTrie
+{
+    static const int c_root = 0;
+
+    int16_t base[Capacity];
+    int16_t check[Capacity];    // parent state, -1 = free slot
+    uint8_t value[Capacity];    // key index + 1, 0 = not the end of a key
+
+    // Returns the state reached from 'state' on 'ch', or -1
+    constexpr int Next(int state, char ch) const
+    {
+        int code = TrieCode(ch);
+        int t = base[state] + code;
+        return (code != 0 && t > 0 && t < (int)Capacity && check[t] == state) ? t : -1;
+    }
+};
+
+// Builds the double array from an array of keyed records (record.roman is
+// the key). First an ordinary first-child/next-sibling trie is built, then
+// each node's children are placed breadth-first at the lowest free base.
+template <size_t Capacity, typename Record, size_t N>
+constexpr DoubleArrayTrie<Capacity> MakeDoubleArrayTrie(const Record (&records)[N])
+{
+    static_assert(N < 255, "too many keys for 8-bit values");
+
+    // Linked trie
+    char nodeChar[Capacity] = {};
+    int16_t firstChild[Capacity] = {};
+    int16_t nextSibling[Capacity] = {};
+    uint8_t nodeValue[Capacity] = {};
+    size_t cNodes = 1;
+
+    for (size_t i = 0; i < N; i++)
+    {
+        int16_t node = 0;
+        for (const char* pch = records[i].roman; *pch; pch++)
+        {
+            int16_t child = firstChild[node];
+            while (child && nodeChar[child] != *pch)
+                child = nextSibling[child];
+
+            if (!child)
+            {
+                child = (int16_t)cNodes++;
+                nodeChar[child] = *pch;
+                nextSibling[child] = firstChild[node];
+                firstChild[node] = child;
+            }
+            node = child;
+        }
+        nodeValue[node] = (uint8_t)(i + 1);
+    }
+
+    // Double array
+    DoubleArrayTrie<Capacity> trie = {};
+    for (size_t i = 0; i < Capacity; i++)
+        trie.check[i] = -1;
+    trie.check[0] = -2;     // root slot is taken
+
+    int16_t slot[Capacity] = {};    // double-array index of each trie node
+    int16_t queue[Capacity] = {};
+    size_t head = 0;
+    size_t tail = 0;
+    queue[tail++] = 0;
+    int firstFree = 1;
+
+    while (head < tail)
+    {
+        int16_t node = queue[head++];
+        int16_t state = slot[node];
+
+        if (!firstChild[node])
+            continue;
+
+        while (trie.check[firstFree] != -1)
+            firstFree++;
+
+        int minCode = c_trieAlphabetLast;
+        for (int16_t child = firstChild[node]; child; child = nextSibling[child])
+        {
+            if (TrieCode(nodeChar[child]) < minCode)
+                minCode = TrieCode(nodeChar[child]);
+        }
+
+        int b = firstFree - minCode;
+        for (;; b++)
+        {
+            // Out of room: not a constant expression, so the build fails
+            if (b + minCode >= (int)Capacity)
+                throw "DoubleArrayTrie capacity too small";
+
+            bool fits = true;
+            for (int16_t child = firstChild[node]; child && fits; child = nextSibling[child])
+            {
+                int t = b + TrieCode(nodeChar[child]);
+                fits = (t > 0 && t < (int)Capacity && trie.check[t] == -1);
+            }
+            if (fits)
+                break;
+        }
+
+        trie.base[state] = (int16_t)b;
+        for (int16_t child = firstChild[node]; child; child = nextSibling[child])
+        {
+            int16_t t = (int16_t)(b + TrieCode(nodeChar[child]));
+            trie.check[t] = state;
+            trie.value[t] = nodeValue[child];
+            slot[child] = t;
+            queue[tail++] = child;
+        }
+    }
+
+    return trie;
+}
@@ -0,0 +1,102 @@
+﻿// EngineImage.h
+// All immutable engine data - the layouts' key tables, the syllable matrix
+// and the word dictionary - in one read-only image. The image holds no
+// pointers: a header lists each section by offset and size, so it can be
+// used wherever it is mapped. The DLL embeds it page-aligned and padded to
+// whole pages (src/EngineImageData.cpp, generated by tools/ImageBuild.cpp);
+// no relocation touches those pages, so every process that loads the DLL
+// shares one copy of them. The same bytes in a file can be mapped instead.
+// Portable C++17 - no Windows headers
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Dictionary.h"
+#include "LayoutRegistry.h"
+#include "TamilScript.h"
+
+static const uint32_t c_engineImageMagic = 0x4D494541;     // "AEIM"
+static const uint16_t c_engineImageVersion = 1;
+static const size_t c_engineImagePage = 4096;
+static const size_t c_engineImageAlign = 64;                // sections start on a cache line
+
+enum EngineImageSectionId : uint8_t
+{
+    EngineImageKeyMaps = 0,     // KeyMapTables per layout, in LayoutId order
+    EngineImageSyllables,       // TamilSyllableMatrix
+    EngineImageDictionary,      // dictionary blob (see Dictionary.h)
+    EngineImageSectionCount
+};
+
+struct EngineImageSection
+{
+    uint32_t offset;            // from the start of the image
+    uint32_t cb;
+};
+
+struct EngineImageHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t sectionCount;
+    uint32_t cbImage;           // whole pages
+    uint32_t reserved;
+    EngineImageSection sections[EngineImageSectionCount];
+};
+
+// Lays out an image of the compiled-in key tables and syllable matrix with
+// the given dictionary blob. Returns the image size, or 0 if it is larger
+// than cbImageMax; with pvImage null only computes the size.
+size_t WriteEngineImage(void* pvImage, size_t cbImageMax, const void* pvDictionary, size_t cbDictionary);
+
+class EngineImage
+{
+public:
+    EngineImage() : _pbImage(nullptr), _cbImage(0), _pKeyMaps(nullptr), _pSyllables(nullptr) {}
+
+    // Uses the image in place; it must stay mapped while in use. Returns
+    // false, and serves the compiled-in tables, if the image is not valid.
+    bool Attach(const void* pvImage, size_t cbImage);
+
+    bool IsAttached() const { return _pbImage != nullptr; }
+    size_t Size() const { return _cbImage; }
+
+    const KeyMapTables& KeyMap(LayoutId id) const { return _pKeyMaps ? _pKeyMaps[id] : *g_layouts[id].keyMap; }
+    const TamilSyllableMatrix& Syllables() const { return _pSyllables ? *_pSyllables : c_tamilSyllables; }
+    const Dictionary& GetDictionary() const { return _dictionary; }
+
+    // True when the key tables and syllable matrix in the image are those
+    // compiled from the sources - false for an image not rebuilt since
+    bool MatchesSources() const;
+
+private:
+    const uint8_t* _pbImage;
+    size_t _cbImage;
+    const KeyMapTables* _pKeyMaps;
+    const TamilSyllableMatrix* _pSyllables;
+    Dictionary _dictionary;
+};
+
+// Generated data (src/EngineImageData.cpp)
+extern const uint32_t g_engineImage[];
+extern const size_t g_cbEngineImage;
+
+// The image embedded in the DLL, attached on first use. Inline so the
+// offline tools, which build their own images, never reference the data.
+inline const EngineImage& EmbeddedImage()
+{
+    static const EngineImage s_image = []()
+    {
+        EngineImage image;
+        image.Attach(g_engineImage, g_cbEngineImage);
+        return image;
+    }();
+    return s_image;
+}
+
+inline const Dictionary& EmbeddedDictionary()
+{
+    return EmbeddedImage().GetDictionary();
+}
@@ -0,0 +1,47 @@
+﻿// EngineOutput.h
+// Fixed-size result of feeding one key to a composition engine.
+// Portable C++17 - no Windows headers
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+static const size_t c_engineMaxOutput = 16;
+
+// cchDelete code units before the caret are replaced by text[0..cchText).
+// Engines only delete text they emitted themselves within the current syllable.
+struct EngineOutput
+{
+    uint8_t cchDelete;
+    uint8_t cchText;
+    char16_t text[c_engineMaxOutput];
+
+    void Clear()
+    {
+        cchDelete = 0;
+        cchText = 0;
+    }
+
+    void Append(char16_t ch)
+    {
+        if (cchText < c_engineMaxOutput)
+            text[cchText++] = ch;
+    }
+
+    void Append(const char16_t* pch, size_t cch)
+    {
+        for (size_t i = 0; i < cch; i++)
+            Append(pch[i]);
+    }
+
+    // Applies a further (delete, insert) step on top of this output.
+    // Deletions first consume text appended earlier, then reach into the document.
+    void Merge(size_t cchDel, const char16_t* pch, size_t cch)
+    {
+        size_t cchFromText = (cchDel < cchText) ? cchDel : cchText;
+        cchText = (uint8_t)(cchText - cchFromText);
+        cchDelete = (uint8_t)(cchDelete + cchDel - cchFromText);
+        Append(pch, cch);
+    }
+};
@@ -0,0 +1,66 @@
+﻿// KeyDecisionCache.h
+// Single-entry cache of the decision for the key being delivered. TSF calls
+// OnTestKeyDown and then OnKeyDown for the same key; the test computes the
+// mapping, the engine output and the engine's next state once, and the key
+// down consumes them. The entry is keyed by wParam, lParam, context,
+// modifiers and the engine version it was computed from, so any state
+// change in between turns it into a miss.
+// Portable C++17 - no Windows headers
+
+#pragma once
+
+#include "KeyboardEngine.h"
+
+struct KeyDecision
+{
+    uintptr_t wParam;
+    intptr_t lParam;
+    const void* pContext;
+    uint32_t modifiers;         // ModifierTracker::Bits()
+    uint32_t engineVersion;     // version the decision was computed from
+    char16_t code;              // mapped key code, 0 if not mapped
+    bool consumed;              // engine consumed the key
+    EngineOutput output;
+    KeyboardEngine next;        // engine state after the key
+};
+
+class KeyDecisionCache
+{
+public:
+    KeyDecisionCache() : _valid(false), _hits(0), _misses(0) {}
+
+    // Counts a hit or a miss
+    const KeyDecision* Find(uintptr_t wParam, intptr_t lParam, const void* pContext, uint32_t modifiers,
+        uint32_t engineVersion)
+    {
+        if (_valid && _entry.wParam == wParam && _entry.lParam == lParam && _entry.pContext == pContext &&
+            _entry.modifiers == modifiers && _entry.engineVersion == engineVersion)
+        {
+            _hits++;
+            return &_entry;
+        }
+
+        _misses++;
+        return nullptr;
+    }
+
+    // Slot for a new decision; valid once Store is called
+    KeyDecision& Begin()
+    {
+        _valid = false;
+        return _entry;
+    }
+
+    void Store() { _valid = true; }
+
+    void Invalidate() { _valid = false; }
+
+    uint64_t Hits() const { return _hits; }
+    uint64_t Misses() const { return _misses; }
+
+private:
+    bool _valid;
+    KeyDecision _entry;
+    uint64_t _hits;
+    uint64_t _misses;
+};
@@ -0,0 +1,181 @@
+﻿// KeyMap.h
+// Declarative keyboard layout description and the constexpr generator that
+// turns it into dense per-modifier lookup tables (one 256-entry array per
+// layer, indexed by virtual key).
+// Portable C++17 - no Windows headers, builds with MSVC, GCC and Clang
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Modifier layers
+enum KeyLayer : uint8_t
+{
+    KeyLayerBase = 0,
+    KeyLayerShift = 1,
+    KeyLayerAltGr = 2,
+    KeyLayerCount = 3
+};
+
+// Windows virtual-key codes for the OEM keys (US physical positions).
+// Letters and digits use their upper-case ASCII value, as on Windows.
+static const uint8_t c_vkOem1 = 0xBA;       // ;:
+static const uint8_t c_vkOemPlus = 0xBB;    // =+
+static const uint8_t c_vkOemComma = 0xBC;   // ,<
+static const uint8_t c_vkOemMinus = 0xBD;   // -_
+static const uint8_t c_vkOemPeriod = 0xBE;  // .>
+static const uint8_t c_vkOem2 = 0xBF;       // /?
+static const uint8_t c_vkOem3 = 0xC0;       // `~
+static const uint8_t c_vkOem4 = 0xDB;       // [{
+static const uint8_t c_vkOem5 = 0xDC;       // \|
+static const uint8_t c_vkOem6 = 0xDD;       // ]}
+static const uint8_t c_vkOem7 = 0xDE;       // '"
+
+// The key and layer that type a printable ASCII character on a US keyboard.
+// False for characters no key types (controls, anything past '~').
+constexpr bool UsKeyForAscii(char16_t ch, uint8_t* pvk, KeyLayer* pLayer)
+{
+    const char* shiftedDigits = ")!@#$%^&*(";
+    const char* oemBase = ";=,-./`[\\]'";
+    const char* oemShift = ":+<_>?~{|}\"";
+    const uint8_t oemVk[] =
+    {
+        c_vkOem1, c_vkOemPlus, c_vkOemComma, c_vkOemMinus, c_vkOemPeriod, c_vkOem2,
+        c_vkOem3, c_vkOem4, c_vkOem5, c_vkOem6, c_vkOem7
+    };
+
+    *pLayer = KeyLayerBase;
+
+    if (ch >= 'a' && ch <= 'z')
+    {
+        *pvk = (uint8_t)(ch - 'a' + 'A');
+        return true;
+    }
+    if ((ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == ' ')
+    {
+        *pvk = (uint8_t)ch;
+        *pLayer = (ch >= 'A' && ch <= 'Z') ? KeyLayerShift : KeyLayerBase;
+        return true;
+    }
+
+    for (size_t i = 0; i < 10; i++)
+    {
+        if (ch == (char16_t)shiftedDigits[i])
+        {
+            *pvk = (uint8_t)('0' + i);
+            *pLayer = KeyLayerShift;
+            return true;
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(oemVk); i++)
+    {
+        if (ch == (char16_t)oemBase[i] || ch == (char16_t)oemShift[i])
+        {
+            *pvk = oemVk[i];
+            *pLayer = (ch == (char16_t)oemShift[i]) ? KeyLayerShift : KeyLayerBase;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Keys that produce more than one code unit (e.g. க்ஷ) are stored in the
+// table as c_keySequenceBase + index into the layout's sequence list.
+// The base lies in the private use area, which no layout emits directly.
+static const char16_t c_keySequenceBase = 0xE000;
+static const size_t c_keySequenceSlots = 32;
+static const size_t c_keySequenceLength = 6;   // including terminator
+
+// One physical key of a layout description. Zero means "not mapped" on
+// that layer; unmapped keys are passed through to the application.
+struct KeyBinding
+{
+    uint8_t vk;
+    char16_t base;
+    char16_t shift;
+    char16_t altGr;
+};
+
+// Generated lookup tables for one layout
+struct KeyMapTables
+{
+    char16_t layers[KeyLayerCount][256];
+    char16_t sequences[c_keySequenceSlots][c_keySequenceLength];
+
+    // Branch-free lookup: one load from a single cache line.
+    // Returns 0 for unmapped keys and for wParam values outside 0..255.
+    constexpr char16_t Lookup(KeyLayer layer, uintptr_t vk) const
+    {
+        return layers[layer][vk & 0xFF] & (char16_t)((vk <= 0xFF) ? 0xFFFF : 0);
+    }
+
+    static constexpr bool IsSequence(char16_t code)
+    {
+        return code >= c_keySequenceBase && code < c_keySequenceBase + c_keySequenceSlots;
+    }
+
+    // Expands a looked-up code into its output text. Returns the number of
+    // code units written to pchOut (at most c_keySequenceLength - 1).
+    size_t Expand(char16_t code, char16_t* pchOut) const
+    {
+        if (!IsSequence(code))
+        {
+            pchOut[0] = code;
+            return code ? 1 : 0;
+        }
+
+        const char16_t* pch = sequences[code - c_keySequenceBase];
+        size_t cch = 0;
+        while (cch < c_keySequenceLength - 1 && pch[cch])
+        {
+            pchOut[cch] = pch[cch];
+            cch++;
+        }
+        return cch;
+    }
+};
+
+// constexpr generator: builds the dense tables from a layout description.
+// Sequences are null-terminated UTF-16 literals referenced from bindings
+// as c_keySequenceBase + index.
+template <size_t N, size_t S>
+constexpr KeyMapTables MakeKeyMapTables(const KeyBinding (&bindings)[N],
+    const char16_t* const (&sequences)[S])
+{
+    static_assert(S <= c_keySequenceSlots, "too many key sequences in layout");
+
+    KeyMapTables tables = {};
+
+    for (size_t i = 0; i < N; i++)
+    {
+        tables.layers[KeyLayerBase][bindings[i].vk] = bindings[i].base;
+        tables.layers[KeyLayerShift][bindings[i].vk] = bindings[i].shift;
+        tables.layers[KeyLayerAltGr][bindings[i].vk] = bindings[i].altGr;
+    }
+
+    for (size_t i = 0; i < S; i++)
+    {
+        for (size_t j = 0; j < c_keySequenceLength - 1 && sequences[i][j]; j++)
+        {
+            tables.sequences[i][j] = sequences[i][j];
+        }
+    }
+
+    return tables;
+}
+
+template <size_t N>
+constexpr KeyMapTables MakeKeyMapTables(const KeyBinding (&bindings)[N])
+{
+    const char16_t* const noSequences[1] = { u"" };
+    return MakeKeyMapTables(bindings, noSequences);
+}
+
+// Layouts
+extern const KeyMapTables g_keyMapTamil99;
+extern const KeyMapTables g_keyMapAnjal;
+extern const KeyMapTables g_keyMapTypewriter;
+extern const KeyMapTables g_keyMapBamini;
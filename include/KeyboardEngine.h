@@ -0,0 +1,72 @@
+﻿// KeyboardEngine.h
+// Layout-independent front end used by the text service: maps a key through
+// the active layout's tables and runs it through that layout's composition
+// engine. All engine state is held inline, so switching layouts only swaps
+// the descriptor pointer - no parsing, no allocation. The key tables are
+// read from the shared engine image (see EngineImage.h).
+// Portable C++17 - no Windows headers
+
+#pragma once
+
+#include "EngineImage.h"
+#include "LayoutRegistry.h"
+#include "PhoneticEngine.h"
+#include "Tamil99Engine.h"
+#include "TypewriterEngine.h"
+
+class KeyboardEngine
+{
+public:
+    // Starts on the compiled tables, so constructing one touches no image;
+    // SetLayout switches to the image's copy
+    KeyboardEngine() :
+        _pLayout(&g_layouts[LayoutTamil99]),
+        _pKeyMap(g_layouts[LayoutTamil99].keyMap),
+        _version(0)
+    {
+    }
+
+    void SetLayout(const LayoutDescriptor* pLayout)
+    {
+        _pLayout = pLayout;
+        _pKeyMap = &EmbeddedImage().KeyMap(pLayout->id);
+        Reset();
+    }
+
+    // Changes whenever the state may have changed (key, reset, layout), so
+    // a decision computed at one version is valid only at that version.
+    // Copies carry the version along.
+    uint32_t Version() const { return _version; }
+
+    const LayoutDescriptor* GetLayout() const { return _pLayout; }
+
+    // Code for the key on the given layer, 0 if unmapped (see KeyMapTables)
+    char16_t MapKey(KeyLayer layer, uintptr_t vk) const
+    {
+        return _pKeyMap->Lookup(layer, vk);
+    }
+
+    // Runs a code returned by MapKey through the active engine.
+    // Returns true when the key was consumed.
+    bool ProcessKey(char16_t code, EngineOutput* pOutput);
+
+    // Trailing code units of the text emitted so far that the active engine
+    // may still delete or rewrite - the open syllable. 0 at a syllable
+    // boundary. The next ProcessKey never deletes more than this.
+    size_t ComposingLength() const;
+
+    // Forget any pending syllable
+    void Reset();
+
+    // Reset, then pick up the syllable that ends the text before the caret
+    // (a few units, oldest first - see SurroundingText.h)
+    void Resume(const char16_t* pchBefore, size_t cchBefore);
+
+private:
+    const LayoutDescriptor* _pLayout;
+    const KeyMapTables* _pKeyMap;           // _pLayout's tables in the engine image
+    uint32_t _version;
+    Tamil99Engine _tamil99Engine;
+    TypewriterEngine _typewriterEngine;
+    PhoneticEngine _phoneticEngine;
+};
@@ -0,0 +1,164 @@
+﻿// LatencyHistogram.h
+// Fixed-memory log-linear latency histograms for the keystroke pipeline.
+// Values (nanoseconds) below 32 get exact buckets; above that every power
+// of two is split into 16 linear sub-buckets, so any recorded value is
+// reported within 1/16 (6.25%) of its true value. Recording is one relaxed
+// atomic increment; nothing is allocated.
+// Portable C++17
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+static const unsigned c_latencySubBucketBits = 4;
+static const uint64_t c_latencySubBuckets = 1 << c_latencySubBucketBits;            // 16
+static const unsigned c_latencyMaxBit = 47;                                          // ~39 hours in ns
+static const size_t c_latencyBucketCount = (c_latencyMaxBit - c_latencySubBucketBits + 2) * c_latencySubBuckets;
+
+constexpr unsigned LatencyHighestBit(uint64_t value)
+{
+    unsigned bit = 0;
+    while (value >>= 1)
+        bit++;
+    return bit;
+}
+
+// Bucket for a value; values beyond 2^(c_latencyMaxBit+1) land in the last bucket
+constexpr size_t LatencyBucketIndex(uint64_t value)
+{
+    if (value < 2 * c_latencySubBuckets)
+        return (size_t)value;
+
+    unsigned bit = LatencyHighestBit(value);
+    if (bit > c_latencyMaxBit)
+        return c_latencyBucketCount - 1;
+
+    unsigned shift = bit - c_latencySubBucketBits;
+    return (size_t)((shift + 1) * c_latencySubBuckets + ((value >> shift) - c_latencySubBuckets));
+}
+
+// Smallest value that maps to a bucket
+constexpr uint64_t LatencyBucketLowerBound(size_t index)
+{
+    if (index < 2 * c_latencySubBuckets)
+        return index;
+
+    uint64_t shift = index / c_latencySubBuckets - 1;
+    return (c_latencySubBuckets + index % c_latencySubBuckets) << shift;
+}
+
+// Largest value that maps to a bucket
+constexpr uint64_t LatencyBucketUpperBound(size_t index)
+{
+    return (index + 1 < c_latencyBucketCount) ? LatencyBucketLowerBound(index + 1) - 1 : UINT64_MAX;
+}
+
+static_assert(LatencyBucketIndex(31) == 31, "exact range");
+static_assert(LatencyBucketIndex(32) == 32 && LatencyBucketIndex(33) == 32, "first shifted bucket holds two values");
+static_assert(LatencyBucketIndex(63) == 47 && LatencyBucketIndex(64) == 48, "power-of-two boundary");
+static_assert(LatencyBucketLowerBound(LatencyBucketIndex(1000000)) <= 1000000 &&
+    LatencyBucketUpperBound(LatencyBucketIndex(1000000)) >= 1000000, "1 ms round trip");
+static_assert(LatencyBucketUpperBound(LatencyBucketIndex(1000000)) - LatencyBucketLowerBound(LatencyBucketIndex(1000000)) < 1000000 / 16,
+    "relative error below 1/16");
+static_assert(LatencyBucketIndex(UINT64_MAX) == c_latencyBucketCount - 1, "overflow bucket");
+static_assert(LatencyBucketIndex(LatencyBucketLowerBound(c_latencyBucketCount - 1)) == c_latencyBucketCount - 1, "last bucket");
+
+inline uint64_t LatencyNow()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+class LatencyHistogram
+{
+public:
+    void Record(uint64_t ns)
+    {
+        _buckets[LatencyBucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+        _sum.fetch_add(ns, std::memory_order_relaxed);
+
+        uint64_t max = _max.load(std::memory_order_relaxed);
+        while (ns > max && !_max.compare_exchange_weak(max, ns, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    uint64_t Count() const;
+    uint64_t Max() const { return _max.load(std::memory_order_relaxed); }
+    uint64_t Mean() const;
+
+    // Upper bound of the bucket holding the value at quantile q (0..1),
+    // capped at the largest value seen. 0 when empty.
+    uint64_t Percentile(double q) const;
+
+    void Reset();
+
+private:
+    std::atomic<uint32_t> _buckets[c_latencyBucketCount] = {};
+    std::atomic<uint64_t> _sum{ 0 };
+    std::atomic<uint64_t> _max{ 0 };
+};
+
+// Keystroke pipeline stages
+enum LatencyStage : uint8_t
+{
+    LatencyTestKeyDown,         // OnTestKeyDown
+    LatencyKeyDown,             // OnKeyDown, whole call
+    LatencyMapping,             // key lookup plus composition engine
+    LatencyRequestEditSession,  // RequestEditSession call (includes the session when run synchronously)
+    LatencyEditSessionQueue,    // RequestEditSession issued -> DoEditSession starts
+    LatencyEditSession,         // DoEditSession start -> end
+    LatencySetSelection,        // ITfContext::SetSelection inside the session
+    LatencyKeyToText,           // OnKeyDown start -> DoEditSession end
+    LatencyCompletion,          // dictionary ranking on the candidate worker
+    LatencyCandidates,          // word posted to the worker -> its completions received
+    LatencyLoad,                // DllGetClassObject and CreateInstance, each call
+    LatencyActivate,            // Activate of a new instance, whole call
+    LatencyFirstKey,            // first key after activation, deferred engine setup included
+    LatencyReactivate,          // Activate of an instance back from the warm cache, whole call
+    LatencyStageCount
+};
+
+struct LatencyStats
+{
+    LatencyHistogram stages[LatencyStageCount];
+
+    void Record(LatencyStage stage, uint64_t startNs, uint64_t endNs)
+    {
+        stages[stage].Record(endNs - startNs);
+    }
+
+    // Writes one line per stage with samples:
+    //   <stage> n=<count> mean=<us> p50=<us> p99=<us> p999=<us> max=<us>
+    // Returns the length written (always null terminated, truncated to cch).
+    size_t Dump(char* pszOut, size_t cch) const;
+
+    void Reset();
+};
+
+// Process-wide statistics for all text service instances
+extern LatencyStats g_latencyStats;
+
+// Records the time from construction to end of scope
+class LatencyScope
+{
+public:
+    explicit LatencyScope(LatencyStage stage, bool fRecord = true) : _stage(stage), _fRecord(fRecord), _startNs(LatencyNow()) {}
+    ~LatencyScope()
+    {
+        if (_fRecord)
+            g_latencyStats.Record(_stage, _startNs, LatencyNow());
+    }
+
+    uint64_t StartNs() const { return _startNs; }
+
+private:
+    LatencyStage _stage;
+    bool _fRecord;
+    uint64_t _startNs;
+};
+
+extern const char* const c_latencyStageNames[LatencyStageCount];
@@ -0,0 +1,37 @@
+﻿// LayoutRegistry.h
+// Registry of the keyboard layouts the text service offers. Each layout is an
+// immutable, statically allocated descriptor: its key tables plus the engine
+// (state machine) that composes the keys. Switching layouts is a pointer swap.
+// Portable C++17 - no Windows headers
+
+#pragma once
+
+#include "KeyMap.h"
+
+enum LayoutId : uint8_t
+{
+    LayoutTamil99 = 0,
+    LayoutAnjal,
+    LayoutTypewriter,
+    LayoutBamini,
+    LayoutCount
+};
+
+// Composition state machine used by a layout
+enum LayoutEngineKind : uint8_t
+{
+    LayoutEngineTamil99,        // Tamil99Engine - logical order, automatic pulli
+    LayoutEngineTypewriter,     // TypewriterEngine - visual order, prefix reordering
+    LayoutEnginePhonetic        // PhoneticEngine - romanized input, longest-match trie
+};
+
+struct LayoutDescriptor
+{
+    LayoutId id;
+    const char16_t* description;    // TSF profile description
+    const KeyMapTables* keyMap;     // compiled tables; the engine reads the image's copy
+    LayoutEngineKind engine;
+};
+
+// Indexed by LayoutId
+extern const LayoutDescriptor g_layouts[LayoutCount];
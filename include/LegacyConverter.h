@@ -0,0 +1,69 @@
+﻿// LegacyConverter.h
+// Converts documents in the 8-bit Tamil font encodings (TSCII, Bamini - see
+// LegacyEncoding.h) to Unicode and back. Each byte maps to its glyph's text
+// through a table generated from the encoding's glyph list, and the few
+// glyph pairs that draw something else (TSCII ஸ் + ு is ஸு) map as one.
+// The glyphs are in visual order, so decoding runs them through the
+// TypewriterEngine that the glyph-order keyboard layouts use: ெ + க becomes
+// கெ, ெ + க + ா becomes கொ. Encoding does the reverse, taking the longest
+// glyph that matches and moving ெ ே ை (and the front half of ொ ோ ௌ)
+// before the consonant.
+//
+// A byte that is not a glyph passes through, ASCII as itself and 0x80-0xFF
+// as the Latin-1 character of the same value. Where ASCII is never a glyph
+// (TSCII) its runs are copied with the TamilScan kernels. After a
+// pass-through byte the engine is back at its reset state, so a document
+// can be split there and the parts converted independently.
+// Portable C++17 - no Windows headers, no allocation
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "LegacyEncoding.h"
+
+// Decode's and Encode's result when the output buffer is too small
+static const size_t c_legacyNoRoom = SIZE_MAX;
+
+// Encode's stand-in for text the encoding has no glyph for
+static const char c_legacyUnmapped = '?';
+
+class LegacyConverter
+{
+public:
+    explicit LegacyConverter(LegacyEncodingId encoding);
+
+    LegacyEncodingId Encoding() const { return _encoding; }
+
+    // Converts cbIn bytes to Unicode in logical order. Returns the number
+    // of units written, or c_legacyNoRoom if pchOut fills up first. With
+    // pchOut NULL it only measures.
+    size_t Decode(const char* pbIn, size_t cbIn, char16_t* pchOut, size_t cchOutMax) const;
+
+    // Converts cchIn units to glyph bytes in visual order. Characters with
+    // no glyph are written as c_legacyUnmapped and counted in *pcUnmapped
+    // (may be NULL). Returns the bytes written, or c_legacyNoRoom; with
+    // pbOut NULL it only measures.
+    size_t Encode(const char16_t* pchIn, size_t cchIn, char* pbOut, size_t cbOutMax, size_t* pcUnmapped) const;
+
+    // Output buffer sizes that always suffice
+    static size_t MaxDecoded(size_t cbIn) { return cbIn * c_legacyGlyphMax; }
+    static size_t MaxEncoded(size_t cchIn) { return cchIn * 2; }
+
+private:
+    // The byte whose glyph is the longest prefix of pch[0..cch), or -1
+    int _Match(const char16_t* pch, size_t cch, size_t* pcchGlyph) const;
+
+    // The glyph pair whose text starts pch[0..cch), or -1
+    int _MatchPair(const char16_t* pch, size_t cch) const;
+
+    // Bytes for a vowel sign drawn in front of its consonant: the prefix
+    // glyph and, for ொ ோ ௌ, the glyph after it (-1 when there is none).
+    // False for other characters, or when the encoding lacks a glyph.
+    bool _SplitSign(char16_t ch, int* pbPrefix, int* pbSuffix) const;
+
+    LegacyEncodingId _encoding;
+    const LegacyEncodingTable* _pTable;
+    int _signBytes[7][2];       // _SplitSign's bytes for U+0BC6-U+0BCC
+};
@@ -0,0 +1,430 @@
+﻿// LegacyEncoding.h
+// 8-bit Tamil font encodings: which glyph each byte draws, as Unicode text.
+// Documents typed in these fonts store glyphs in visual order - the prefix
+// vowel signs ெ ே ை come before their consonant, and ொ ோ ௌ are split
+// around it - so LegacyConverter reorders as it converts (see
+// LegacyConverter.h). The glyph lists are the single source for the
+// converter's tables and, for Bamini, for the keyboard layout that types
+// the same bytes (KeyMapTypewriter.cpp).
+// Portable C++17 - no Windows headers
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "KeyMap.h"
+#include "TamilScript.h"
+
+enum LegacyEncodingId : uint8_t
+{
+    LegacyEncodingTscii = 0,
+    LegacyEncodingBamini = 1,
+    LegacyEncodingCount = 2
+};
+
+// Longest glyph text (ஸ்ரீ, க்ஷ்)
+static const size_t c_legacyGlyphMax = 4;
+static const size_t c_legacyPairMax = 8;
+
+// One byte of a font encoding and the text of its glyph, in logical order.
+// Bytes not listed pass through: ASCII as itself, 0x80-0xFF as the Latin-1
+// character of the same value.
+struct LegacyGlyph
+{
+    uint8_t byte;
+    const char16_t* text;
+};
+
+// Two glyphs that together draw other text than they do apart
+struct LegacyGlyphPair
+{
+    uint8_t first;
+    uint8_t second;
+    const char16_t* text;
+};
+
+//
+// TSCII 1.7. ASCII is left as it is; the glyphs are 0x80-0xFE. 0xFE is a
+// second இ, kept for old documents; text encodes to 0xAD.
+//
+inline constexpr LegacyGlyph c_tsciiGlyphs[] =
+{
+    { 0x80, u"\u0BE6" },                      // ௦
+    { 0x81, u"\u0BE7" },                      // ௧
+    { 0x82, u"\u0BB8\u0BCD\u0BB0\u0BC0" },    // ஸ்ரீ
+    { 0x83, u"\u0B9C" },                      // ஜ
+    { 0x84, u"\u0BB7" },                      // ஷ
+    { 0x85, u"\u0BB8" },                      // ஸ
+    { 0x86, u"\u0BB9" },                      // ஹ
+    { 0x87, u"\u0B95\u0BCD\u0BB7" },          // க்ஷ
+    { 0x88, u"\u0B9C\u0BCD" },                // ஜ்
+    { 0x89, u"\u0BB7\u0BCD" },                // ஷ்
+    { 0x8A, u"\u0BB8\u0BCD" },                // ஸ்
+    { 0x8B, u"\u0BB9\u0BCD" },                // ஹ்
+    { 0x8C, u"\u0B95\u0BCD\u0BB7\u0BCD" },    // க்ஷ்
+    { 0x8D, u"\u0BE8" },                      // ௨
+    { 0x8E, u"\u0BE9" },                      // ௩
+    { 0x8F, u"\u0BEA" },                      // ௪
+    { 0x90, u"\u0BEB" },                      // ௫
+    { 0x91, u"\u2018" },                      // ‘
+    { 0x92, u"\u2019" },                      // ’
+    { 0x93, u"\u201C" },                      // “
+    { 0x94, u"\u201D" },                      // ”
+    { 0x95, u"\u0BEC" },                      // ௬
+    { 0x96, u"\u0BED" },                      // ௭
+    { 0x97, u"\u0BEE" },                      // ௮
+    { 0x98, u"\u0BEF" },                      // ௯
+    { 0x99, u"\u0B99\u0BC1" },                // ஙு
+    { 0x9A, u"\u0B9E\u0BC1" },                // ஞு
+    { 0x9B, u"\u0B99\u0BC2" },                // ஙூ
+    { 0x9C, u"\u0B9E\u0BC2" },                // ஞூ
+    { 0x9D, u"\u0BF0" },                      // ௰
+    { 0x9E, u"\u0BF1" },                      // ௱
+    { 0x9F, u"\u0BF2" },                      // ௲
+    { 0xA1, u"\u0BBE" },                      // ா
+    { 0xA2, u"\u0BBF" },                      // ி
+    { 0xA3, u"\u0BC0" },                      // ீ
+    { 0xA4, u"\u0BC1" },                      // ு
+    { 0xA5, u"\u0BC2" },                      // ூ
+    { 0xA6, u"\u0BC6" },                      // ெ
+    { 0xA7, u"\u0BC7" },                      // ே
+    { 0xA8, u"\u0BC8" },                      // ை
+    { 0xA9, u"\u00A9" },                      // ©
+    { 0xAA, u"\u0BD7" },                      // ௗ
+    { 0xAB, u"\u0B85" },                      // அ
+    { 0xAC, u"\u0B86" },                      // ஆ
+    { 0xAD, u"\u0B87" },                      // இ
+    { 0xAE, u"\u0B88" },                      // ஈ
+    { 0xAF, u"\u0B89" },                      // உ
+    { 0xB0, u"\u0B8A" },                      // ஊ
+    { 0xB1, u"\u0B8E" },                      // எ
+    { 0xB2, u"\u0B8F" },                      // ஏ
+    { 0xB3, u"\u0B90" },                      // ஐ
+    { 0xB4, u"\u0B92" },                      // ஒ
+    { 0xB5, u"\u0B93" },                      // ஓ
+    { 0xB6, u"\u0B94" },                      // ஔ
+    { 0xB7, u"\u0B83" },                      // ஃ
+    { 0xB8, u"\u0B95" },                      // க
+    { 0xB9, u"\u0B99" },                      // ங
+    { 0xBA, u"\u0B9A" },                      // ச
+    { 0xBB, u"\u0B9E" },                      // ஞ
+    { 0xBC, u"\u0B9F" },                      // ட
+    { 0xBD, u"\u0BA3" },                      // ண
+    { 0xBE, u"\u0BA4" },                      // த
+    { 0xBF, u"\u0BA8" },                      // ந
+    { 0xC0, u"\u0BAA" },                      // ப
+    { 0xC1, u"\u0BAE" },                      // ம
+    { 0xC2, u"\u0BAF" },                      // ய
+    { 0xC3, u"\u0BB0" },                      // ர
+    { 0xC4, u"\u0BB2" },                      // ல
+    { 0xC5, u"\u0BB5" },                      // வ
+    { 0xC6, u"\u0BB4" },                      // ழ
+    { 0xC7, u"\u0BB3" },                      // ள
+    { 0xC8, u"\u0BB1" },                      // ற
+    { 0xC9, u"\u0BA9" },                      // ன
+    { 0xCA, u"\u0B9F\u0BBF" },                // டி
+    { 0xCB, u"\u0B9F\u0BC0" },                // டீ
+    { 0xCC, u"\u0B95\u0BC1" },                // கு
+    { 0xCD, u"\u0B9A\u0BC1" },                // சு
+    { 0xCE, u"\u0B9F\u0BC1" },                // டு
+    { 0xCF, u"\u0BA3\u0BC1" },                // ணு
+    { 0xD0, u"\u0BA4\u0BC1" },                // து
+    { 0xD1, u"\u0BA8\u0BC1" },                // நு
+    { 0xD2, u"\u0BAA\u0BC1" },                // பு
+    { 0xD3, u"\u0BAE\u0BC1" },                // மு
+    { 0xD4, u"\u0BAF\u0BC1" },                // யு
+    { 0xD5, u"\u0BB0\u0BC1" },                // ரு
+    { 0xD6, u"\u0BB2\u0BC1" },                // லு
+    { 0xD7, u"\u0BB5\u0BC1" },                // வு
+    { 0xD8, u"\u0BB4\u0BC1" },                // ழு
+    { 0xD9, u"\u0BB3\u0BC1" },                // ளு
+    { 0xDA, u"\u0BB1\u0BC1" },                // று
+    { 0xDB, u"\u0BA9\u0BC1" },                // னு
+    { 0xDC, u"\u0B95\u0BC2" },                // கூ
+    { 0xDD, u"\u0B9A\u0BC2" },                // சூ
+    { 0xDE, u"\u0B9F\u0BC2" },                // டூ
+    { 0xDF, u"\u0BA3\u0BC2" },                // ணூ
+    { 0xE0, u"\u0BA4\u0BC2" },                // தூ
+    { 0xE1, u"\u0BA8\u0BC2" },                // நூ
+    { 0xE2, u"\u0BAA\u0BC2" },                // பூ
+    { 0xE3, u"\u0BAE\u0BC2" },                // மூ
+    { 0xE4, u"\u0BAF\u0BC2" },                // யூ
+    { 0xE5, u"\u0BB0\u0BC2" },                // ரூ
+    { 0xE6, u"\u0BB2\u0BC2" },                // லூ
+    { 0xE7, u"\u0BB5\u0BC2" },                // வூ
+    { 0xE8, u"\u0BB4\u0BC2" },                // ழூ
+    { 0xE9, u"\u0BB3\u0BC2" },                // ளூ
+    { 0xEA, u"\u0BB1\u0BC2" },                // றூ
+    { 0xEB, u"\u0BA9\u0BC2" },                // னூ
+    { 0xEC, u"\u0B95\u0BCD" },                // க்
+    { 0xED, u"\u0B99\u0BCD" },                // ங்
+    { 0xEE, u"\u0B9A\u0BCD" },                // ச்
+    { 0xEF, u"\u0B9E\u0BCD" },                // ஞ்
+    { 0xF0, u"\u0B9F\u0BCD" },                // ட்
+    { 0xF1, u"\u0BA3\u0BCD" },                // ண்
+    { 0xF2, u"\u0BA4\u0BCD" },                // த்
+    { 0xF3, u"\u0BA8\u0BCD" },                // ந்
+    { 0xF4, u"\u0BAA\u0BCD" },                // ப்
+    { 0xF5, u"\u0BAE\u0BCD" },                // ம்
+    { 0xF6, u"\u0BAF\u0BCD" },                // ய்
+    { 0xF7, u"\u0BB0\u0BCD" },                // ர்
+    { 0xF8, u"\u0BB2\u0BCD" },                // ல்
+    { 0xF9, u"\u0BB5\u0BCD" },                // வ்
+    { 0xFA, u"\u0BB4\u0BCD" },                // ழ்
+    { 0xFB, u"\u0BB3\u0BCD" },                // ள்
+    { 0xFC, u"\u0BB1\u0BCD" },                // ற்
+    { 0xFD, u"\u0BA9\u0BCD" },                // ன்
+    { 0xFE, u"\u0B87" },                      // இ
+};
+
+// ஸு ஸூ ஹு ஹூ are drawn as ஸ் / ஹ் with the ு / ூ glyph after it
+inline constexpr LegacyGlyphPair c_tsciiGlyphPairs[] =
+{
+    { 0x8A, 0xA4, u"\u0BB8\u0BC1" },          // ஸு
+    { 0x8A, 0xA5, u"\u0BB8\u0BC2" },          // ஸூ
+    { 0x8B, 0xA4, u"\u0BB9\u0BC1" },          // ஹு
+    { 0x8B, 0xA5, u"\u0BB9\u0BC2" },          // ஹூ
+};
+
+//
+// Bamini. Tamil letters sit on the ASCII letters and a few punctuation
+// bytes, at the positions of the Bamini keyboard layout - a key types its
+// glyph's byte. Shifted letters carry the கு-series glyphs. Digits, space
+// and the remaining punctuation pass through.
+//
+inline constexpr LegacyGlyph c_baminiGlyphs[] =
+{
+    { 'a',  u"\u0BAF" },             // ய
+    { 'A',  u"\u0BAF\u0BC1" },       // யு
+    { 'c',  u"\u0B89" },             // உ
+    { 'C',  u"\u0B8A" },             // ஊ
+    { 'd',  u"\u0BA9" },             // ன
+    { 'D',  u"\u0BA9\u0BC1" },       // னு
+    { 'e',  u"\u0BA8" },             // ந
+    { 'E',  u"\u0BA8\u0BC1" },       // நு
+    { 'f',  u"\u0B95" },             // க
+    { 'F',  u"\u0B95\u0BC1" },       // கு
+    { 'g',  u"\u0BAA" },             // ப
+    { 'G',  u"\u0BAA\u0BC1" },       // பு
+    { 'h',  u"\u0BBE" },             // ா
+    { 'i',  u"\u0BC8" },             // ை
+    { 'I',  u"\u0B90" },             // ஐ
+    { 'j',  u"\u0BA4" },             // த
+    { 'J',  u"\u0BA4\u0BC1" },       // து
+    { 'k',  u"\u0BAE" },             // ம
+    { 'K',  u"\u0BAE\u0BC1" },       // மு
+    { 'l',  u"\u0B9F" },             // ட
+    { 'L',  u"\u0B9F\u0BC1" },       // டு
+    { 'm',  u"\u0B85" },             // அ
+    { 'M',  u"\u0B86" },             // ஆ
+    { 'n',  u"\u0BC6" },             // ெ
+    { 'N',  u"\u0BC7" },             // ே
+    { 'o',  u"\u0BB4" },             // ழ
+    { 'O',  u"\u0BB4\u0BC1" },       // ழு
+    { 'p',  u"\u0BBF" },             // ி
+    { 'P',  u"\u0BC0" },             // ீ
+    { 'q',  u"\u0B99" },             // ங
+    { 'Q',  u"\u0B9E" },             // ஞ
+    { 'r',  u"\u0B9A" },             // ச
+    { 'R',  u"\u0B9A\u0BC1" },       // சு
+    { 's',  u"\u0BB3" },             // ள
+    { 'S',  u"\u0BB3\u0BC1" },       // ளு
+    { 't',  u"\u0BB5" },             // வ
+    { 'T',  u"\u0BB5\u0BC1" },       // வு
+    { 'u',  u"\u0BB0" },             // ர
+    { 'U',  u"\u0BB0\u0BC1" },       // ரு
+    { 'v',  u"\u0B8E" },             // எ
+    { 'V',  u"\u0B8F" },             // ஏ
+    { 'w',  u"\u0BB1" },             // ற
+    { 'W',  u"\u0BB1\u0BC1" },       // று
+    { 'x',  u"\u0B92" },             // ஒ
+    { 'X',  u"\u0B93" },             // ஓ
+    { 'y',  u"\u0BB2" },             // ல
+    { 'Y',  u"\u0BB2\u0BC1" },       // லு
+    { 'z',  u"\u0BA3" },             // ண
+    { 'Z',  u"\u0BA3\u0BC1" },       // ணு
+    { ';',  u"\u0BCD" },             // ்
+    { ',',  u"\u0B87" },             // இ
+    { '<',  u"\u0B88" },             // ஈ
+    { '/',  u"\u0B83" },             // ஃ
+    { '[',  u"\u0B9C" },             // ஜ
+    { '{',  u"\u0BC1" },             // ு
+    { ']',  u"\u0BB8" },             // ஸ
+    { '}',  u"\u0BC2" },             // ூ
+    { '\\', u"\u0BB7" },             // ஷ
+    { '`',  u"\u0BB9" },             // ஹ
+};
+
+// Units whose glyphs the encoding table indexes directly: Latin-1, then the
+// Tamil block. Glyphs starting with any other unit are found by search.
+static const size_t c_legacyIndexedUnits = 256 + 128;
+
+constexpr size_t LegacyUnitIndex(char16_t ch)
+{
+    return (ch < 0x100) ? ch
+        : (ch >= c_tamilBlockStart && ch <= c_tamilBlockEnd) ? 256 + (ch - c_tamilBlockStart)
+        : c_legacyIndexedUnits;
+}
+
+// Dense tables generated from a glyph list
+struct LegacyEncodingTable
+{
+    char16_t text[256][c_legacyGlyphMax];   // glyph text, 0-padded
+    uint8_t cch[256];                       // 0: the byte is not a glyph
+    bool fAsciiPlain;                       // no glyph below 0x80: ASCII passes through
+
+    // Glyph bytes ordered by first unit, longest text first, for the
+    // longest match when encoding. A glyph with the same text as an earlier
+    // one is left out, so text encodes to the first byte listed.
+    uint8_t encodeOrder[256];
+    size_t cEncode;
+
+    // Where each indexed unit's glyphs start in encodeOrder, and how many
+    uint8_t firstGlyph[c_legacyIndexedUnits];
+    uint8_t cGlyphs[c_legacyIndexedUnits];
+
+    // Glyph pairs, matched before single glyphs both ways
+    uint8_t pairBytes[c_legacyPairMax][2];
+    char16_t pairText[c_legacyPairMax][c_legacyGlyphMax];
+    uint8_t pairCch[c_legacyPairMax];
+    size_t cPairs;
+    bool fPairFirst[256];                   // the byte starts a pair
+};
+
+template <size_t N, size_t P>
+constexpr LegacyEncodingTable MakeLegacyEncodingTable(const LegacyGlyph (&glyphs)[N], const LegacyGlyphPair (&pairs)[P])
+{
+    static_assert(N <= 256, "one glyph per byte");
+    static_assert(P <= c_legacyPairMax, "too many glyph pairs");
+
+    LegacyEncodingTable table = {};
+    table.fAsciiPlain = true;
+
+    for (size_t i = 0; i < N; i++)
+    {
+        uint8_t b = glyphs[i].byte;
+        size_t cch = 0;
+        while (cch < c_legacyGlyphMax && glyphs[i].text[cch])
+        {
+            table.text[b][cch] = glyphs[i].text[cch];
+            cch++;
+        }
+        table.cch[b] = (uint8_t)cch;
+        if (b < 0x80)
+            table.fAsciiPlain = false;
+
+        bool fDuplicate = false;
+        for (size_t j = 0; j < i && !fDuplicate; j++)
+        {
+            uint8_t bEarlier = glyphs[j].byte;
+            fDuplicate = table.cch[bEarlier] == cch;
+            for (size_t k = 0; k < cch && fDuplicate; k++)
+                fDuplicate = table.text[bEarlier][k] == table.text[b][k];
+        }
+        if (fDuplicate)
+            continue;
+
+        // Insertion sort: first unit ascending, then longest first
+        size_t pos = table.cEncode;
+        while (pos > 0)
+        {
+            uint8_t bBefore = table.encodeOrder[pos - 1];
+            if (table.text[bBefore][0] < table.text[b][0] ||
+                (table.text[bBefore][0] == table.text[b][0] && table.cch[bBefore] >= cch))
+            {
+                break;
+            }
+            table.encodeOrder[pos] = bBefore;
+            pos--;
+        }
+        table.encodeOrder[pos] = b;
+        table.cEncode++;
+    }
+
+    for (size_t k = table.cEncode; k > 0; k--)
+    {
+        size_t index = LegacyUnitIndex(table.text[table.encodeOrder[k - 1]][0]);
+        if (index < c_legacyIndexedUnits)
+        {
+            table.firstGlyph[index] = (uint8_t)(k - 1);
+            table.cGlyphs[index]++;
+        }
+    }
+
+    for (size_t i = 0; i < P; i++)
+    {
+        if (!pairs[i].text[0])
+            continue;
+
+        size_t iPair = table.cPairs++;
+        table.pairBytes[iPair][0] = pairs[i].first;
+        table.pairBytes[iPair][1] = pairs[i].second;
+        while (table.pairCch[iPair] < c_legacyGlyphMax && pairs[i].text[table.pairCch[iPair]])
+        {
+            table.pairText[iPair][table.pairCch[iPair]] = pairs[i].text[table.pairCch[iPair]];
+            table.pairCch[iPair]++;
+        }
+        table.fPairFirst[pairs[i].first] = true;
+    }
+
+    return table;
+}
+
+template <size_t N>
+constexpr LegacyEncodingTable MakeLegacyEncodingTable(const LegacyGlyph (&glyphs)[N])
+{
+    const LegacyGlyphPair noPairs[1] = { { 0, 0, u"" } };
+    return MakeLegacyEncodingTable(glyphs, noPairs);
+}
+
+// Glyphs with more than one unit, each of which a keyboard layout built
+// from the list needs a sequence slot for
+template <size_t N>
+constexpr size_t LegacyGlyphSequenceCount(const LegacyGlyph (&glyphs)[N])
+{
+    size_t cSequences = 0;
+    for (size_t i = 0; i < N; i++)
+    {
+        if (glyphs[i].text[0] && glyphs[i].text[1])
+            cSequences++;
+    }
+    return cSequences;
+}
+
+// Key tables for a font whose glyphs sit on ASCII bytes: the US key that
+// types each byte emits its glyph's text. Multi-unit glyphs take sequence
+// slots in list order. Bytes no key types (0x80 and up) are left out.
+template <size_t N>
+constexpr KeyMapTables MakeLegacyKeyMapTables(const LegacyGlyph (&glyphs)[N])
+{
+    KeyMapTables tables = {};
+    size_t cSequences = 0;
+
+    for (size_t i = 0; i < N; i++)
+    {
+        uint8_t vk = 0;
+        KeyLayer layer = KeyLayerBase;
+        if (!UsKeyForAscii(glyphs[i].byte, &vk, &layer))
+            continue;
+
+        const char16_t* pch = glyphs[i].text;
+        if (!pch[1])
+        {
+            tables.layers[layer][vk] = pch[0];
+            continue;
+        }
+
+        if (cSequences == c_keySequenceSlots)
+            continue;
+        for (size_t j = 0; j < c_keySequenceLength - 1 && pch[j]; j++)
+            tables.sequences[cSequences][j] = pch[j];
+        tables.layers[layer][vk] = (char16_t)(c_keySequenceBase + cSequences);
+        cSequences++;
+    }
+
+    return tables;
+}
+
+// Tables for every encoding, indexed by LegacyEncodingId
+extern const LegacyEncodingTable g_legacyEncodings[LegacyEncodingCount];
@@ -0,0 +1,199 @@
+﻿// ModifierTracker.h
+// Shift / Ctrl / Alt / AltGr / Caps Lock state maintained incrementally from
+// the key events the key event sink already receives, so mapping a key
+// needs no GetKeyState calls. Left and right keys are tracked separately;
+// AltGr is the right Alt key (Windows also reports a fake left Ctrl with it).
+// Portable C++17 - Windows virtual-key values, no Windows headers
+
+#pragma once
+
+#include <cstdint>
+
+#include "KeyMap.h"
+
+enum ModifierBits : uint32_t
+{
+    ModifierShift = 0x01,
+    ModifierCtrl = 0x02,
+    ModifierAlt = 0x04,
+    ModifierAltGr = 0x08,
+    ModifierCapsLock = 0x10         // toggle state, not the key
+};
+
+// Windows virtual-key codes for the modifier keys
+static const uint8_t c_vkShift = 0x10;
+static const uint8_t c_vkControl = 0x11;
+static const uint8_t c_vkMenu = 0x12;
+static const uint8_t c_vkCapital = 0x14;
+static const uint8_t c_vkLShift = 0xA0;
+static const uint8_t c_vkRShift = 0xA1;
+static const uint8_t c_vkLControl = 0xA2;
+static const uint8_t c_vkRControl = 0xA3;
+static const uint8_t c_vkLMenu = 0xA4;
+static const uint8_t c_vkRMenu = 0xA5;
+
+// Keystroke lParam fields (WM_KEYDOWN / WM_KEYUP)
+static const uint32_t c_scanRShift = 0x36;
+static const intptr_t c_keyFlagExtended = 1 << 24;
+static const intptr_t c_keyFlagAltDown = 1 << 29;      // context code (WM_SYSKEY* only)
+static const intptr_t c_keyFlagWasDown = 1 << 30;      // previous key state (auto-repeat)
+
+class ModifierTracker
+{
+public:
+    constexpr ModifierTracker() : _keys(0), _capsLock(false), _lastDownVk(0), _lastDownLParam(0) {}
+
+    // TSF may deliver the same keystroke twice (OnTestKeyDown, then
+    // OnKeyDown); the repeat is recognized and ignored
+    constexpr void OnKeyDown(uintptr_t vk, intptr_t lParam)
+    {
+        if (vk == _lastDownVk && lParam == _lastDownLParam)
+            return;
+        _lastDownVk = vk;
+        _lastDownLParam = lParam;
+
+        _keys |= _KeyBit(vk, lParam);
+
+        // Toggle on the physical press only, not on auto-repeat
+        if (vk == c_vkCapital && !(lParam & c_keyFlagWasDown))
+            _capsLock = !_capsLock;
+
+        _CheckAlt(vk, lParam);
+    }
+
+    constexpr void OnKeyUp(uintptr_t vk, intptr_t lParam)
+    {
+        _lastDownVk = 0;
+        _keys &= ~_KeyBit(vk, lParam);
+        _CheckAlt(vk, lParam);
+    }
+
+    // Re-seeds the state, e.g. after focus returns while keys were held
+    // elsewhere. keyBits uses the ModifierKey* values below.
+    constexpr void Reset(uint32_t keyBits, bool capsLock)
+    {
+        _keys = keyBits;
+        _capsLock = capsLock;
+        _lastDownVk = 0;
+    }
+
+    constexpr uint32_t Bits() const
+    {
+        uint32_t bits = 0;
+        if (_keys & (ModifierKeyLShift | ModifierKeyRShift))
+            bits |= ModifierShift;
+        if (_keys & (ModifierKeyLCtrl | ModifierKeyRCtrl))
+            bits |= ModifierCtrl;
+        if (_keys & (ModifierKeyLAlt | ModifierKeyRAlt))
+            bits |= ModifierAlt;
+        if (_keys & ModifierKeyRAlt)
+            bits |= ModifierAltGr;
+        if (_capsLock)
+            bits |= ModifierCapsLock;
+        return bits;
+    }
+
+    // Layer for character keys. False for Ctrl or Alt shortcuts, which are
+    // left to the application. Ctrl+Alt is treated as AltGr, as Windows does.
+    constexpr bool Layer(KeyLayer* pLayer) const
+    {
+        uint32_t bits = Bits();
+        bool ctrlAlt = (bits & ModifierCtrl) && (bits & ModifierAlt);
+
+        if ((bits & ModifierAltGr) || ctrlAlt)
+        {
+            *pLayer = KeyLayerAltGr;
+            return true;
+        }
+        if (bits & (ModifierCtrl | ModifierAlt))
+            return false;
+
+        *pLayer = (bits & ModifierShift) ? KeyLayerShift : KeyLayerBase;
+        return true;
+    }
+
+    // Physical keys
+    enum : uint32_t
+    {
+        ModifierKeyLShift = 0x01,
+        ModifierKeyRShift = 0x02,
+        ModifierKeyLCtrl = 0x04,
+        ModifierKeyRCtrl = 0x08,
+        ModifierKeyLAlt = 0x10,
+        ModifierKeyRAlt = 0x20
+    };
+
+private:
+    // Generic VK_SHIFT / VK_CONTROL / VK_MENU are told apart by scan code
+    // (right Shift) or the extended-key flag (right Ctrl and Alt)
+    static constexpr uint32_t _KeyBit(uintptr_t vk, intptr_t lParam)
+    {
+        bool extended = (lParam & c_keyFlagExtended) != 0;
+
+        switch (vk)
+        {
+        case c_vkShift:
+            return (((lParam >> 16) & 0xFF) == (intptr_t)c_scanRShift) ? ModifierKeyRShift : ModifierKeyLShift;
+        case c_vkControl:
+            return extended ? ModifierKeyRCtrl : ModifierKeyLCtrl;
+        case c_vkMenu:
+            return extended ? ModifierKeyRAlt : ModifierKeyLAlt;
+        case c_vkLShift:    return ModifierKeyLShift;
+        case c_vkRShift:    return ModifierKeyRShift;
+        case c_vkLControl:  return ModifierKeyLCtrl;
+        case c_vkRControl:  return ModifierKeyRCtrl;
+        case c_vkLMenu:     return ModifierKeyLAlt;
+        case c_vkRMenu:     return ModifierKeyRAlt;
+        default:            return 0;
+        }
+    }
+
+    // A keystroke with the context code set (WM_SYSKEYDOWN and friends) is
+    // proof that Alt is held, which repairs a missed Alt press. The flag is
+    // always clear on WM_KEYDOWN, including AltGr combinations, so its
+    // absence proves nothing.
+    constexpr void _CheckAlt(uintptr_t vk, intptr_t lParam)
+    {
+        if (vk == c_vkMenu || vk == c_vkLMenu || vk == c_vkRMenu)
+            return;
+
+        if ((lParam & c_keyFlagAltDown) && !(_keys & (ModifierKeyLAlt | ModifierKeyRAlt)))
+            _keys |= ModifierKeyLAlt;
+    }
+
+    uint32_t _keys;
+    bool _capsLock;
+    uintptr_t _lastDownVk;          // last key-down event, 0 after a key up
+    intptr_t _lastDownLParam;
+};
+
+// Compile-time checks of the tracker
+constexpr uint32_t ModifierBitsAfter(const uintptr_t (&vks)[4], const intptr_t (&lParams)[4], const bool (&down)[4])
+{
+    ModifierTracker tracker;
+    for (int i = 0; i < 4; i++)
+    {
+        if (!vks[i])
+            continue;
+        if (down[i])
+            tracker.OnKeyDown(vks[i], lParams[i]);
+        else
+            tracker.OnKeyUp(vks[i], lParams[i]);
+    }
+    return tracker.Bits();
+}
+
+// Left Shift down, 'A' down: Shift
+static_assert(ModifierBitsAfter({ c_vkShift, 'A', 0, 0 }, { 0x2A << 16, 0x1E << 16, 0, 0 }, { true, true }) == ModifierShift, "left shift");
+// Right Shift down and up: nothing
+static_assert(ModifierBitsAfter({ c_vkShift, c_vkShift, 0, 0 }, { c_scanRShift << 16, c_scanRShift << 16, 0, 0 }, { true, false }) == 0, "right shift released");
+// Both Shifts down, left released: still Shift
+static_assert(ModifierBitsAfter({ c_vkShift, c_vkShift, c_vkShift, 0 }, { 0x2A << 16, c_scanRShift << 16, 0x2A << 16, 0 }, { true, true, false }) == ModifierShift, "one shift still held");
+// AltGr: fake left Ctrl plus extended (right) Alt
+static_assert(ModifierBitsAfter({ c_vkControl, c_vkMenu, 0, 0 }, { 0x1D << 16, (0x38 << 16) | c_keyFlagExtended, 0, 0 }, { true, true }) == (ModifierCtrl | ModifierAlt | ModifierAltGr), "altgr");
+// Caps Lock press with auto-repeat toggles once
+static_assert(ModifierBitsAfter({ c_vkCapital, c_vkCapital, c_vkCapital, 0 }, { 0x3A << 16, (0x3A << 16) | c_keyFlagWasDown, 0x3A << 16, 0 }, { true, true, false }) == ModifierCapsLock, "caps lock");
+// The same Caps Lock event seen by OnTestKeyDown and OnKeyDown toggles once
+static_assert(ModifierBitsAfter({ c_vkCapital, c_vkCapital, 0, 0 }, { 0x3A << 16, 0x3A << 16, 0, 0 }, { true, true }) == ModifierCapsLock, "duplicate delivery");
+// A WM_SYSKEYDOWN for a letter proves Alt is held
+static_assert(ModifierBitsAfter({ 'F', 0, 0, 0 }, { c_keyFlagAltDown, 0, 0, 0 }, { true }) == ModifierAlt, "alt from context code");
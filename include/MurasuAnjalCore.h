@@ -1,7 +1,9 @@
 ﻿// MurasuAnjalCore.h
 // Minimal TSF-based Input Method Editor for Tamil keyboards
 // Starting with Tamil99 layout, extensible for other layouts
-// No external dependencies, files, network, or registry access beyond IME registration
+// No external dependencies or network access. Beyond IME registration it reads
+// only the optional diagnostics values under HKCU\Software\Murasu\AnjalCore,
+// and writes a file only when tracing is turned on there (%TEMP%\AnjalCore-<pid>.trace)
 
 #pragma once
 
@@ -10,28 +12,64 @@
 #include <msctf.h>
 #include <olectl.h>
 #include <string>
+#include "KeyboardEngine.h"
+#include "PendingOutput.h"
+#include "KeyDecisionCache.h"
+#include "ModifierTracker.h"
+#include "CompositionBuffer.h"
+#include "SurroundingText.h"
+#include "DocumentMap.h"
+#include "Completion.h"
+#include "CandidateWorker.h"
+#include "WarmCache.h"
 
 // CLSID for the Text Input Processor
 // {F7123523-AA20-43CB-8BE3-8AA74E8584F9}
 static const GUID c_clsidTextService =
 { 0xF7123523, 0xAA20, 0x43CB, { 0x8B, 0xE3, 0x8A, 0xA7, 0x4E, 0x85, 0x84, 0xF9 } };
 
-// Profile GUID
-// {B243DC17-B1C8-496A-B00B-5EB8C3EE4B6F}
+// Profile GUIDs - one TSF language profile per layout
+// {B243DC17-B1C8-496A-B00B-5EB8C3EE4B6F} - Tamil99
 static const GUID c_guidProfile =
 { 0xB243DC17, 0xB1C8, 0x496A, { 0xB0, 0x0B, 0x5E, 0xB8, 0xC3, 0xEE, 0x4B, 0x6F } };
 
+// {D01C04B1-3617-4A98-88FA-67D16156DD7B} - Anjal phonetic
+static const GUID c_guidProfileAnjal =
+{ 0xD01C04B1, 0x3617, 0x4A98, { 0x88, 0xFA, 0x67, 0xD1, 0x61, 0x56, 0xDD, 0x7B } };
+
+// {E9B68836-9B90-4523-A375-AA9049B97DF2} - Typewriter
+static const GUID c_guidProfileTypewriter =
+{ 0xE9B68836, 0x9B90, 0x4523, { 0xA3, 0x75, 0xAA, 0x90, 0x49, 0xB9, 0x7D, 0xF2 } };
+
+// {0B382A8D-43AD-43F5-B749-EF09505F5EAC} - Bamini
+static const GUID c_guidProfileBamini =
+{ 0x0B382A8D, 0x43AD, 0x43F5, { 0xB7, 0x49, 0xEF, 0x09, 0x50, 0x5F, 0x5E, 0xAC } };
+
+// Indexed by LayoutId (see LayoutRegistry.h)
+static const GUID* const c_layoutProfiles[LayoutCount] =
+{
+    &c_guidProfile,
+    &c_guidProfileAnjal,
+    &c_guidProfileTypewriter,
+    &c_guidProfileBamini,
+};
+
 // Language - Tamil
 static const LANGID c_langid = MAKELANGID(LANG_TAMIL, SUBLANG_DEFAULT);
 
 // Description
-#define TEXTSERVICE_DESC    L"Murasu Anjal Core - Tamil99"
+#define TEXTSERVICE_DESC    L"Murasu Anjal Core"
 #define TEXTSERVICE_MODEL   L"Apartment"
 
 // Forward declarations
 class CMurasuAnjalTextService;
+class CEditSession;
 
-// Class Factory
+// Edit sessions kept per text service: one per pending batch in flight.
+// Requests beyond this fall back to the heap.
+static const size_t c_editSessionPoolSize = c_pendingBatchCount;
+
+// Class Factory - a single static instance; its references lock the DLL
 class CClassFactory : public IClassFactory
 {
 public:
@@ -43,18 +81,16 @@ public:
     // IClassFactory
     STDMETHODIMP CreateInstance(IUnknown* pUnkOuter, REFIID riid, void** ppvObj);
     STDMETHODIMP LockServer(BOOL fLock);
-
-    CClassFactory() : _refCount(1) {}
-
-private:
-    long _refCount;
 };
 
 // Murasu Anjal Text Service - Main IME implementation
 class CMurasuAnjalTextService : public ITfTextInputProcessor,
     public ITfTextInputProcessorEx,
     public ITfThreadMgrEventSink,
-    public ITfKeyEventSink
+    public ITfKeyEventSink,
+    public ITfActiveLanguageProfileNotifySink,
+    public ITfCompositionSink,
+    public ITfTextEditSink
 {
 public:
     CMurasuAnjalTextService();
@@ -87,23 +123,109 @@ public:
     STDMETHODIMP OnKeyUp(ITfContext* pContext, WPARAM wParam, LPARAM lParam, BOOL* pfEaten);
     STDMETHODIMP OnPreservedKey(ITfContext* pContext, REFGUID rguid, BOOL* pfEaten);
 
+    // ITfActiveLanguageProfileNotifySink
+    STDMETHODIMP OnActivated(REFCLSID clsid, REFGUID guidProfile, BOOL fActivated);
+
+    // ITfCompositionSink
+    STDMETHODIMP OnCompositionTerminated(TfEditCookie ecWrite, ITfComposition* pComposition);
+
+    // ITfTextEditSink
+    STDMETHODIMP OnEndEdit(ITfContext* pContext, TfEditCookie ecReadOnly, ITfEditRecord* pEditRecord);
+
     // Helper methods
     BOOL _InitThreadMgrEventSink();
     void _UninitThreadMgrEventSink();
     BOOL _InitKeyEventSink();
     void _UninitKeyEventSink();
-    HRESULT _InsertTextAtSelection(ITfContext* pContext, const WCHAR* pchText, ULONG cchText);
+    BOOL _InitProfileNotifySink();
+    void _UninitProfileNotifySink();
+    BOOL _InitTextEditSink(ITfDocumentMgr* pDocMgr);
+    void _UninitTextEditSink();
+    void _ResetTextEditSink();
+    void _RequestSurroundingText();
+    void _OnSurroundingText(ITfContext* pContext, const WCHAR* pchText, ULONG cchText, BOOL fAtStart);
+    BOOL _RestoreDocumentState();
+    void _SelectLayoutFromActiveProfile();
+    void _InitEngine();
+    BOOL _InitCandidateWorker();
+    void _UninitCandidateWorker();
+    static CMurasuAnjalTextService* _Reattach();
+    void _Park();
+    size_t _WarmSize() const;
+    static void _ReleaseWarm(const WarmCache<CMurasuAnjalTextService>::Released& released);
+    void _OnCandidatesReady();
+    static void _PostCandidatesReady(void* pv);
+    static LRESULT CALLBACK _CandidateWndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
+    HRESULT _InsertTextAtSelection(ITfContext* pContext, const WCHAR* pchText, ULONG cchText, ULONG cchDelete,
+        ULONG cchComposing, ULONGLONG keyDownNs);
+    HRESULT _SetTextAtSelection(TfEditCookie ec, ITfContext* pContext, const WCHAR* pchText, ULONG cchText, ULONG cchDelete);
+    HRESULT _UpdateComposition(TfEditCookie ec, ITfContext* pContext, const PendingBatch& batch);
+    void _CommitComposition();
+    void _TrackComposing(ITfContext* pContext, ULONG cchComposing);
     wchar_t _MapKeyToTamil(WPARAM wParam);
+    void _SyncModifiers();
+    const KeyDecision& _DecideKey(ITfContext* pContext, WPARAM wParam, LPARAM lParam);
+    static const LayoutDescriptor* _FindLayout(REFGUID guidProfile);
+    static BOOL _IsModifierKey(WPARAM wParam);
+    void _LogKeyDetails(WPARAM wParam, LPARAM lParam);    // verbose builds only
+    static BOOL _StartTrace();
+    CEditSession* _AcquireEditSession();
+    void _ReturnEditSession(CEditSession* pEditSession);
 
 private:
     long _refCount;
     TfClientId _tfClientId;
     ITfThreadMgr* _pThreadMgr;
     DWORD _dwThreadMgrEventSinkCookie;
+    DWORD _dwProfileNotifySinkCookie;
+    ITfContext* _pTextEditSinkContext;  // top context of the focused document
+    DWORD _dwTextEditSinkCookie;
     BOOL _isKeyboardEnabled;
-
-    // Simple Tamil99 mapping - embedded in code, no external files
-    static const wchar_t* GetTamilChar(char key);
+    BOOL _isTracing;                    // holds a TraceStart reference
+    BOOL _isEngineReady;                // layout chosen and modifiers synced since Activate
+    BOOL _isReattached;                 // back from the warm cache, not yet activated
+
+    // Active layout and its composition state - fixed size, no per-key allocation
+    KeyboardEngine _engine;
+
+    // Shift / Ctrl / Alt / AltGr / Caps Lock, fed by the key event sink
+    ModifierTracker _modifiers;
+
+    // Decision made in OnTestKeyDown for the following OnKeyDown
+    KeyDecisionCache _keyDecision;
+
+    // Output waiting for its edit session; CEditSession drains it
+    PendingOutputQueue _pendingOutput;
+    friend class CEditSession;
+
+    // Open syllable. _composition mirrors the composition range as edit
+    // sessions leave it; _cchComposingQueued and _pComposingContext describe
+    // it as of the last queued key, ahead of the sessions.
+    ITfComposition* _pComposition;
+    CompositionBuffer _composition;
+    ITfContext* _pComposingContext;
+    ULONG _cchComposingQueued;
+
+    // Text before the caret of _pTextEditSinkContext, read once per focus change
+    SurroundingText _surroundingText;
+
+    // Engine state of every document this thread has seen, and the focused
+    // one - identities only, no references held
+    DocumentMap _documents;
+    ITfDocumentMgr* _pFocusDocumentMgr;
+
+    // Word being typed and its dictionary completions
+    WordCompletion _completion;
+
+    // Ranks completions off the key path; results come back as a message
+    // to _hwndCandidates, a message-only window on this thread
+    CandidateWorker _candidateWorker;
+    HWND _hwndCandidates;
+    BOOL _isCandidateWorkerFailed;      // not retried until the next activation
+
+    // Edit session pool - allocated once, then recycled through the free list
+    CEditSession* _pEditSessionBlock;
+    CEditSession* _pFreeEditSession;
 };
 
 // DLL exports
@@ -113,6 +235,12 @@ extern "C" STDAPI DllGetClassObject(REFCLSID rclsid, REFIID riid, LPVOID* ppv);
 extern "C" STDAPI DllRegisterServer(void);
 extern "C" STDAPI DllUnregisterServer(void);
 
+// Converts text as if typed key by key in the given layout (a LayoutId);
+// see Transliterator.h. With pchOut NULL, *pcchOut receives the buffer
+// length needed; HRESULT_FROM_WIN32(ERROR_INSUFFICIENT_BUFFER) does the same.
+extern "C" STDAPI AnjalTransliterate(const char16_t* pchIn, size_t cchIn, UINT layout,
+    char16_t* pchOut, size_t cchOutMax, size_t* pcchOut);
+
 // Globals
 extern HINSTANCE g_hInst;
 extern LONG g_cRefDll;
@@ -0,0 +1,140 @@
+﻿// PendingOutput.h
+// Queue of engine output waiting for an edit session. Consecutive keys for
+// the same context are merged into the newest batch as long as its session
+// has not started, so a burst of keys costs one RequestEditSession, one
+// SetText and one SetSelection. Batches are applied strictly in order:
+// TSF runs asynchronous edit sessions in request order and each batch has
+// exactly one session.
+// Portable C++17 - no Windows headers, no allocation
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+static const size_t c_pendingBatchText = 128;
+static const size_t c_pendingBatchCount = 8;       // power of two
+
+struct PendingBatch
+{
+    uint32_t serial;            // identifies the session that applies it
+    bool open;                  // still accepting merges (session not started)
+    const void* pContext;       // identity only - the session holds the reference
+    uint64_t keyDownNs;         // first key merged in, for latency stats
+    uint32_t keyCount;
+    uint32_t cchDelete;         // code units before the caret to replace
+    uint32_t cchText;
+    uint32_t cchComposing;      // trailing units still open after the last key (see CompositionBuffer)
+    char16_t text[c_pendingBatchText];
+};
+
+enum PendingAppendResult
+{
+    PendingMerged,              // joined a batch that already has a session
+    PendingNewBatch,            // started a batch - request a session for it
+    PendingFull                 // queue full, nothing recorded
+};
+
+class PendingOutputQueue
+{
+public:
+    PendingOutputQueue() : _head(0), _count(0), _nextSerial(1) {}
+
+    // Adds one (delete, insert) step and the composing length after it. On
+    // PendingNewBatch *pSerial is the serial the new session must pass to Take().
+    PendingAppendResult Append(const void* pContext, size_t cchDelete, const char16_t* pch, size_t cch,
+        size_t cchComposing, uint64_t keyDownNs, uint32_t* pSerial)
+    {
+        if (_count > 0)
+        {
+            PendingBatch& tail = _At(_count - 1);
+            if (tail.open && tail.pContext == pContext && _Fits(tail, cchDelete, cch))
+            {
+                _Merge(tail, cchDelete, pch, cch);
+                tail.cchComposing = (uint32_t)cchComposing;
+                tail.keyCount++;
+                return PendingMerged;
+            }
+        }
+
+        if (_count == c_pendingBatchCount || cch > c_pendingBatchText)
+            return PendingFull;
+
+        PendingBatch& batch = _At(_count++);
+        batch.serial = _nextSerial++;
+        batch.open = true;
+        batch.pContext = pContext;
+        batch.keyDownNs = keyDownNs;
+        batch.keyCount = 1;
+        batch.cchDelete = 0;
+        batch.cchText = 0;
+        batch.cchComposing = (uint32_t)cchComposing;
+        _Merge(batch, cchDelete, pch, cch);
+
+        *pSerial = batch.serial;
+        return PendingNewBatch;
+    }
+
+    // Called by the session at the start of DoEditSession. Closes the batch
+    // to further merges and returns it, or NULL if it is gone. Older batches
+    // whose sessions never ran are discarded.
+    PendingBatch* Take(uint32_t serial)
+    {
+        while (_count > 0 && (int32_t)(_At(0).serial - serial) < 0)
+            _PopFront();
+
+        if (_count == 0 || _At(0).serial != serial)
+            return nullptr;
+
+        PendingBatch& batch = _At(0);
+        batch.open = false;
+        return &batch;
+    }
+
+    // Called when the session has applied the batch returned by Take
+    void Complete(uint32_t serial)
+    {
+        if (_count > 0 && _At(0).serial == serial)
+            _PopFront();
+    }
+
+    // Drops a batch whose session could not be requested
+    void Discard(uint32_t serial)
+    {
+        if (_count > 0 && _At(_count - 1).serial == serial)
+            _count--;
+    }
+
+    size_t Count() const { return _count; }
+
+private:
+    PendingBatch& _At(size_t i) { return _batches[(_head + i) & (c_pendingBatchCount - 1)]; }
+
+    void _PopFront()
+    {
+        _head = (_head + 1) & (c_pendingBatchCount - 1);
+        _count--;
+    }
+
+    static bool _Fits(const PendingBatch& batch, size_t cchDelete, size_t cch)
+    {
+        size_t cchKept = (cchDelete < batch.cchText) ? batch.cchText - cchDelete : 0;
+        return cchKept + cch <= c_pendingBatchText;
+    }
+
+    // Deletions first consume text queued earlier, then reach into the document
+    static void _Merge(PendingBatch& batch, size_t cchDelete, const char16_t* pch, size_t cch)
+    {
+        size_t cchFromText = (cchDelete < batch.cchText) ? cchDelete : batch.cchText;
+        batch.cchText -= (uint32_t)cchFromText;
+        batch.cchDelete += (uint32_t)(cchDelete - cchFromText);
+
+        for (size_t i = 0; i < cch; i++)
+            batch.text[batch.cchText++] = pch[i];
+    }
+
+    PendingBatch _batches[c_pendingBatchCount];
+    size_t _head;
+    size_t _count;
+    uint32_t _nextSerial;
+};
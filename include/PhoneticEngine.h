@@ -0,0 +1,76 @@
+﻿// PhoneticEngine.h
+// Anjal phonetic (romanized) composition engine. Typed Latin letters are
+// matched against a compile-time double-array trie of romanized tokens
+// ("k", "th", "nth", "aa", "zh" ...) using longest match. The current token
+// is shown tentatively and re-rendered as it grows; consonants carry a pulli
+// until a vowel turns them into uyirmei (k -> க், ka -> க, kaa -> கா).
+// Portable C++17 - no Windows headers, no allocation
+
+#pragma once
+
+#include "EngineOutput.h"
+#include "TamilScript.h"
+
+enum PhoneticTokenKind : uint8_t
+{
+    PhoneticConsonant,      // text is a consonant or cluster, shown with pulli
+    PhoneticVowel,          // index into c_tamilVowels
+    PhoneticSymbol          // text inserted as-is
+};
+
+struct PhoneticToken
+{
+    const char* roman;
+    PhoneticTokenKind kind;
+    uint8_t vowel;
+    char16_t text[4];
+};
+
+// Longest romanized token
+static const size_t c_phoneticMaxToken = 4;
+
+class PhoneticEngine
+{
+public:
+    PhoneticEngine() { Reset(); }
+
+    // Same contract as Tamil99Engine::ProcessKey; the key text is the Latin
+    // letter produced by the phonetic key tables
+    bool ProcessKey(const char16_t* pchKey, size_t cchKey, EngineOutput* pOutput);
+
+    // The token on screen may still be replaced as it grows, and a pulli
+    // may still be replaced by a vowel sign
+    size_t ComposingLength() const
+    {
+        return _rendered ? _cchRendered : (_afterConsonant ? 1 : 0);
+    }
+
+    void Reset();
+
+    // Continues from the text before the caret: a consonant with pulli takes
+    // the next vowel as its sign, and a word start is recognized
+    void Resume(const char16_t* pchBefore, size_t cchBefore);
+
+    // The token table, for converters that run the scheme backwards
+    // (see Romanizer.h)
+    static const PhoneticToken* Tokens(size_t* pcTokens);
+
+    // Length of the token typing pch[0..cch) would take first - the longest
+    // one the letters start with - or 0 if they start none
+    static size_t LongestToken(const char* pch, size_t cch);
+
+private:
+    void _Feed(char ch, EngineOutput* pOutput);
+    void _RenderToken(const PhoneticToken& token, EngineOutput* pOutput);
+    void _CommitToken();
+
+    int16_t _state;                         // trie state, 0 = between tokens
+    uint8_t _cchPending;                    // letters consumed by the current token path
+    uint8_t _cchAccepted;                   // length of the longest complete token in it
+    uint8_t _token;                         // that token's index + 1
+    uint8_t _cchRendered;                   // code units currently shown for the token
+    bool _rendered;
+    bool _afterConsonant;                   // previous token left a consonant with pulli
+    bool _atWordStart;
+    char _pending[c_phoneticMaxToken];
+};
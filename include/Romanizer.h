@@ -0,0 +1,122 @@
+﻿// Romanizer.h
+// Tamil text back to Anjal romanization - the letters a user would type on
+// the Anjal layout to get it - for search indexing. It runs the phonetic
+// engine's token table the other way: each uyirmei in the syllable matrix
+// splits back into its consonant and vowel, a consonant with pulli is the
+// consonant alone, and the consonant clusters the scheme has tokens for
+// (ந்த nth, ன்ற ndr, ண்ட nd ...) come back as those tokens. A word-initial
+// ந is n, as the engine types it. Everything that is not a Tamil letter is
+// kept as it is and starts a new word.
+//
+// Letters typed in a row can join into a longer token (ட் then ஹ is "th",
+// which is த), so a consonant with pulli is written with the first of its
+// tokens that the next letters do not extend, and a cluster falls back to
+// its letters. Text typed on the Anjal layout comes back to itself through
+// Transliterator; text that layout cannot type (a vowel letter inside a
+// word, a word-initial ன, ன்த, ன்ஜ) is romanized as closely as it can be.
+// Decomposed vowel signs (ெ + ா, ெ + ௗ) read as their composed forms.
+//
+// Streaming, with the contract of TransliteratorStream: UTF-8 in at any
+// split, UTF-8 out into the caller's buffer. Only the open syllable and
+// the consonants with pulli before it are held back, in fixed buffers
+// inside the object. The tables are built once, in the constructor.
+// Portable C++17 - no Windows headers, no allocation
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "PhoneticEngine.h"
+#include "TransliteratorStream.h"
+
+// Consonants with pulli held back before the open syllable; a longer run is
+// written out as it goes
+static const size_t c_romanChainMax = 8;
+
+// Tokens that write one consonant or cluster, and the clusters
+static const size_t c_romanCandidatesMax = 4;
+static const size_t c_romanClustersMax = 8;
+
+// Romanized letters of one held syllable at most: a cluster split into two
+// tokens and a vowel
+static const size_t c_romanSyllableMax = 3 * c_phoneticMaxToken;
+
+class Romanizer
+{
+public:
+    Romanizer();
+
+    // Takes UTF-8 from pbIn[0..cbIn) and writes the romanized text that is
+    // final to pbOut[0..cbOutMax). Returns StreamOutputNeeded when pbOut
+    // filled up first: *pcbRead bytes were taken, so call again with the
+    // rest. Malformed UTF-8 becomes U+FFFD. cbOutMax of 4 or more always
+    // makes progress.
+    StreamResult Feed(const char* pbIn, size_t cbIn, size_t* pcbRead, char* pbOut, size_t cbOutMax, size_t* pcbWritten);
+
+    // End of the text: writes what is held. StreamOutputNeeded means call
+    // again with more room; on StreamDone the romanizer is reset for the
+    // next text.
+    StreamResult Finish(char* pbOut, size_t cbOutMax, size_t* pcbWritten);
+
+    // Drops everything held and starts a new text
+    void Reset();
+
+private:
+    // A held syllable: a consonant or cluster (unit) and what follows it
+    struct Syllable
+    {
+        uint8_t unit;           // consonant index, c_tamilConsonantCount + cluster, or a c_romanUnit* value
+        uint8_t ending;         // vowel index (0 = inherent அ), or c_romanPulli
+    };
+
+    // Tokens for one consonant or cluster, most preferred first
+    struct Candidates
+    {
+        const char* roman[c_romanCandidatesMax];
+        uint8_t count;
+    };
+
+    // Precomputed letters for a syllable that ends in a vowel
+    struct RomanText
+    {
+        char text[c_romanSyllableMax];
+        uint8_t cch;
+    };
+
+    struct Cluster
+    {
+        char16_t text[3];       // consonant, pulli, consonant
+        uint8_t first;          // consonant indices, for falling back to letters
+        uint8_t second;
+        const char* roman;
+    };
+
+    bool _Write(char* pbOut, size_t cbOutMax, size_t* pcbWritten);
+    void _Step(uint32_t cp);
+    void _Flush(size_t cSyllables);
+    size_t _Romanize(const Syllable& syllable, bool fWordStart, const char* pchRight, size_t cchRight, char* pchOut) const;
+    size_t _Unit(uint8_t unit, bool fWordStart, const char* pchRight, size_t cchRight, char* pchOut) const;
+    size_t _Consonant(uint8_t consonant, bool fWordStart, const char* pchRight, size_t cchRight, char* pchOut) const;
+    void _Append(uint32_t cp);
+
+    // Tables. _syllableRoman is the syllable matrix the other way round,
+    // with a row per cluster after the consonants.
+    const char* _vowelRoman[c_tamilVowelCount];
+    const char* _aythamRoman;
+    Candidates _consonants[2][c_tamilConsonantCount];   // [word start][consonant]
+    Cluster _clusters[c_romanClustersMax];
+    size_t _cClusters;
+    RomanText _syllableRoman[2][c_tamilConsonantCount + c_romanClustersMax][c_tamilVowelCount];
+
+    // Held text
+    Syllable _syllables[c_romanChainMax];
+    size_t _cSyllables;
+    bool _fWordStart;                       // the first held syllable starts a word
+    uint8_t _cbSequence;                    // bytes of a UTF-8 sequence taken so far
+    uint8_t _cbSequenceNeeded;              // its full length
+    uint32_t _cpSequence;                   // its bits so far
+    size_t _cbHeld;                         // final romanized bytes not yet written
+    size_t _ibWritten;
+    char _held[c_romanChainMax * c_romanSyllableMax + 4];
+};
@@ -0,0 +1,66 @@
+﻿// SpscQueue.h
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Push and Pop never block and never allocate; each side keeps a
+// private copy of the other side's index and reloads it only when the
+// queue looks full (or empty), so the common case touches no shared line
+// but its own.
+// Portable C++17
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+template <typename T, size_t N>
+class SpscQueue
+{
+    static_assert(N > 0 && (N & (N - 1)) == 0, "queue size must be a power of two");
+
+public:
+    SpscQueue() : _head(0), _tailCache(0), _tail(0), _headCache(0) {}
+
+    // Producer only. False when the queue is full.
+    bool Push(const T& item)
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tailCache >= N)
+        {
+            _tailCache = _tail.load(std::memory_order_acquire);
+            if (head - _tailCache >= N)
+                return false;
+        }
+
+        _items[head & (N - 1)] = item;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. False when the queue is empty.
+    bool Pop(T* pItem)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _headCache)
+        {
+            _headCache = _head.load(std::memory_order_acquire);
+            if (tail == _headCache)
+                return false;
+        }
+
+        *pItem = _items[tail & (N - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only
+    bool IsEmpty() const
+    {
+        return _tail.load(std::memory_order_relaxed) == _head.load(std::memory_order_acquire);
+    }
+
+private:
+    alignas(64) std::atomic<size_t> _head;      // written by the producer
+    size_t _tailCache;                          // producer's view of _tail
+    alignas(64) std::atomic<size_t> _tail;      // written by the consumer
+    size_t _headCache;                          // consumer's view of _head
+    alignas(64) T _items[N];
+};
@@ -0,0 +1,115 @@
+﻿// SurroundingText.h
+// The last few code units before the caret in one context. Filled by one
+// document read after a focus change, then kept current from our own edits,
+// so typing never reads the document. Edits made by anyone else invalidate it.
+// Portable C++17 - no Windows headers, no allocation
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Enough for the longest syllable the engines look back at (க்ஷ + sign)
+static const size_t c_surroundingTextMax = 16;
+
+class SurroundingText
+{
+public:
+    SurroundingText() { Invalidate(); }
+
+    // Text before the caret as read from the document. fAtStart is true
+    // when the document has nothing further back.
+    void Fill(const void* pContext, const char16_t* pch, size_t cch, bool fAtStart)
+    {
+        if (cch > c_surroundingTextMax)
+        {
+            pch += cch - c_surroundingTextMax;
+            cch = c_surroundingTextMax;
+            fAtStart = false;
+        }
+
+        for (size_t i = 0; i < cch; i++)
+            _text[i] = pch[i];
+        _cch = cch;
+        _fAtStart = fAtStart;
+        _pContext = pContext;
+        _cOwnEdits = 0;
+    }
+
+    // Our own edit session replaced cchDelete units before the caret with
+    // pch[0..cch) and left the caret after it. Expects the matching OnEndEdit
+    // when pContext is the window's context; edits elsewhere are not counted,
+    // their OnEndEdit never reaches this window.
+    void Apply(const void* pContext, size_t cchDelete, const char16_t* pch, size_t cch)
+    {
+        if (pContext != _pContext)
+            return;
+        _cOwnEdits++;
+
+        if (cchDelete > _cch)
+        {
+            // Deleted past the window: what lies before it is unknown
+            _cch = 0;
+            _fAtStart = false;
+        }
+        else
+        {
+            _cch -= cchDelete;
+        }
+
+        if (cch >= c_surroundingTextMax)
+        {
+            pch += cch - c_surroundingTextMax;
+            cch = c_surroundingTextMax;
+            _cch = 0;
+            _fAtStart = false;
+        }
+        else if (_cch + cch > c_surroundingTextMax)
+        {
+            size_t cchDrop = _cch + cch - c_surroundingTextMax;
+            for (size_t i = cchDrop; i < _cch; i++)
+                _text[i - cchDrop] = _text[i];
+            _cch -= cchDrop;
+            _fAtStart = false;
+        }
+
+        for (size_t i = 0; i < cch; i++)
+            _text[_cch++] = pch[i];
+    }
+
+    // ITfTextEditSink::OnEndEdit for pContext: our own edits are already
+    // applied, anything else on the window's context invalidates it
+    void OnEndEdit(const void* pContext)
+    {
+        if (pContext != _pContext)
+            return;
+
+        if (_cOwnEdits > 0)
+            _cOwnEdits--;
+        else
+            Invalidate();
+    }
+
+    void Invalidate()
+    {
+        _pContext = nullptr;
+        _cch = 0;
+        _fAtStart = false;
+        _cOwnEdits = 0;
+    }
+
+    bool IsValid(const void* pContext) const { return _pContext != nullptr && _pContext == pContext; }
+    const void* Context() const { return _pContext; }
+
+    // The window, oldest first; the caret is after the last unit
+    const char16_t* Text() const { return _text; }
+    size_t Length() const { return _cch; }
+    bool AtStart() const { return _fAtStart; }
+
+private:
+    const void* _pContext;      // identity only; nullptr when invalid
+    size_t _cch;
+    bool _fAtStart;
+    uint32_t _cOwnEdits;        // our sessions whose OnEndEdit is still to come
+    char16_t _text[c_surroundingTextMax];
+};
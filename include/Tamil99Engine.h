@@ -0,0 +1,68 @@
+﻿// Tamil99Engine.h
+// Tamil99 composition engine - TSF independent finite-state machine that
+// applies the Tamil99 typing rules to the code points produced by the
+// Tamil99 key tables.
+// Portable C++17 - no Windows headers, no allocation
+
+#pragma once
+
+#include "EngineOutput.h"
+#include "TamilScript.h"
+
+//
+// Rules implemented (Tamil Nadu Government Tamil99 standard):
+//   1. Consonant + vowel       -> uyirmei (vowel sign from the syllable matrix)
+//   2. Consonant + அ           -> consonant unchanged (inherent vowel)
+//   3. Same consonant twice    -> automatic pulli on the first (க + க -> க்க)
+//   4. Soft + hard pair        -> automatic pulli on the soft consonant
+//                                 (ங்க ஞ்ச ண்ட ந்த ம்ப ன்ற)
+//   5. After an automatic pulli the next consonant starts a new cluster,
+//      so a third repetition is not doubled again (க்கக)
+//
+class Tamil99Engine
+{
+public:
+    Tamil99Engine() { Reset(); }
+
+    // Feeds the text mapped to one key. Writes what should be inserted at the
+    // caret to pOutput and returns true when the key was consumed
+    // (pOutput may be empty, e.g. அ after a consonant).
+    bool ProcessKey(const char16_t* pchKey, size_t cchKey, EngineOutput* pOutput);
+
+    // Trailing code units of the emitted text that belong to the open
+    // syllable; 0 at a syllable boundary. A consonant stays open until its
+    // vowel sign (or the next syllable) arrives.
+    size_t ComposingLength() const
+    {
+        return (_state != StateIdle) ? 1 : 0;
+    }
+
+    // Continues from the text already before the caret (see SurroundingText):
+    // a vowel typed after a consonant in the document becomes its sign
+    void Resume(const char16_t* pchBefore, size_t cchBefore)
+    {
+        Reset();
+        if (cchBefore > 0)
+            _EnterFromText(pchBefore, cchBefore);
+    }
+
+    // Forget the pending syllable (caret moved, focus change, unmapped key)
+    void Reset()
+    {
+        _state = StateIdle;
+        _consonant = 0;
+    }
+
+private:
+    enum State : uint8_t
+    {
+        StateIdle,              // no consonant waiting for a vowel
+        StateConsonant,         // consonant typed, vowel sign may follow
+        StateClusterEnd         // second consonant of an automatic pulli cluster
+    };
+
+    void _EnterFromText(const char16_t* pch, size_t cch);
+
+    State _state;
+    uint8_t _consonant;         // index into c_tamilConsonants
+};
@@ -0,0 +1,61 @@
+﻿// TamilScan.h
+// Vector kernels for runs of UTF-16: the Tamil character class of every unit
+// (GetTamilCharInfo, 16-32 units per step), where grapheme clusters start,
+// the next ASCII unit, and ASCII runs copied between bytes and units. One
+// set of kernels per instruction set - AVX2, SSSE3 or NEON, with a scalar
+// fallback - picked once for the CPU at first use. Every set gives the same
+// results as the scalar one.
+//
+// Clusters follow the Unicode rules as they apply to Tamil text: a cluster
+// continues over a vowel sign, pulli, ௗ or the anusvara U+0B82, over the
+// combining diacritics U+0300-U+036F, ZWNJ / ZWJ and the variation
+// selectors U+FE00-U+FE0F, and over the low half of a surrogate pair and
+// the LF of a CR LF. Tamil has no conjunct-forming virama, so a consonant
+// after pulli starts a new cluster (க்ஷ is two).
+// Portable C++17 - no Windows headers, no allocation
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "TamilScript.h"
+
+struct TamilScanKernels
+{
+    const char* name;
+
+    // pClasses[i] = GetTamilCharInfo(pch[i]).charClass
+    void (*pfnClassify)(const char16_t* pch, size_t cch, uint8_t* pClasses);
+
+    // pfStarts[i] = 1 where a cluster starts at pch[i], 0 where pch[i]
+    // continues the one before. chBefore is the unit before pch[0], 0 at the
+    // start of the text.
+    void (*pfnClusterStarts)(const char16_t* pch, size_t cch, char16_t chBefore, uint8_t* pfStarts);
+
+    // Index of the first unit below U+0080; cch if there is none
+    size_t (*pfnFindAscii)(const char16_t* pch, size_t cch);
+
+    // Copy the leading run of ASCII between bytes and units, stopping at the
+    // first byte of 0x80 and up (unit of U+0080 and up). Returns the length
+    // of the run; nothing past it is written.
+    size_t (*pfnWidenAscii)(const uint8_t* pb, size_t cb, char16_t* pch);
+    size_t (*pfnNarrowAscii)(const char16_t* pch, size_t cch, uint8_t* pb);
+};
+
+// The best kernels this CPU runs
+const TamilScanKernels& TamilScan();
+
+// Every set this CPU runs, the scalar one first; for comparing them
+size_t TamilScanAvailable(const TamilScanKernels** ppKernels, size_t cMax);
+
+// One unit's cluster rule, as the kernels apply it: true when ch continues
+// the cluster that chBefore belongs to
+inline bool TamilContinuesCluster(char16_t chBefore, char16_t ch)
+{
+    TamilCharClass charClass = GetTamilCharInfo(ch).charClass;
+    return charClass == TamilClassVowelSign || charClass == TamilClassPulli || ch == 0x0B82 ||
+        (ch >= 0x0300 && ch <= 0x036F) || ch == 0x200C || ch == 0x200D || (ch >= 0xFE00 && ch <= 0xFE0F) ||
+        (ch >= 0xDC00 && ch <= 0xDFFF && chBefore >= 0xD800 && chBefore <= 0xDBFF) ||
+        (ch == 0x0A && chBefore == 0x0D);
+}
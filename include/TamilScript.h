@@ -0,0 +1,141 @@
+﻿// TamilScript.h
+// Tamil Unicode block (U+0B80-U+0BFF) constants, character classes and the
+// precomputed consonant-by-vowel syllable (uyirmei) matrix shared by the engines.
+// Portable C++17 - no Windows headers
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+static const char16_t c_tamilBlockStart = 0x0B80;
+static const char16_t c_tamilBlockEnd = 0x0BFF;
+
+static const char16_t c_tamilAytham = 0x0B83;    // ஃ
+static const char16_t c_tamilPulli = 0x0BCD;     // ்
+static const char16_t c_tamilAuLength = 0x0BD7;  // ௗ
+
+// 18 native consonants followed by the grantha consonants
+static const size_t c_tamilConsonantCount = 22;
+static const size_t c_tamilVowelCount = 12;
+
+inline constexpr char16_t c_tamilConsonants[c_tamilConsonantCount] =
+{
+    0x0B95, 0x0B99, 0x0B9A, 0x0B9E, 0x0B9F, 0x0BA3,     // க ங ச ஞ ட ண
+    0x0BA4, 0x0BA8, 0x0BAA, 0x0BAE, 0x0BAF, 0x0BB0,     // த ந ப ம ய ர
+    0x0BB2, 0x0BB5, 0x0BB4, 0x0BB3, 0x0BB1, 0x0BA9,     // ல வ ழ ள ற ன
+    0x0B9C, 0x0BB7, 0x0BB8, 0x0BB9,                     // ஜ ஷ ஸ ஹ
+};
+
+inline constexpr char16_t c_tamilVowels[c_tamilVowelCount] =
+{
+    0x0B85, 0x0B86, 0x0B87, 0x0B88, 0x0B89, 0x0B8A,     // அ ஆ இ ஈ உ ஊ
+    0x0B8E, 0x0B8F, 0x0B90, 0x0B92, 0x0B93, 0x0B94,     // எ ஏ ஐ ஒ ஓ ஔ
+};
+
+// Dependent vowel sign for each vowel; அ is inherent and has none
+inline constexpr char16_t c_tamilVowelSigns[c_tamilVowelCount] =
+{
+    0,      0x0BBE, 0x0BBF, 0x0BC0, 0x0BC1, 0x0BC2,     //   ா ி ீ ு ூ
+    0x0BC6, 0x0BC7, 0x0BC8, 0x0BCA, 0x0BCB, 0x0BCC,     // ெ ே ை ொ ோ ௌ
+};
+
+enum TamilCharClass : uint8_t
+{
+    TamilClassNone = 0,
+    TamilClassVowel,
+    TamilClassConsonant,
+    TamilClassVowelSign,
+    TamilClassPulli,
+    TamilClassAytham,
+    TamilClassDigit,
+    TamilClassSymbol
+};
+
+// Class of a code point in the Tamil block plus its index into the
+// consonant / vowel arrays above (vowel signs use the vowel index)
+struct TamilCharInfo
+{
+    TamilCharClass charClass;
+    uint8_t index;
+};
+
+struct TamilCharTable
+{
+    TamilCharInfo info[128];
+};
+
+constexpr TamilCharTable MakeTamilCharTable()
+{
+    TamilCharTable table = {};
+
+    for (size_t i = 0; i < c_tamilVowelCount; i++)
+    {
+        table.info[c_tamilVowels[i] - c_tamilBlockStart] = { TamilClassVowel, (uint8_t)i };
+        if (c_tamilVowelSigns[i])
+            table.info[c_tamilVowelSigns[i] - c_tamilBlockStart] = { TamilClassVowelSign, (uint8_t)i };
+    }
+
+    for (size_t i = 0; i < c_tamilConsonantCount; i++)
+        table.info[c_tamilConsonants[i] - c_tamilBlockStart] = { TamilClassConsonant, (uint8_t)i };
+
+    table.info[0x0BB6 - c_tamilBlockStart] = { TamilClassConsonant, (uint8_t)c_tamilConsonantCount };  // ஶ (no matrix row)
+    table.info[c_tamilPulli - c_tamilBlockStart] = { TamilClassPulli, 0 };
+    table.info[c_tamilAytham - c_tamilBlockStart] = { TamilClassAytham, 0 };
+    table.info[c_tamilAuLength - c_tamilBlockStart] = { TamilClassVowelSign, 11 };
+
+    for (char16_t ch = 0x0BE6; ch <= 0x0BF2; ch++)
+        table.info[ch - c_tamilBlockStart] = { TamilClassDigit, (uint8_t)(ch - 0x0BE6) };
+    for (char16_t ch = 0x0BF3; ch <= 0x0BFA; ch++)
+        table.info[ch - c_tamilBlockStart] = { TamilClassSymbol, 0 };
+    table.info[0x0BD0 - c_tamilBlockStart] = { TamilClassSymbol, 0 };  // ௐ
+
+    return table;
+}
+
+inline constexpr TamilCharTable c_tamilCharTable = MakeTamilCharTable();
+
+inline constexpr TamilCharInfo GetTamilCharInfo(char16_t ch)
+{
+    return (ch >= c_tamilBlockStart && ch <= c_tamilBlockEnd)
+        ? c_tamilCharTable.info[ch - c_tamilBlockStart]
+        : TamilCharInfo{ TamilClassNone, 0 };
+}
+
+// Syllable matrix: consonant + vowel -> uyirmei text.
+// text[0] is the consonant, text[1] the vowel sign (0 for அ).
+struct TamilSyllable
+{
+    char16_t text[2];
+    uint8_t cch;
+};
+
+struct TamilSyllableMatrix
+{
+    TamilSyllable cell[c_tamilConsonantCount][c_tamilVowelCount];
+};
+
+constexpr TamilSyllableMatrix MakeTamilSyllableMatrix()
+{
+    TamilSyllableMatrix matrix = {};
+
+    for (size_t c = 0; c < c_tamilConsonantCount; c++)
+    {
+        for (size_t v = 0; v < c_tamilVowelCount; v++)
+        {
+            TamilSyllable& cell = matrix.cell[c][v];
+            cell.text[0] = c_tamilConsonants[c];
+            cell.text[1] = c_tamilVowelSigns[v];
+            cell.cch = c_tamilVowelSigns[v] ? 2 : 1;
+        }
+    }
+
+    return matrix;
+}
+
+inline constexpr TamilSyllableMatrix c_tamilSyllables = MakeTamilSyllableMatrix();
+
+static_assert(c_tamilSyllables.cell[0][1].text[1] == 0x0BBE, "கா");
+static_assert(c_tamilSyllables.cell[17][11].text[0] == 0x0BA9, "னௌ");
+static_assert(GetTamilCharInfo(0x0BB4).charClass == TamilClassConsonant, "ழ");
+static_assert(GetTamilCharInfo(0x0BC8).index == 8, "ை -> ஐ");
@@ -0,0 +1,59 @@
+﻿// TraceEvents.h
+// Event ids for the binary trace (TraceRing.h) and the table the decoder
+// uses to format them. Records carry raw 64-bit arguments only; each format
+// string below consumes them in order as unsigned long long.
+// Append new events at the end - ids are stored in trace files.
+// Portable C++17
+
+#pragma once
+
+#include <cstdint>
+
+enum TraceEventId : uint16_t
+{
+    TraceNone = 0,
+    TraceDropped,               // synthesized by the collector
+    TraceActivate,
+    TraceDeactivate,
+    TraceLayoutSwitch,
+    TraceKeyDown,
+    TraceKeyMapped,
+    TraceEngineOutput,
+    TraceKeyEaten,
+    TraceKeyReset,
+    TraceEditSessionRequest,
+    TraceEditSessionBegin,
+    TraceEditSessionEnd,
+    TraceSurroundingTextRead,   // the only document read on the typing path
+    TraceForeignEdit,
+    TraceActiveFlags,           // ITfThreadMgrEx flags, queried only while tracing
+    TraceEngineReady,           // deferred engine setup done on the first key
+    TraceEventCount
+};
+
+struct TraceEventInfo
+{
+    const char* name;
+    const char* format;
+};
+
+inline constexpr TraceEventInfo c_traceEvents[TraceEventCount] =
+{
+    { "None",               "" },
+    { "Dropped",            "records=%llu" },
+    { "Activate",           "clientId=0x%llX" },
+    { "Deactivate",         "" },
+    { "LayoutSwitch",       "layout=%llu" },
+    { "KeyDown",            "vk=0x%02llX lParam=0x%08llX" },
+    { "KeyMapped",          "code=U+%04llX" },
+    { "EngineOutput",       "delete=%llu text=%llu first=U+%04llX" },
+    { "KeyEaten",           "hr=0x%08llX" },
+    { "KeyReset",           "vk=0x%02llX" },
+    { "EditSessionRequest", "hr=0x%08llX hrSession=0x%08llX" },
+    { "EditSessionBegin",   "delete=%llu text=%llu keys=%llu" },
+    { "EditSessionEnd",     "hr=0x%08llX" },
+    { "SurroundingTextRead", "units=%llu atStart=%llu" },
+    { "ForeignEdit",        "context=0x%llX" },
+    { "ActiveFlags",        "flags=0x%llX" },
+    { "EngineReady",        "layout=%llu" },
+};
@@ -0,0 +1,224 @@
+﻿// TraceRing.h
+// Binary trace backend. Producers append fixed-size records (timestamp,
+// event id, raw arguments) to a ring owned by the calling thread - one
+// single-producer/single-consumer ring per thread, so the hot path takes no
+// lock and does no formatting. A collector thread drains every ring into a
+// trace file that tools/TraceDecode.cpp turns into text.
+// Portable C++17
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "TraceEvents.h"
+
+#ifndef ANJAL_TRACE_ENABLED
+#define ANJAL_TRACE_ENABLED 1
+#endif
+
+static const size_t c_traceMaxArgs = 4;
+static const size_t c_traceRingRecords = 1024;     // per thread, power of two
+static const size_t c_traceMaxThreads = 64;
+
+static_assert((c_traceRingRecords & (c_traceRingRecords - 1)) == 0, "ring size must be a power of two");
+
+struct TraceRecord
+{
+    uint64_t timestamp;                 // steady clock ticks, see TraceFileHeader
+    uint32_t thread;                    // ring slot of the producing thread
+    uint16_t eventId;                   // TraceEventId
+    uint16_t argCount;
+    uint64_t args[c_traceMaxArgs];
+};
+
+static_assert(sizeof(TraceRecord) == 48, "trace file format");
+
+// Trace file: one header followed by TraceRecords
+static const uint32_t c_traceFileMagic = 0x43525441;   // "ATRC"
+static const uint32_t c_traceFileVersion = 1;
+
+struct TraceFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t reserved;
+    uint64_t ticksPerSecond;
+};
+
+inline uint64_t TraceTimestamp()
+{
+    return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+class TraceRing
+{
+public:
+    TraceRing(uint32_t slot) : _slot(slot), _head(0), _dropped(0), _tail(0), _retired(false) {}
+
+    uint32_t Slot() const { return _slot; }
+
+    // Producer (owning thread) only. Never blocks: when the collector has
+    // fallen behind the record is counted as dropped instead.
+    bool Push(const TraceRecord& record)
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) >= c_traceRingRecords)
+        {
+            _dropped.store(_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        _records[head & (c_traceRingRecords - 1)] = record;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer (collector) only. Calls fn(const TraceRecord&) for every
+    // published record and returns the count.
+    template <typename Fn>
+    size_t Drain(Fn&& fn)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        size_t head = _head.load(std::memory_order_acquire);
+
+        for (size_t i = tail; i != head; i++)
+            fn(_records[i & (c_traceRingRecords - 1)]);
+
+        _tail.store(head, std::memory_order_release);
+        return head - tail;
+    }
+
+    // Consumer only: dropped count since the last call
+    uint64_t TakeDropped()
+    {
+        uint64_t dropped = _dropped.load(std::memory_order_relaxed);
+        uint64_t reported = _droppedReported;
+        _droppedReported = dropped;
+        return dropped - reported;
+    }
+
+    void Retire() { _retired.store(true, std::memory_order_release); }
+    bool IsRetired() const { return _retired.load(std::memory_order_acquire); }
+
+private:
+    const uint32_t _slot;
+    alignas(64) std::atomic<size_t> _head;          // written by the producer
+    std::atomic<uint64_t> _dropped;
+    alignas(64) std::atomic<size_t> _tail;          // written by the consumer
+    uint64_t _droppedReported = 0;
+    std::atomic<bool> _retired;
+    alignas(64) TraceRecord _records[c_traceRingRecords];
+};
+
+extern std::atomic<bool> g_traceEnabled;
+
+// Ring of the calling thread, created and registered on first use.
+// NULL when every slot is taken.
+TraceRing* TraceThreadRing();
+
+// Starts the collector thread writing to pFile (which it then owns) and
+// enables tracing. Nested calls are reference counted; only the first
+// file is used and later ones are closed.
+bool TraceStart(FILE* pFile);
+
+// Drops one reference; the last one stops the collector, writes the
+// remaining records and closes the file.
+void TraceStop();
+
+// For DLL_PROCESS_DETACH at process exit, with references still held: the
+// collector thread has been terminated, so it is detached rather than
+// joined - a joinable std::thread destroyed with the statics would call
+// std::terminate. Unless the collector died holding the drain lock, the
+// remaining records are written and the file is closed.
+void TraceProcessExit();
+
+template <typename... Args>
+inline void TraceEvent(TraceEventId id, Args... args)
+{
+    static_assert(sizeof...(Args) <= c_traceMaxArgs, "too many trace arguments");
+
+    if (!g_traceEnabled.load(std::memory_order_relaxed))
+        return;
+
+    TraceRing* pRing = TraceThreadRing();
+    if (!pRing)
+        return;
+
+    TraceRecord record;
+    record.timestamp = TraceTimestamp();
+    record.thread = pRing->Slot();
+    record.eventId = id;
+    record.argCount = (uint16_t)sizeof...(Args);
+
+    size_t i = 0;
+    ((record.args[i++] = (uint64_t)args), ...);
+    for (; i < c_traceMaxArgs; i++)
+        record.args[i] = 0;
+
+    pRing->Push(record);
+}
+
+// Trace points compile out with ANJAL_TRACE_ENABLED=0
+#if ANJAL_TRACE_ENABLED
+#define ANJAL_TRACE(...) TraceEvent(__VA_ARGS__)
+#else
+#define ANJAL_TRACE(...) ((void)0)
+#endif
+
+// Registry of per-thread rings, indexed by slot
+struct TraceRingTable
+{
+    std::atomic<TraceRing*> slots[c_traceMaxThreads];
+};
+
+extern TraceRingTable g_traceRings;
+void TraceLockDrain();
+void TraceUnlockDrain();
+
+// Drains every registered ring (serialized internally) and reports drops
+// as TraceDropped records. Rings of exited threads are released once
+// empty. Returns the number of records drained.
+template <typename Fn>
+size_t TraceDrainAll(Fn&& fn)
+{
+    size_t count = 0;
+
+    TraceLockDrain();
+    for (size_t i = 0; i < c_traceMaxThreads; i++)
+    {
+        TraceRing* pRing = g_traceRings.slots[i].load(std::memory_order_acquire);
+        if (!pRing)
+            continue;
+
+        bool retired = pRing->IsRetired();
+        count += pRing->Drain(fn);
+
+        uint64_t dropped = pRing->TakeDropped();
+        if (dropped)
+        {
+            TraceRecord record = {};
+            record.timestamp = TraceTimestamp();
+            record.thread = pRing->Slot();
+            record.eventId = TraceDropped;
+            record.argCount = 1;
+            record.args[0] = dropped;
+            fn(record);
+        }
+
+        // The owner is gone and nothing can be pushed after Retire()
+        if (retired)
+        {
+            pRing->Drain(fn);
+            g_traceRings.slots[i].store(nullptr, std::memory_order_release);
+            delete pRing;
+        }
+    }
+    TraceUnlockDrain();
+
+    return count;
+}
@@ -0,0 +1,62 @@
+﻿// Transliterator.h
+// Converts stored text - romanized chat logs, form fields - as if it were
+// typed key by key on a US keyboard into the text service. Each character
+// is the key that types it, mapped through the layout's tables and run
+// through the same KeyboardEngine as OnKeyDown. A character whose key the
+// layout leaves unmapped (space, most punctuation, Enter), or that has no
+// key at all (Tamil, anything outside ASCII), ends the open syllable and is
+// kept as it is - what the application does with a key the service does
+// not eat.
+//
+// After such a character the engine is back at its reset state, so text can
+// be split there and the parts converted independently; runs of them are
+// copied without going near the engine. Caps Lock is taken as off and the
+// AltGr layer is never used: no plain character needs it.
+// Portable C++17 - no Windows headers, no allocation
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "KeyboardEngine.h"
+
+// Convert's result when the output buffer is too small
+static const size_t c_transliterateNoRoom = SIZE_MAX;
+
+// The key and layer that type ch on a US keyboard. False for characters
+// no key types; Tab and Enter (CR or LF) count as keys.
+bool UsKeyForChar(char16_t ch, uint8_t* pvk, KeyLayer* pLayer);
+
+class Transliterator
+{
+public:
+    explicit Transliterator(LayoutId layout);
+
+    LayoutId Layout() const { return _engine.GetLayout()->id; }
+
+    // True when ch ends any open syllable, leaving the engine reset: the
+    // text may be split after it
+    bool IsBoundary(char16_t ch) const { return ch >= 0x80 || _codes[ch] == 0; }
+
+    // Key code that types ch on the layout, 0 if it passes through
+    char16_t KeyCode(char16_t ch) const { return (ch < 0x80) ? _codes[ch] : 0; }
+
+    // The engine on the layout at its reset state, for conversions kept
+    // elsewhere (see TransliteratorStream.h)
+    const KeyboardEngine& ResetEngine() const { return _engine; }
+
+    // Converts pchIn[0..cchIn) from a reset engine into pchOut. Returns the
+    // length written, or c_transliterateNoRoom when the conversion needs
+    // more than cchOutMax units at some point (a syllable may grow and then
+    // shrink). With pchOut null only measures: returns the cchOutMax the
+    // conversion needs. Const, so one instance serves any number of threads.
+    size_t Convert(const char16_t* pchIn, size_t cchIn, char16_t* pchOut, size_t cchOutMax) const;
+
+    // Safe cchOutMax for any input of cchIn units
+    static size_t MaxOutput(size_t cchIn) { return cchIn * c_engineMaxOutput; }
+
+private:
+    KeyboardEngine _engine;         // reset, on the layout; copied per conversion
+    char16_t _codes[0x80];          // key code per ASCII character, 0 if it passes through
+};
@@ -0,0 +1,67 @@
+﻿// TransliteratorStream.h
+// Push-style conversion of text that arrives in pieces - network fragments,
+// pipe reads - with the same result as Transliterator::Convert on the whole
+// text. UTF-8 in, UTF-8 out. The engine state, a UTF-8 sequence cut by a
+// fragment end, and the open syllable all carry over to the next Feed, so
+// input may be split at any byte.
+//
+// Output goes straight into the caller's buffer. Only the open syllable
+// (KeyboardEngine::ComposingLength units, which the next key may still
+// rewrite) is held back, in a fixed buffer inside the object; everything
+// before it is final and written as soon as there is room. Finish writes
+// the held syllable.
+// Portable C++17 - no Windows headers, no allocation
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Transliterator.h"
+
+// Code units held back: the open syllable plus one key's output
+static const size_t c_streamHeldMax = 64;
+
+enum StreamResult
+{
+    StreamDone,             // all input taken (Feed) or all output written (Finish)
+    StreamOutputNeeded      // the output buffer is full: call again with more room
+};
+
+class TransliteratorStream
+{
+public:
+    // Converts with transliterator's layout and tables; it must outlive the
+    // stream. Any number of streams may share one Transliterator.
+    explicit TransliteratorStream(const Transliterator& transliterator);
+
+    // Takes UTF-8 from pbIn[0..cbIn) and writes the converted text that is
+    // final to pbOut[0..cbOutMax). Returns StreamOutputNeeded when pbOut
+    // filled up first: *pcbRead bytes were taken, so call again with the
+    // rest. Malformed UTF-8 becomes U+FFFD. cbOutMax of 4 or more always
+    // makes progress.
+    StreamResult Feed(const char* pbIn, size_t cbIn, size_t* pcbRead, char* pbOut, size_t cbOutMax, size_t* pcbWritten);
+
+    // End of the text: closes the open syllable and writes what is held.
+    // StreamOutputNeeded means call again with more room; on StreamDone the
+    // stream is reset for the next text.
+    StreamResult Finish(char* pbOut, size_t cbOutMax, size_t* pcbWritten);
+
+    // Drops everything held and starts a new text
+    void Reset();
+
+private:
+    bool _Write(char* pbOut, size_t cbOutMax, size_t* pcbWritten);
+    void _Step(uint32_t cp);
+
+    const Transliterator* _pTransliterator;
+    KeyboardEngine _engine;
+    bool _fReset;                           // engine is at its reset state
+    uint8_t _cbSequence;                    // bytes of a UTF-8 sequence taken so far
+    uint8_t _cbSequenceNeeded;              // its full length
+    uint32_t _cpSequence;                   // its bits so far
+    size_t _cchHeld;                        // converted units not yet written
+    size_t _cchFinal;                       // leading held units no key can rewrite
+    size_t _ichWritten;                     // leading final units already written
+    char16_t _held[c_streamHeldMax];
+};
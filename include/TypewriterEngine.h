@@ -0,0 +1,56 @@
+﻿// TypewriterEngine.h
+// Composition engine for glyph-order layouts (Tamil Typewriter, Bamini).
+// These layouts are typed in visual order, so the prefix vowel signs
+// ெ ே ை come before the consonant they belong to. The engine holds the
+// prefix until the consonant arrives and emits them in Unicode logical order.
+// Portable C++17 - no Windows headers, no allocation
+
+#pragma once
+
+#include "EngineOutput.h"
+#include "TamilScript.h"
+
+//
+// Rules:
+//   1. Prefix sign (ெ ே ை)      -> held, nothing inserted yet
+//   2. Consonant after a prefix  -> consonant + sign (ெ + க -> கெ)
+//   3. ா after கெ / கே           -> sign rewritten to ொ / ோ
+//   4. ௗ after கெ                -> sign rewritten to ௌ
+//   5. Anything else after a held prefix inserts the prefix as typed
+//
+class TypewriterEngine
+{
+public:
+    TypewriterEngine() { Reset(); }
+
+    // Same contract as Tamil99Engine::ProcessKey
+    bool ProcessKey(const char16_t* pchKey, size_t cchKey, EngineOutput* pOutput);
+
+    // Consonant + ெ / ே stays open while ா or ௗ may still rewrite the sign.
+    // A held prefix has not been emitted, so it is not counted.
+    size_t ComposingLength() const
+    {
+        return _lastSign ? 2 : 0;
+    }
+
+    // The prefix sign waiting for its consonant, 0 if none. Converters
+    // insert it as typed when their input ends.
+    char16_t HeldPrefix() const
+    {
+        return _prefixSign;
+    }
+
+    void Reset()
+    {
+        _prefixSign = 0;
+        _lastSign = 0;
+    }
+
+    // Continues from the text before the caret: ா or ௗ after கெ / கே in the
+    // document still rewrites the sign
+    void Resume(const char16_t* pchBefore, size_t cchBefore);
+
+private:
+    char16_t _prefixSign;       // prefix sign typed, waiting for its consonant
+    char16_t _lastSign;         // ெ or ே just emitted after a consonant
+};
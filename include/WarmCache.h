@@ -0,0 +1,199 @@
+﻿// WarmCache.h
+// Process-wide cache of deactivated text service instances. Switching
+// between Tamil and another language deactivates the service and activates
+// it again each time; with the cache the next activation on the same thread
+// gets the instance back - its candidate worker, message window, edit
+// session pool and layout - instead of building a new one.
+//
+// One entry per thread. The cache holds at most c_warmCacheSlots entries
+// and c_warmCacheBytesMax bytes between them, evicting the least recently
+// parked first, and trims entries idle for c_warmCacheIdleMs. It never
+// releases an entry itself: whatever a call lets go of is handed back, to
+// be released by the caller outside the lock.
+// Portable C++17 - no Windows headers
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+static const size_t c_warmCacheSlots = 8;
+static const size_t c_warmCacheBytesMax = 1024 * 1024;
+static const uint64_t c_warmCacheIdleMs = 5 * 60 * 1000;
+
+struct WarmCacheStats
+{
+    uint64_t parked;
+    uint64_t reattached;                // Take found the thread's entry
+    uint64_t missed;                    // Take found none
+    uint64_t evicted;                   // over the slot or byte cap, or replaced
+    uint64_t trimmed;                   // idle too long
+    size_t cEntries;
+    size_t cbEntries;
+};
+
+template <class T>
+class WarmCache
+{
+public:
+    // Entries a call let go of; the caller releases them
+    struct Released
+    {
+        T* ap[c_warmCacheSlots];
+        size_t c;
+    };
+
+    WarmCache() : _slots(), _cbEntries(0), _stats() {}
+
+    // Parks p as the thread's entry, replacing any it had. cb is what keeping
+    // it costs. Returns false, and does not hold p, if cb alone is over the cap.
+    bool Park(T* p, uint32_t threadId, size_t cb, uint64_t nowMs, Released* pReleased)
+    {
+        pReleased->c = 0;
+        if (cb > c_warmCacheBytesMax)
+            return false;
+
+        std::lock_guard<std::mutex> lock(_lock);
+        _TrimIdle(nowMs, pReleased);
+
+        size_t iFree = c_warmCacheSlots;
+        for (size_t i = 0; i < c_warmCacheSlots; i++)
+        {
+            if (_slots[i].p != nullptr && _slots[i].threadId == threadId)
+            {
+                _Release(i, pReleased);
+                _stats.evicted++;
+            }
+            if (_slots[i].p == nullptr && iFree == c_warmCacheSlots)
+                iFree = i;
+        }
+
+        // Oldest out until there is a slot and the bytes fit
+        while (iFree == c_warmCacheSlots || _cbEntries + cb > c_warmCacheBytesMax)
+        {
+            size_t iOldest = _Oldest();
+            _Release(iOldest, pReleased);
+            _stats.evicted++;
+            if (iFree == c_warmCacheSlots)
+                iFree = iOldest;
+        }
+
+        _slots[iFree].p = p;
+        _slots[iFree].threadId = threadId;
+        _slots[iFree].parkedMs = nowMs;
+        _slots[iFree].cb = cb;
+        _cbEntries += cb;
+        _stats.parked++;
+        return true;
+    }
+
+    // The thread's entry, now the caller's, or null
+    T* Take(uint32_t threadId, uint64_t nowMs, Released* pReleased)
+    {
+        pReleased->c = 0;
+
+        std::lock_guard<std::mutex> lock(_lock);
+        _TrimIdle(nowMs, pReleased);
+
+        for (size_t i = 0; i < c_warmCacheSlots; i++)
+        {
+            if (_slots[i].p != nullptr && _slots[i].threadId == threadId)
+            {
+                T* p = _slots[i].p;
+                _cbEntries -= _slots[i].cb;
+                _slots[i] = Slot();
+                _stats.reattached++;
+                return p;
+            }
+        }
+
+        _stats.missed++;
+        return nullptr;
+    }
+
+    // Drops p if it is parked; returns true if it was, and the caller now
+    // owns the cache's hold on it
+    bool Remove(const T* p)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        for (size_t i = 0; i < c_warmCacheSlots; i++)
+        {
+            if (_slots[i].p == p)
+            {
+                _cbEntries -= _slots[i].cb;
+                _slots[i] = Slot();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Lets go of every entry idle for c_warmCacheIdleMs
+    void Trim(uint64_t nowMs, Released* pReleased)
+    {
+        pReleased->c = 0;
+
+        std::lock_guard<std::mutex> lock(_lock);
+        _TrimIdle(nowMs, pReleased);
+    }
+
+    WarmCacheStats Stats() const
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        WarmCacheStats stats = _stats;
+        stats.cEntries = 0;
+        for (size_t i = 0; i < c_warmCacheSlots; i++)
+            stats.cEntries += _slots[i].p != nullptr;
+        stats.cbEntries = _cbEntries;
+        return stats;
+    }
+
+private:
+    struct Slot
+    {
+        T* p;
+        uint32_t threadId;
+        uint64_t parkedMs;
+        size_t cb;
+    };
+
+    // At least one slot is in use when this is called
+    size_t _Oldest() const
+    {
+        size_t iOldest = 0;
+        for (size_t i = 1; i < c_warmCacheSlots; i++)
+        {
+            if (_slots[i].p != nullptr &&
+                (_slots[iOldest].p == nullptr || _slots[i].parkedMs < _slots[iOldest].parkedMs))
+            {
+                iOldest = i;
+            }
+        }
+        return iOldest;
+    }
+
+    void _Release(size_t i, Released* pReleased)
+    {
+        pReleased->ap[pReleased->c++] = _slots[i].p;
+        _cbEntries -= _slots[i].cb;
+        _slots[i] = Slot();
+    }
+
+    void _TrimIdle(uint64_t nowMs, Released* pReleased)
+    {
+        for (size_t i = 0; i < c_warmCacheSlots; i++)
+        {
+            if (_slots[i].p != nullptr && nowMs - _slots[i].parkedMs >= c_warmCacheIdleMs)
+            {
+                _Release(i, pReleased);
+                _stats.trimmed++;
+            }
+        }
+    }
+
+    mutable std::mutex _lock;
+    Slot _slots[c_warmCacheSlots];
+    size_t _cbEntries;
+    WarmCacheStats _stats;
+};
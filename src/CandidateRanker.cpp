@@ -0,0 +1,255 @@
+﻿// CandidateRanker.cpp
+// Incremental best-first top-k over the dictionary - see CandidateRanker.h
+
+#include "../include/CandidateRanker.h"
+
+#include <algorithm>
+#include <cstring>
+
+// Heap order: higher bound first; on a tie a finished word before a subtree
+static bool CandidateLess(const CandidateEntry& a, const CandidateEntry& b)
+{
+    return (a.bound != b.bound) ? a.bound < b.bound : a.fWord < b.fWord;
+}
+
+size_t CandidateRanker::Rank(const Dictionary& dictionary, const char16_t* pch, size_t cch)
+{
+    if (&dictionary != _pDictionary)
+    {
+        Reset();
+        _pDictionary = &dictionary;
+    }
+
+    _cResults = 0;
+    if (cch >= c_dictionaryMaxWord)
+        cch = 0;
+
+    // Keep only the frontiers of prefixes the new one still starts with
+    size_t cchCommon = 0;
+    while (cchCommon < cch && cchCommon < _cchPrefix && pch[cchCommon] == _prefix[cchCommon])
+        cchCommon++;
+    while (_cLevels > 0 && _Top().cchPrefix > cchCommon)
+        _cLevels--;
+
+    bool fShorter = (cch < _cchPrefix);
+    for (size_t i = 0; i < cch; i++)
+        _prefix[i] = pch[i];
+    _cchPrefix = cch;
+
+    if (cch == 0)
+        return 0;
+
+    if (_cLevels > 0 && _Top().cchPrefix == cch)
+    {
+        if (fShorter)
+            _stats.restored++;
+        _cResults = _Top().cResults;
+        return _cResults;
+    }
+
+    int32_t state = dictionary.Walk(Dictionary::c_root, pch, cch);
+    if (state < 0)
+        return 0;
+
+    if (_cLevels > 0)
+    {
+        const Level& from = _Top();
+        Level& level = _Push();
+        uint32_t droppedBound = _Narrow(from, &level, state, cch);
+        _Run(&level);
+
+        // Something dropped from the shorter prefix's frontier in this
+        // branch may outrank the last result; rank from the state itself
+        if (droppedBound > 0 &&
+            (level.cResults < c_candidateTopK || level.results[c_candidateTopK - 1].bound < droppedBound))
+        {
+            _Start(&level, state, cch, 0);
+            _Run(&level);
+            _stats.restarted++;
+        }
+        else
+        {
+            _stats.narrowed++;
+        }
+    }
+    else
+    {
+        Level& level = _Push();
+        _Start(&level, state, cch, 0);
+        _Run(&level);
+        _stats.restarted++;
+    }
+
+    _cResults = _Top().cResults;
+    return _cResults;
+}
+
+size_t CandidateRanker::Text(size_t i, char16_t* pch, size_t cchMax) const
+{
+    const CandidateEntry& entry = _Top().results[i];
+    if (entry.depth > cchMax)
+        return 0;
+
+    _pDictionary->PathText(entry.state, entry.depth, pch);
+    return entry.depth;
+}
+
+void CandidateRanker::GetList(CandidateList* pList) const
+{
+    size_t cchText = 0;
+    pList->cCandidates = 0;
+    for (size_t i = 0; i < _cResults; i++)
+    {
+        size_t cch = Text(i, pList->text + cchText, sizeof(pList->text) / sizeof(pList->text[0]) - cchText);
+        if (cch == 0)
+            break;
+
+        pList->candidates[i] = { Frequency(i), (uint16_t)cchText, (uint16_t)cch };
+        cchText += cch;
+        pList->cCandidates++;
+    }
+}
+
+// A new level on top; the oldest one is recycled when the stack is full
+CandidateRanker::Level& CandidateRanker::_Push()
+{
+    if (_cLevels == c_candidateLevelsMax)
+        _iBottom = (_iBottom + 1) % c_candidateLevelsMax;
+    else
+        _cLevels++;
+
+    return _Level(_cLevels - 1);
+}
+
+void CandidateRanker::_Start(Level* pLevel, int32_t state, size_t depth, uint32_t droppedInherited) const
+{
+    pLevel->cchPrefix = (uint8_t)depth;
+    pLevel->cResults = 0;
+    pLevel->cHeap = 0;
+    pLevel->droppedInherited = droppedInherited;
+    memset(pLevel->droppedBranch, 0, sizeof(pLevel->droppedBranch));
+    _Add(pLevel, { _pDictionary->MaxFrequency(state), state, (uint8_t)depth, 0, 0, 0 });
+}
+
+// The entries of 'from' - results and heap alike - cover its prefix's words
+// exactly once. Those inside the subtree of 'state' cover the new prefix's.
+// Returns the highest bound 'from' dropped that may lie in that subtree.
+uint32_t CandidateRanker::_Narrow(const Level& from, Level* pLevel, int32_t state, size_t depth) const
+{
+    int32_t branchState = state;
+    for (size_t d = depth; d > from.cchPrefix + 1u; d--)
+        branchState = _pDictionary->Parent(branchState);
+    uint32_t droppedBound = std::max(from.droppedInherited, from.droppedBranch[_pDictionary->Symbol(branchState)]);
+
+    _Start(pLevel, state, depth, droppedBound);
+    pLevel->cHeap = 0;
+
+    const CandidateEntry* aEntries[2] = { from.results, from.heap };
+    size_t cEntries[2] = { from.cResults, from.cHeap };
+
+    for (size_t iList = 0; iList < 2; iList++)
+    {
+        for (size_t i = 0; i < cEntries[iList]; i++)
+        {
+            CandidateEntry entry = aEntries[iList][i];
+            if (entry.depth < depth)
+            {
+                // A subtree not yet opened above the new state holds all of
+                // it; nothing else can overlap
+                if (entry.fWord)
+                    continue;
+
+                int32_t ancestor = state;
+                for (size_t d = depth; d > entry.depth; d--)
+                    ancestor = _pDictionary->Parent(ancestor);
+                if (ancestor == entry.state)
+                {
+                    _Start(pLevel, state, depth, droppedBound);
+                    return droppedBound;
+                }
+            }
+            else
+            {
+                // Walk up to the new depth, noting the branch passed on the way
+                int32_t ancestor = entry.state;
+                uint8_t branch = 0;
+                for (size_t d = entry.depth; d > depth; d--)
+                {
+                    if (d == depth + 1)
+                        branch = _pDictionary->Symbol(ancestor);
+                    ancestor = _pDictionary->Parent(ancestor);
+                }
+
+                if (ancestor == state)
+                {
+                    entry.branch = branch;
+                    _Add(pLevel, entry);
+                }
+            }
+        }
+    }
+
+    return droppedBound;
+}
+
+// Pushes onto the bounded heap. When it is full the less promising half
+// gives way at once - one selection pass per c_candidateFrontierMax / 2
+// pushes - and the highest bound dropped is remembered per branch.
+void CandidateRanker::_Add(Level* pLevel, const CandidateEntry& entry) const
+{
+    CandidateEntry* pHeap = pLevel->heap;
+
+    if (pLevel->cHeap == c_candidateFrontierMax)
+    {
+        size_t cKeep = c_candidateFrontierMax / 2;
+        std::nth_element(pHeap, pHeap + cKeep, pHeap + c_candidateFrontierMax,
+            [](const CandidateEntry& a, const CandidateEntry& b) { return CandidateLess(b, a); });
+
+        for (size_t i = cKeep; i < c_candidateFrontierMax; i++)
+        {
+            uint32_t& droppedBound = pLevel->droppedBranch[pHeap[i].branch];
+            droppedBound = std::max(droppedBound, pHeap[i].bound);
+        }
+
+        pLevel->cHeap = (uint16_t)cKeep;
+        std::make_heap(pHeap, pHeap + cKeep, CandidateLess);
+    }
+
+    pHeap[pLevel->cHeap++] = entry;
+    std::push_heap(pHeap, pHeap + pLevel->cHeap, CandidateLess);
+}
+
+// Best-first until k words are out. A word comes off the heap only when
+// no subtree left can hold a more frequent one.
+void CandidateRanker::_Run(Level* pLevel)
+{
+    size_t cExpanded = 0;
+    CandidateEntry* pHeap = pLevel->heap;
+
+    while (pLevel->cResults < c_candidateTopK && pLevel->cHeap > 0 && cExpanded < c_dictionaryVisitLimit)
+    {
+        std::pop_heap(pHeap, pHeap + pLevel->cHeap, CandidateLess);
+        CandidateEntry entry = pHeap[--pLevel->cHeap];
+
+        if (entry.fWord)
+        {
+            pLevel->results[pLevel->cResults++] = entry;
+            continue;
+        }
+
+        // Children of the prefix's own state start the branches
+        bool fTop = (entry.depth == pLevel->cchPrefix);
+
+        cExpanded++;
+        for (int32_t child = _pDictionary->FirstChild(entry.state); child >= 0; child = _pDictionary->NextSibling(entry.state, child))
+        {
+            uint8_t branch = fTop ? _pDictionary->Symbol(child) : entry.branch;
+            if (_pDictionary->IsWordEnd(child))
+                _Add(pLevel, { _pDictionary->MaxFrequency(child), entry.state, entry.depth, 1, branch, 0 });
+            else if (entry.depth + 1u < c_dictionaryMaxWord)
+                _Add(pLevel, { _pDictionary->MaxFrequency(child), child, (uint8_t)(entry.depth + 1), 0, branch, 0 });
+        }
+    }
+
+    _stats.expanded += cExpanded;
+}
@@ -0,0 +1,247 @@
+﻿// CandidateWorker.cpp
+// Candidate worker thread and its hand-off - see CandidateWorker.h
+
+#include "../include/CandidateWorker.h"
+#include "../include/LatencyHistogram.h"
+
+#include <chrono>
+
+CandidateWorker::CandidateWorker() :
+    _pDictionary(nullptr),
+    _pfnReady(nullptr),
+    _pvReady(nullptr),
+    _generation(0),
+    _stop(false),
+    _sleeping(false),
+    _notified(false),
+    _fHeld(false),
+    _posted(0),
+    _heldCount(0),
+    _skipped(0),
+    _ranked(0),
+    _stale(0)
+{
+}
+
+bool CandidateWorker::Start(const Dictionary* pDictionary, ReadyCallback pfnReady, void* pvReady)
+{
+    if (IsRunning())
+        return true;
+
+    if (pDictionary == nullptr || !pDictionary->IsAttached() || pfnReady == nullptr)
+        return false;
+
+    _pDictionary = pDictionary;
+    _pfnReady = pfnReady;
+    _pvReady = pvReady;
+    _stop.store(false, std::memory_order_relaxed);
+    _notified.store(false, std::memory_order_relaxed);
+    _ranker.Reset();
+
+    _thread = std::thread(&CandidateWorker::_Main, this);
+    return true;
+}
+
+void CandidateWorker::Stop()
+{
+    if (!IsRunning())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(_wakeLock);
+        _stop.store(true, std::memory_order_relaxed);
+    }
+    _wake.notify_one();
+    _thread.join();
+
+    // Nothing posted before the stop is of use any more
+    CandidateRequest request;
+    while (_requests.Pop(&request))
+    {
+    }
+    CandidateResult result;
+    while (_results.Pop(&result))
+    {
+    }
+    _fHeld.store(false, std::memory_order_relaxed);
+    Cancel();
+}
+
+uint32_t CandidateWorker::Post(const char16_t* pch, size_t cch)
+{
+    Cancel();
+    uint32_t generation = Generation();
+    if (!IsRunning())
+        return generation;
+
+    if (cch > c_dictionaryMaxWord)
+        cch = c_dictionaryMaxWord;
+
+    // Anything still held is older, so the new request simply replaces it
+    _held.generation = generation;
+    _held.cchWord = (uint32_t)cch;
+    _held.postNs = LatencyNow();
+    for (size_t i = 0; i < cch; i++)
+        _held.word[i] = pch[i];
+    _fHeld.store(true, std::memory_order_relaxed);
+
+    _posted.fetch_add(1, std::memory_order_relaxed);
+    if (!_Flush())
+        _heldCount.fetch_add(1, std::memory_order_relaxed);
+
+    return generation;
+}
+
+// Pushes the held request if there is room, and wakes the worker. With the
+// fence in _WaitForRequest, either the push finds room or the worker sees
+// the request held and asks for a Receive.
+bool CandidateWorker::_Flush()
+{
+    if (!_fHeld.load(std::memory_order_relaxed))
+        return true;
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!_requests.Push(_held))
+        return false;
+
+    _fHeld.store(false, std::memory_order_relaxed);
+    _Wake();
+    return true;
+}
+
+// The lock is taken only when the worker is asleep, and the worker holds it
+// only to check the queue - never while ranking
+void CandidateWorker::_Wake()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_sleeping.load(std::memory_order_relaxed))
+    {
+        // Taking the lock waits out a worker between its check and its
+        // wait; notifying after it is released saves the worker blocking on it
+        {
+            std::lock_guard<std::mutex> lock(_wakeLock);
+        }
+        _wake.notify_one();
+    }
+}
+
+bool CandidateWorker::Receive(CandidateResult* pResult)
+{
+    // Results pushed from here on get a new callback. With the fence in
+    // _Main, either the loop below sees a result or its push calls back.
+    _notified.store(false, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // A request held back by a full queue goes now that the worker has answered
+    _Flush();
+
+    bool fFound = false;
+    uint32_t generation = Generation();
+    CandidateResult result;
+    while (_results.Pop(&result))
+    {
+        if (result.generation == generation)
+        {
+            *pResult = result;
+            fFound = true;
+        }
+        else
+        {
+            _stale.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    return fFound;
+}
+
+CandidateWorkerStats CandidateWorker::Stats() const
+{
+    CandidateWorkerStats stats;
+    stats.posted = _posted.load(std::memory_order_relaxed);
+    stats.held = _heldCount.load(std::memory_order_relaxed);
+    stats.skipped = _skipped.load(std::memory_order_relaxed);
+    stats.ranked = _ranked.load(std::memory_order_relaxed);
+    stats.stale = _stale.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// Worker: tells the UI thread to call Receive, once until it does
+void CandidateWorker::_Notify()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!_notified.exchange(true, std::memory_order_relaxed))
+        _pfnReady(_pvReady);
+}
+
+// Worker: sleeps until a request arrives. False when stopping.
+bool CandidateWorker::_WaitForRequest()
+{
+    if (!_requests.IsEmpty())
+        return !_stop.load(std::memory_order_relaxed);
+
+    // Everything queued was stale, and the newest request is still held
+    // by the UI thread; its Receive sends it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_fHeld.load(std::memory_order_relaxed))
+        _Notify();
+
+    std::unique_lock<std::mutex> lock(_wakeLock);
+    _sleeping.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    while (_requests.IsEmpty() && !_stop.load(std::memory_order_relaxed))
+        _wake.wait(lock);
+
+    _sleeping.store(false, std::memory_order_relaxed);
+    return !_stop.load(std::memory_order_relaxed);
+}
+
+void CandidateWorker::_Main()
+{
+    CandidateRequest request;
+
+    while (_WaitForRequest())
+    {
+        if (!_requests.Pop(&request))
+            continue;
+
+        // Only the newest request can still be current
+        if (request.generation != _generation.load(std::memory_order_acquire))
+        {
+            _skipped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        {
+            LatencyScope rankScope(LatencyCompletion);
+            _ranker.Rank(*_pDictionary, request.word, request.cchWord);
+            _ranker.GetList(&_result.list);
+        }
+        _result.generation = request.generation;
+        _result.postNs = request.postNs;
+
+        // The UI may not have collected earlier results yet; wait for room
+        // unless this one goes stale first
+        bool fSent = false;
+        while (!_stop.load(std::memory_order_relaxed))
+        {
+            if (request.generation != _generation.load(std::memory_order_acquire))
+                break;
+            if (_results.Push(_result))
+            {
+                fSent = true;
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        if (!fSent)
+        {
+            _skipped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        _ranked.fetch_add(1, std::memory_order_relaxed);
+        _Notify();
+    }
+}
@@ -0,0 +1,189 @@
+﻿// Dictionary.cpp
+// In-place lookup over a dictionary blob - see Dictionary.h
+
+#include "../include/Dictionary.h"
+
+bool Dictionary::Attach(const void* pBlob, size_t cbBlob)
+{
+    _pHeader = nullptr;
+    _pUnits = nullptr;
+    _pTails = nullptr;
+    _pSymbols = nullptr;
+
+    if (pBlob == nullptr || cbBlob < sizeof(DictionaryHeader) || ((uintptr_t)pBlob & 3) != 0)
+        return false;
+
+    const DictionaryHeader* pHeader = (const DictionaryHeader*)pBlob;
+    if (pHeader->magic != c_dictionaryMagic ||
+        pHeader->version != c_dictionaryVersion ||
+        pHeader->symbolCount < 2 || pHeader->symbolCount > c_dictionaryUnitRange ||
+        pHeader->unitCount == 0 || pHeader->unitCount > c_dictionaryIndexMask ||
+        pHeader->tailCount > c_dictionaryIndexMask ||
+        (cbBlob - sizeof(DictionaryHeader)) / sizeof(DictionaryUnit) < pHeader->unitCount ||
+        (cbBlob - sizeof(DictionaryHeader) - pHeader->unitCount * sizeof(DictionaryUnit)) / sizeof(DictionaryTail) < pHeader->tailCount ||
+        cbBlob - sizeof(DictionaryHeader) - pHeader->unitCount * sizeof(DictionaryUnit) - pHeader->tailCount * sizeof(DictionaryTail) <
+            pHeader->tailSymbolCount)
+    {
+        return false;
+    }
+
+    _pHeader = pHeader;
+    _pUnits = (const DictionaryUnit*)(pHeader + 1);
+    _pTails = (const DictionaryTail*)(_pUnits + pHeader->unitCount);
+    _pSymbols = (const uint8_t*)(_pTails + pHeader->tailCount);
+    return true;
+}
+
+size_t Dictionary::BlobSize() const
+{
+    return _pHeader ? sizeof(DictionaryHeader) + _pHeader->unitCount * sizeof(DictionaryUnit) +
+        _pHeader->tailCount * sizeof(DictionaryTail) + _pHeader->tailSymbolCount : 0;
+}
+
+int32_t Dictionary::Walk(int32_t state, const char16_t* pch, size_t cch) const
+{
+    if (!_pHeader)
+        return -1;
+
+    for (size_t i = 0; i < cch && state >= 0; i++)
+    {
+        size_t offset = (size_t)(pch[i] - c_dictionaryFirstUnit);
+        if (pch[i] < c_dictionaryFirstUnit || offset >= c_dictionaryUnitRange)
+            return -1;
+
+        uint8_t symbol = _pHeader->symbolOf[offset];
+        if (symbol == c_dictionaryEndSymbol)
+            return -1;
+
+        // Inside a tail there is one way on
+        if (state >= c_dictionaryTailState || _pUnits[state].Info() == c_dictionaryTailInfo)
+        {
+            int32_t next = FirstChild(state);
+            state = (next >= 0 && Symbol(next) == symbol) ? next : -1;
+        }
+        else
+        {
+            state = _Child(state, symbol);
+        }
+    }
+
+    return state;
+}
+
+uint32_t Dictionary::WordFrequency(int32_t state) const
+{
+    if (!_pHeader || state < 0)
+        return 0;
+
+    if (state >= c_dictionaryTailState || _pUnits[state].Info() == c_dictionaryTailInfo)
+    {
+        int32_t next = FirstChild(state);
+        return (next >= 0 && IsWordEnd(next)) ? MaxFrequency(next) : 0;
+    }
+
+    int32_t end = _Child(state, c_dictionaryEndSymbol);
+    return (end >= 0) ? _pUnits[end].base : 0;
+}
+
+size_t Dictionary::Complete(const char16_t* pchPrefix, size_t cchPrefix,
+    DictionaryMatch* pMatches, size_t cMatchesMax,
+    char16_t* pchText, size_t cchTextMax) const
+{
+    if (cchPrefix >= c_dictionaryMaxWord || cMatchesMax == 0)
+        return 0;
+
+    int32_t state = Walk(c_root, pchPrefix, cchPrefix);
+    if (state < 0)
+        return 0;
+
+    char16_t word[c_dictionaryMaxWord];
+    for (size_t i = 0; i < cchPrefix; i++)
+        word[i] = pchPrefix[i];
+
+    size_t cMatches = 0;
+    size_t cchUsed = 0;
+    size_t cVisits = 0;
+
+    // Records word[0..cchWord); false when the text does not fit
+    auto addMatch = [&](size_t cchWord, uint32_t frequency)
+    {
+        if (cchUsed + cchWord > cchTextMax)
+            return false;
+
+        DictionaryMatch& match = pMatches[cMatches++];
+        match.frequency = frequency;
+        match.ichWord = (uint16_t)cchUsed;
+        match.cchWord = (uint16_t)cchWord;
+        for (size_t i = 0; i < cchWord; i++)
+            pchText[cchUsed++] = word[i];
+        return true;
+    };
+
+    // Below a tail there is one word: the rest of it is the tail's symbols
+    auto addTail = [&](int32_t tailState, size_t cchWord)
+    {
+        const DictionaryTail& tail = _pTails[_pUnits[_TailSlot(tailState)].Base()];
+        const uint8_t* pSymbol = _pSymbols + tail.iSymbol + (tailState & _TailOffsetMask()) - 1;
+        for (; *pSymbol != c_dictionaryEndSymbol && cchWord < c_dictionaryMaxWord; pSymbol++, cVisits++)
+            word[cchWord++] = _pHeader->unitOf[*pSymbol];
+        return (*pSymbol == c_dictionaryEndSymbol) ? addMatch(cchWord, tail.frequency) : true;
+    };
+
+    if (state >= c_dictionaryTailState || _pUnits[state].Info() == c_dictionaryTailInfo)
+    {
+        addTail(FirstChild(state), cchPrefix);
+        return cMatches;
+    }
+
+    // Depth-first in symbol order over the slots. Each stack entry is the
+    // state and the symbol of the child to look for next.
+    struct Frame
+    {
+        int32_t state;
+        uint32_t nextSymbol;
+    };
+    Frame stack[c_dictionaryMaxWord];
+
+    size_t depth = 0;
+    stack[0] = { state, c_dictionaryEndSymbol };
+
+    while (cMatches < cMatchesMax && cVisits < c_dictionaryVisitLimit)
+    {
+        Frame& frame = stack[depth];
+        int32_t child = _NextChild(frame.state, frame.nextSymbol);
+        if (child < 0)
+        {
+            if (depth == 0)
+                break;
+            depth--;
+            continue;
+        }
+
+        cVisits++;
+        uint8_t symbol = (uint8_t)(child - _pUnits[frame.state].Base());
+        frame.nextSymbol = symbol + 1u;
+
+        size_t cchWord = cchPrefix + depth;
+        if (symbol == c_dictionaryEndSymbol)
+        {
+            if (!addMatch(cchWord, _pUnits[child].base))
+                break;
+        }
+        else if (cchWord < c_dictionaryMaxWord && depth + 1 < c_dictionaryMaxWord)
+        {
+            word[cchWord] = _pHeader->unitOf[symbol];
+            if (_pUnits[child].Info() == c_dictionaryTailInfo)
+            {
+                if (!addTail(_TailState(child, 1), cchWord + 1))
+                    break;
+            }
+            else
+            {
+                depth++;
+                stack[depth] = { child, c_dictionaryEndSymbol };
+            }
+        }
+    }
+
+    return cMatches;
+}
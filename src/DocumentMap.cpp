@@ -0,0 +1,150 @@
+﻿// DocumentMap.cpp
+// Per-document engine state table - see DocumentMap.h
+
+#include "../include/DocumentMap.h"
+
+static_assert((c_documentMapInline & (c_documentMapInline - 1)) == 0, "inline table must be a power of two");
+
+static unsigned Log2(size_t n)
+{
+    unsigned log = 0;
+    while (((size_t)1 << log) < n)
+        log++;
+    return log;
+}
+
+DocumentMap::DocumentMap()
+{
+    _pSlots = _inlineSlots;
+    _mask = c_documentMapInline - 1;
+    _shift = 64 - Log2(c_documentMapInline);
+    _cEntries = 0;
+
+    for (size_t i = 0; i < c_documentMapInline; i++)
+        _inlineSlots[i].pDocument = nullptr;
+}
+
+DocumentMap::~DocumentMap()
+{
+    if (_pSlots != _inlineSlots)
+        delete[] _pSlots;
+}
+
+DocumentState* DocumentMap::Find(const void* pDocument)
+{
+    if (pDocument == nullptr)
+        return nullptr;
+
+    for (size_t i = _Home(pDocument); ; i = (i + 1) & _mask)
+    {
+        if (_pSlots[i].pDocument == pDocument)
+            return &_pSlots[i].state;
+        if (_pSlots[i].pDocument == nullptr)
+            return nullptr;
+    }
+}
+
+DocumentState* DocumentMap::Insert(const void* pDocument)
+{
+    if (pDocument == nullptr)
+        return nullptr;
+
+    DocumentState* pState = Find(pDocument);
+    if (pState != nullptr)
+        return pState;
+
+    // At most three quarters full, so every probe run ends at a free slot
+    if ((_cEntries + 1) * 4 > Capacity() * 3 && !_Grow())
+        return nullptr;
+
+    size_t i = _Home(pDocument);
+    while (_pSlots[i].pDocument != nullptr)
+        i = (i + 1) & _mask;
+
+    _pSlots[i].pDocument = pDocument;
+    _pSlots[i].state = DocumentState();
+    _pSlots[i].state.fSaved = false;
+    _cEntries++;
+    return &_pSlots[i].state;
+}
+
+void DocumentMap::Remove(const void* pDocument)
+{
+    if (pDocument == nullptr)
+        return;
+
+    size_t i = _Home(pDocument);
+    while (_pSlots[i].pDocument != pDocument)
+    {
+        if (_pSlots[i].pDocument == nullptr)
+            return;
+        i = (i + 1) & _mask;
+    }
+
+    // Pull back every later entry of the run that may sit in the hole: one
+    // whose home is not in (hole, j]
+    size_t j = i;
+    for (;;)
+    {
+        j = (j + 1) & _mask;
+        if (_pSlots[j].pDocument == nullptr)
+            break;
+
+        size_t home = _Home(_pSlots[j].pDocument);
+        bool fStays = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+        if (!fStays)
+        {
+            _pSlots[i] = _pSlots[j];
+            i = j;
+        }
+    }
+
+    _pSlots[i].pDocument = nullptr;
+    _cEntries--;
+}
+
+void DocumentMap::Clear()
+{
+    if (_pSlots != _inlineSlots)
+    {
+        delete[] _pSlots;
+        _pSlots = _inlineSlots;
+        _mask = c_documentMapInline - 1;
+        _shift = 64 - Log2(c_documentMapInline);
+    }
+
+    for (size_t i = 0; i < c_documentMapInline; i++)
+        _inlineSlots[i].pDocument = nullptr;
+    _cEntries = 0;
+}
+
+bool DocumentMap::_Grow()
+{
+    size_t cSlots = Capacity() * 2;
+    Slot* pSlots = new Slot[cSlots];
+    if (pSlots == nullptr)
+        return false;
+    for (size_t i = 0; i < cSlots; i++)
+        pSlots[i].pDocument = nullptr;
+
+    Slot* pOldSlots = _pSlots;
+    size_t cOldSlots = Capacity();
+    _pSlots = pSlots;
+    _mask = cSlots - 1;
+    _shift = 64 - Log2(cSlots);
+
+    for (size_t iOld = 0; iOld < cOldSlots; iOld++)
+    {
+        if (pOldSlots[iOld].pDocument == nullptr)
+            continue;
+
+        size_t i = _Home(pOldSlots[iOld].pDocument);
+        while (_pSlots[i].pDocument != nullptr)
+            i = (i + 1) & _mask;
+        _pSlots[i] = pOldSlots[iOld];
+    }
+
+    if (pOldSlots != _inlineSlots)
+        delete[] pOldSlots;
+    return true;
+}
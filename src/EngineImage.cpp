@@ -0,0 +1,119 @@
+﻿// EngineImage.cpp
+// Engine image layout and validation - see EngineImage.h
+
+#include "../include/EngineImage.h"
+
+#include <cstring>
+
+static size_t AlignUp(size_t cb, size_t align)
+{
+    return (cb + align - 1) & ~(align - 1);
+}
+
+size_t WriteEngineImage(void* pvImage, size_t cbImageMax, const void* pvDictionary, size_t cbDictionary)
+{
+    EngineImageHeader header = {};
+    header.magic = c_engineImageMagic;
+    header.version = c_engineImageVersion;
+    header.sectionCount = EngineImageSectionCount;
+
+    size_t cbSections[EngineImageSectionCount] =
+    {
+        LayoutCount * sizeof(KeyMapTables),
+        sizeof(TamilSyllableMatrix),
+        cbDictionary,
+    };
+
+    size_t offset = AlignUp(sizeof(header), c_engineImageAlign);
+    for (size_t i = 0; i < EngineImageSectionCount; i++)
+    {
+        header.sections[i].offset = (uint32_t)offset;
+        header.sections[i].cb = (uint32_t)cbSections[i];
+        offset = AlignUp(offset + cbSections[i], c_engineImageAlign);
+    }
+
+    // Whole pages, so nothing else shares the image's last page
+    size_t cbImage = AlignUp(offset, c_engineImagePage);
+    header.cbImage = (uint32_t)cbImage;
+    if (pvImage == nullptr)
+        return cbImage;
+    if (cbImage > cbImageMax || cbImage > UINT32_MAX)
+        return 0;
+
+    uint8_t* pbImage = (uint8_t*)pvImage;
+    memset(pbImage, 0, cbImage);
+    memcpy(pbImage, &header, sizeof(header));
+
+    KeyMapTables* pKeyMaps = (KeyMapTables*)(pbImage + header.sections[EngineImageKeyMaps].offset);
+    for (size_t i = 0; i < LayoutCount; i++)
+        pKeyMaps[i] = *g_layouts[i].keyMap;
+
+    memcpy(pbImage + header.sections[EngineImageSyllables].offset, &c_tamilSyllables, sizeof(TamilSyllableMatrix));
+    memcpy(pbImage + header.sections[EngineImageDictionary].offset, pvDictionary, cbDictionary);
+    return cbImage;
+}
+
+bool EngineImage::Attach(const void* pvImage, size_t cbImage)
+{
+    _pbImage = nullptr;
+    _cbImage = 0;
+    _pKeyMaps = nullptr;
+    _pSyllables = nullptr;
+    _dictionary = Dictionary();
+
+    if (pvImage == nullptr || cbImage < sizeof(EngineImageHeader) || ((uintptr_t)pvImage & (c_engineImageAlign - 1)) != 0)
+        return false;
+
+    const EngineImageHeader* pHeader = (const EngineImageHeader*)pvImage;
+    if (pHeader->magic != c_engineImageMagic ||
+        pHeader->version != c_engineImageVersion ||
+        pHeader->sectionCount != EngineImageSectionCount ||
+        pHeader->cbImage > cbImage)
+    {
+        return false;
+    }
+
+    // Every section inside the image and aligned; the fixed ones their exact size
+    for (size_t i = 0; i < EngineImageSectionCount; i++)
+    {
+        const EngineImageSection& section = pHeader->sections[i];
+        if (section.offset < sizeof(EngineImageHeader) ||
+            section.offset % c_engineImageAlign != 0 ||
+            section.offset > pHeader->cbImage ||
+            section.cb > pHeader->cbImage - section.offset)
+        {
+            return false;
+        }
+    }
+
+    if (pHeader->sections[EngineImageKeyMaps].cb != LayoutCount * sizeof(KeyMapTables) ||
+        pHeader->sections[EngineImageSyllables].cb != sizeof(TamilSyllableMatrix))
+    {
+        return false;
+    }
+
+    const uint8_t* pbImage = (const uint8_t*)pvImage;
+    const EngineImageSection& dictionary = pHeader->sections[EngineImageDictionary];
+    if (!_dictionary.Attach(pbImage + dictionary.offset, dictionary.cb))
+        return false;
+
+    _pbImage = pbImage;
+    _cbImage = pHeader->cbImage;
+    _pKeyMaps = (const KeyMapTables*)(pbImage + pHeader->sections[EngineImageKeyMaps].offset);
+    _pSyllables = (const TamilSyllableMatrix*)(pbImage + pHeader->sections[EngineImageSyllables].offset);
+    return true;
+}
+
+bool EngineImage::MatchesSources() const
+{
+    if (!IsAttached())
+        return false;
+
+    for (size_t i = 0; i < LayoutCount; i++)
+    {
+        if (memcmp(&_pKeyMaps[i], g_layouts[i].keyMap, sizeof(KeyMapTables)) != 0)
+            return false;
+    }
+
+    return memcmp(_pSyllables, &c_tamilSyllables, sizeof(TamilSyllableMatrix)) == 0;
+}
@@ -0,0 +1,524 @@
+﻿// EngineImageData.cpp
+// Embedded engine image - 4 layouts, 172 words, 16384 bytes.
+// Generated by tools/ImageBuild.cpp - do not edit.
+
+#include "../include/EngineImage.h"
+
+// Page-aligned and whole pages long: no other data shares these pages
+alignas(c_engineImagePage) const uint32_t g_engineImage[] =
+{
+    0x4D494541, 0x00030001, 0x00004000, 0x00000000, 0x00000040, 0x00001E00, 0x00001E40, 0x00000630,
+    0x00002480, 0x0000109A, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x0B850000, 0x0B920B99, 0x0B8A0B89, 0x0B8E0BCD, 0x0BA90B95, 0x0BAE0BAA, 0x0BB00BA4, 0x0B9F0BB2,
+    0x0B860BA3, 0x0B870B90, 0x0BB10B8F, 0x0B880BB5, 0x0BB30B93, 0x00000B94, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000BA8, 0x00000000, 0x0BB40000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0B9A0000, 0x0B9E0000, 0x00000BAF,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x0B9C0000, 0x00000B83, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x0BB80000, 0x00000BB9, 0x0000E000, 0x0BB70000, 0xE0010000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x0BE70BE6, 0x0BE90BE8, 0x0BEB0BEA, 0x0BED0BEC, 0x0BEF0BEE, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x0BCD0B95, 0x00000BB7, 0x00000000, 0x0BCD0BB8, 0x0BC00BB0, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00610000, 0x00630062, 0x00650064, 0x00670066, 0x00690068, 0x006B006A, 0x006D006C, 0x006F006E,
+    0x00710070, 0x00730072, 0x00750074, 0x00770076, 0x00790078, 0x0000007A, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00410000, 0x00630062, 0x00450064, 0x00670066, 0x00490068, 0x006B006A, 0x006D004C, 0x004F004E,
+    0x00710070, 0x00530052, 0x00550054, 0x00770076, 0x00790078, 0x0000007A, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x0BE70BE6, 0x0BE90BE8, 0x0BEB0BEA, 0x0BED0BEC, 0x0BEF0BEE, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x0BAF0000, 0x0B890000, 0x0BA80BA9, 0x0BAA0B95, 0x0BC80BBE, 0x0BAE0BA4, 0x0B850B9F, 0x0BB40BC6,
+    0x0B990BBF, 0x0BB30B9A, 0x0BB00BB5, 0x0BB10B8E, 0x0BB20B92, 0x00000BA3, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0BB90BCD, 0x00000B87, 0x0B830000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0B9C0000, 0x0BB80BB7, 0x0000E010,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0xE0000000, 0x0B8A0000, 0xE002E001, 0xE004E003, 0x0B900000, 0xE006E005, 0x0B86E007, 0xE0080BC7,
+    0x0B9E0BC0, 0xE00AE009, 0xE00CE00B, 0xE00D0B8F, 0xE00E0B93, 0x0000E00F, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000B88, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0BC10000, 0x0BC20000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x0BC10BAF, 0x00000000, 0x00000000, 0x0BC10BA9, 0x00000000, 0x00000000, 0x0BC10BA8, 0x00000000,
+    0x00000000, 0x0BC10B95, 0x00000000, 0x00000000, 0x0BC10BAA, 0x00000000, 0x00000000, 0x0BC10BA4,
+    0x00000000, 0x00000000, 0x0BC10BAE, 0x00000000, 0x00000000, 0x0BC10B9F, 0x00000000, 0x00000000,
+    0x0BC10BB4, 0x00000000, 0x00000000, 0x0BC10B9A, 0x00000000, 0x00000000, 0x0BC10BB3, 0x00000000,
+    0x00000000, 0x0BC10BB5, 0x00000000, 0x00000000, 0x0BC10BB0, 0x00000000, 0x00000000, 0x0BC10BB1,
+    0x00000000, 0x00000000, 0x0BC10BB2, 0x00000000, 0x00000000, 0x0BC10BA3, 0x00000000, 0x00000000,
+    0x0BCD0BB8, 0x0BC00BB0, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x0BAF0000, 0x0B890000, 0x0BA80BA9, 0x0BAA0B95, 0x0BC80BBE, 0x0BAE0BA4, 0x0B850B9F, 0x0BB40BC6,
+    0x0B990BBF, 0x0BB30B9A, 0x0BB00BB5, 0x0BB10B8E, 0x0BB20B92, 0x00000BA3, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000BCD, 0x00000B87, 0x0B830000,
+    0x00000BB9, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0B9C0000, 0x0BB80BB7, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0xE0000000, 0x0B8A0000, 0xE002E001, 0xE004E003, 0x0B900000, 0xE006E005, 0x0B86E007, 0xE0080BC7,
+    0x0B9E0BC0, 0xE00AE009, 0xE00CE00B, 0xE00D0B8F, 0xE00E0B93, 0x0000E00F, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000B88, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0BC10000, 0x0BC20000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x0BC10BAF, 0x00000000, 0x00000000, 0x0BC10BA9, 0x00000000, 0x00000000, 0x0BC10BA8, 0x00000000,
+    0x00000000, 0x0BC10B95, 0x00000000, 0x00000000, 0x0BC10BAA, 0x00000000, 0x00000000, 0x0BC10BA4,
+    0x00000000, 0x00000000, 0x0BC10BAE, 0x00000000, 0x00000000, 0x0BC10B9F, 0x00000000, 0x00000000,
+    0x0BC10BB4, 0x00000000, 0x00000000, 0x0BC10B9A, 0x00000000, 0x00000000, 0x0BC10BB3, 0x00000000,
+    0x00000000, 0x0BC10BB5, 0x00000000, 0x00000000, 0x0BC10BB0, 0x00000000, 0x00000000, 0x0BC10BB1,
+    0x00000000, 0x00000000, 0x0BC10BB2, 0x00000000, 0x00000000, 0x0BC10BA3, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000B95, 0x0B950001, 0x00020BBE, 0x0BBF0B95, 0x0B950002, 0x00020BC0, 0x0BC10B95, 0x0B950002,
+    0x00020BC2, 0x0BC60B95, 0x0B950002, 0x00020BC7, 0x0BC80B95, 0x0B950002, 0x00020BCA, 0x0BCB0B95,
+    0x0B950002, 0x00020BCC, 0x00000B99, 0x0B990001, 0x00020BBE, 0x0BBF0B99, 0x0B990002, 0x00020BC0,
+    0x0BC10B99, 0x0B990002, 0x00020BC2, 0x0BC60B99, 0x0B990002, 0x00020BC7, 0x0BC80B99, 0x0B990002,
+    0x00020BCA, 0x0BCB0B99, 0x0B990002, 0x00020BCC, 0x00000B9A, 0x0B9A0001, 0x00020BBE, 0x0BBF0B9A,
+    0x0B9A0002, 0x00020BC0, 0x0BC10B9A, 0x0B9A0002, 0x00020BC2, 0x0BC60B9A, 0x0B9A0002, 0x00020BC7,
+    0x0BC80B9A, 0x0B9A0002, 0x00020BCA, 0x0BCB0B9A, 0x0B9A0002, 0x00020BCC, 0x00000B9E, 0x0B9E0001,
+    0x00020BBE, 0x0BBF0B9E, 0x0B9E0002, 0x00020BC0, 0x0BC10B9E, 0x0B9E0002, 0x00020BC2, 0x0BC60B9E,
+    0x0B9E0002, 0x00020BC7, 0x0BC80B9E, 0x0B9E0002, 0x00020BCA, 0x0BCB0B9E, 0x0B9E0002, 0x00020BCC,
+    0x00000B9F, 0x0B9F0001, 0x00020BBE, 0x0BBF0B9F, 0x0B9F0002, 0x00020BC0, 0x0BC10B9F, 0x0B9F0002,
+    0x00020BC2, 0x0BC60B9F, 0x0B9F0002, 0x00020BC7, 0x0BC80B9F, 0x0B9F0002, 0x00020BCA, 0x0BCB0B9F,
+    0x0B9F0002, 0x00020BCC, 0x00000BA3, 0x0BA30001, 0x00020BBE, 0x0BBF0BA3, 0x0BA30002, 0x00020BC0,
+    0x0BC10BA3, 0x0BA30002, 0x00020BC2, 0x0BC60BA3, 0x0BA30002, 0x00020BC7, 0x0BC80BA3, 0x0BA30002,
+    0x00020BCA, 0x0BCB0BA3, 0x0BA30002, 0x00020BCC, 0x00000BA4, 0x0BA40001, 0x00020BBE, 0x0BBF0BA4,
+    0x0BA40002, 0x00020BC0, 0x0BC10BA4, 0x0BA40002, 0x00020BC2, 0x0BC60BA4, 0x0BA40002, 0x00020BC7,
+    0x0BC80BA4, 0x0BA40002, 0x00020BCA, 0x0BCB0BA4, 0x0BA40002, 0x00020BCC, 0x00000BA8, 0x0BA80001,
+    0x00020BBE, 0x0BBF0BA8, 0x0BA80002, 0x00020BC0, 0x0BC10BA8, 0x0BA80002, 0x00020BC2, 0x0BC60BA8,
+    0x0BA80002, 0x00020BC7, 0x0BC80BA8, 0x0BA80002, 0x00020BCA, 0x0BCB0BA8, 0x0BA80002, 0x00020BCC,
+    0x00000BAA, 0x0BAA0001, 0x00020BBE, 0x0BBF0BAA, 0x0BAA0002, 0x00020BC0, 0x0BC10BAA, 0x0BAA0002,
+    0x00020BC2, 0x0BC60BAA, 0x0BAA0002, 0x00020BC7, 0x0BC80BAA, 0x0BAA0002, 0x00020BCA, 0x0BCB0BAA,
+    0x0BAA0002, 0x00020BCC, 0x00000BAE, 0x0BAE0001, 0x00020BBE, 0x0BBF0BAE, 0x0BAE0002, 0x00020BC0,
+    0x0BC10BAE, 0x0BAE0002, 0x00020BC2, 0x0BC60BAE, 0x0BAE0002, 0x00020BC7, 0x0BC80BAE, 0x0BAE0002,
+    0x00020BCA, 0x0BCB0BAE, 0x0BAE0002, 0x00020BCC, 0x00000BAF, 0x0BAF0001, 0x00020BBE, 0x0BBF0BAF,
+    0x0BAF0002, 0x00020BC0, 0x0BC10BAF, 0x0BAF0002, 0x00020BC2, 0x0BC60BAF, 0x0BAF0002, 0x00020BC7,
+    0x0BC80BAF, 0x0BAF0002, 0x00020BCA, 0x0BCB0BAF, 0x0BAF0002, 0x00020BCC, 0x00000BB0, 0x0BB00001,
+    0x00020BBE, 0x0BBF0BB0, 0x0BB00002, 0x00020BC0, 0x0BC10BB0, 0x0BB00002, 0x00020BC2, 0x0BC60BB0,
+    0x0BB00002, 0x00020BC7, 0x0BC80BB0, 0x0BB00002, 0x00020BCA, 0x0BCB0BB0, 0x0BB00002, 0x00020BCC,
+    0x00000BB2, 0x0BB20001, 0x00020BBE, 0x0BBF0BB2, 0x0BB20002, 0x00020BC0, 0x0BC10BB2, 0x0BB20002,
+    0x00020BC2, 0x0BC60BB2, 0x0BB20002, 0x00020BC7, 0x0BC80BB2, 0x0BB20002, 0x00020BCA, 0x0BCB0BB2,
+    0x0BB20002, 0x00020BCC, 0x00000BB5, 0x0BB50001, 0x00020BBE, 0x0BBF0BB5, 0x0BB50002, 0x00020BC0,
+    0x0BC10BB5, 0x0BB50002, 0x00020BC2, 0x0BC60BB5, 0x0BB50002, 0x00020BC7, 0x0BC80BB5, 0x0BB50002,
+    0x00020BCA, 0x0BCB0BB5, 0x0BB50002, 0x00020BCC, 0x00000BB4, 0x0BB40001, 0x00020BBE, 0x0BBF0BB4,
+    0x0BB40002, 0x00020BC0, 0x0BC10BB4, 0x0BB40002, 0x00020BC2, 0x0BC60BB4, 0x0BB40002, 0x00020BC7,
+    0x0BC80BB4, 0x0BB40002, 0x00020BCA, 0x0BCB0BB4, 0x0BB40002, 0x00020BCC, 0x00000BB3, 0x0BB30001,
+    0x00020BBE, 0x0BBF0BB3, 0x0BB30002, 0x00020BC0, 0x0BC10BB3, 0x0BB30002, 0x00020BC2, 0x0BC60BB3,
+    0x0BB30002, 0x00020BC7, 0x0BC80BB3, 0x0BB30002, 0x00020BCA, 0x0BCB0BB3, 0x0BB30002, 0x00020BCC,
+    0x00000BB1, 0x0BB10001, 0x00020BBE, 0x0BBF0BB1, 0x0BB10002, 0x00020BC0, 0x0BC10BB1, 0x0BB10002,
+    0x00020BC2, 0x0BC60BB1, 0x0BB10002, 0x00020BC7, 0x0BC80BB1, 0x0BB10002, 0x00020BCA, 0x0BCB0BB1,
+    0x0BB10002, 0x00020BCC, 0x00000BA9, 0x0BA90001, 0x00020BBE, 0x0BBF0BA9, 0x0BA90002, 0x00020BC0,
+    0x0BC10BA9, 0x0BA90002, 0x00020BC2, 0x0BC60BA9, 0x0BA90002, 0x00020BC7, 0x0BC80BA9, 0x0BA90002,
+    0x00020BCA, 0x0BCB0BA9, 0x0BA90002, 0x00020BCC, 0x00000B9C, 0x0B9C0001, 0x00020BBE, 0x0BBF0B9C,
+    0x0B9C0002, 0x00020BC0, 0x0BC10B9C, 0x0B9C0002, 0x00020BC2, 0x0BC60B9C, 0x0B9C0002, 0x00020BC7,
+    0x0BC80B9C, 0x0B9C0002, 0x00020BCA, 0x0BCB0B9C, 0x0B9C0002, 0x00020BCC, 0x00000BB7, 0x0BB70001,
+    0x00020BBE, 0x0BBF0BB7, 0x0BB70002, 0x00020BC0, 0x0BC10BB7, 0x0BB70002, 0x00020BC2, 0x0BC60BB7,
+    0x0BB70002, 0x00020BC7, 0x0BC80BB7, 0x0BB70002, 0x00020BCA, 0x0BCB0BB7, 0x0BB70002, 0x00020BCC,
+    0x00000BB8, 0x0BB80001, 0x00020BBE, 0x0BBF0BB8, 0x0BB80002, 0x00020BC0, 0x0BC10BB8, 0x0BB80002,
+    0x00020BC2, 0x0BC60BB8, 0x0BB80002, 0x00020BC7, 0x0BC80BB8, 0x0BB80002, 0x00020BCA, 0x0BCB0BB8,
+    0x0BB80002, 0x00020BCC, 0x00000BB9, 0x0BB90001, 0x00020BBE, 0x0BBF0BB9, 0x0BB90002, 0x00020BC0,
+    0x0BC10BB9, 0x0BB90002, 0x00020BC2, 0x0BC60BB9, 0x0BB90002, 0x00020BC7, 0x0BC80BB9, 0x0BB90002,
+    0x00020BCA, 0x0BCB0BB9, 0x0BB90002, 0x00020BCC, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x43494441, 0x00240003, 0x000000AC, 0x00000124, 0x0000009B, 0x0000010A, 0x00000000, 0x03020100,
+    0x00050400, 0x00060000, 0x00070000, 0x00000800, 0x000A0900, 0x0B000000, 0x0C000000, 0x0000000D,
+    0x00100F0E, 0x12110000, 0x16151413, 0x00001817, 0x00000000, 0x1A190000, 0x001D1C1B, 0x1F1E0000,
+    0x22210020, 0x00002300, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0B850000, 0x0B870B86,
+    0x0B8A0B89, 0x0B920B8E, 0x0B990B95, 0x0B9F0B9A, 0x0BA40BA3, 0x0BA90BA8, 0x0BAE0BAA, 0x0BB00BAF,
+    0x0BB20BB1, 0x0BB40BB3, 0x0BBE0BB5, 0x0BC00BBF, 0x0BC20BC1, 0x0BC70BC6, 0x0BCA0BC8, 0x0BCD0BCB,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xC9000001, 0x10000000,
+    0x00000000, 0x00FFFFFF, 0x6500000E, 0x10000000, 0x7E000009, 0x0C000000, 0x8B00001D, 0x10000000,
+    0xD0000028, 0x0F000000, 0xFF000000, 0xFF000000, 0xA400002C, 0x10000000, 0xFF000001, 0xFF000000,
+    0xB000002D, 0x0C000000, 0x00000000, 0x00FFFFFF, 0x97000037, 0x08000000, 0x00000000, 0x00FFFFFF,
+    0x00000000, 0x00FFFFFF, 0xDC00004A, 0x0D000000, 0x0E000054, 0x10000000, 0x00000000, 0x00FFFFFF,
+    0xB7000069, 0x0F000000, 0x33000081, 0x10000000, 0xFF000009, 0xFF000003, 0xFF000002, 0xFF000000,
+    0xFF00000A, 0xFF000003, 0xFF000003, 0xFF000002, 0x00000000, 0x00FFFFFF, 0x00000000, 0x00FFFFFF,
+    0x6C000080, 0x0F000000, 0xFF000004, 0xFF000002, 0xFF000005, 0xFF000002, 0xFF000006, 0xFF000002,
+    0x2D000001, 0x09000002, 0xFF000007, 0xFF000002, 0xFF000008, 0xFF000002, 0x00000000, 0x00FFFFFF,
+    0xAA000023, 0x05000002, 0x00000000, 0x00FFFFFF, 0x00000000, 0x00FFFFFF, 0x2D000081, 0x0900001D,
+    0x70000026, 0x03000002, 0x65000031, 0x10000002, 0xFF00000B, 0xFF000004, 0xFF00000C, 0xFF000004,
+    0xFF00000D, 0xFF000004, 0xFF00000E, 0xFF000004, 0xFF00000F, 0xFF000004, 0xFF000010, 0xFF000004,
+    0xAA0000B0, 0x05000021, 0x700000B4, 0x03000025, 0x850000CA, 0x0B000049, 0x72000042, 0x0A000004,
+    0xFF000012, 0xFF000005, 0xFF000011, 0xFF000004, 0xFF000013, 0xFF000005, 0x7E000027, 0x08000005,
+    0xFF000017, 0xFF000007, 0xAC0000B6, 0x0300004C, 0xFF000014, 0xFF000005, 0xE2000050, 0x08000009,
+    0x58000043, 0x02000009, 0xFF00001A, 0xFF000009, 0xA40000A1, 0x10000007, 0x460000B8, 0x05000055,
+    0xFF000015, 0xFF000005, 0xFF000016, 0xFF000005, 0xFF00003E, 0xFF000034, 0xFF00003B, 0xFF000026,
+    0xFF000018, 0xFF000007, 0xFF00001B, 0xFF000009, 0xFF000019, 0xFF000007, 0x650000A6, 0x10000026,
+    0xFF00001C, 0xFF000009, 0xBD00004D, 0x0A000009, 0xFF00003C, 0xFF000026, 0xFF00001D, 0xFF000009,
+    0x85000018, 0x0B000009, 0xFF00003F, 0xFF000034, 0x530000CD, 0x0B000060, 0xAC000020, 0x03000009,
+    0x1C000057, 0x02000009, 0xFF00001E, 0xFF000009, 0xFF00001F, 0xFF000009, 0x97000062, 0x0800000B,
+    0xFF000020, 0xFF00000B, 0x080000CD, 0x0700006E, 0xFF000023, 0xFF00000E, 0xFF000021, 0xFF00000B,
+    0x4600002A, 0x0500000B, 0xFF000024, 0xFF00000E, 0x000001A4, 0x0000004D, 0x5E00006C, 0x0100000B,
+    0xFF000022, 0xFF00000B, 0xFF00003D, 0xFF000030, 0xDC000089, 0x0D00000E, 0xFF000028, 0xFF00000F,
+    0xFF000044, 0xFF000039, 0xE60000C6, 0x00000030, 0xFF000025, 0xFF00000E, 0x53000028, 0x0B00000F,
+    0xFF000046, 0xFF000046, 0xBD0000C1, 0x0A000046, 0xFF000029, 0xFF00000F, 0xFF000026, 0xFF00000E,
+    0xFF000041, 0xFF000038, 0xFF000045, 0xFF000039, 0xFF000047, 0xFF00004D, 0xFF000042, 0xFF000038,
+    0xFF00002A, 0xFF00000F, 0xE20000CA, 0x0C00007F, 0xFF000027, 0xFF00000E, 0x00001CE8, 0x0000007E,
+    0x0E00009C, 0x1000000F, 0x0800003D, 0x0700000F, 0xEF0000A6, 0x0E00000F, 0xFF000043, 0xFF000038,
+    0xFF00002B, 0xFF000011, 0xFF000048, 0xFF000050, 0x27000065, 0x0A00000F, 0xD4000097, 0x03000011,
+    0xFF00002C, 0xFF000011, 0xFF00002D, 0xFF000011, 0xFF000049, 0xFF000050, 0xFF000052, 0xFF000073,
+    0xFF000053, 0xFF000073, 0xE20000CB, 0x04000085, 0xFF00004A, 0xFF000058, 0x530000CD, 0x0F0000A0,
+    0xFF00002E, 0xFF000011, 0x3A00006C, 0x0F000011, 0xE2000047, 0x0C000011, 0x33000093, 0x08000011,
+    0xFF00004B, 0xFF000058, 0x650000A3, 0x08000011, 0xFF00002F, 0xFF000011, 0x2C0000DD, 0x0100008E,
+    0xE200006D, 0x04000011, 0xFF000030, 0xFF000011, 0xC00000A2, 0x03000011, 0xFF000031, 0xFF000011,
+    0x080000A0, 0x0B000012, 0x140000CF, 0x0D00009B, 0xB70000AA, 0x0F000011, 0xFF000038, 0xFF000019,
+    0xFF000032, 0xFF000012, 0x2C000061, 0x01000019, 0xFF000056, 0xFF00007E, 0x210000AB, 0x0B000012,
+    0x2D0000D0, 0x09000024, 0xFF000039, 0xFF000019, 0xC30000AB, 0x09000019, 0x1A00009F, 0x08000012,
+    0xFF000033, 0xFF000012, 0x00000000, 0x00FFFFFF, 0xFF00003A, 0xFF000019, 0xFF000034, 0xFF000012,
+    0xD60000C0, 0x0A000019, 0x650000B1, 0x0C000012, 0x1400007F, 0x0D000019, 0xFF000035, 0xFF000012,
+    0xE40000B2, 0x02000012, 0xFF000036, 0xFF000012, 0x6C0000BC, 0x0F000019, 0x53000067, 0x0F000012,
+    0x000021FC, 0x0000003B, 0xFF000037, 0xFF000012, 0xDC0000C5, 0x0D00005B, 0xFF000057, 0xFF000080,
+    0xFF00004D, 0xFF00006D, 0x00001BBC, 0x0000006F, 0xFF00004E, 0xFF00006D, 0xFF000054, 0xFF000074,
+    0xFF000040, 0xFF00003B, 0x00000172, 0x0000008B, 0xFF00004F, 0xFF00006D, 0xFF00004C, 0xFF00005B,
+    0xFF000050, 0xFF00006D, 0xFF000059, 0xFF000082, 0xFF000051, 0xFF00006F, 0xFF000063, 0xFF000094,
+    0xFF000055, 0xFF000074, 0x400000BF, 0x0A00006D, 0xFF000058, 0xFF000080, 0xFF00005B, 0xFF000087,
+    0xFF00005C, 0xFF000087, 0x540000C0, 0x01000082, 0xFF00005D, 0xFF00008B, 0xFF00005A, 0xFF000082,
+    0xFF00005E, 0xFF00008B, 0xFF00005F, 0xFF000089, 0x080000DA, 0x02000094, 0xFF000061, 0xFF000090,
+    0x650000D0, 0x0C00009A, 0xFF000064, 0xFF00009A, 0xFF000066, 0xFF00009D, 0x0000017C, 0x00000099,
+    0xFF000067, 0xFF00009D, 0xFF000073, 0xFF000044, 0xFF000060, 0xFF000089, 0xA40000C6, 0x1000003B,
+    0xFF000062, 0xFF000090, 0xFF000065, 0xFF00009A, 0xFF000068, 0xFF000093, 0xFF00006D, 0xFF00009F,
+    0x650000ED, 0x10000044, 0xFF00006F, 0xFF00002D, 0xFF000069, 0xFF000093, 0xFF000070, 0xFF00002D,
+    0xFF000071, 0xFF00002E, 0xE60000CC, 0x0000005E, 0xFF00006A, 0xFF000099, 0xFF000072, 0xFF00002E,
+    0xFF00006E, 0xFF00009F, 0xFF000077, 0xFF000062, 0xFF00006B, 0xFF000099, 0xFF000074, 0xFF00005E,
+    0x010000F1, 0x100000C4, 0xFF000075, 0xFF0000C4, 0xFF00006C, 0xFF000099, 0x850000D0, 0x0B00002F,
+    0xAC0000F4, 0x03000036, 0xFF000076, 0xFF0000C4, 0x460000F6, 0x0500003C, 0xDC0000E4, 0x0D0000A3,
+    0x530000E9, 0x0B00004B, 0xFF00007C, 0xFF000052, 0xFF00007A, 0xFF0000B2, 0xE20000DF, 0x0C00006A,
+    0xFF000078, 0xFF000062, 0xFF00007B, 0xFF0000B2, 0x540000FD, 0x010000B6, 0xFF000079, 0xFF000062,
+    0xFF00007E, 0xFF00007A, 0xFF00007D, 0xFF000052, 0x080000D7, 0x020000BB, 0x650000E8, 0x0C0000BD,
+    0xFF000080, 0xFF00007C, 0x2C0000E6, 0x01000084, 0xFF000082, 0xFF00008A, 0x2D000100, 0x09000091,
+    0x00002328, 0x000000C9, 0xFF00007F, 0xFF00007A, 0xE60000F9, 0x000000CE, 0xFF000081, 0xFF00007C,
+    0x00002008, 0x000000D5, 0xFF000083, 0xFF00008A, 0x850000F5, 0x0B0000D8, 0x0000014A, 0x000000D9,
+    0xFF000084, 0xFF0000C9, 0x00000168, 0x000000DB, 0xFF000088, 0xFF0000DC, 0xFF00008A, 0xFF0000DD,
+    0xE2000106, 0x0C0000E0, 0x08000102, 0x020000E7, 0x650000ED, 0x0C0000E8, 0xFF00008B, 0xFF0000DD,
+    0x00000154, 0x000000E3, 0xFF000089, 0xFF0000DC, 0x2C000102, 0x010000EA, 0x00000A5A, 0x000000EC,
+    0xE60000F8, 0x000000EF, 0x850000F6, 0x0B0000F3, 0x460000EA, 0x050000DB, 0x46000117, 0x05000103,
+    0x00001770, 0x00000107, 0x00001388, 0x000000F9, 0xDC000105, 0x0D0000DC, 0xFF000087, 0xFF0000DB,
+    0xFF00008E, 0xFF000103, 0xFF00008C, 0xFF0000E3, 0xFF00008D, 0xFF0000EC, 0xFF000086, 0xFF0000D9,
+    0xFF000085, 0xFF0000D5, 0xFF000090, 0xFF0000F9, 0x080000FD, 0x020000FA, 0x6500011A, 0x0C0000FB,
+    0xFF000091, 0xFF0000FF, 0xFF000094, 0xFF000101, 0xFF00008F, 0xFF000107, 0xFF000095, 0xFF000101,
+    0xFF000092, 0xFF0000FF, 0x8500011B, 0x0B000102, 0x00000546, 0x00000104, 0xFF000093, 0xFF0000FF,
+    0x08000104, 0x0200010F, 0x00001194, 0x00000110, 0x00000F0A, 0x00000116, 0x0800010D, 0x02000119,
+    0x00000000, 0x00FFFFFF, 0xFF000099, 0xFF00011C, 0xFF000096, 0xFF000104, 0xFF00009A, 0xFF00011C,
+    0x00000000, 0x00FFFFFF, 0xFF000097, 0xFF000110, 0xFF000098, 0xFF000116, 0x000014B4, 0x0000002A,
+    0x00002648, 0x000000A3, 0x0000026C, 0x0000000C, 0x00000FA0, 0x000000F3, 0x00001004, 0x00000086,
+    0x000022C4, 0x000000C8, 0x00001FA4, 0x00000107, 0x00001068, 0x000000EF, 0x000010CC, 0x000000EB,
+    0x000011F8, 0x00000026, 0x00000B54, 0x000000BB, 0x0000041A, 0x0000009D, 0x000002BC, 0x0000006F,
+    0x00000244, 0x00000047, 0x00002134, 0x000000C8, 0x00002454, 0x00000107, 0x00000C1C, 0x0000009F,
+    0x00001E14, 0x0000008B, 0x00001838, 0x00000007, 0x000001E0, 0x00000017, 0x00001964, 0x000000C5,
+    0x00000DDE, 0x0000006E, 0x00001F40, 0x000000F7, 0x000017D4, 0x00000007, 0x00000064, 0x00000039,
+    0x00000136, 0x000000AD, 0x000004B0, 0x0000009D, 0x000012C0, 0x000000D1, 0x0000047E, 0x00000095,
+    0x00000078, 0x00000000, 0x000000AA, 0x000000BA, 0x00000992, 0x0000000C, 0x00000334, 0x00000101,
+    0x0000073A, 0x0000007C, 0x00000898, 0x000000A0, 0x00000F3C, 0x0000009B, 0x00000960, 0x0000001A,
+    0x00000186, 0x0000009D, 0x000003E8, 0x00000053, 0x00000230, 0x000000E4, 0x00001518, 0x00000043,
+    0x00000A8C, 0x000000CD, 0x00000320, 0x000000FA, 0x00000CB2, 0x00000017, 0x0000060E, 0x0000006F,
+    0x00000398, 0x00000012, 0x000000BE, 0x000000CD, 0x00000096, 0x00000088, 0x00000802, 0x00000109,
+    0x00000280, 0x000000A6, 0x000006A4, 0x00000089, 0x00002198, 0x0000002D, 0x0000079E, 0x0000009D,
+    0x00000082, 0x000000B7, 0x000000B4, 0x0000003F, 0x000015E0, 0x000000CA, 0x00000ABE, 0x0000005C,
+    0x00000640, 0x00000017, 0x000002A8, 0x000000E9, 0x00001C84, 0x00000089, 0x00001C20, 0x00000089,
+    0x00000CE4, 0x000000C8, 0x000008FC, 0x000000C8, 0x00000384, 0x0000008F, 0x000019C8, 0x000000C6,
+    0x000007D0, 0x00000089, 0x000009C4, 0x00000003, 0x000002D0, 0x000000E8, 0x00000258, 0x000000DA,
+    0x000001B8, 0x00000109, 0x000006D6, 0x0000009F, 0x0000021C, 0x000000E7, 0x0000092E, 0x000000BF,
+    0x00000294, 0x0000009D, 0x00000104, 0x00000020, 0x0000015E, 0x00000089, 0x00000F6E, 0x000000D7,
+    0x00001A90, 0x00000007, 0x0000157C, 0x000000C8, 0x0000206C, 0x00000089, 0x00001AF4, 0x00000089,
+    0x00001B58, 0x00000007, 0x00000C4E, 0x0000006F, 0x00000BEA, 0x0000009F, 0x000003D4, 0x00000089,
+    0x00000140, 0x00000109, 0x0000125C, 0x00000062, 0x00000866, 0x00000089, 0x000002F8, 0x00000103,
+    0x0000044C, 0x00000017, 0x000008CA, 0x00000089, 0x000003C0, 0x0000002A, 0x00000348, 0x00000102,
+    0x00001EDC, 0x000000C8, 0x0000010E, 0x00000078, 0x000009F6, 0x000000DD, 0x00000E10, 0x00000008,
+    0x000001CC, 0x00000089, 0x00000E42, 0x00000082, 0x00000834, 0x00000089, 0x00000B22, 0x0000006F,
+    0x00000D16, 0x0000009D, 0x000002E4, 0x00000017, 0x0000008C, 0x00000089, 0x00000B86, 0x00000058,
+    0x000000A0, 0x00000109, 0x0000076C, 0x0000006F, 0x00000AF0, 0x0000006F, 0x00000DAC, 0x00000099,
+    0x00001DB0, 0x00000033, 0x000005DC, 0x0000009D, 0x00000578, 0x00000016, 0x000005AA, 0x00000109,
+    0x0000035C, 0x00000105, 0x00000370, 0x00000109, 0x00001900, 0x000000C5, 0x000000DC, 0x000000B5,
+    0x00001E78, 0x000000B7, 0x0000251C, 0x000000C8, 0x00000D7A, 0x00000089, 0x00000D48, 0x00000109,
+    0x00000190, 0x00000109, 0x00000BB8, 0x00000109, 0x00000C80, 0x00000109, 0x00000672, 0x00000089,
+    0x00000708, 0x00000109, 0x0000030C, 0x00000103, 0x000004E2, 0x0000006D, 0x00001D4C, 0x0000006F,
+    0x0000006E, 0x00000109, 0x00001450, 0x00000109, 0x000013EC, 0x00000011, 0x00001A2C, 0x00000009,
+    0x0000189C, 0x000000FD, 0x000003AC, 0x000000E9, 0x000000C8, 0x00000109, 0x000016A8, 0x00000089,
+    0x00001644, 0x00000017, 0x00000E74, 0x00000089, 0x00000EA6, 0x00000089, 0x000000FA, 0x00000072,
+    0x00000A28, 0x00000088, 0x000000F0, 0x00000088, 0x0000170C, 0x000000C1, 0x00001324, 0x0000004C,
+    0x0000012C, 0x00000089, 0x00000118, 0x00000089, 0x00000122, 0x00000089, 0x000000E6, 0x000000B1,
+    0x000000D2, 0x0000006F, 0x00000514, 0x00000009, 0x00001130, 0x00000009, 0x00000ED8, 0x00000009,
+    0x000001F4, 0x00000092, 0x00000208, 0x00000089, 0x1C002317, 0x23002316, 0x00231608, 0x23151A12,
+    0x151A0B00, 0x15120023, 0x0C230023, 0x0023131B, 0x13190F23, 0x131A0023, 0x2313121A, 0x1C142300,
+    0x23002311, 0x23111C0B, 0x19152300, 0x15002311, 0x13002311, 0x20002311, 0x00231112, 0x0B1D0823,
+    0x13002311, 0x10231020, 0x0023110B, 0x11082308, 0x15080023, 0x08230820, 0x23110817, 0x11080D00,
+    0x0D230023, 0x00230F1F, 0x00230F19, 0x0F121A13, 0x0F0D0023, 0x0C230023, 0x2300230F, 0x11002015,
+    0x200F0020, 0x200D1A00, 0x23082300, 0x23002008, 0x13001C14, 0x1C13001C, 0x1C0D230E, 0x1C0D1C00,
+    0x1C0D1400, 0x0D0D2300, 0x230C001C, 0x23001C0B, 0x1C0B1910, 0x08230800, 0x1A17001C, 0x1A142300,
+    0x1D152300, 0x10001A13, 0x1A0F001A, 0x0A231700, 0x001A0A23, 0x1F102015, 0x23001A0A, 0x23001911,
+    0x23001910, 0x23001908, 0x15230016, 0x12200B00, 0x121A1400, 0x23000F00, 0x0000000D, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+};
+
+const size_t g_cbEngineImage = sizeof(g_engineImage);
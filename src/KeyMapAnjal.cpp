@@ -0,0 +1,59 @@
+﻿// KeyMapAnjal.cpp
+// Anjal phonetic layout: the keys produce Latin letters that PhoneticEngine
+// composes into Tamil. Shift only matters for the letters that have an
+// upper-case token (A E I O U N L R S T); the rest give the lower-case letter.
+// The tables are generated at compile time - see KeyMap.h
+
+#include "../include/KeyMap.h"
+
+static constexpr KeyBinding c_anjalBindings[] =
+{
+    //  Key          Base    Shift   AltGr
+    { 'A',          'a',    'A',    0      },
+    { 'B',          'b',    'b',    0      },
+    { 'C',          'c',    'c',    0      },
+    { 'D',          'd',    'd',    0      },
+    { 'E',          'e',    'E',    0      },
+    { 'F',          'f',    'f',    0      },
+    { 'G',          'g',    'g',    0      },
+    { 'H',          'h',    'h',    0      },
+    { 'I',          'i',    'I',    0      },
+    { 'J',          'j',    'j',    0      },
+    { 'K',          'k',    'k',    0      },
+    { 'L',          'l',    'L',    0      },
+    { 'M',          'm',    'm',    0      },
+    { 'N',          'n',    'N',    0      },
+    { 'O',          'o',    'O',    0      },
+    { 'P',          'p',    'p',    0      },
+    { 'Q',          'q',    'q',    0      },
+    { 'R',          'r',    'R',    0      },
+    { 'S',          's',    'S',    0      },
+    { 'T',          't',    'T',    0      },
+    { 'U',          'u',    'U',    0      },
+    { 'V',          'v',    'v',    0      },
+    { 'W',          'w',    'w',    0      },
+    { 'X',          'x',    'x',    0      },
+    { 'Y',          'y',    'y',    0      },
+    { 'Z',          'z',    'z',    0      },
+
+    // Number row - Tamil digits on AltGr
+    { '0',          0,      0,      0x0BE6 },  // ௦
+    { '1',          0,      0,      0x0BE7 },  // ௧
+    { '2',          0,      0,      0x0BE8 },  // ௨
+    { '3',          0,      0,      0x0BE9 },  // ௩
+    { '4',          0,      0,      0x0BEA },  // ௪
+    { '5',          0,      0,      0x0BEB },  // ௫
+    { '6',          0,      0,      0x0BEC },  // ௬
+    { '7',          0,      0,      0x0BED },  // ௭
+    { '8',          0,      0,      0x0BEE },  // ௮
+    { '9',          0,      0,      0x0BEF },  // ௯
+};
+
+static constexpr KeyMapTables c_anjalTables = MakeKeyMapTables(c_anjalBindings);
+
+static_assert(c_anjalTables.Lookup(KeyLayerBase, 'K') == 'k', "K -> k");
+static_assert(c_anjalTables.Lookup(KeyLayerShift, 'N') == 'N', "Shift+N -> N (ண)");
+static_assert(c_anjalTables.Lookup(KeyLayerShift, 'K') == 'k', "Shift+K -> k");
+static_assert(c_anjalTables.Lookup(KeyLayerBase, '1') == 0, "digits pass through");
+
+const KeyMapTables g_keyMapAnjal = c_anjalTables;
@@ -0,0 +1,85 @@
+﻿// KeyMapTamil99.cpp
+// Tamil99 layout description (Tamil Nadu Government standard keyboard)
+// The tables are generated at compile time - see KeyMap.h
+
+#include "../include/KeyMap.h"
+
+static constexpr const char16_t* c_tamil99Sequences[] =
+{
+    u"\u0B95\u0BCD\u0BB7",            // க்ஷ
+    u"\u0BB8\u0BCD\u0BB0\u0BC0",      // ஸ்ரீ
+};
+
+static constexpr KeyBinding c_tamil99Bindings[] =
+{
+    //  Key          Base     Shift                      AltGr
+    // Top row - long vowels, ஐ and hard consonants
+    { 'Q',          0x0B86,  0x0BB8,                    0      },  // ஆ  ஸ
+    { 'W',          0x0B88,  0x0BB7,                    0      },  // ஈ  ஷ
+    { 'E',          0x0B8A,  0x0B9C,                    0      },  // ஊ  ஜ
+    { 'R',          0x0B90,  0x0BB9,                    0      },  // ஐ  ஹ
+    { 'T',          0x0B8F,  c_keySequenceBase + 0,     0      },  // ஏ  க்ஷ
+    { 'Y',          0x0BB3,  c_keySequenceBase + 1,     0      },  // ள  ஸ்ரீ
+    { 'U',          0x0BB1,  0,                         0      },  // ற
+    { 'I',          0x0BA9,  0,                         0      },  // ன
+    { 'O',          0x0B9F,  0,                         0      },  // ட
+    { 'P',          0x0BA3,  0,                         0      },  // ண
+    { c_vkOem4,     0x0B9A,  0,                         0      },  // ச
+    { c_vkOem6,     0x0B9E,  0,                         0      },  // ஞ
+
+    // Home row - short vowels, pulli and common consonants
+    { 'A',          0x0B85,  0,                         0      },  // அ
+    { 'S',          0x0B87,  0,                         0      },  // இ
+    { 'D',          0x0B89,  0,                         0      },  // உ
+    { 'F',          0x0BCD,  0x0B83,                    0      },  // ்  ஃ
+    { 'G',          0x0B8E,  0,                         0      },  // எ
+    { 'H',          0x0B95,  0,                         0      },  // க
+    { 'J',          0x0BAA,  0,                         0      },  // ப
+    { 'K',          0x0BAE,  0,                         0      },  // ம
+    { 'L',          0x0BA4,  0,                         0      },  // த
+    { c_vkOem1,     0x0BA8,  0,                         0      },  // ந
+    { c_vkOem7,     0x0BAF,  0,                         0      },  // ய
+
+    // Bottom row
+    { 'Z',          0x0B94,  0,                         0      },  // ஔ
+    { 'X',          0x0B93,  0,                         0      },  // ஓ
+    { 'C',          0x0B92,  0,                         0      },  // ஒ
+    { 'V',          0x0BB5,  0,                         0      },  // வ
+    { 'B',          0x0B99,  0,                         0      },  // ங
+    { 'N',          0x0BB2,  0,                         0      },  // ல
+    { 'M',          0x0BB0,  0,                         0      },  // ர
+    { c_vkOem2,     0x0BB4,  0,                         0      },  // ழ
+
+    // Number row - Tamil digits on AltGr
+    { '0',          0,       0,                         0x0BE6 },  // ௦
+    { '1',          0,       0,                         0x0BE7 },  // ௧
+    { '2',          0,       0,                         0x0BE8 },  // ௨
+    { '3',          0,       0,                         0x0BE9 },  // ௩
+    { '4',          0,       0,                         0x0BEA },  // ௪
+    { '5',          0,       0,                         0x0BEB },  // ௫
+    { '6',          0,       0,                         0x0BEC },  // ௬
+    { '7',          0,       0,                         0x0BED },  // ௭
+    { '8',          0,       0,                         0x0BEE },  // ௮
+    { '9',          0,       0,                         0x0BEF },  // ௯
+};
+
+static constexpr KeyMapTables c_tamil99Tables = MakeKeyMapTables(c_tamil99Bindings, c_tamil99Sequences);
+
+// Compile-time spot checks; tools/KeyMapCheck.cpp compares the whole table
+// with the mapping documented in README.md
+static_assert(c_tamil99Tables.Lookup(KeyLayerBase, 'A') == 0x0B85, "A -> அ");
+static_assert(c_tamil99Tables.Lookup(KeyLayerBase, 'Q') == 0x0B86, "Q -> ஆ");
+static_assert(c_tamil99Tables.Lookup(KeyLayerBase, 'S') == 0x0B87, "S -> இ");
+static_assert(c_tamil99Tables.Lookup(KeyLayerBase, 'W') == 0x0B88, "W -> ஈ");
+static_assert(c_tamil99Tables.Lookup(KeyLayerBase, 'D') == 0x0B89, "D -> உ");
+static_assert(c_tamil99Tables.Lookup(KeyLayerBase, 'E') == 0x0B8A, "E -> ஊ");
+static_assert(c_tamil99Tables.Lookup(KeyLayerBase, 'F') == 0x0BCD, "F -> pulli");
+static_assert(c_tamil99Tables.Lookup(KeyLayerBase, 'H') == 0x0B95, "H -> க");
+static_assert(c_tamil99Tables.Lookup(KeyLayerBase, c_vkOem4) == 0x0B9A, "[ -> ச");
+static_assert(c_tamil99Tables.Lookup(KeyLayerBase, c_vkOem2) == 0x0BB4, "/ -> ழ");
+static_assert(c_tamil99Tables.Lookup(KeyLayerShift, 'E') == 0x0B9C, "Shift+E -> ஜ");
+static_assert(c_tamil99Tables.Lookup(KeyLayerAltGr, '5') == 0x0BEB, "AltGr+5 -> ௫");
+static_assert(c_tamil99Tables.Lookup(KeyLayerBase, '1') == 0, "digits pass through");
+static_assert(c_tamil99Tables.Lookup(KeyLayerBase, 0x141) == 0, "out-of-range wParam");
+
+const KeyMapTables g_keyMapTamil99 = c_tamil99Tables;
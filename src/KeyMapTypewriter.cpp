@@ -0,0 +1,91 @@
+﻿// KeyMapTypewriter.cpp
+// Glyph-order layouts: Tamil Typewriter (Remington positions) and Bamini.
+// Both are typed in visual order - the prefix vowel signs ெ ே ை are typed
+// before the consonant and reordered by TypewriterEngine.
+// Bamini follows the typewriter letter positions; the two differ in the
+// grantha and symbol keys. Shifted letters carry the கு-series glyphs.
+// The tables are generated at compile time - see KeyMap.h; Bamini's come
+// from its font's glyph list in LegacyEncoding.h.
+
+#include "../include/KeyMap.h"
+#include "../include/LegacyEncoding.h"
+
+//
+// Tamil Typewriter
+//
+static constexpr const char16_t* c_typewriterSequences[] =
+{
+    u"\u0BAF\u0BC1",                // யு
+    u"\u0BA9\u0BC1",                // னு
+    u"\u0BA8\u0BC1",                // நு
+    u"\u0B95\u0BC1",                // கு
+    u"\u0BAA\u0BC1",                // பு
+    u"\u0BA4\u0BC1",                // து
+    u"\u0BAE\u0BC1",                // மு
+    u"\u0B9F\u0BC1",                // டு
+    u"\u0BB4\u0BC1",                // ழு
+    u"\u0B9A\u0BC1",                // சு
+    u"\u0BB3\u0BC1",                // ளு
+    u"\u0BB5\u0BC1",                // வு
+    u"\u0BB0\u0BC1",                // ரு
+    u"\u0BB1\u0BC1",                // று
+    u"\u0BB2\u0BC1",                // லு
+    u"\u0BA3\u0BC1",                // ணு
+    u"\u0BB8\u0BCD\u0BB0\u0BC0",    // ஸ்ரீ
+};
+
+static constexpr KeyBinding c_typewriterBindings[] =
+{
+    //  Key          Base     Shift                      AltGr
+    { 'A',           0x0BAF,  c_keySequenceBase + 0,     0      },  // ய  யு
+    { 'C',           0x0B89,  0x0B8A,                    0      },  // உ  ஊ
+    { 'D',           0x0BA9,  c_keySequenceBase + 1,     0      },  // ன  னு
+    { 'E',           0x0BA8,  c_keySequenceBase + 2,     0      },  // ந  நு
+    { 'F',           0x0B95,  c_keySequenceBase + 3,     0      },  // க  கு
+    { 'G',           0x0BAA,  c_keySequenceBase + 4,     0      },  // ப  பு
+    { 'H',           0x0BBE,  0,                         0      },  // ா
+    { 'I',           0x0BC8,  0x0B90,                    0      },  // ை  ஐ
+    { 'J',           0x0BA4,  c_keySequenceBase + 5,     0      },  // த  து
+    { 'K',           0x0BAE,  c_keySequenceBase + 6,     0      },  // ம  மு
+    { 'L',           0x0B9F,  c_keySequenceBase + 7,     0      },  // ட  டு
+    { 'M',           0x0B85,  0x0B86,                    0      },  // அ  ஆ
+    { 'N',           0x0BC6,  0x0BC7,                    0      },  // ெ  ே
+    { 'O',           0x0BB4,  c_keySequenceBase + 8,     0      },  // ழ  ழு
+    { 'P',           0x0BBF,  0x0BC0,                    0      },  // ி  ீ
+    { 'Q',           0x0B99,  0x0B9E,                    0      },  // ங  ஞ
+    { 'R',           0x0B9A,  c_keySequenceBase + 9,     0      },  // ச  சு
+    { 'S',           0x0BB3,  c_keySequenceBase + 10,    0      },  // ள  ளு
+    { 'T',           0x0BB5,  c_keySequenceBase + 11,    0      },  // வ  வு
+    { 'U',           0x0BB0,  c_keySequenceBase + 12,    0      },  // ர  ரு
+    { 'V',           0x0B8E,  0x0B8F,                    0      },  // எ  ஏ
+    { 'W',           0x0BB1,  c_keySequenceBase + 13,    0      },  // ற  று
+    { 'X',           0x0B92,  0x0B93,                    0      },  // ஒ  ஓ
+    { 'Y',           0x0BB2,  c_keySequenceBase + 14,    0      },  // ல  லு
+    { 'Z',           0x0BA3,  c_keySequenceBase + 15,    0      },  // ண  ணு
+    { c_vkOem1,      0x0BCD,  0,                         0      },  // ்
+    { c_vkOemComma,  0x0B87,  0x0B88,                    0      },  // இ  ஈ
+    { c_vkOem2,      0x0B83,  0,                         0      },  // ஃ
+    { c_vkOem4,      0x0B9C,  0x0BC1,                    0      },  // ஜ  ு
+    { c_vkOem6,      0x0BB8,  0x0BC2,                    0      },  // ஸ  ூ
+    { c_vkOem5,      0x0BB7,  0,                         0      },  // ஷ
+    { c_vkOemPlus,   0x0BB9,  0,                         0      },  // ஹ
+    { c_vkOem7,      c_keySequenceBase + 16,  0,                  0      },  // ஸ்ரீ
+};
+
+//
+// Bamini: built from the font's glyph list, which the Bamini converter
+// shares (see LegacyEncoding.h)
+//
+static_assert(LegacyGlyphSequenceCount(c_baminiGlyphs) <= c_keySequenceSlots, "too many key sequences in layout");
+
+static constexpr KeyMapTables c_typewriterTables = MakeKeyMapTables(c_typewriterBindings, c_typewriterSequences);
+static constexpr KeyMapTables c_baminiTables = MakeLegacyKeyMapTables(c_baminiGlyphs);
+
+static_assert(c_typewriterTables.Lookup(KeyLayerBase, 'F') == 0x0B95, "f -> க");
+static_assert(c_typewriterTables.Lookup(KeyLayerBase, 'N') == 0x0BC6, "n -> prefix ெ");
+static_assert(c_baminiTables.Lookup(KeyLayerShift, 'M') == 0x0B86, "M -> ஆ");
+static_assert(c_baminiTables.Lookup(KeyLayerBase, c_vkOem3) == 0x0BB9, "` -> ஹ");
+static_assert(c_baminiTables.Lookup(KeyLayerShift, 'F') == c_keySequenceBase + 3, "F -> கு, fourth sequence");
+
+const KeyMapTables g_keyMapTypewriter = c_typewriterTables;
+const KeyMapTables g_keyMapBamini = c_baminiTables;
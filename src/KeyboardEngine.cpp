@@ -0,0 +1,64 @@
+﻿// KeyboardEngine.cpp
+// Dispatch from the active layout descriptor to its engine
+
+#include "../include/KeyboardEngine.h"
+
+bool KeyboardEngine::ProcessKey(char16_t code, EngineOutput* pOutput)
+{
+    _version++;
+
+    char16_t keyText[c_keySequenceLength];
+    size_t cchKey = _pKeyMap->Expand(code, keyText);
+
+    switch (_pLayout->engine)
+    {
+    case LayoutEngineTypewriter:
+        return _typewriterEngine.ProcessKey(keyText, cchKey, pOutput);
+    case LayoutEnginePhonetic:
+        return _phoneticEngine.ProcessKey(keyText, cchKey, pOutput);
+    case LayoutEngineTamil99:
+    default:
+        return _tamil99Engine.ProcessKey(keyText, cchKey, pOutput);
+    }
+}
+
+size_t KeyboardEngine::ComposingLength() const
+{
+    switch (_pLayout->engine)
+    {
+    case LayoutEngineTypewriter:
+        return _typewriterEngine.ComposingLength();
+    case LayoutEnginePhonetic:
+        return _phoneticEngine.ComposingLength();
+    case LayoutEngineTamil99:
+    default:
+        return _tamil99Engine.ComposingLength();
+    }
+}
+
+void KeyboardEngine::Reset()
+{
+    _version++;
+    _tamil99Engine.Reset();
+    _typewriterEngine.Reset();
+    _phoneticEngine.Reset();
+}
+
+void KeyboardEngine::Resume(const char16_t* pchBefore, size_t cchBefore)
+{
+    Reset();
+
+    switch (_pLayout->engine)
+    {
+    case LayoutEngineTypewriter:
+        _typewriterEngine.Resume(pchBefore, cchBefore);
+        break;
+    case LayoutEnginePhonetic:
+        _phoneticEngine.Resume(pchBefore, cchBefore);
+        break;
+    case LayoutEngineTamil99:
+    default:
+        _tamil99Engine.Resume(pchBefore, cchBefore);
+        break;
+    }
+}
@@ -0,0 +1,119 @@
+﻿// LatencyHistogram.cpp
+// Histogram queries and the stats dump - see LatencyHistogram.h
+
+#include "../include/LatencyHistogram.h"
+
+#include <cstdio>
+
+LatencyStats g_latencyStats;
+
+const char* const c_latencyStageNames[LatencyStageCount] =
+{
+    "TestKeyDown",
+    "KeyDown",
+    "Mapping",
+    "RequestEditSession",
+    "EditSessionQueue",
+    "EditSession",
+    "SetSelection",
+    "KeyToText",
+    "Completion",
+    "Candidates",
+    "Load",
+    "Activate",
+    "FirstKey",
+    "Reactivate",
+};
+
+uint64_t LatencyHistogram::Count() const
+{
+    uint64_t count = 0;
+    for (size_t i = 0; i < c_latencyBucketCount; i++)
+        count += _buckets[i].load(std::memory_order_relaxed);
+    return count;
+}
+
+uint64_t LatencyHistogram::Mean() const
+{
+    uint64_t count = Count();
+    return count ? _sum.load(std::memory_order_relaxed) / count : 0;
+}
+
+uint64_t LatencyHistogram::Percentile(double q) const
+{
+    uint64_t count = Count();
+    if (count == 0)
+        return 0;
+
+    // Rank of the wanted sample, 1-based
+    uint64_t rank = (uint64_t)(q * (double)count + 0.5);
+    if (rank < 1)
+        rank = 1;
+    if (rank > count)
+        rank = count;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < c_latencyBucketCount; i++)
+    {
+        seen += _buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+        {
+            uint64_t upper = LatencyBucketUpperBound(i);
+            uint64_t max = Max();
+            return (upper < max) ? upper : max;
+        }
+    }
+
+    return Max();
+}
+
+void LatencyHistogram::Reset()
+{
+    for (size_t i = 0; i < c_latencyBucketCount; i++)
+        _buckets[i].store(0, std::memory_order_relaxed);
+    _sum.store(0, std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+}
+
+size_t LatencyStats::Dump(char* pszOut, size_t cch) const
+{
+    if (cch == 0)
+        return 0;
+
+    size_t cchUsed = 0;
+    pszOut[0] = 0;
+
+    for (size_t i = 0; i < LatencyStageCount; i++)
+    {
+        const LatencyHistogram& histogram = stages[i];
+        uint64_t count = histogram.Count();
+        if (count == 0)
+            continue;
+
+        int cchLine = snprintf(pszOut + cchUsed, cch - cchUsed,
+            "%-18s n=%llu mean=%.1fus p50=%.1fus p99=%.1fus p999=%.1fus max=%.1fus\n",
+            c_latencyStageNames[i], (unsigned long long)count,
+            histogram.Mean() / 1000.0,
+            histogram.Percentile(0.50) / 1000.0,
+            histogram.Percentile(0.99) / 1000.0,
+            histogram.Percentile(0.999) / 1000.0,
+            histogram.Max() / 1000.0);
+
+        if (cchLine < 0)
+            break;
+        if ((size_t)cchLine >= cch - cchUsed)
+        {
+            // Truncated; snprintf already terminated the buffer
+            return cch - 1;
+        }
+        cchUsed += (size_t)cchLine;
+    }
+
+    return cchUsed;
+}
+
+void LatencyStats::Reset()
+{
+    for (size_t i = 0; i < LatencyStageCount; i++)
+        stages[i].Reset();
+}
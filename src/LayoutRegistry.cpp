@@ -0,0 +1,12 @@
+﻿// LayoutRegistry.cpp
+// Static layout descriptors - see LayoutRegistry.h
+
+#include "../include/LayoutRegistry.h"
+
+const LayoutDescriptor g_layouts[LayoutCount] =
+{
+    { LayoutTamil99,    u"Murasu Anjal Core - Tamil99",     &g_keyMapTamil99,       LayoutEngineTamil99     },
+    { LayoutAnjal,      u"Murasu Anjal Core - Anjal",       &g_keyMapAnjal,         LayoutEnginePhonetic    },
+    { LayoutTypewriter, u"Murasu Anjal Core - Typewriter",  &g_keyMapTypewriter,    LayoutEngineTypewriter  },
+    { LayoutBamini,     u"Murasu Anjal Core - Bamini",      &g_keyMapBamini,        LayoutEngineTypewriter  },
+};
@@ -0,0 +1,375 @@
+﻿// LegacyConverter.cpp
+// Font-encoding conversion - see LegacyConverter.h
+
+#include "../include/LegacyConverter.h"
+#include "../include/TamilScan.h"
+#include "../include/TypewriterEngine.h"
+
+static constexpr LegacyEncodingTable c_tsciiTable = MakeLegacyEncodingTable(c_tsciiGlyphs, c_tsciiGlyphPairs);
+static constexpr LegacyEncodingTable c_baminiTable = MakeLegacyEncodingTable(c_baminiGlyphs);
+
+static_assert(c_tsciiTable.fAsciiPlain && !c_baminiTable.fAsciiPlain, "ASCII passes through TSCII only");
+static_assert(c_tsciiTable.text[0xB8][0] == 0x0B95 && c_tsciiTable.cch[0xB8] == 1, "TSCII 0xB8 -> க");
+static_assert(c_tsciiTable.cch[0xA0] == 0 && c_tsciiTable.cch[0xFF] == 0, "TSCII 0xA0, 0xFF are not glyphs");
+static_assert(c_tsciiTable.cEncode == sizeof(c_tsciiGlyphs) / sizeof(c_tsciiGlyphs[0]) - 1, "0xFE repeats இ");
+static_assert(c_tsciiTable.cPairs == 4 && c_tsciiTable.fPairFirst[0x8A] && !c_tsciiTable.fPairFirst[0x85], "TSCII ஸ் + ு -> ஸு");
+static_assert(c_baminiTable.text['f'][0] == 0x0B95 && c_baminiTable.cch['F'] == 2, "Bamini f -> க, F -> கு");
+
+const LegacyEncodingTable g_legacyEncodings[LegacyEncodingCount] = { c_tsciiTable, c_baminiTable };
+
+static const char16_t c_signE = 0x0BC6;     // ெ
+static const char16_t c_signEE = 0x0BC7;    // ே
+static const char16_t c_signAI = 0x0BC8;    // ை
+static const char16_t c_signAA = 0x0BBE;    // ா
+
+// ASCII runs up to this long - the space between two words - are copied
+// in line; the vector kernels only pay for themselves on longer ones
+static const size_t c_shortAsciiRun = 16;
+
+static inline bool IsPrefixSign(char16_t ch)
+{
+    return ch == c_signE || ch == c_signEE || ch == c_signAI;
+}
+
+// The vowel signs from U+0BC6 to U+0BCC as drawn: the half in front of the
+// consonant and the half after it
+static const char16_t c_signHalves[7][2] =
+{
+    { c_signE, 0 },                     // ெ
+    { c_signEE, 0 },                    // ே
+    { c_signAI, 0 },                    // ை
+    { 0, 0 },                           // unassigned
+    { c_signE, c_signAA },              // ொ
+    { c_signEE, c_signAA },             // ோ
+    { c_signE, c_tamilAuLength },       // ௌ
+};
+
+LegacyConverter::LegacyConverter(LegacyEncodingId encoding)
+{
+    _encoding = encoding;
+    _pTable = &g_legacyEncodings[encoding];
+
+    for (size_t i = 0; i < 7; i++)
+    {
+        size_t cchGlyph;
+        for (size_t half = 0; half < 2; half++)
+        {
+            _signBytes[i][half] = c_signHalves[i][half] ? _Match(&c_signHalves[i][half], 1, &cchGlyph) : -1;
+        }
+
+        // A sign whose front half has no glyph, or whose back half has
+        // none, cannot be drawn at all
+        if (_signBytes[i][0] < 0 || (c_signHalves[i][1] && _signBytes[i][1] < 0))
+        {
+            _signBytes[i][0] = -1;
+            _signBytes[i][1] = -1;
+        }
+    }
+}
+
+size_t LegacyConverter::Decode(const char* pbIn, size_t cbIn, char16_t* pchOut, size_t cchOutMax) const
+{
+    const TamilScanKernels& scan = TamilScan();
+    const LegacyEncodingTable& table = *_pTable;
+    const uint8_t* pb = (const uint8_t*)pbIn;
+    TypewriterEngine engine;
+    size_t cchOut = 0;
+    size_t cchNeeded = 0;
+
+    size_t ib = 0;
+    while (ib < cbIn)
+    {
+        uint8_t b = pb[ib];
+        bool fIdle = engine.HeldPrefix() == 0 && engine.ComposingLength() == 0;
+
+        if (fIdle && b < 0x80 && table.fAsciiPlain)
+        {
+            // An ASCII run, long ones a vector at a time. Nothing is held,
+            // so it is final as it stands.
+            size_t cbRun = 1;
+            if (pchOut != nullptr)
+            {
+                if (cchOut == cchOutMax)
+                    return c_legacyNoRoom;
+                size_t cbMax = (cbIn - ib < cchOutMax - cchOut) ? cbIn - ib : cchOutMax - cchOut;
+                pchOut[cchOut] = b;
+                while (cbRun < cbMax && cbRun < c_shortAsciiRun && pb[ib + cbRun] < 0x80)
+                {
+                    pchOut[cchOut + cbRun] = pb[ib + cbRun];
+                    cbRun++;
+                }
+                if (cbRun == c_shortAsciiRun)
+                    cbRun += scan.pfnWidenAscii(pb + ib + cbRun, cbMax - cbRun, pchOut + cchOut + cbRun);
+            }
+            else
+            {
+                while (ib + cbRun < cbIn && pb[ib + cbRun] < 0x80)
+                    cbRun++;
+            }
+
+            cchOut += cbRun;
+            if (cchOut > cchNeeded)
+                cchNeeded = cchOut;
+            ib += cbRun;
+            continue;
+        }
+
+        char16_t chByte = b;
+        const char16_t* pchGlyph = table.cch[b] ? table.text[b] : &chByte;
+        size_t cchGlyph = table.cch[b] ? table.cch[b] : 1;
+        ib++;
+
+        if (table.fPairFirst[b] && ib < cbIn)
+        {
+            for (size_t k = 0; k < table.cPairs; k++)
+            {
+                if (table.pairBytes[k][0] == b && table.pairBytes[k][1] == pb[ib])
+                {
+                    pchGlyph = table.pairText[k];
+                    cchGlyph = table.pairCch[k];
+                    ib++;
+                    break;
+                }
+            }
+        }
+
+        if (fIdle && !(cchGlyph == 1 && IsPrefixSign(pchGlyph[0])))
+        {
+            // Nothing held and no prefix: the engine would only append
+            if (pchOut != nullptr)
+            {
+                if (cchOut + cchGlyph > cchOutMax)
+                    return c_legacyNoRoom;
+                for (size_t j = 0; j < cchGlyph; j++)
+                    pchOut[cchOut + j] = pchGlyph[j];
+            }
+            cchOut += cchGlyph;
+            if (cchOut > cchNeeded)
+                cchNeeded = cchOut;
+            continue;
+        }
+
+        EngineOutput output;
+        engine.ProcessKey(pchGlyph, cchGlyph, &output);
+
+        // The engine only deletes the sign it has just emitted
+        cchOut -= (output.cchDelete < cchOut) ? output.cchDelete : cchOut;
+        if (pchOut != nullptr)
+        {
+            if (cchOut + output.cchText > cchOutMax)
+                return c_legacyNoRoom;
+            for (size_t j = 0; j < output.cchText; j++)
+                pchOut[cchOut + j] = output.text[j];
+        }
+        cchOut += output.cchText;
+        if (cchOut > cchNeeded)
+            cchNeeded = cchOut;
+    }
+
+    // A prefix sign at the very end never met its consonant
+    if (engine.HeldPrefix() != 0)
+    {
+        if (pchOut != nullptr)
+        {
+            if (cchOut == cchOutMax)
+                return c_legacyNoRoom;
+            pchOut[cchOut] = engine.HeldPrefix();
+        }
+        cchOut++;
+        if (cchOut > cchNeeded)
+            cchNeeded = cchOut;
+    }
+
+    return (pchOut != nullptr) ? cchOut : cchNeeded;
+}
+
+size_t LegacyConverter::Encode(const char16_t* pchIn, size_t cchIn, char* pbOut, size_t cbOutMax, size_t* pcUnmapped) const
+{
+    const TamilScanKernels& scan = TamilScan();
+    const LegacyEncodingTable& table = *_pTable;
+    uint8_t* pb = (uint8_t*)pbOut;
+    size_t cbOut = 0;
+    size_t cUnmapped = 0;
+
+    size_t i = 0;
+    while (i < cchIn)
+    {
+        char16_t ch = pchIn[i];
+
+        if (ch < 0x80 && table.fAsciiPlain)
+        {
+            size_t cchRun = 1;
+            if (pb != nullptr)
+            {
+                if (cbOut == cbOutMax)
+                    return c_legacyNoRoom;
+                size_t cchMax = (cchIn - i < cbOutMax - cbOut) ? cchIn - i : cbOutMax - cbOut;
+                pb[cbOut] = (uint8_t)ch;
+                while (cchRun < cchMax && cchRun < c_shortAsciiRun && pchIn[i + cchRun] < 0x80)
+                {
+                    pb[cbOut + cchRun] = (uint8_t)pchIn[i + cchRun];
+                    cchRun++;
+                }
+                if (cchRun == c_shortAsciiRun)
+                    cchRun += scan.pfnNarrowAscii(pchIn + i + cchRun, cchMax - cchRun, pb + cbOut + cchRun);
+            }
+            else
+            {
+                while (i + cchRun < cchIn && pchIn[i + cchRun] < 0x80)
+                    cchRun++;
+            }
+
+            cbOut += cchRun;
+            i += cchRun;
+            continue;
+        }
+
+        // Up to three bytes: prefix sign, glyph, and the back half of ொ ோ ௌ
+        uint8_t bytes[3];
+        size_t cb = 0;
+        int bPrefix;
+        int bSuffix;
+
+        size_t cchGlyph;
+        int bGlyph = -1;
+        int iPair = _MatchPair(pchIn + i, cchIn - i);
+        if (iPair >= 0)
+        {
+            // Pairs end in a vowel sign: nothing to move
+            bytes[cb++] = table.pairBytes[iPair][0];
+            bytes[cb++] = table.pairBytes[iPair][1];
+            i += table.pairCch[iPair];
+        }
+        else if ((bGlyph = _Match(pchIn + i, cchIn - i, &cchGlyph)) >= 0)
+        {
+            // A sign drawn in front of the consonant the glyph ends in
+            // moves before it
+            i += cchGlyph;
+            if (i < cchIn &&
+                GetTamilCharInfo(table.text[bGlyph][cchGlyph - 1]).charClass == TamilClassConsonant &&
+                _SplitSign(pchIn[i], &bPrefix, &bSuffix))
+            {
+                bytes[cb++] = (uint8_t)bPrefix;
+                bytes[cb++] = (uint8_t)bGlyph;
+                if (bSuffix >= 0)
+                    bytes[cb++] = (uint8_t)bSuffix;
+                i++;
+            }
+            else
+            {
+                bytes[cb++] = (uint8_t)bGlyph;
+            }
+        }
+        else if (_SplitSign(ch, &bPrefix, &bSuffix))
+        {
+            // A two-part sign with no consonant: both halves, as drawn
+            bytes[cb++] = (uint8_t)bPrefix;
+            if (bSuffix >= 0)
+                bytes[cb++] = (uint8_t)bSuffix;
+            i++;
+        }
+        else if (ch < 0x100 && table.cch[ch] == 0)
+        {
+            // Decodes to itself
+            bytes[cb++] = (uint8_t)ch;
+            i++;
+        }
+        else
+        {
+            bytes[cb++] = (uint8_t)c_legacyUnmapped;
+            cUnmapped++;
+            i += (ch >= 0xD800 && ch < 0xDC00 && i + 1 < cchIn && pchIn[i + 1] >= 0xDC00 && pchIn[i + 1] < 0xE000) ? 2 : 1;
+        }
+
+        if (pb != nullptr)
+        {
+            if (cbOut + cb > cbOutMax)
+                return c_legacyNoRoom;
+            for (size_t j = 0; j < cb; j++)
+                pb[cbOut + j] = bytes[j];
+        }
+        cbOut += cb;
+    }
+
+    if (pcUnmapped != nullptr)
+        *pcUnmapped = cUnmapped;
+    return cbOut;
+}
+
+int LegacyConverter::_Match(const char16_t* pch, size_t cch, size_t* pcchGlyph) const
+{
+    const LegacyEncodingTable& table = *_pTable;
+
+    // The glyphs starting with pch[0], longest first
+    size_t first;
+    size_t last;
+    size_t index = LegacyUnitIndex(pch[0]);
+    if (index < c_legacyIndexedUnits)
+    {
+        first = table.firstGlyph[index];
+        last = first + table.cGlyphs[index];
+    }
+    else
+    {
+        first = 0;
+        last = table.cEncode;
+        while (first < last)
+        {
+            size_t mid = (first + last) / 2;
+            if (table.text[table.encodeOrder[mid]][0] < pch[0])
+                first = mid + 1;
+            else
+                last = mid;
+        }
+        last = first;
+        while (last < table.cEncode && table.text[table.encodeOrder[last]][0] == pch[0])
+            last++;
+    }
+
+    for (size_t k = first; k < last; k++)
+    {
+        uint8_t b = table.encodeOrder[k];
+        size_t cchGlyph = table.cch[b];
+        if (cchGlyph > cch)
+            continue;
+
+        size_t j = 1;
+        while (j < cchGlyph && table.text[b][j] == pch[j])
+            j++;
+        if (j == cchGlyph)
+        {
+            *pcchGlyph = cchGlyph;
+            return b;
+        }
+    }
+    return -1;
+}
+
+int LegacyConverter::_MatchPair(const char16_t* pch, size_t cch) const
+{
+    const LegacyEncodingTable& table = *_pTable;
+
+    for (size_t k = 0; k < table.cPairs; k++)
+    {
+        size_t cchPair = table.pairCch[k];
+        if (cchPair > cch || table.pairText[k][0] != pch[0])
+            continue;
+
+        size_t j = 1;
+        while (j < cchPair && table.pairText[k][j] == pch[j])
+            j++;
+        if (j == cchPair)
+            return (int)k;
+    }
+    return -1;
+}
+
+bool LegacyConverter::_SplitSign(char16_t ch, int* pbPrefix, int* pbSuffix) const
+{
+    if (ch < c_signE || ch > 0x0BCC)
+        return false;
+
+    *pbPrefix = _signBytes[ch - c_signE][0];
+    *pbSuffix = _signBytes[ch - c_signE][1];
+    return *pbPrefix >= 0;
+}
@@ -3,38 +3,213 @@
 
 #include "../include/MurasuAnjalCore.h"
 #include <stdio.h>
+#include <strsafe.h>
 #include "../include/Debug.h"
+#include "../include/TraceRing.h"
+#include "../include/LatencyHistogram.h"
+#include "../include/Transliterator.h"
 
 // Globals
 HINSTANCE g_hInst = NULL;
 LONG g_cRefDll = 0;
 
+// Handed out by DllGetClassObject; nothing to allocate on the load path
+static CClassFactory s_classFactory;
+
+// Deactivated instances kept for the next activation on their thread
+static WarmCache<CMurasuAnjalTextService> s_warmCache;
+
+// What a running candidate worker thread costs while parked: the committed
+// part of its stack and the thread's own bookkeeping, roughly
+static const size_t c_warmWorkerThreadBytes = 64 * 1024;
+
+// Presses taken from one auto-repeat key message
+static const UINT c_maxKeyRepeat = 64;
+
+// Message-only window that brings the candidate worker's results back to
+// the thread the text service lives on
+static const WCHAR c_szCandidateWindowClass[] = L"MurasuAnjalCoreCandidates";
+static const UINT WM_ANJAL_CANDIDATES = WM_APP + 1;
+static const UINT WM_ANJAL_RELEASE = WM_APP + 2;       // let go by the warm cache on another thread
+static const UINT_PTR c_warmIdleTimer = 1;
+
 //
-// Edit Session for inserting text
+// Edit Session for inserting text. It applies the pending batch with its
+// serial - every key merged into that batch until the session starts.
+// Sessions come from the text service's pool: when the last reference goes
+// away the object is returned there instead of being deleted.
 //
 class CEditSession : public ITfEditSession
 {
 public:
-    CEditSession(ITfContext* pContext, const WCHAR* pchText, ULONG cchText)
+    CEditSession()
+    {
+        _refCount = 0;
+        _pTextService = NULL;
+        _pContext = NULL;
+        _serial = 0;
+        _requestNs = 0;
+        _fPooled = FALSE;
+        _pNextFree = NULL;
+    }
+
+    // Prepares a fresh or recycled session; returns it with one reference
+    void Init(CMurasuAnjalTextService* pTextService, ITfContext* pContext, uint32_t serial)
     {
         _refCount = 1;
+        _pTextService = pTextService;
+        _pTextService->AddRef();
         _pContext = pContext;
         _pContext->AddRef();
-        _cchText = cchText;
-        _pchText = new WCHAR[cchText + 1];
-        if (_pchText)
+        _serial = serial;
+        _requestNs = 0;
+    }
+
+    // IUnknown
+    STDMETHODIMP QueryInterface(REFIID riid, void** ppvObj)
+    {
+        if (!ppvObj)
+            return E_INVALIDARG;
+
+        *ppvObj = NULL;
+
+        if (IsEqualIID(riid, IID_IUnknown) || IsEqualIID(riid, IID_ITfEditSession))
+        {
+            *ppvObj = (ITfEditSession*)this;
+        }
+
+        if (*ppvObj)
+        {
+            AddRef();
+            return S_OK;
+        }
+
+        return E_NOINTERFACE;
+    }
+
+    STDMETHODIMP_(ULONG) AddRef()
+    {
+        return InterlockedIncrement(&_refCount);
+    }
+
+    STDMETHODIMP_(ULONG) Release()
+    {
+        LONG cr = InterlockedDecrement(&_refCount);
+        if (cr == 0)
+        {
+            _Recycle();
+        }
+        return cr;
+    }
+
+    // Called right before RequestEditSession, for the queue latency
+    void MarkRequested()
+    {
+        _requestNs = LatencyNow();
+    }
+
+    // ITfEditSession
+    STDMETHODIMP DoEditSession(TfEditCookie ec)
+    {
+        ULONGLONG startNs = LatencyNow();
+        g_latencyStats.Record(LatencyEditSessionQueue, _requestNs, startNs);
+
+        // From here on new keys start a new batch
+        PendingOutputQueue& pending = _pTextService->_pendingOutput;
+        PendingBatch* pBatch = pending.Take(_serial);
+        if (!pBatch)
+            return S_OK;
+
+        ULONG cchDelete = pBatch->cchDelete;
+        ULONG cchText = pBatch->cchText;
+        const WCHAR* pchText = (const WCHAR*)pBatch->text;
+
+        LogVerbose(LogEditSession, L"      DoEditSession START: %u key(s)", pBatch->keyCount);
+        ANJAL_TRACE(TraceEditSessionBegin, cchDelete, cchText, pBatch->keyCount);
+
+        HRESULT hr = S_OK;
+        BOOL fEdited = TRUE;
+        if (pBatch->cchComposing > 0 || _pTextService->_pComposition)
+        {
+            // Open syllable: rewrite the composition range
+            hr = _pTextService->_UpdateComposition(ec, _pContext, *pBatch);
+        }
+        else if (cchDelete > 0 || cchText > 0)
+        {
+            hr = _pTextService->_SetTextAtSelection(ec, _pContext, pchText, cchText, cchDelete);
+        }
+        else
         {
-            memcpy(_pchText, pchText, cchText * sizeof(WCHAR));
-            _pchText[cchText] = 0;
+            // Commit of a composition that never started
+            fEdited = FALSE;
         }
+
+        // Keep the text before the caret current without reading it back
+        if (SUCCEEDED(hr) && fEdited)
+            _pTextService->_surroundingText.Apply(_pContext, cchDelete, pBatch->text, cchText);
+
+        LogVerbose(LogEditSession, L"      DoEditSession END: 0x%08X", hr);
+        ANJAL_TRACE(TraceEditSessionEnd, (ULONG)hr);
+
+        ULONGLONG endNs = LatencyNow();
+        g_latencyStats.Record(LatencyEditSession, startNs, endNs);
+        if (pBatch->keyDownNs)
+            g_latencyStats.Record(LatencyKeyToText, pBatch->keyDownNs, endNs);
+
+        pending.Complete(_serial);
+        return hr;
+    }
+
+private:
+    friend class CMurasuAnjalTextService;
+
+    void _Recycle()
+    {
+        _pContext->Release();
+        _pContext = NULL;
+
+        // The text service reference goes last: it owns the pool this
+        // object lives in
+        CMurasuAnjalTextService* pTextService = _pTextService;
+        _pTextService = NULL;
+
+        if (_fPooled)
+            pTextService->_ReturnEditSession(this);
+        else
+            delete this;
+
+        pTextService->Release();
+    }
+
+    long _refCount;
+    CMurasuAnjalTextService* _pTextService;     // owns the pending output and the pool
+    ITfContext* _pContext;
+    uint32_t _serial;                           // batch this session applies
+    ULONGLONG _requestNs;                       // RequestEditSession issued
+    BOOL _fPooled;                              // part of the text service's block
+    CEditSession* _pNextFree;
+};
+
+//
+// Read-only session that fills the surrounding-text cache: the few code
+// units before the selection, once per focus change
+//
+class CSurroundingTextSession : public ITfEditSession
+{
+public:
+    CSurroundingTextSession(CMurasuAnjalTextService* pTextService, ITfContext* pContext)
+    {
+        _refCount = 1;
+        _pTextService = pTextService;
+        _pTextService->AddRef();
+        _pContext = pContext;
+        _pContext->AddRef();
     }
 
-    ~CEditSession()
+    ~CSurroundingTextSession()
     {
-        if (_pContext)
-            _pContext->Release();
-        if (_pchText)
-            delete[] _pchText;
+        _pContext->Release();
+        _pTextService->Release();
     }
 
     // IUnknown
@@ -77,75 +252,38 @@ public:
     // ITfEditSession
     STDMETHODIMP DoEditSession(TfEditCookie ec)
     {
-        DebugOut(logTag, L"      DoEditSession START");
+        TF_SELECTION tfSelection;
+        ULONG cFetched = 0;
+        HRESULT hr = _pContext->GetSelection(ec, TF_DEFAULT_SELECTION, 1, &tfSelection, &cFetched);
+        if (FAILED(hr) || cFetched != 1)
+            return hr;
 
-        HRESULT hr = E_FAIL;
-        ITfInsertAtSelection* pInsertAtSelection = NULL;
-        ITfRange* pRange = NULL;
+        ITfRange* pRange = tfSelection.range;
+        pRange->Collapse(ec, TF_ANCHOR_START);
+
+        LONG cchShifted = 0;
+        pRange->ShiftStart(ec, -(LONG)c_surroundingTextMax, &cchShifted, NULL);
 
-        hr = _pContext->QueryInterface(IID_ITfInsertAtSelection, (void**)&pInsertAtSelection);
-        DebugOut(logTag, L"        QI ITfInsertAtSelection: 0x%08X", hr);
+        WCHAR achText[c_surroundingTextMax];
+        ULONG cchText = 0;
+        hr = pRange->GetText(ec, 0, achText, ARRAYSIZE(achText), &cchText);
+        LogVerbose(LogEditSession, L"      Surrounding text: %u unit(s), 0x%08X", cchText, hr);
+        pRange->Release();
 
         if (SUCCEEDED(hr))
         {
-            DebugOut(logTag, L"        Method: QUERYONLY + SetText + Move cursor");
-
-            // Get the current selection range
-            hr = pInsertAtSelection->InsertTextAtSelection(ec,
-                TF_IAS_QUERYONLY,
-                NULL,
-                0,
-                &pRange);
-
-            DebugOut(logTag, L"        InsertTextAtSelection(QUERYONLY): 0x%08X", hr);
-
-            if (SUCCEEDED(hr) && pRange)
-            {
-                // Collapse to insertion point (start of selection)
-                hr = pRange->Collapse(ec, TF_ANCHOR_START);
-                DebugOut(logTag, L"        Collapse to START: 0x%08X", hr);
-
-                // Insert the text
-                hr = pRange->SetText(ec, 0, _pchText, _cchText);
-                DebugOut(logTag, L"        SetText: 0x%08X", hr);
-
-                if (SUCCEEDED(hr))
-                {
-                    // ✅ Move the range to END of the text we just inserted
-                    // ShiftEnd moves the end anchor forward by the length of text
-                    LONG cch;
-                    hr = pRange->ShiftEnd(ec, _cchText, &cch, NULL);
-                    DebugOut(logTag, L"        ShiftEnd(%d chars): 0x%08X, moved=%d", _cchText, hr, cch);
-
-                    // Collapse to the end (this puts both anchors at the end)
-                    hr = pRange->Collapse(ec, TF_ANCHOR_END);
-                    DebugOut(logTag, L"        Collapse to END: 0x%08X", hr);
-
-                    // Set this as the new selection (cursor position)
-                    TF_SELECTION tfSelection;
-                    tfSelection.range = pRange;
-                    tfSelection.style.ase = TF_AE_END;  // Active end is at the end
-                    tfSelection.style.fInterimChar = FALSE;
-
-                    hr = _pContext->SetSelection(ec, 1, &tfSelection);
-                    DebugOut(logTag, L"        SetSelection: 0x%08X", hr);
-                }
-
-                pRange->Release();
-            }
-
-            pInsertAtSelection->Release();
+            BOOL fAtStart = (-cchShifted < (LONG)c_surroundingTextMax);
+            ANJAL_TRACE(TraceSurroundingTextRead, cchText, fAtStart);
+            _pTextService->_OnSurroundingText(_pContext, achText, cchText, fAtStart);
         }
 
-        DebugOut(logTag, L"      DoEditSession END: 0x%08X", hr);
         return hr;
     }
 
 private:
     long _refCount;
+    CMurasuAnjalTextService* _pTextService;
     ITfContext* _pContext;
-    WCHAR* _pchText;
-    ULONG _cchText;
 };
 
 //
@@ -156,12 +294,17 @@ BOOL WINAPI DllMain(HINSTANCE hInstance, DWORD dwReason, LPVOID pvReserved)
     switch (dwReason)
     {
     case DLL_PROCESS_ATTACH:
-        DebugOut(logTag, L"DLL_PROCESS_ATTACH");
+        LogInfo(LogLifecycle, L"DLL_PROCESS_ATTACH");
         g_hInst = hInstance;
         DisableThreadLibraryCalls(hInstance);
         break;
     case DLL_PROCESS_DETACH:
-        DebugOut(logTag, L"DLL_PROCESS_DETACH");
+        LogInfo(LogLifecycle, L"DLL_PROCESS_DETACH");
+        // pvReserved is set when the process is exiting. A FreeLibrary
+        // needs DllCanUnloadNow first, so no text service - and no trace
+        // reference - is left then.
+        if (pvReserved != NULL)
+            TraceProcessExit();
         break;
     }
     return TRUE;
@@ -172,6 +315,11 @@ BOOL WINAPI DllMain(HINSTANCE hInstance, DWORD dwReason, LPVOID pvReserved)
 //
 STDAPI DllCanUnloadNow(void)
 {
+    // Parked instances hold the DLL; the idle ones go first
+    WarmCache<CMurasuAnjalTextService>::Released released;
+    s_warmCache.Trim(GetTickCount64(), &released);
+    CMurasuAnjalTextService::_ReleaseWarm(released);
+
     return (g_cRefDll == 0) ? S_OK : S_FALSE;
 }
 
@@ -180,16 +328,7 @@ STDAPI DllCanUnloadNow(void)
 //
 STDAPI DllGetClassObject(REFCLSID rclsid, REFIID riid, LPVOID* ppv)
 {
-	DebugOut(logTag, L"DllGetClassObject called!");
-
-    // Show which CLSID was requested
-    WCHAR msg[200];
-    LPOLESTR clsidStr;
-    StringFromCLSID(rclsid, &clsidStr);
-    DebugOut(logTag, L"Requested CLSID: %s", clsidStr);
-
-    CoTaskMemFree(clsidStr);
-	// end show CLSID
+    LatencyScope loadScope(LatencyLoad);
 
     if (!ppv)
         return E_INVALIDARG;
@@ -197,18 +336,36 @@ STDAPI DllGetClassObject(REFCLSID rclsid, REFIID riid, LPVOID* ppv)
     *ppv = NULL;
 
     if (IsEqualIID(rclsid, c_clsidTextService))
+        return s_classFactory.QueryInterface(riid, ppv);
+
+    return CLASS_E_CLASSNOTAVAILABLE;
+}
+
+//
+// AnjalTransliterate - bulk conversion through the keystroke engine. Needs
+// no activation and no COM; any thread may call it.
+//
+STDAPI AnjalTransliterate(const char16_t* pchIn, size_t cchIn, UINT layout,
+    char16_t* pchOut, size_t cchOutMax, size_t* pcchOut)
+{
+    if (pcchOut == NULL || (pchIn == NULL && cchIn > 0) || layout >= LayoutCount)
+        return E_INVALIDARG;
+
+    *pcchOut = 0;
+
+    Transliterator transliterator((LayoutId)layout);
+    if (pchOut != NULL)
     {
-        CClassFactory* pClassFactory = new CClassFactory();
-        if (pClassFactory)
+        size_t cchOut = transliterator.Convert(pchIn, cchIn, pchOut, cchOutMax);
+        if (cchOut != c_transliterateNoRoom)
         {
-            HRESULT hr = pClassFactory->QueryInterface(riid, ppv);
-            pClassFactory->Release();
-            return hr;
+            *pcchOut = cchOut;
+            return S_OK;
         }
-        return E_OUTOFMEMORY;
     }
 
-    return CLASS_E_CLASSNOTAVAILABLE;
+    *pcchOut = transliterator.Convert(pchIn, cchIn, NULL, 0);
+    return (pchOut != NULL) ? HRESULT_FROM_WIN32(ERROR_INSUFFICIENT_BUFFER) : S_OK;
 }
 
 //
@@ -235,24 +392,22 @@ STDMETHODIMP CClassFactory::QueryInterface(REFIID riid, void** ppvObj)
     return E_NOINTERFACE;
 }
 
+// The static factory is never freed; a reference on it is a reference on the DLL
 STDMETHODIMP_(ULONG) CClassFactory::AddRef()
 {
-    return InterlockedIncrement(&_refCount);
+    InterlockedIncrement(&g_cRefDll);
+    return 2;
 }
 
 STDMETHODIMP_(ULONG) CClassFactory::Release()
 {
-    LONG cr = InterlockedDecrement(&_refCount);
-    if (cr == 0)
-    {
-        delete this;
-    }
-    return cr;
+    InterlockedDecrement(&g_cRefDll);
+    return 1;
 }
 
 STDMETHODIMP CClassFactory::CreateInstance(IUnknown* pUnkOuter, REFIID riid, void** ppvObj)
 {
-	DebugOut(logTag, L"CreateInstance called!");
+    LatencyScope loadScope(LatencyLoad);
 
     if (!ppvObj)
         return E_INVALIDARG;
@@ -262,7 +417,10 @@ STDMETHODIMP CClassFactory::CreateInstance(IUnknown* pUnkOuter, REFIID riid, voi
     if (pUnkOuter != NULL)
         return CLASS_E_NOAGGREGATION;
 
-    CMurasuAnjalTextService* pTextService = new CMurasuAnjalTextService();
+    // The thread's parked instance if there is one; see WarmCache.h
+    CMurasuAnjalTextService* pTextService = CMurasuAnjalTextService::_Reattach();
+    if (pTextService == NULL)
+        pTextService = new CMurasuAnjalTextService();
     if (pTextService == NULL)
         return E_OUTOFMEMORY;
 
@@ -290,13 +448,32 @@ CMurasuAnjalTextService::CMurasuAnjalTextService()
     _tfClientId = TF_CLIENTID_NULL;
     _pThreadMgr = NULL;
     _dwThreadMgrEventSinkCookie = TF_INVALID_COOKIE;
+    _dwProfileNotifySinkCookie = TF_INVALID_COOKIE;
     _isKeyboardEnabled = TRUE;
+    _isTracing = FALSE;
+    _isEngineReady = FALSE;
+    _isReattached = FALSE;
+    _pEditSessionBlock = NULL;
+    _pFreeEditSession = NULL;
+    _pComposition = NULL;
+    _pComposingContext = NULL;
+    _cchComposingQueued = 0;
+    _pTextEditSinkContext = NULL;
+    _dwTextEditSinkCookie = TF_INVALID_COOKIE;
+    _pFocusDocumentMgr = NULL;
+    _hwndCandidates = NULL;
+    _isCandidateWorkerFailed = FALSE;
 
     InterlockedIncrement(&g_cRefDll);
 }
 
 CMurasuAnjalTextService::~CMurasuAnjalTextService()
 {
+    _UninitCandidateWorker();
+
+    // Every session holds a reference on us, so all of them are back in the pool
+    delete[] _pEditSessionBlock;
+
     InterlockedDecrement(&g_cRefDll);
 }
 
@@ -323,6 +500,18 @@ STDMETHODIMP CMurasuAnjalTextService::QueryInterface(REFIID riid, void** ppvObj)
     {
         *ppvObj = (ITfKeyEventSink*)this;
     }
+    else if (IsEqualIID(riid, IID_ITfActiveLanguageProfileNotifySink))
+    {
+        *ppvObj = (ITfActiveLanguageProfileNotifySink*)this;
+    }
+    else if (IsEqualIID(riid, IID_ITfCompositionSink))
+    {
+        *ppvObj = (ITfCompositionSink*)this;
+    }
+    else if (IsEqualIID(riid, IID_ITfTextEditSink))
+    {
+        *ppvObj = (ITfTextEditSink*)this;
+    }
 
     if (*ppvObj)
     {
@@ -350,7 +539,21 @@ STDMETHODIMP_(ULONG) CMurasuAnjalTextService::Release()
 
 STDMETHODIMP CMurasuAnjalTextService::Activate(ITfThreadMgr* pThreadMgr, TfClientId tfClientId)
 {
-	DebugOut(logTag, L"Activate() called!");
+    LatencyScope activateScope(_isReattached ? LatencyReactivate : LatencyActivate);
+    _isReattached = FALSE;
+
+    // Activated again without being released: no longer parked
+    if (s_warmCache.Remove(this))
+        Release();
+    if (_hwndCandidates != NULL)
+        KillTimer(_hwndCandidates, c_warmIdleTimer);
+
+    Debug::LoadSettings();
+	LogInfo(LogLifecycle, L"Activate() called!");
+
+    if (Debug::IsTraceRequested() && !_isTracing)
+        _isTracing = _StartTrace();
+    ANJAL_TRACE(TraceActivate, tfClientId);
 
     _pThreadMgr = pThreadMgr;
     _pThreadMgr->AddRef();
@@ -362,33 +565,45 @@ STDMETHODIMP CMurasuAnjalTextService::Activate(ITfThreadMgr* pThreadMgr, TfClien
     if (!_InitKeyEventSink())
         return E_FAIL;
 
-    // Check what app we are attaching to
+    if (!_InitProfileNotifySink())
+        return E_FAIL;
+
+    // The layout, the modifiers, the engine image and the candidate worker
+    // wait for the first key (_InitEngine); most processes never get one
+    _isEngineReady = FALSE;
+    _ResetTextEditSink();
+
+    // Check what app we are attaching to - only worth the query while tracing
     ITfThreadMgrEx* pThreadMgrEx = NULL;
-    if (SUCCEEDED(_pThreadMgr->QueryInterface(IID_ITfThreadMgrEx, (void**)&pThreadMgrEx)))
+    if (_isTracing && SUCCEEDED(_pThreadMgr->QueryInterface(IID_ITfThreadMgrEx, (void**)&pThreadMgrEx)))
     {
         DWORD dwFlags = 0;
         pThreadMgrEx->GetActiveFlags(&dwFlags);
+        ANJAL_TRACE(TraceActiveFlags, dwFlags);
 
-        if (dwFlags & TF_TMF_IMMERSIVEMODE)
-        {
-            // Running in UWP app (Search, Settings, etc.)
-            DebugOut(logTag, L"Running in IMMERSIVE MODE (UWP)");
-        }
-        else
-        {
-            // Running in desktop app
-            DebugOut(logTag, L"Running in DESKTOP MODE");
-        }
-
+        // Immersive mode: a UWP app (Search, Settings, etc.)
+        LogInfo(LogLifecycle, (dwFlags & TF_TMF_IMMERSIVEMODE) ? L"Running in IMMERSIVE MODE (UWP)" : L"Running in DESKTOP MODE");
         pThreadMgrEx->Release();
     }
-	// End check app
 
     return S_OK;
 }
 
 STDMETHODIMP CMurasuAnjalTextService::Deactivate()
 {
+    // The worker stays up for the next activation; nothing outstanding is wanted
+    _candidateWorker.Cancel();
+    _isCandidateWorkerFailed = FALSE;
+    _isEngineReady = FALSE;
+    _completion.Invalidate();
+    _UninitTextEditSink();
+    _surroundingText.Invalidate();
+
+    // No more OnUninitDocumentMgr calls, so the identities could be reused
+    _documents.Clear();
+    _pFocusDocumentMgr = NULL;
+
+    _UninitProfileNotifySink();
     _UninitKeyEventSink();
     _UninitThreadMgrEventSink();
 
@@ -399,13 +614,236 @@ STDMETHODIMP CMurasuAnjalTextService::Deactivate()
     }
 
     _tfClientId = TF_CLIENTID_NULL;
+    _keyDecision.Invalidate();
+
+    // TSF terminates the compositions of a deactivated text service
+    if (_pComposition)
+    {
+        _pComposition->Release();
+        _pComposition = NULL;
+    }
+    _composition.Clear();
+    _TrackComposing(NULL, 0);
+
+#if ANJAL_LOG_COMPILED(INFO)
+    if (Debug::IsEnabled(LogLevelInfo, LogLifecycle))
+    {
+        char achStats[1024];
+        g_latencyStats.Dump(achStats, ARRAYSIZE(achStats));
+        LogInfo(LogLifecycle, L"Keystroke latency (process totals):\n%hs", achStats);
+        LogInfo(LogLifecycle, L"Key decision cache: %llu hit(s), %llu miss(es)",
+            _keyDecision.Hits(), _keyDecision.Misses());
+
+        CandidateWorkerStats workerStats = _candidateWorker.Stats();
+        LogInfo(LogLifecycle, L"Candidate worker: %llu posted, %llu held, %llu skipped, %llu ranked, %llu stale",
+            workerStats.posted, workerStats.held, workerStats.skipped, workerStats.ranked, workerStats.stale);
+
+        WarmCacheStats warmStats = s_warmCache.Stats();
+        LogInfo(LogLifecycle, L"Warm cache: %llu parked, %llu reattached, %llu missed, %llu evicted, %llu trimmed; %zu held, %zu bytes",
+            warmStats.parked, warmStats.reattached, warmStats.missed, warmStats.evicted, warmStats.trimmed,
+            warmStats.cEntries, warmStats.cbEntries);
+    }
+#endif
+
+    ANJAL_TRACE(TraceDeactivate);
+    if (_isTracing)
+    {
+        TraceStop();
+        _isTracing = FALSE;
+    }
 
+    _Park();
     return S_OK;
 }
 
+// Warm cache (see WarmCache.h). CreateInstance takes the thread's parked
+// instance, with the cache's reference, or NULL.
+CMurasuAnjalTextService* CMurasuAnjalTextService::_Reattach()
+{
+    WarmCache<CMurasuAnjalTextService>::Released released;
+    CMurasuAnjalTextService* pTextService = s_warmCache.Take(GetCurrentThreadId(), GetTickCount64(), &released);
+    _ReleaseWarm(released);
+
+    if (pTextService)
+        pTextService->_isReattached = TRUE;
+    return pTextService;
+}
+
+// Deactivate: keeps this instance, worker and all, for the next activation
+// on this thread. Its window trims it if it stays idle.
+void CMurasuAnjalTextService::_Park()
+{
+    WarmCache<CMurasuAnjalTextService>::Released released;
+    AddRef();
+    if (!s_warmCache.Park(this, GetCurrentThreadId(), _WarmSize(), GetTickCount64(), &released))
+        Release();      // TSF still holds us here, so never the last reference
+    else if (_hwndCandidates != NULL)
+        SetTimer(_hwndCandidates, c_warmIdleTimer, (UINT)c_warmCacheIdleMs, NULL);
+
+    _ReleaseWarm(released);
+}
+
+// What keeping this instance costs: itself, the edit session pool and a
+// running worker's thread
+size_t CMurasuAnjalTextService::_WarmSize() const
+{
+    size_t cb = sizeof(*this);
+    if (_pEditSessionBlock != NULL)
+        cb += c_editSessionPoolSize * sizeof(CEditSession);
+    if (_candidateWorker.IsRunning())
+        cb += c_warmWorkerThreadBytes;
+    return cb;
+}
+
+// Instances the cache let go of. One with a window on another thread is
+// released there: its window, and messages still queued for it, belong to
+// that thread. If the thread is gone so is the window, and the post fails.
+void CMurasuAnjalTextService::_ReleaseWarm(const WarmCache<CMurasuAnjalTextService>::Released& released)
+{
+    for (size_t i = 0; i < released.c; i++)
+    {
+        CMurasuAnjalTextService* pTextService = released.ap[i];
+        HWND hwnd = pTextService->_hwndCandidates;
+        if (hwnd != NULL && GetWindowThreadProcessId(hwnd, NULL) != GetCurrentThreadId() &&
+            PostMessageW(hwnd, WM_ANJAL_RELEASE, 0, 0))
+        {
+            continue;
+        }
+
+        pTextService->Release();
+    }
+}
+
+// Candidate worker, started for the first word to complete. It posts
+// WM_ANJAL_CANDIDATES when results are waiting; the message is handled on
+// this thread, between keys. Typing works without it.
+BOOL CMurasuAnjalTextService::_InitCandidateWorker()
+{
+    if (_hwndCandidates != NULL)
+        return TRUE;
+    if (_isCandidateWorkerFailed)
+        return FALSE;
+    _isCandidateWorkerFailed = TRUE;
+
+    // Registered once per process; other instances find it already there
+    WNDCLASSEXW wc = { sizeof(wc) };
+    wc.lpfnWndProc = _CandidateWndProc;
+    wc.hInstance = g_hInst;
+    wc.lpszClassName = c_szCandidateWindowClass;
+    if (!RegisterClassExW(&wc) && GetLastError() != ERROR_CLASS_ALREADY_EXISTS)
+    {
+        LogError(LogLifecycle, L"Candidate window class not registered, no completions");
+        return FALSE;
+    }
+
+    _hwndCandidates = CreateWindowExW(0, c_szCandidateWindowClass, L"", 0, 0, 0, 0, 0,
+        HWND_MESSAGE, NULL, g_hInst, NULL);
+    if (_hwndCandidates == NULL)
+    {
+        LogError(LogLifecycle, L"Candidate window not created, no completions");
+        return FALSE;
+    }
+
+    SetWindowLongPtrW(_hwndCandidates, GWLP_USERDATA, (LONG_PTR)this);
+
+    if (!_candidateWorker.Start(&EmbeddedDictionary(), _PostCandidatesReady, _hwndCandidates))
+    {
+        _UninitCandidateWorker();
+        return FALSE;
+    }
+
+    _isCandidateWorkerFailed = FALSE;
+    return TRUE;
+}
+
+void CMurasuAnjalTextService::_UninitCandidateWorker()
+{
+    // Once the worker has stopped nothing posts to the window; messages
+    // still queued for it go with it
+    _candidateWorker.Stop();
+
+    if (_hwndCandidates != NULL)
+    {
+        // Only the owner can; a window whose thread has exited is gone already
+        if (GetWindowThreadProcessId(_hwndCandidates, NULL) == GetCurrentThreadId())
+            DestroyWindow(_hwndCandidates);
+        _hwndCandidates = NULL;
+    }
+}
+
+// Worker thread: only schedules the Receive
+void CMurasuAnjalTextService::_PostCandidatesReady(void* pv)
+{
+    PostMessageW((HWND)pv, WM_ANJAL_CANDIDATES, 0, 0);
+}
+
+LRESULT CALLBACK CMurasuAnjalTextService::_CandidateWndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
+{
+    CMurasuAnjalTextService* pThis = (CMurasuAnjalTextService*)GetWindowLongPtrW(hwnd, GWLP_USERDATA);
+    if (pThis == NULL)
+        return DefWindowProcW(hwnd, uMsg, wParam, lParam);
+
+    switch (uMsg)
+    {
+    case WM_ANJAL_CANDIDATES:
+        pThis->_OnCandidatesReady();
+        return 0;
+
+    case WM_ANJAL_RELEASE:
+        pThis->Release();
+        return 0;
+
+    case WM_TIMER:
+        // Parked and idle. Another thread may have trimmed it meanwhile;
+        // then the cache no longer has it and the release is on its way here.
+        if (wParam == c_warmIdleTimer)
+        {
+            KillTimer(hwnd, c_warmIdleTimer);
+            if (s_warmCache.Remove(pThis))
+                pThis->Release();
+            return 0;
+        }
+        break;
+    }
+
+    return DefWindowProcW(hwnd, uMsg, wParam, lParam);
+}
+
+// Anything for an older keystroke is dropped by Receive
+void CMurasuAnjalTextService::_OnCandidatesReady()
+{
+    CandidateResult result;
+    if (!_candidateWorker.Receive(&result))
+        return;
+
+    g_latencyStats.Record(LatencyCandidates, result.postNs, LatencyNow());
+    _completion.SetCandidates(result.list);
+    LogVerbose(LogKeystroke, L"Completions: %u", result.list.cCandidates);
+}
+
+// Binary trace to %TEMP%\AnjalCore-<pid>.trace; decode with tools\TraceDecode
+BOOL CMurasuAnjalTextService::_StartTrace()
+{
+    WCHAR achPath[MAX_PATH];
+    DWORD cchTemp = GetTempPathW(ARRAYSIZE(achPath), achPath);
+    if (cchTemp == 0 || cchTemp >= ARRAYSIZE(achPath))
+        return FALSE;
+
+    if (FAILED(StringCchPrintfW(achPath + cchTemp, ARRAYSIZE(achPath) - cchTemp,
+        L"AnjalCore-%u.trace", GetCurrentProcessId())))
+        return FALSE;
+
+    FILE* pFile = NULL;
+    if (_wfopen_s(&pFile, achPath, L"wb") != 0 || !pFile)
+        return FALSE;
+
+    LogInfo(LogLifecycle, L"Tracing to %s", achPath);
+    return TraceStart(pFile) ? TRUE : FALSE;
+}
+
 STDMETHODIMP CMurasuAnjalTextService::ActivateEx(ITfThreadMgr* ptim, TfClientId tid, DWORD dwFlags)
 {
-	DebugOut(logTag, L"ActivateEx() called!");
+	LogInfo(LogLifecycle, L"ActivateEx() called!");
 
     return Activate(ptim, tid);
 }
@@ -441,44 +879,329 @@ void CMurasuAnjalTextService::_UninitThreadMgrEventSink()
     }
 }
 
-STDMETHODIMP CMurasuAnjalTextService::OnInitDocumentMgr(ITfDocumentMgr* pDocMgr)
+// Active Language Profile Notify Sink - tells us when the user switches layouts
+BOOL CMurasuAnjalTextService::_InitProfileNotifySink()
 {
-    return S_OK;
-}
+    ITfSource* pSource = NULL;
+    HRESULT hr = _pThreadMgr->QueryInterface(IID_ITfSource, (void**)&pSource);
 
-STDMETHODIMP CMurasuAnjalTextService::OnUninitDocumentMgr(ITfDocumentMgr* pDocMgr)
-{
-    return S_OK;
-}
+    if (SUCCEEDED(hr))
+    {
+        hr = pSource->AdviseSink(IID_ITfActiveLanguageProfileNotifySink,
+            (ITfActiveLanguageProfileNotifySink*)this,
+            &_dwProfileNotifySinkCookie);
+        pSource->Release();
+    }
 
-STDMETHODIMP CMurasuAnjalTextService::OnSetFocus(ITfDocumentMgr* pDocMgrFocus, ITfDocumentMgr* pDocMgrPrevFocus)
-{
-    return S_OK;
+    return SUCCEEDED(hr);
 }
 
-STDMETHODIMP CMurasuAnjalTextService::OnPushContext(ITfContext* pContext)
+void CMurasuAnjalTextService::_UninitProfileNotifySink()
 {
-    return S_OK;
+    if (_dwProfileNotifySinkCookie != TF_INVALID_COOKIE)
+    {
+        ITfSource* pSource = NULL;
+        if (SUCCEEDED(_pThreadMgr->QueryInterface(IID_ITfSource, (void**)&pSource)))
+        {
+            pSource->UnadviseSink(_dwProfileNotifySinkCookie);
+            pSource->Release();
+        }
+        _dwProfileNotifySinkCookie = TF_INVALID_COOKIE;
+    }
 }
 
-STDMETHODIMP CMurasuAnjalTextService::OnPopContext(ITfContext* pContext)
+// Text edit sink on the top context of the focused document. Once the
+// engine is set up, advising also starts the one read of the text before the
+// caret for this focus; before the first key it waits for _InitEngine.
+BOOL CMurasuAnjalTextService::_InitTextEditSink(ITfDocumentMgr* pDocMgr)
 {
-    return S_OK;
-}
+    _UninitTextEditSink();
+    _surroundingText.Invalidate();
 
-// Key Event Sink
-BOOL CMurasuAnjalTextService::_InitKeyEventSink()
-{
-    ITfKeystrokeMgr* pKeystrokeMgr = NULL;
-    HRESULT hr = _pThreadMgr->QueryInterface(IID_ITfKeystrokeMgr, (void**)&pKeystrokeMgr);
+    if (pDocMgr == NULL)
+        return TRUE;
 
-	DebugOut(logTag, SUCCEEDED(hr) ? L"Got KeystrokeMgr" : L"FAILED to get KeystrokeMgr"); 
+    if (FAILED(pDocMgr->GetTop(&_pTextEditSinkContext)) || _pTextEditSinkContext == NULL)
+    {
+        _pTextEditSinkContext = NULL;
+        return FALSE;
+    }
+
+    ITfSource* pSource = NULL;
+    HRESULT hr = _pTextEditSinkContext->QueryInterface(IID_ITfSource, (void**)&pSource);
+
+    if (SUCCEEDED(hr))
+    {
+        hr = pSource->AdviseSink(IID_ITfTextEditSink, (ITfTextEditSink*)this, &_dwTextEditSinkCookie);
+        pSource->Release();
+    }
+
+    if (FAILED(hr))
+    {
+        _dwTextEditSinkCookie = TF_INVALID_COOKIE;
+        _pTextEditSinkContext->Release();
+        _pTextEditSinkContext = NULL;
+        return FALSE;
+    }
+
+    if (_isEngineReady)
+        _RequestSurroundingText();
+
+    return TRUE;
+}
+
+// The one read of the text before the caret in the sink's context
+void CMurasuAnjalTextService::_RequestSurroundingText()
+{
+    if (_pTextEditSinkContext == NULL)
+        return;
+
+    CSurroundingTextSession* pSession = new CSurroundingTextSession(this, _pTextEditSinkContext);
+    if (pSession)
+    {
+        HRESULT hrSession = S_OK;
+        HRESULT hr = _pTextEditSinkContext->RequestEditSession(_tfClientId, pSession, TF_ES_ASYNCDONTCARE | TF_ES_READ, &hrSession);
+        LogVerbose(LogEditSession, L"  Surrounding text session: hr=0x%08X, hrSession=0x%08X", hr, hrSession);
+        pSession->Release();
+    }
+}
+
+void CMurasuAnjalTextService::_UninitTextEditSink()
+{
+    if (_pTextEditSinkContext == NULL)
+        return;
+
+    if (_dwTextEditSinkCookie != TF_INVALID_COOKIE)
+    {
+        ITfSource* pSource = NULL;
+        if (SUCCEEDED(_pTextEditSinkContext->QueryInterface(IID_ITfSource, (void**)&pSource)))
+        {
+            pSource->UnadviseSink(_dwTextEditSinkCookie);
+            pSource->Release();
+        }
+        _dwTextEditSinkCookie = TF_INVALID_COOKIE;
+    }
+
+    _pTextEditSinkContext->Release();
+    _pTextEditSinkContext = NULL;
+}
+
+// The top context of the focused document may have changed
+void CMurasuAnjalTextService::_ResetTextEditSink()
+{
+    ITfDocumentMgr* pDocMgr = NULL;
+    if (_pThreadMgr && SUCCEEDED(_pThreadMgr->GetFocus(&pDocMgr)))
+    {
+        _pFocusDocumentMgr = pDocMgr;
+        _InitTextEditSink(pDocMgr);
+        if (pDocMgr)
+            pDocMgr->Release();
+    }
+    else
+    {
+        _pFocusDocumentMgr = NULL;
+        _InitTextEditSink(NULL);
+    }
+}
+
+// Result of CSurroundingTextSession. When nothing has been typed since the
+// focus change, the engine picks up the syllable before the caret: the one
+// the document was left with if the text still agrees, else from the text.
+void CMurasuAnjalTextService::_OnSurroundingText(ITfContext* pContext, const WCHAR* pchText, ULONG cchText, BOOL fAtStart)
+{
+    // A later focus change has its own read
+    if (pContext != _pTextEditSinkContext)
+        return;
+
+    _surroundingText.Fill(pContext, (const char16_t*)pchText, cchText, fAtStart != FALSE);
+
+    if (_engine.ComposingLength() == 0 && _pendingOutput.Count() == 0 && _pComposition == NULL)
+    {
+        // Reads start only once the engine is set up; checked in case one
+        // requested before a Deactivate completes after the next Activate
+        if (_isEngineReady && !_RestoreDocumentState())
+            _engine.Resume(_surroundingText.Text(), _surroundingText.Length());
+        _completion.Resume(_surroundingText.Text(), _surroundingText.Length(), _surroundingText.AtStart());
+        _candidateWorker.Cancel();
+    }
+}
+
+// The focused document's engine state as it lost focus, if that syllable
+// can continue: same layout, and the text before the caret still ends the
+// way it did. Phonetic input keeps keys the text alone does not show.
+BOOL CMurasuAnjalTextService::_RestoreDocumentState()
+{
+    const DocumentState* pState = _documents.Find(_pFocusDocumentMgr);
+    if (pState == NULL || pState->engine.GetLayout() != _engine.GetLayout() || !pState->Matches(_surroundingText))
+        return FALSE;
+
+    _engine = pState->engine;
+    _keyDecision.Invalidate();
+    LogVerbose(LogLifecycle, L"Restored the document's open syllable (%u units)", (UINT)_engine.ComposingLength());
+    return TRUE;
+}
+
+// Picks up the layout that is active when the first key arrives; later
+// switches arrive through OnActivated. Keeps the current layout if the
+// profile cannot be read.
+void CMurasuAnjalTextService::_SelectLayoutFromActiveProfile()
+{
+    const LayoutDescriptor* pLayout = _engine.GetLayout();
+
+    ITfInputProcessorProfileMgr* pProfileMgr = NULL;
+    if (SUCCEEDED(CoCreateInstance(CLSID_TF_InputProcessorProfiles, NULL, CLSCTX_INPROC_SERVER,
+        IID_ITfInputProcessorProfileMgr, (void**)&pProfileMgr)))
+    {
+        TF_INPUTPROCESSORPROFILE profile;
+        if (pProfileMgr->GetActiveProfile(GUID_TFCAT_TIP_KEYBOARD, &profile) == S_OK &&
+            IsEqualGUID(profile.clsid, c_clsidTextService) &&
+            _FindLayout(profile.guidProfile) != NULL)
+        {
+            pLayout = _FindLayout(profile.guidProfile);
+        }
+
+        pProfileMgr->Release();
+    }
+
+    _engine.SetLayout(pLayout);
+}
+
+// Setup deferred from Activate to the first key: most processes the DLL is
+// loaded into never get one
+void CMurasuAnjalTextService::_InitEngine()
+{
+#ifdef _DEBUG
+    // The embedded image is generated; a layout edited since is not in it
+    if (!EmbeddedImage().MatchesSources())
+        LogError(LogLifecycle, L"Engine image does not match the layout sources - rerun tools\\ImageBuild");
+#endif
+
+    _SelectLayoutFromActiveProfile();
+    _SyncModifiers();
+    _keyDecision.Invalidate();
+
+    // The text before the caret was not read on focus while the engine
+    // waited; read it now. _OnSurroundingText resumes the engine from it,
+    // before this key if the application grants the read at once.
+    _isEngineReady = TRUE;
+    ANJAL_TRACE(TraceEngineReady, _engine.GetLayout()->id);
+    if (!_surroundingText.IsValid(_pTextEditSinkContext))
+        _RequestSurroundingText();
+}
+
+const LayoutDescriptor* CMurasuAnjalTextService::_FindLayout(REFGUID guidProfile)
+{
+    for (int i = 0; i < LayoutCount; i++)
+    {
+        if (IsEqualGUID(guidProfile, *c_layoutProfiles[i]))
+            return &g_layouts[i];
+    }
+    return NULL;
+}
+
+STDMETHODIMP CMurasuAnjalTextService::OnActivated(REFCLSID clsid, REFGUID guidProfile, BOOL fActivated)
+{
+    if (!fActivated || !IsEqualGUID(clsid, c_clsidTextService))
+        return S_OK;
+
+    // Layout switch: a pointer swap, the tables are static
+    const LayoutDescriptor* pLayout = _FindLayout(guidProfile);
+    if (pLayout)
+    {
+        _engine.SetLayout(pLayout);
+        _keyDecision.Invalidate();
+        ANJAL_TRACE(TraceLayoutSwitch, pLayout->id);
+        LogInfo(LogLifecycle, L"Layout switched: %s", (const WCHAR*)pLayout->description);
+    }
+
+    return S_OK;
+}
+
+STDMETHODIMP CMurasuAnjalTextService::OnInitDocumentMgr(ITfDocumentMgr* pDocMgr)
+{
+    _documents.Insert(pDocMgr);
+    return S_OK;
+}
+
+STDMETHODIMP CMurasuAnjalTextService::OnUninitDocumentMgr(ITfDocumentMgr* pDocMgr)
+{
+    _documents.Remove(pDocMgr);
+    if (pDocMgr == _pFocusDocumentMgr)
+        _pFocusDocumentMgr = NULL;
+    return S_OK;
+}
+
+STDMETHODIMP CMurasuAnjalTextService::OnSetFocus(ITfDocumentMgr* pDocMgrFocus, ITfDocumentMgr* pDocMgrPrevFocus)
+{
+    // The document losing focus keeps its open syllable, for when it comes
+    // back (see _RestoreDocumentState). Not while its text is unknown or
+    // output is still queued for it.
+    DocumentState* pState = _documents.Insert(_pFocusDocumentMgr);
+    if (pState != NULL)
+    {
+        pState->engine = _engine;
+        pState->textBefore = _surroundingText;
+        pState->fSaved = _isEngineReady && _pendingOutput.Count() == 0 &&
+            _surroundingText.IsValid(_pTextEditSinkContext);
+    }
+    _pFocusDocumentMgr = pDocMgrFocus;
+
+    // A syllable does not continue into another document
+    _engine.Reset();
+    _CommitComposition();
+    _completion.Invalidate();
+    _candidateWorker.Cancel();
+    _keyDecision.Invalidate();
+    _InitTextEditSink(pDocMgrFocus);
+    return S_OK;
+}
+
+STDMETHODIMP CMurasuAnjalTextService::OnPushContext(ITfContext* pContext)
+{
+    _keyDecision.Invalidate();
+    _ResetTextEditSink();
+    return S_OK;
+}
+
+STDMETHODIMP CMurasuAnjalTextService::OnPopContext(ITfContext* pContext)
+{
+    _keyDecision.Invalidate();
+    _ResetTextEditSink();
+    return S_OK;
+}
+
+// Called after every edit session that changed the context, ours included.
+// Ours were already applied to the surrounding text; any other edit (the
+// application, another text service, a mouse click) invalidates it.
+STDMETHODIMP CMurasuAnjalTextService::OnEndEdit(ITfContext* pContext, TfEditCookie ecReadOnly, ITfEditRecord* pEditRecord)
+{
+    bool fWasValid = _surroundingText.IsValid(pContext);
+    _surroundingText.OnEndEdit(pContext);
+
+    if (fWasValid && !_surroundingText.IsValid(pContext))
+    {
+        LogVerbose(LogEditSession, L"OnEndEdit: edited by someone else, surrounding text dropped");
+        _completion.Invalidate();
+        _candidateWorker.Cancel();
+        ANJAL_TRACE(TraceForeignEdit, (ULONG_PTR)pContext);
+    }
+
+    return S_OK;
+}
+
+// Key Event Sink
+BOOL CMurasuAnjalTextService::_InitKeyEventSink()
+{
+    ITfKeystrokeMgr* pKeystrokeMgr = NULL;
+    HRESULT hr = _pThreadMgr->QueryInterface(IID_ITfKeystrokeMgr, (void**)&pKeystrokeMgr);
+
+	LogInfo(LogLifecycle, SUCCEEDED(hr) ? L"Got KeystrokeMgr" : L"FAILED to get KeystrokeMgr"); 
 
     if (SUCCEEDED(hr))
     {
         hr = pKeystrokeMgr->AdviseKeyEventSink(_tfClientId, (ITfKeyEventSink*)this, TRUE);
 
-		DebugOut(logTag, SUCCEEDED(hr) ? L"AdviseKeyEventSink OK" : L"AdviseKeyEventSink FAILED"); 
+		LogInfo(LogLifecycle, SUCCEEDED(hr) ? L"AdviseKeyEventSink OK" : L"AdviseKeyEventSink FAILED"); 
         pKeystrokeMgr->Release();
     }
 
@@ -497,22 +1220,39 @@ void CMurasuAnjalTextService::_UninitKeyEventSink()
 
 STDMETHODIMP CMurasuAnjalTextService::OnSetFocus(BOOL fForeground)
 {
+    _engine.Reset();
+    _CommitComposition();
+    _completion.Invalidate();
+    _candidateWorker.Cancel();
+    _keyDecision.Invalidate();
+
+    // Modifiers may have changed while another application had the keyboard
+    if (fForeground)
+        _SyncModifiers();
     return S_OK;
 }
 
 STDMETHODIMP CMurasuAnjalTextService::OnTestKeyDown(ITfContext* pContext, WPARAM wParam, LPARAM lParam, BOOL* pfEaten)
 {
+    LatencyScope testKeyScope(LatencyTestKeyDown);
+    LatencyScope firstKeyScope(LatencyFirstKey, !_isEngineReady);
+
     if (!pfEaten)
         return E_INVALIDARG;
 
     *pfEaten = FALSE;
 
+    if (!_isEngineReady)
+        _InitEngine();
+
+    _modifiers.OnKeyDown(wParam, lParam);
+
     if (!_isKeyboardEnabled)
         return S_OK;
 
-    // Check if this key has a Tamil mapping
-    wchar_t tamilChar = _MapKeyToTamil(wParam);
-    if (tamilChar != 0)
+    // Check if this key has a Tamil mapping; the full decision is kept for OnKeyDown
+    const KeyDecision& decision = _DecideKey(pContext, wParam, lParam);
+    if (decision.code != 0)
     {
         *pfEaten = TRUE;
     }
@@ -522,12 +1262,15 @@ STDMETHODIMP CMurasuAnjalTextService::OnTestKeyDown(ITfContext* pContext, WPARAM
 
 STDMETHODIMP CMurasuAnjalTextService::OnKeyDown(ITfContext* pContext, WPARAM wParam, LPARAM lParam, BOOL* pfEaten)
 {
-    DebugOut(logTag, L"=== OnKeyDown ===");
-    DebugOut(logTag, L"  Context: %p", pContext);
+    LatencyScope keyDownScope(LatencyKeyDown);
+    LatencyScope firstKeyScope(LatencyFirstKey, !_isEngineReady);
+
+    LogVerbose(LogKeystroke, L"=== OnKeyDown ===");
+    LogVerbose(LogKeystroke, L"  Context: %p", pContext);
 
     if (!pContext)
     {
-        DebugOut(logTag, L"  ERROR: NULL Context!");
+        LogError(LogKeystroke, L"  ERROR: NULL Context!");
         *pfEaten = FALSE;
         return S_OK;
     }
@@ -537,23 +1280,160 @@ STDMETHODIMP CMurasuAnjalTextService::OnKeyDown(ITfContext* pContext, WPARAM wPa
 
     *pfEaten = FALSE;
 
+    if (!_isEngineReady)
+        _InitEngine();
+
+    _modifiers.OnKeyDown(wParam, lParam);
+
     if (!_isKeyboardEnabled || !pContext)
         return S_OK;
 
+    ANJAL_TRACE(TraceKeyDown, wParam, lParam);
+
+#if ANJAL_LOG_COMPILED(VERBOSE)
     // ========== COMPREHENSIVE KEY LOGGING ==========
+    // Only worth the Win32 round trips when someone is listening
+    if (Debug::IsEnabled(LogLevelVerbose, LogKeystroke))
+        _LogKeyDetails(wParam, lParam);
+#endif
+
+    // Normally computed by OnTestKeyDown already; consumed here either way
+    ULONGLONG mappingNs = LatencyNow();
+    const KeyDecision& decision = _DecideKey(pContext, wParam, lParam);
+    _keyDecision.Invalidate();
+
+    wchar_t tamilChar = decision.code;
+    if (tamilChar != 0)
+    {
+        LogVerbose(LogKeystroke, L"  Layout Mapping: U+%04X ('%c')", tamilChar, tamilChar);
+        ANJAL_TRACE(TraceKeyMapped, tamilChar);
+
+        // ✅ ADD DEFENSIVE CHECKS AND LOGGING
+        LogVerbose(LogKeystroke, L"  About to insert text...");
+
+        // Check pContext validity
+        if (!pContext)
+        {
+            LogError(LogKeystroke, L"  ERROR: pContext is NULL!");
+            return S_OK;
+        }
+
+        LogVerbose(LogKeystroke, L"  pContext valid: 0x%p", pContext);
+        LogVerbose(LogKeystroke, L"  _tfClientId: 0x%08X", _tfClientId);
+
+        // Auto-repeat may report several presses in one message; each one
+        // goes through the engine and into the same pending batch
+        UINT cRepeat = LOWORD(lParam);
+        if (cRepeat == 0)
+            cRepeat = 1;
+        else if (cRepeat > c_maxKeyRepeat)
+            cRepeat = c_maxKeyRepeat;
+
+        HRESULT hr = S_OK;
+        for (UINT iRepeat = 0; iRepeat < cRepeat && SUCCEEDED(hr); iRepeat++)
+        {
+            // Run the key through the active layout's composition rules.
+            // The first press was already run against a copy of the engine.
+            EngineOutput output;
+            BOOL fConsumed;
+            if (iRepeat == 0)
+            {
+                output = decision.output;
+                fConsumed = decision.consumed;
+                _engine = decision.next;
+                g_latencyStats.Record(LatencyMapping, mappingNs, LatencyNow());
+            }
+            else
+            {
+                fConsumed = _engine.ProcessKey((char16_t)tamilChar, &output);
+            }
+
+            if (!fConsumed)
+            {
+                LogVerbose(LogKeystroke, L"  Engine did not consume key");
+                return S_OK;
+            }
+
+            LogVerbose(LogKeystroke, L"  Engine output: %d code unit(s)", output.cchText);
+            ANJAL_TRACE(TraceEngineOutput, output.cchDelete, output.cchText, output.text[0]);
+            _completion.Apply(output.cchDelete, output.text, output.cchText);
+
+            // A vowel after a consonant may produce nothing (inherent அ) but
+            // still closes the syllable
+            ULONG cchComposing = (ULONG)_engine.ComposingLength();
+            if (output.cchText > 0 || output.cchDelete > 0 || cchComposing != _cchComposingQueued)
+            {
+                // Queue the Tamil character(s); merged with keys still waiting for their session
+                hr = _InsertTextAtSelection(pContext, (const WCHAR*)output.text, output.cchText, output.cchDelete,
+                    cchComposing, keyDownScope.StartNs());
+                LogVerbose(LogKeystroke, L"  _InsertTextAtSelection returned: 0x%08X", hr);
+            }
+        }
+
+        ANJAL_TRACE(TraceKeyEaten, (ULONG)hr);
+        if (SUCCEEDED(hr))
+        {
+            *pfEaten = TRUE;
+            LogVerbose(LogKeystroke, L"  Action: Successfully inserted Tamil char, ate key");
+
+            // Complete the word once its last syllable is closed. The worker
+            // ranks it; anything it still has for an earlier key is stale.
+            if (_engine.ComposingLength() == 0 && _completion.Length() > 0 && _InitCandidateWorker())
+                _candidateWorker.Post(_completion.Word(), _completion.Length());
+            else
+                _candidateWorker.Cancel();
+        }
+        else
+        {
+            _engine.Reset();
+            _CommitComposition();
+            _completion.Invalidate();
+            _candidateWorker.Cancel();
+            LogError(LogKeystroke, L"  ERROR: Failed to insert text, hr=0x%08X", hr);
+        }
+    }
+    else
+    {
+        // Anything other than a modifier ends the pending syllable
+        if (!_IsModifierKey(wParam))
+        {
+            _engine.Reset();
+            _CommitComposition();
+
+            // Space, Tab and Enter end the word; editing and navigation
+            // keys leave the caret somewhere we cannot see
+            if (wParam == VK_SPACE || wParam == VK_TAB || wParam == VK_RETURN)
+                _completion.Reset();
+            else
+                _completion.Invalidate();
+            _candidateWorker.Cancel();
+            ANJAL_TRACE(TraceKeyReset, wParam);
+        }
+
+        LogVerbose(LogKeystroke, L"  Layout Mapping: None (0x0000)");
+        LogVerbose(LogKeystroke, L"  Action: Not eating key");
+    }
 
-    DebugOut(logTag, L"=== OnKeyDown ===");
-    DebugOut(logTag, L"  Virtual Key Code (wParam): 0x%02X (%d)", wParam, wParam);
+    LogVerbose(LogKeystroke, L"=== End OnKeyDown ===");
+
+    return S_OK;
+}
+
+#if ANJAL_LOG_COMPILED(VERBOSE)
+// Dumps everything Windows knows about a key - diagnostics only
+void CMurasuAnjalTextService::_LogKeyDetails(WPARAM wParam, LPARAM lParam)
+{
+    LogVerbose(LogKeystroke, L"  Virtual Key Code (wParam): 0x%02X (%d)", wParam, wParam);
 
     WCHAR keyName[256] = { 0 };
     GetKeyNameTextW((LONG)lParam, keyName, 256);
-    DebugOut(logTag, L"  Key Name: %s", keyName);
+    LogVerbose(LogKeystroke, L"  Key Name: %s", keyName);
 
-    DebugOut(logTag, L"  lParam: 0x%08X", lParam);
+    LogVerbose(LogKeystroke, L"  lParam: 0x%08X", lParam);
     UINT scanCode = (lParam >> 16) & 0xFF;
-    DebugOut(logTag, L"    Scan Code: 0x%02X (%d)", scanCode, scanCode);
-    DebugOut(logTag, L"    Extended: %d", (lParam >> 24) & 0x01);
-    DebugOut(logTag, L"    Alt Down: %d", (lParam >> 29) & 0x01);
+    LogVerbose(LogKeystroke, L"    Scan Code: 0x%02X (%d)", scanCode, scanCode);
+    LogVerbose(LogKeystroke, L"    Extended: %d", (lParam >> 24) & 0x01);
+    LogVerbose(LogKeystroke, L"    Alt Down: %d", (lParam >> 29) & 0x01);
 
     BYTE keyboardState[256] = { 0 };
     GetKeyboardState(keyboardState);
@@ -563,165 +1443,493 @@ STDMETHODIMP CMurasuAnjalTextService::OnKeyDown(ITfContext* pContext, WPARAM wPa
 
     if (result > 0)
     {
-        DebugOut(logTag, L"  ToUnicode Result: '%s' (U+%04X)", unicodeChars, unicodeChars[0]);
+        LogVerbose(LogKeystroke, L"  ToUnicode Result: '%s' (U+%04X)", unicodeChars, unicodeChars[0]);
         for (int i = 0; i < result; i++)
         {
-            DebugOut(logTag, L"    Char[%d]: U+%04X ('%c')", i, unicodeChars[i], unicodeChars[i]);
+            LogVerbose(LogKeystroke, L"    Char[%d]: U+%04X ('%c')", i, unicodeChars[i], unicodeChars[i]);
         }
     }
     else if (result == 0)
     {
-        DebugOut(logTag, L"  ToUnicode Result: No translation");
+        LogVerbose(LogKeystroke, L"  ToUnicode Result: No translation");
     }
     else
     {
-        DebugOut(logTag, L"  ToUnicode Result: Dead key");
+        LogVerbose(LogKeystroke, L"  ToUnicode Result: Dead key");
     }
 
     HKL hkl = GetKeyboardLayout(0);
-    DebugOut(logTag, L"  Current HKL: 0x%08X", hkl);
+    LogVerbose(LogKeystroke, L"  Current HKL: 0x%08X", hkl);
     LANGID langId = LOWORD(hkl);
-    DebugOut(logTag, L"  Language ID: 0x%04X (%d)", langId, langId);
+    LogVerbose(LogKeystroke, L"  Language ID: 0x%04X (%d)", langId, langId);
+}
+#endif
 
-    wchar_t tamilChar = _MapKeyToTamil(wParam);
-    if (tamilChar != 0)
+STDMETHODIMP CMurasuAnjalTextService::OnTestKeyUp(ITfContext* pContext, WPARAM wParam, LPARAM lParam, BOOL* pfEaten)
+{
+    if (!pfEaten)
+        return E_INVALIDARG;
+
+    *pfEaten = FALSE;
+    _modifiers.OnKeyUp(wParam, lParam);
+    return S_OK;
+}
+
+STDMETHODIMP CMurasuAnjalTextService::OnKeyUp(ITfContext* pContext, WPARAM wParam, LPARAM lParam, BOOL* pfEaten)
+{
+    if (!pfEaten)
+        return E_INVALIDARG;
+
+    *pfEaten = FALSE;
+    _modifiers.OnKeyUp(wParam, lParam);
+    return S_OK;
+}
+
+STDMETHODIMP CMurasuAnjalTextService::OnPreservedKey(ITfContext* pContext, REFGUID rguid, BOOL* pfEaten)
+{
+    if (!pfEaten)
+        return E_INVALIDARG;
+
+    *pfEaten = FALSE;
+    return S_OK;
+}
+
+// Edit session pool. The block is allocated on first use; after that typing
+// never touches the heap unless more sessions are in flight than the pool holds.
+// Sessions are created and released on the text service's (apartment) thread.
+CEditSession* CMurasuAnjalTextService::_AcquireEditSession()
+{
+    if (_pEditSessionBlock == NULL)
     {
-        DebugOut(logTag, L"  Your Tamil99 Mapping: U+%04X ('%c')", tamilChar, tamilChar);
+        _pEditSessionBlock = new CEditSession[c_editSessionPoolSize];
+        if (_pEditSessionBlock)
+        {
+            for (size_t i = 0; i < c_editSessionPoolSize; i++)
+            {
+                _pEditSessionBlock[i]._fPooled = TRUE;
+                _ReturnEditSession(&_pEditSessionBlock[i]);
+            }
+        }
+    }
 
-        // ✅ ADD DEFENSIVE CHECKS AND LOGGING
-        DebugOut(logTag, L"  About to insert text...");
+    CEditSession* pEditSession = _pFreeEditSession;
+    if (pEditSession)
+    {
+        _pFreeEditSession = pEditSession->_pNextFree;
+        pEditSession->_pNextFree = NULL;
+        return pEditSession;
+    }
 
-        // Check pContext validity
-        if (!pContext)
+    LogVerbose(LogEditSession, L"    Edit session pool empty, allocating");
+    return new CEditSession();
+}
+
+void CMurasuAnjalTextService::_ReturnEditSession(CEditSession* pEditSession)
+{
+    pEditSession->_pNextFree = _pFreeEditSession;
+    _pFreeEditSession = pEditSession;
+}
+
+// Replaces cchDelete units before the selection with the text and moves the
+// caret after it. Used when no syllable is open.
+HRESULT CMurasuAnjalTextService::_SetTextAtSelection(TfEditCookie ec, ITfContext* pContext, const WCHAR* pchText, ULONG cchText, ULONG cchDelete)
+{
+    HRESULT hr = E_FAIL;
+    ITfInsertAtSelection* pInsertAtSelection = NULL;
+    ITfRange* pRange = NULL;
+
+    hr = pContext->QueryInterface(IID_ITfInsertAtSelection, (void**)&pInsertAtSelection);
+    LogVerbose(LogEditSession, L"        QI ITfInsertAtSelection: 0x%08X", hr);
+
+    if (SUCCEEDED(hr))
+    {
+        LogVerbose(LogEditSession, L"        Method: QUERYONLY + SetText + Move cursor");
+
+        // Get the current selection range
+        hr = pInsertAtSelection->InsertTextAtSelection(ec,
+            TF_IAS_QUERYONLY,
+            NULL,
+            0,
+            &pRange);
+
+        LogVerbose(LogEditSession, L"        InsertTextAtSelection(QUERYONLY): 0x%08X", hr);
+
+        if (SUCCEEDED(hr) && pRange)
         {
-            DebugOut(logTag, L"  ERROR: pContext is NULL!");
-            return S_OK;
+            // Collapse to insertion point (start of selection)
+            hr = pRange->Collapse(ec, TF_ANCHOR_START);
+            LogVerbose(LogEditSession, L"        Collapse to START: 0x%08X", hr);
+
+            // Extend back over text the engine is rewriting (e.g. ெ -> ொ)
+            if (cchDelete > 0)
+            {
+                LONG cchShifted;
+                hr = pRange->ShiftStart(ec, -(LONG)cchDelete, &cchShifted, NULL);
+                LogVerbose(LogEditSession, L"        ShiftStart(-%d chars): 0x%08X, moved=%d", cchDelete, hr, cchShifted);
+            }
+
+            // Insert the text of every merged key at once
+            hr = pRange->SetText(ec, 0, pchText, cchText);
+            LogVerbose(LogEditSession, L"        SetText: 0x%08X", hr);
+
+            if (SUCCEEDED(hr))
+            {
+                // ✅ Move the range to END of the text we just inserted
+                // ShiftEnd moves the end anchor forward by the length of text
+                LONG cch;
+                hr = pRange->ShiftEnd(ec, cchText, &cch, NULL);
+                LogVerbose(LogEditSession, L"        ShiftEnd(%d chars): 0x%08X, moved=%d", cchText, hr, cch);
+
+                // Collapse to the end (this puts both anchors at the end)
+                hr = pRange->Collapse(ec, TF_ANCHOR_END);
+                LogVerbose(LogEditSession, L"        Collapse to END: 0x%08X", hr);
+
+                // Set this as the new selection (cursor position)
+                TF_SELECTION tfSelection;
+                tfSelection.range = pRange;
+                tfSelection.style.ase = TF_AE_END;  // Active end is at the end
+                tfSelection.style.fInterimChar = FALSE;
+
+                ULONGLONG selectionNs = LatencyNow();
+                hr = pContext->SetSelection(ec, 1, &tfSelection);
+                g_latencyStats.Record(LatencySetSelection, selectionNs, LatencyNow());
+                LogVerbose(LogEditSession, L"        SetSelection: 0x%08X", hr);
+            }
+
+            pRange->Release();
         }
 
-        DebugOut(logTag, L"  pContext valid: 0x%p", pContext);
-        DebugOut(logTag, L"  _tfClientId: 0x%08X", _tfClientId);
+        pInsertAtSelection->Release();
+    }
+
+    return hr;
+}
+
+// Applies a batch while a syllable is open. The range's current text comes
+// from _composition, so a rewrite is one SetText over the whole range with
+// no GetText. The committed prefix is then shifted out of the composition,
+// or the composition ends when the syllable is complete.
+HRESULT CMurasuAnjalTextService::_UpdateComposition(TfEditCookie ec, ITfContext* pContext, const PendingBatch& batch)
+{
+    CompositionUpdate update;
+    _composition.Apply(batch.cchDelete, batch.text, batch.cchText, batch.cchComposing, &update);
 
-        // Insert the Tamil character with error checking
-        HRESULT hr = _InsertTextAtSelection(pContext, &tamilChar, 1);
+    LogVerbose(LogEditSession, L"        Composition: %u unit(s), commit %u, delete before %u",
+        update.cchText, update.cchCommit, update.cchDeleteBefore);
 
-        DebugOut(logTag, L"  _InsertTextAtSelection returned: 0x%08X", hr);
+    HRESULT hr = S_OK;
+    if (_pComposition == NULL)
+    {
+        // New syllable: start the composition at the selection
+        ITfInsertAtSelection* pInsertAtSelection = NULL;
+        ITfContextComposition* pContextComposition = NULL;
+        ITfRange* pRangeStart = NULL;
 
+        hr = pContext->QueryInterface(IID_ITfInsertAtSelection, (void**)&pInsertAtSelection);
         if (SUCCEEDED(hr))
         {
-            *pfEaten = TRUE;
-            DebugOut(logTag, L"  Action: Successfully inserted Tamil char, ate key");
+            hr = pInsertAtSelection->InsertTextAtSelection(ec, TF_IAS_QUERYONLY, NULL, 0, &pRangeStart);
+            pInsertAtSelection->Release();
         }
-        else
+
+        if (SUCCEEDED(hr) && pRangeStart)
+        {
+            pRangeStart->Collapse(ec, TF_ANCHOR_START);
+
+            hr = pContext->QueryInterface(IID_ITfContextComposition, (void**)&pContextComposition);
+            if (SUCCEEDED(hr))
+            {
+                hr = pContextComposition->StartComposition(ec, pRangeStart, (ITfCompositionSink*)this, &_pComposition);
+                LogVerbose(LogEditSession, L"        StartComposition: 0x%08X", hr);
+                pContextComposition->Release();
+            }
+            pRangeStart->Release();
+        }
+
+        if (FAILED(hr) || _pComposition == NULL)
         {
-            DebugOut(logTag, L"  ERROR: Failed to insert text, hr=0x%08X", hr);
+            // The application refused the composition: insert directly
+            _pComposition = NULL;
+            _composition.Clear();
+            return _SetTextAtSelection(ec, pContext, (const WCHAR*)batch.text, batch.cchText, batch.cchDelete);
         }
     }
-    else
+
+    ITfRange* pRange = NULL;
+
+    // The engine reached past the range - extend the composition over that text
+    if (update.cchDeleteBefore > 0 && SUCCEEDED(_pComposition->GetRange(&pRange)))
     {
-        DebugOut(logTag, L"  Your Tamil99 Mapping: None (0x0000)");
-        DebugOut(logTag, L"  Action: Not eating key");
+        LONG cchShifted;
+        pRange->ShiftStart(ec, -(LONG)update.cchDeleteBefore, &cchShifted, NULL);
+        _pComposition->ShiftStart(ec, pRange);
+        pRange->Release();
+        pRange = NULL;
     }
 
-    DebugOut(logTag, L"=== End OnKeyDown ===");
+    // A pure commit leaves the text alone
+    if (batch.cchDelete > 0 || batch.cchText > 0)
+    {
+        hr = _pComposition->GetRange(&pRange);
+        if (SUCCEEDED(hr))
+        {
+            hr = pRange->SetText(ec, TF_ST_CORRECTION, (const WCHAR*)update.text, update.cchText);
+            LogVerbose(LogEditSession, L"        SetText(composition): 0x%08X", hr);
+            pRange->Release();
+            pRange = NULL;
+        }
+    }
 
-    return S_OK;
+    if (SUCCEEDED(hr))
+        hr = _pComposition->GetRange(&pRange);
+
+    if (SUCCEEDED(hr))
+    {
+        if (update.cchCommit == update.cchText)
+        {
+            // Syllable boundary: everything is committed
+            _pComposition->EndComposition(ec);
+            _pComposition->Release();
+            _pComposition = NULL;
+        }
+        else if (update.cchCommit > 0)
+        {
+            ITfRange* pNewStart = NULL;
+            if (SUCCEEDED(pRange->Clone(&pNewStart)))
+            {
+                LONG cchShifted;
+                pNewStart->ShiftStart(ec, (LONG)update.cchCommit, &cchShifted, NULL);
+                _pComposition->ShiftStart(ec, pNewStart);
+                pNewStart->Release();
+            }
+        }
+
+        // Caret after the syllable
+        pRange->Collapse(ec, TF_ANCHOR_END);
+
+        TF_SELECTION tfSelection;
+        tfSelection.range = pRange;
+        tfSelection.style.ase = TF_AE_END;
+        tfSelection.style.fInterimChar = FALSE;
+
+        ULONGLONG selectionNs = LatencyNow();
+        hr = pContext->SetSelection(ec, 1, &tfSelection);
+        g_latencyStats.Record(LatencySetSelection, selectionNs, LatencyNow());
+        LogVerbose(LogEditSession, L"        SetSelection: 0x%08X", hr);
+
+        pRange->Release();
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        _composition.Commit();
+    }
+    else
+    {
+        // Leave whatever is in the document committed
+        if (_pComposition)
+        {
+            _pComposition->EndComposition(ec);
+            _pComposition->Release();
+            _pComposition = NULL;
+        }
+        _composition.Clear();
+    }
+
+    return hr;
 }
 
-STDMETHODIMP CMurasuAnjalTextService::OnTestKeyUp(ITfContext* pContext, WPARAM wParam, LPARAM lParam, BOOL* pfEaten)
+// Ends the open syllable where it stands: focus changed or a key outside the
+// layout arrived. The commit is queued like a key, so it is applied after
+// any text still waiting for its session.
+void CMurasuAnjalTextService::_CommitComposition()
 {
-    if (!pfEaten)
-        return E_INVALIDARG;
+    if (_pComposingContext == NULL)
+        return;
 
-    *pfEaten = FALSE;
-    return S_OK;
+    LogVerbose(LogEditSession, L"  Committing open syllable");
+    _InsertTextAtSelection(_pComposingContext, NULL, 0, 0, 0, 0);
 }
 
-STDMETHODIMP CMurasuAnjalTextService::OnKeyUp(ITfContext* pContext, WPARAM wParam, LPARAM lParam, BOOL* pfEaten)
+// Remembers which context has an open syllable as of the last queued key
+void CMurasuAnjalTextService::_TrackComposing(ITfContext* pContext, ULONG cchComposing)
 {
-    if (!pfEaten)
-        return E_INVALIDARG;
+    _cchComposingQueued = cchComposing;
 
-    *pfEaten = FALSE;
-    return S_OK;
+    ITfContext* pComposingContext = (cchComposing > 0) ? pContext : NULL;
+    if (pComposingContext == _pComposingContext)
+        return;
+
+    if (pComposingContext)
+        pComposingContext->AddRef();
+    if (_pComposingContext)
+        _pComposingContext->Release();
+    _pComposingContext = pComposingContext;
 }
 
-STDMETHODIMP CMurasuAnjalTextService::OnPreservedKey(ITfContext* pContext, REFGUID rguid, BOOL* pfEaten)
+// The application ended our composition (click elsewhere, its own edit).
+// The text stays as it is; the engine starts a new syllable.
+STDMETHODIMP CMurasuAnjalTextService::OnCompositionTerminated(TfEditCookie ecWrite, ITfComposition* pComposition)
 {
-    if (!pfEaten)
-        return E_INVALIDARG;
+    LogVerbose(LogEditSession, L"OnCompositionTerminated");
 
-    *pfEaten = FALSE;
+    if (pComposition == _pComposition && _pComposition)
+    {
+        _pComposition->Release();
+        _pComposition = NULL;
+        _composition.Clear();
+    }
+
+    _engine.Reset();
+    _completion.Invalidate();
+    _candidateWorker.Cancel();
+    _keyDecision.Invalidate();
+    _TrackComposing(NULL, 0);
     return S_OK;
 }
 
-// Helper: Insert text at current selection using edit session
-HRESULT CMurasuAnjalTextService::_InsertTextAtSelection(ITfContext* pContext, const WCHAR* pchText, ULONG cchText)
+// Helper: Queue text for the current selection. A new edit session is
+// requested only when the text could not join a batch that is still waiting
+// for its session. cchComposing is the open syllable after this text
+// (KeyboardEngine::ComposingLength); 0 commits it.
+HRESULT CMurasuAnjalTextService::_InsertTextAtSelection(ITfContext* pContext, const WCHAR* pchText, ULONG cchText, ULONG cchDelete,
+    ULONG cchComposing, ULONGLONG keyDownNs)
 {
-    DebugOut(logTag, L"  _InsertTextAtSelection START");
+    LogVerbose(LogEditSession, L"  _InsertTextAtSelection START");
 
-    CEditSession* pEditSession = new CEditSession(pContext, pchText, cchText);
+    // A syllable left open in another context ends first
+    if (_pComposingContext && _pComposingContext != pContext)
+        _CommitComposition();
+
+    uint32_t serial = 0;
+    switch (_pendingOutput.Append(pContext, cchDelete, (const char16_t*)pchText, cchText, cchComposing, keyDownNs, &serial))
+    {
+    case PendingMerged:
+        LogVerbose(LogEditSession, L"    Merged into pending edit session");
+        _TrackComposing(pContext, cchComposing);
+        return S_OK;
+    case PendingFull:
+        LogWarning(LogEditSession, L"    Pending output full, dropping key");
+        return E_FAIL;
+    case PendingNewBatch:
+        break;
+    }
+
+    CEditSession* pEditSession = _AcquireEditSession();
     if (pEditSession == NULL)
+    {
+        _pendingOutput.Discard(serial);
         return E_OUTOFMEMORY;
+    }
+    pEditSession->Init(this, pContext, serial);
 
-    DebugOut(logTag, L"    Calling RequestEditSession (ASYNC)...");
+    LogVerbose(LogEditSession, L"    Calling RequestEditSession (ASYNC)...");
 
     HRESULT hr;
     HRESULT hrSession = S_OK;
 
     // ✅ Use ASYNC - safer for applications like Word
+    pEditSession->MarkRequested();
+    ULONGLONG requestNs = LatencyNow();
     hr = pContext->RequestEditSession(
         _tfClientId,
         pEditSession,
         TF_ES_ASYNCDONTCARE | TF_ES_READWRITE,  // ← Changed from TF_ES_SYNC
         &hrSession);
+    g_latencyStats.Record(LatencyRequestEditSession, requestNs, LatencyNow());
+
+    LogVerbose(LogEditSession, L"    RequestEditSession: hr=0x%08X, hrSession=0x%08X", hr, hrSession);
+    ANJAL_TRACE(TraceEditSessionRequest, (ULONG)hr, (ULONG)hrSession);
 
-    DebugOut(logTag, L"    RequestEditSession: hr=0x%08X, hrSession=0x%08X", hr, hrSession);
+    if (FAILED(hr))
+        _pendingOutput.Discard(serial);
+    else
+        _TrackComposing(pContext, cchComposing);
 
     pEditSession->Release();
     return hr;
 }
 
-// Tamil99 character mapping - MINIMAL DEMO VERSION
-// This maps just a few keys to demonstrate the concept
-// You'll expand this with the full Tamil99 layout
+// Key mapping for the active layout
+// Looks the key up in the compile-time generated tables (see KeyMap.h).
+// Returns 0 when the key is not mapped on the active modifier layer. Codes in
+// the key sequence range expand to several code units via KeyMapTables::Expand.
 wchar_t CMurasuAnjalTextService::_MapKeyToTamil(WPARAM wParam)
 {
-    // Basic Tamil99 mapping (partial - for demonstration)
-    // Format: English key -> Tamil character
-    switch (wParam)
-    {
-        // Vowels
-    case 'A': return 0x0B85;  // அ
-    case 'S': return 0x0B86;  // ஆ
-    case 'D': return 0x0B87;  // இ
-    case 'F': return 0x0B88;  // ஈ
-    case 'G': return 0x0B89;  // உ
-    case 'H': return 0x0B8A;  // ஊ
-
-        // Consonants
-    case 'Q': return 0x0B95;  // க
-    case 'W': return 0x0B99;  // ங
-    case 'E': return 0x0B9A;  // ச
-    case 'R': return 0x0B9E;  // ஞ
-    case 'T': return 0x0B9F;  // ட
-    case 'Y': return 0x0BA3;  // ண
-
-        // Add more mappings here for full Tamil99 layout
+    // Leave shortcuts such as Ctrl+C and Alt+F alone
+    KeyLayer layer;
+    if (!_modifiers.Layer(&layer))
+        return 0;
 
-    default:
-        return 0;  // No mapping
-    }
+    return (wchar_t)_engine.MapKey(layer, wParam);
 }
 
-// Simple mapping table accessor (for future expansion)
-const wchar_t* CMurasuAnjalTextService::GetTamilChar(char key)
+// Seeds the modifier tracker from the system. Only on activation and focus
+// changes - key events keep it current in between.
+void CMurasuAnjalTextService::_SyncModifiers()
 {
-    // This can be expanded to return full character sequences if needed
-    static wchar_t buffer[2] = { 0 };
-    buffer[0] = 0;
+    uint32_t keyBits = 0;
+    if (GetKeyState(VK_LSHIFT) & 0x8000)
+        keyBits |= ModifierTracker::ModifierKeyLShift;
+    if (GetKeyState(VK_RSHIFT) & 0x8000)
+        keyBits |= ModifierTracker::ModifierKeyRShift;
+    if (GetKeyState(VK_LCONTROL) & 0x8000)
+        keyBits |= ModifierTracker::ModifierKeyLCtrl;
+    if (GetKeyState(VK_RCONTROL) & 0x8000)
+        keyBits |= ModifierTracker::ModifierKeyRCtrl;
+    if (GetKeyState(VK_LMENU) & 0x8000)
+        keyBits |= ModifierTracker::ModifierKeyLAlt;
+    if (GetKeyState(VK_RMENU) & 0x8000)
+        keyBits |= ModifierTracker::ModifierKeyRAlt;
+
+    _modifiers.Reset(keyBits, (GetKeyState(VK_CAPITAL) & 0x0001) != 0);
+}
 
-    // For now, return single character mapping
-    // This method allows for future expansion to support conjuncts
+// Maps the key and runs it through a copy of the engine, unless the cached
+// decision for this exact key and engine state is still valid
+const KeyDecision& CMurasuAnjalTextService::_DecideKey(ITfContext* pContext, WPARAM wParam, LPARAM lParam)
+{
+    uint32_t modifiers = _modifiers.Bits();
+    const KeyDecision* pCached = _keyDecision.Find(wParam, lParam, pContext, modifiers, _engine.Version());
+    if (pCached)
+        return *pCached;
+
+    KeyDecision& decision = _keyDecision.Begin();
+    decision.wParam = wParam;
+    decision.lParam = lParam;
+    decision.pContext = pContext;
+    decision.modifiers = modifiers;
+    decision.engineVersion = _engine.Version();
+    decision.code = (char16_t)_MapKeyToTamil(wParam);
+    decision.next = _engine;
+    decision.consumed = false;
+    decision.output.Clear();
+    if (decision.code != 0)
+        decision.consumed = decision.next.ProcessKey(decision.code, &decision.output);
+    _keyDecision.Store();
+
+    return decision;
+}
 
-    return buffer;
+// Shift, Ctrl, Alt, Win and Caps Lock do not end a pending syllable
+BOOL CMurasuAnjalTextService::_IsModifierKey(WPARAM wParam)
+{
+    switch (wParam)
+    {
+    case VK_SHIFT:
+    case VK_CONTROL:
+    case VK_MENU:
+    case VK_CAPITAL:
+    case VK_LSHIFT:
+    case VK_RSHIFT:
+    case VK_LCONTROL:
+    case VK_RCONTROL:
+    case VK_LMENU:
+    case VK_RMENU:
+    case VK_LWIN:
+    case VK_RWIN:
+        return TRUE;
+    default:
+        return FALSE;
+    }
 }
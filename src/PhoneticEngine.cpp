@@ -0,0 +1,244 @@
+﻿// PhoneticEngine.cpp
+// Anjal phonetic token table, its double-array trie and the longest-match
+// driver - see PhoneticEngine.h
+
+#include "../include/PhoneticEngine.h"
+#include "../include/DoubleArrayTrie.h"
+
+#define VOWEL(roman, index)     { roman, PhoneticVowel, index, { 0 } }
+#define CONSONANT(roman, ...)   { roman, PhoneticConsonant, 0, { __VA_ARGS__ } }
+#define SYMBOL(roman, ...)      { roman, PhoneticSymbol, 0, { __VA_ARGS__ } }
+
+// Every prefix of a token is itself a token, so no typed letter is ever
+// held back invisibly. The first token for a letter is the one Romanizer
+// writes it with.
+static constexpr PhoneticToken c_phoneticTokens[] =
+{
+    // Vowels (index into c_tamilVowels)
+    VOWEL("a", 0),      VOWEL("aa", 1),     VOWEL("A", 1),
+    VOWEL("i", 2),      VOWEL("ii", 3),     VOWEL("I", 3),
+    VOWEL("u", 4),      VOWEL("uu", 5),     VOWEL("U", 5),
+    VOWEL("e", 6),      VOWEL("ee", 7),     VOWEL("E", 7),
+    VOWEL("ai", 8),
+    VOWEL("o", 9),      VOWEL("oo", 10),    VOWEL("O", 10),
+    VOWEL("au", 11),
+
+    // Consonants
+    CONSONANT("k", 0x0B95),                     CONSONANT("g", 0x0B95),                     // க
+    CONSONANT("ng", 0x0B99),                                                                // ங
+    CONSONANT("ch", 0x0B9A),    CONSONANT("c", 0x0B9A),     CONSONANT("s", 0x0B9A),         // ச
+    CONSONANT("nj", 0x0B9E),                                                                // ஞ
+    CONSONANT("t", 0x0B9F),     CONSONANT("d", 0x0B9F),     CONSONANT("T", 0x0B9F),         // ட
+    CONSONANT("N", 0x0BA3),                                                                 // ண
+    CONSONANT("th", 0x0BA4),    CONSONANT("dh", 0x0BA4),                                    // த
+    CONSONANT("w", 0x0BA8),                                                                 // ந
+    CONSONANT("p", 0x0BAA),     CONSONANT("b", 0x0BAA),     CONSONANT("f", 0x0BAA),         // ப
+    CONSONANT("m", 0x0BAE),                                                                 // ம
+    CONSONANT("y", 0x0BAF),                                                                 // ய
+    CONSONANT("r", 0x0BB0),                                                                 // ர
+    CONSONANT("l", 0x0BB2),                                                                 // ல
+    CONSONANT("v", 0x0BB5),                                                                 // வ
+    CONSONANT("zh", 0x0BB4),    CONSONANT("z", 0x0BB4),                                     // ழ
+    CONSONANT("L", 0x0BB3),                                                                 // ள
+    CONSONANT("R", 0x0BB1),                                                                 // ற
+    CONSONANT("n", 0x0BA9),                                                                 // ன (ந at word start)
+    CONSONANT("nt", 0x0BA9, 0x0BCD, 0x0B9F),                                                // ன்ட
+    CONSONANT("nth", 0x0BA8, 0x0BCD, 0x0BA4),                                               // ந்த
+    CONSONANT("nd", 0x0BA3, 0x0BCD, 0x0B9F),                                                // ண்ட
+    CONSONANT("ndr", 0x0BA9, 0x0BCD, 0x0BB1),                                               // ன்ற
+
+    // Grantha
+    CONSONANT("j", 0x0B9C),                                                                 // ஜ
+    CONSONANT("sh", 0x0BB7),                                                                // ஷ
+    CONSONANT("S", 0x0BB8),                                                                 // ஸ
+    CONSONANT("h", 0x0BB9),                                                                 // ஹ
+    CONSONANT("x", 0x0B95, 0x0BCD, 0x0BB7),                                                 // க்ஷ
+
+    SYMBOL("q", 0x0B83),                                                                    // ஃ
+};
+
+#undef VOWEL
+#undef CONSONANT
+#undef SYMBOL
+
+static constexpr DoubleArrayTrie<256> c_phoneticTrie = MakeDoubleArrayTrie<256>(c_phoneticTokens);
+
+static_assert(c_phoneticTrie.Next(c_phoneticTrie.Next(0, 'z'), 'h') > 0, "zh");
+static_assert(c_phoneticTrie.value[c_phoneticTrie.Next(0, 'q')] != 0, "q");
+static_assert(c_phoneticTrie.Next(0, '1') < 0, "digits are not in the alphabet");
+
+const PhoneticToken* PhoneticEngine::Tokens(size_t* pcTokens)
+{
+    *pcTokens = sizeof(c_phoneticTokens) / sizeof(c_phoneticTokens[0]);
+    return c_phoneticTokens;
+}
+
+size_t PhoneticEngine::LongestToken(const char* pch, size_t cch)
+{
+    // The path _Feed follows before it settles on the longest match
+    size_t cchAccepted = 0;
+    int state = 0;
+    for (size_t i = 0; i < cch && i < c_phoneticMaxToken; i++)
+    {
+        state = c_phoneticTrie.Next(state, pch[i]);
+        if (state <= 0)
+            break;
+        if (c_phoneticTrie.value[state])
+            cchAccepted = i + 1;
+    }
+    return cchAccepted;
+}
+
+void PhoneticEngine::Reset()
+{
+    _state = 0;
+    _cchPending = 0;
+    _cchAccepted = 0;
+    _token = 0;
+    _cchRendered = 0;
+    _rendered = false;
+    _afterConsonant = false;
+    _atWordStart = true;
+}
+
+void PhoneticEngine::Resume(const char16_t* pchBefore, size_t cchBefore)
+{
+    Reset();
+
+    if (cchBefore == 0)
+        return;
+
+    TamilCharClass last = GetTamilCharInfo(pchBefore[cchBefore - 1]).charClass;
+    _atWordStart = (last == TamilClassNone || last == TamilClassDigit || last == TamilClassSymbol);
+    _afterConsonant = (last == TamilClassPulli && cchBefore >= 2 &&
+        GetTamilCharInfo(pchBefore[cchBefore - 2]).charClass == TamilClassConsonant);
+}
+
+bool PhoneticEngine::ProcessKey(const char16_t* pchKey, size_t cchKey, EngineOutput* pOutput)
+{
+    pOutput->Clear();
+
+    if (cchKey == 0)
+        return false;
+
+    for (size_t i = 0; i < cchKey; i++)
+    {
+        if (pchKey[i] < 0x80)
+        {
+            _Feed((char)pchKey[i], pOutput);
+        }
+        else
+        {
+            // Non-Latin key text ends the token and is inserted as-is
+            _CommitToken();
+            pOutput->Append(pchKey[i]);
+            _afterConsonant = false;
+            _atWordStart = false;
+        }
+    }
+
+    return true;
+}
+
+void PhoneticEngine::_Feed(char ch, EngineOutput* pOutput)
+{
+    int next = c_phoneticTrie.Next(_state, ch);
+
+    if (next > 0 && _cchPending < c_phoneticMaxToken)
+    {
+        // The token can still grow: show the best match so far
+        _pending[_cchPending++] = ch;
+        _state = (int16_t)next;
+
+        if (c_phoneticTrie.value[next])
+        {
+            _cchAccepted = _cchPending;
+            _token = c_phoneticTrie.value[next];
+            _RenderToken(c_phoneticTokens[_token - 1], pOutput);
+        }
+        return;
+    }
+
+    if (_cchPending == 0)
+    {
+        // Not part of the scheme at all
+        pOutput->Append((char16_t)ch);
+        _afterConsonant = false;
+        _atWordStart = false;
+        return;
+    }
+
+    // Longest match found. Only the letters after it are fed again, so the
+    // work per key is bounded by the token length, not the pending text.
+    char tail[c_phoneticMaxToken];
+    size_t cchTail = _cchPending - _cchAccepted;
+    for (size_t i = 0; i < cchTail; i++)
+        tail[i] = _pending[_cchAccepted + i];
+
+    _CommitToken();
+
+    for (size_t i = 0; i < cchTail; i++)
+        _Feed(tail[i], pOutput);
+    _Feed(ch, pOutput);
+}
+
+void PhoneticEngine::_RenderToken(const PhoneticToken& token, EngineOutput* pOutput)
+{
+    char16_t text[c_engineMaxOutput];
+    size_t cch = 0;
+
+    switch (token.kind)
+    {
+    case PhoneticConsonant:
+        for (size_t i = 0; i < 4 && token.text[i]; i++)
+            text[cch++] = token.text[i];
+        // Anjal convention: a lone n starting a word is dental ந
+        if (cch == 1 && text[0] == 0x0BA9 && _atWordStart)
+            text[0] = 0x0BA8;
+        text[cch++] = c_tamilPulli;
+        break;
+
+    case PhoneticVowel:
+        if (_afterConsonant)
+        {
+            // Replaces the pulli of the previous consonant
+            if (c_tamilVowelSigns[token.vowel])
+                text[cch++] = c_tamilVowelSigns[token.vowel];
+        }
+        else
+        {
+            text[cch++] = c_tamilVowels[token.vowel];
+        }
+        break;
+
+    case PhoneticSymbol:
+        for (size_t i = 0; i < 4 && token.text[i]; i++)
+            text[cch++] = token.text[i];
+        break;
+    }
+
+    // First rendering of a vowel after a consonant removes that consonant's
+    // pulli; later renderings replace what this token showed before
+    size_t cchDelete = _rendered ? _cchRendered
+        : (token.kind == PhoneticVowel && _afterConsonant) ? 1 : 0;
+
+    pOutput->Merge(cchDelete, text, cch);
+    _cchRendered = (uint8_t)cch;
+    _rendered = true;
+}
+
+void PhoneticEngine::_CommitToken()
+{
+    if (_token)
+    {
+        _afterConsonant = (c_phoneticTokens[_token - 1].kind == PhoneticConsonant);
+        _atWordStart = false;
+    }
+
+    _state = 0;
+    _cchPending = 0;
+    _cchAccepted = 0;
+    _token = 0;
+    _cchRendered = 0;
+    _rendered = false;
+}
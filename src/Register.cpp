@@ -20,7 +20,7 @@ static void UnregisterServer();
 //
 STDAPI DllRegisterServer(void)
 {
-    DebugOut(logTag, L"DllRegisterServer called");
+    LogInfo(LogRegistration, L"DllRegisterServer called");
 
     HRESULT hrCo = CoInitializeEx(NULL, COINIT_APARTMENTTHREADED);
     bool coInitSucceeded = (hrCo == S_OK || hrCo == S_FALSE);
@@ -65,7 +65,7 @@ STDAPI DllUnregisterServer(void)
 
 static BOOL RegisterServer()
 {
-    DebugOut(logTag, L"RegisterServer called");
+    LogInfo(LogRegistration, L"RegisterServer called");
 
     HKEY hKey = NULL;
     HKEY hSubKey = NULL;
@@ -95,7 +95,7 @@ static BOOL RegisterServer()
     result = RegCreateKeyExW(HKEY_LOCAL_MACHINE, achIMEKey, 0, NULL,
         REG_OPTION_NON_VOLATILE, KEY_WRITE, NULL, &hKey, &dw);
 
-    DebugOut(logTag, L"RegCreateKeyEx result: 0x%08X for path: %s", result, achIMEKey);
+    LogInfo(LogRegistration, L"RegCreateKeyEx result: 0x%08X for path: %s", result, achIMEKey);
 
     if (result != ERROR_SUCCESS)
         return FALSE;
@@ -105,13 +105,13 @@ static BOOL RegisterServer()
         (BYTE*)TEXTSERVICE_DESC,
         (lstrlenW(TEXTSERVICE_DESC) + 1) * sizeof(WCHAR));
 
-    DebugOut(logTag, L"Set description result: 0x%08X", result);
+    LogInfo(LogRegistration, L"Set description result: 0x%08X", result);
 
     // InprocServer32
     result = RegCreateKeyExW(hKey, L"InprocServer32", 0, NULL,
         REG_OPTION_NON_VOLATILE, KEY_WRITE, NULL, &hSubKey, &dw);
 
-    DebugOut(logTag, L"Create InprocServer32 key result: 0x%08X", result);
+    LogInfo(LogRegistration, L"Create InprocServer32 key result: 0x%08X", result);
 
     if (result == ERROR_SUCCESS)
     {
@@ -119,13 +119,13 @@ static BOOL RegisterServer()
             (BYTE*)achFileName,
             (lstrlenW(achFileName) + 1) * sizeof(WCHAR));
 
-        DebugOut(logTag, L"Set DLL path result: 0x%08X, path: %s", result, achFileName);
+        LogInfo(LogRegistration, L"Set DLL path result: 0x%08X, path: %s", result, achFileName);
 
         result = RegSetValueExW(hSubKey, L"ThreadingModel", 0, REG_SZ,
             (BYTE*)TEXTSERVICE_MODEL,
             (lstrlenW(TEXTSERVICE_MODEL) + 1) * sizeof(WCHAR));
 
-        DebugOut(logTag, L"Set ThreadingModel result: 0x%08X", result);
+        LogInfo(LogRegistration, L"Set ThreadingModel result: 0x%08X", result);
 
         RegCloseKey(hSubKey);
     }
@@ -156,46 +156,30 @@ static void UnregisterServer()
     RegDeleteTreeW(HKEY_CLASSES_ROOT, achIMEKey);
 }
 
-BOOL RegisterProfiles()
+// Registers and enables the TSF language profile for one layout
+static HRESULT RegisterLayoutProfile(ITfInputProcessorProfiles* pInputProcessorProfiles,
+    const LayoutDescriptor* pLayout, const WCHAR* achIconFile, DWORD cchIconFile)
 {
-    DebugOut(logTag, L"RegisterProfiles START");
-
-    ITfInputProcessorProfiles* pInputProcessorProfiles;
-    WCHAR achIconFile[MAX_PATH];
-    DWORD cchIconFile;
+    REFGUID guidProfile = *c_layoutProfiles[pLayout->id];
+    const WCHAR* pszDesc = (const WCHAR*)pLayout->description;
     HRESULT hr;
 
-    hr = CoCreateInstance(CLSID_TF_InputProcessorProfiles, NULL, CLSCTX_INPROC_SERVER,
-        IID_ITfInputProcessorProfiles, (void**)&pInputProcessorProfiles);
-
-    DebugOut(logTag, L"CoCreateInstance result: 0x%08X", hr);
-
-    if (hr != S_OK)
-        goto Exit;
-
-    hr = pInputProcessorProfiles->Register(c_clsidTextService);
-    DebugOut(logTag, L"Register result: 0x%08X", hr);
-
-    if (hr != S_OK)
-        goto Exit;
-
-    cchIconFile = GetModuleFileNameW(g_hInst, achIconFile, ARRAYSIZE(achIconFile));
-    DebugOut(logTag, L"DLL path: %s", achIconFile);
+    LogInfo(LogRegistration, L"RegisterLayoutProfile: %s", pszDesc);
 
     hr = pInputProcessorProfiles->AddLanguageProfile(
         c_clsidTextService,
         c_langid,
-        c_guidProfile,
-        TEXTSERVICE_DESC,
-        (ULONG)lstrlenW(TEXTSERVICE_DESC),
+        guidProfile,
+        pszDesc,
+        (ULONG)lstrlenW(pszDesc),
         achIconFile,
         cchIconFile,
         0);
 
-    DebugOut(logTag, L"AddLanguageProfile result: 0x%08X", hr);
+    LogInfo(LogRegistration, L"AddLanguageProfile result: 0x%08X", hr);
 
     if (hr != S_OK)
-        goto Exit;
+        return hr;
 
     // ✅ Set UWP compatibility flag using ProfileMgr
     ITfInputProcessorProfileMgr* pProfileMgr = NULL;
@@ -203,53 +187,47 @@ BOOL RegisterProfiles()
 
     if (SUCCEEDED(hr) && pProfileMgr)
     {
-        TF_INPUTPROCESSORPROFILE profile;
-        ZeroMemory(&profile, sizeof(profile));
-
-        profile.dwProfileType = TF_PROFILETYPE_INPUTPROCESSOR;
-        profile.langid = c_langid;
-        profile.clsid = c_clsidTextService;
-        profile.guidProfile = c_guidProfile;
-        profile.catid = GUID_TFCAT_TIP_KEYBOARD;
-        profile.hklSubstitute = NULL;
-        profile.dwCaps = TF_IPP_CAPS_IMMERSIVESUPPORT | TF_IPP_CAPS_SECUREMODESUPPORT;
-        profile.hkl = NULL;
-        profile.dwFlags = TF_IPP_FLAG_ENABLED;
+        DWORD dwCaps = TF_IPP_CAPS_IMMERSIVESUPPORT | TF_IPP_CAPS_SECUREMODESUPPORT;
 
         hr = pProfileMgr->RegisterProfile(
             c_clsidTextService,
             c_langid,
-            c_guidProfile,
-            TEXTSERVICE_DESC,
-            (ULONG)lstrlenW(TEXTSERVICE_DESC),
+            guidProfile,
+            pszDesc,
+            (ULONG)lstrlenW(pszDesc),
             achIconFile,
             cchIconFile,
             0,  // uIconIndex
             NULL,  // hklSubstitute
             0,  // dwPreferredLayout
             TRUE,  // bEnabledByDefault
-            profile.dwCaps  // ⭐ This is the critical parameter
+            dwCaps  // ⭐ This is the critical parameter
         );
 
-        DebugOut(logTag, L"RegisterProfile with IMMERSIVESUPPORT: 0x%08X", hr);
+        LogInfo(LogRegistration, L"RegisterProfile with IMMERSIVESUPPORT: 0x%08X", hr);
 
         pProfileMgr->Release();
     }
     // ✅ END OF UWP compatibility flag
-    
+
     // Manually add the CLSID value to the profile
     // (This is normally done automatically by ITfInputProcessorProfileMgr)
+    WCHAR szClsid[64];
+    WCHAR szProfile[64];
     WCHAR szProfileKey[512];
-    swprintf_s(szProfileKey,
-        L"SOFTWARE\\Microsoft\\CTF\\TIP\\{F7123523-AA20-43CB-8BE3-8AA74E8584F9}\\LanguageProfile\\0x00000449\\{B243DC17-B1C8-496A-B00B-5EB8C3EE4B6F}");
+    StringFromGUID2(c_clsidTextService, szClsid, ARRAYSIZE(szClsid));
+    StringFromGUID2(guidProfile, szProfile, ARRAYSIZE(szProfile));
+    StringCchPrintfW(szProfileKey, ARRAYSIZE(szProfileKey),
+        L"SOFTWARE\\Microsoft\\CTF\\TIP\\%s\\LanguageProfile\\0x%08X\\%s",
+        szClsid, (DWORD)c_langid, szProfile);
 
     HKEY hKey;
     if (RegOpenKeyExW(HKEY_LOCAL_MACHINE, szProfileKey, 0, KEY_SET_VALUE, &hKey) == ERROR_SUCCESS)
     {
         // Add CLSID value
         RegSetValueExW(hKey, L"CLSID", 0, REG_SZ,
-            (BYTE*)L"{F7123523-AA20-43CB-8BE3-8AA74E8584F9}",
-            sizeof(L"{F7123523-AA20-43CB-8BE3-8AA74E8584F9}"));
+            (BYTE*)szClsid,
+            (lstrlenW(szClsid) + 1) * sizeof(WCHAR));
 
         // ✅ CRITICAL FIX: Add Enable flag at profile level
         DWORD dwEnable = 1;
@@ -263,16 +241,51 @@ BOOL RegisterProfiles()
     hr = pInputProcessorProfiles->EnableLanguageProfile(
         c_clsidTextService,
         c_langid,
-        c_guidProfile,
+        guidProfile,
         TRUE);
 
-    DebugOut(logTag, L"EnableLanguageProfile result: 0x%08X", hr);
+    LogInfo(LogRegistration, L"EnableLanguageProfile result: 0x%08X", hr);
+
+    return hr;
+}
+
+BOOL RegisterProfiles()
+{
+    LogInfo(LogRegistration, L"RegisterProfiles START");
+
+    ITfInputProcessorProfiles* pInputProcessorProfiles = NULL;
+    WCHAR achIconFile[MAX_PATH];
+    DWORD cchIconFile;
+    HRESULT hr;
+
+    hr = CoCreateInstance(CLSID_TF_InputProcessorProfiles, NULL, CLSCTX_INPROC_SERVER,
+        IID_ITfInputProcessorProfiles, (void**)&pInputProcessorProfiles);
+
+    LogInfo(LogRegistration, L"CoCreateInstance result: 0x%08X", hr);
+
+    if (hr != S_OK)
+        goto Exit;
+
+    hr = pInputProcessorProfiles->Register(c_clsidTextService);
+    LogInfo(LogRegistration, L"Register result: 0x%08X", hr);
+
+    if (hr != S_OK)
+        goto Exit;
+
+    cchIconFile = GetModuleFileNameW(g_hInst, achIconFile, ARRAYSIZE(achIconFile));
+    LogInfo(LogRegistration, L"DLL path: %s", achIconFile);
+
+    // One profile per layout in the registry (see LayoutRegistry.cpp)
+    for (int i = 0; i < LayoutCount && hr == S_OK; i++)
+    {
+        hr = RegisterLayoutProfile(pInputProcessorProfiles, &g_layouts[i], achIconFile, cchIconFile);
+    }
 
 Exit:
     if (pInputProcessorProfiles)
         pInputProcessorProfiles->Release();
 
-    DebugOut(logTag, L"RegisterProfiles END - Final result: 0x%08X", hr);
+    LogInfo(LogRegistration, L"RegisterProfiles END - Final result: 0x%08X", hr);
 
     return (hr == S_OK);
 }
@@ -294,7 +307,7 @@ static void UnregisterProfiles()
 
 static BOOL RegisterCategories()
 {
-    DebugOut(logTag, L"RegisterCategories START");
+    LogInfo(LogRegistration, L"RegisterCategories START");
 
     ITfCategoryMgr* pCategoryMgr = NULL;
     HRESULT hr;
@@ -303,7 +316,7 @@ static BOOL RegisterCategories()
     hr = CoCreateInstance(CLSID_TF_CategoryMgr, NULL, CLSCTX_INPROC_SERVER,
         IID_ITfCategoryMgr, (void**)&pCategoryMgr);
 
-    DebugOut(logTag, L"CoCreateInstance(CategoryMgr) result: 0x%08X", hr);
+    LogInfo(LogRegistration, L"CoCreateInstance(CategoryMgr) result: 0x%08X", hr);
 
     if (FAILED(hr))
         return FALSE;
@@ -314,7 +327,7 @@ static BOOL RegisterCategories()
         GUID_TFCAT_TIP_KEYBOARD,
         c_clsidTextService);
 
-    DebugOut(logTag, L"RegisterCategory(GUID_TFCAT_TIP_KEYBOARD) result: 0x%08X", hr);
+    LogInfo(LogRegistration, L"RegisterCategory(GUID_TFCAT_TIP_KEYBOARD) result: 0x%08X", hr);
 
     if (FAILED(hr))
     {
@@ -328,26 +341,26 @@ static BOOL RegisterCategories()
         GUID_TFCAT_TIPCAP_IMMERSIVESUPPORT,
         c_clsidTextService);
 
-    DebugOut(logTag, L"RegisterCategory(GUID_TFCAT_TIPCAP_IMMERSIVESUPPORT) result: 0x%08X", hr);
+    LogInfo(LogRegistration, L"RegisterCategory(GUID_TFCAT_TIPCAP_IMMERSIVESUPPORT) result: 0x%08X", hr);
 
     // ✅ Optional: Display attribute provider (you already had this)
     hr = pCategoryMgr->RegisterCategory(c_clsidTextService,
         GUID_TFCAT_DISPLAYATTRIBUTEPROVIDER,
         c_clsidTextService);
 
-    DebugOut(logTag, L"RegisterCategory(GUID_TFCAT_DISPLAYATTRIBUTEPROVIDER) result: 0x%08X", hr);
+    LogInfo(LogRegistration, L"RegisterCategory(GUID_TFCAT_DISPLAYATTRIBUTEPROVIDER) result: 0x%08X", hr);
 
     result = SUCCEEDED(hr);
     pCategoryMgr->Release();
 
-    DebugOut(logTag, L"RegisterCategories END - Result: %s", result ? L"SUCCESS" : L"FAILED");
+    LogInfo(LogRegistration, L"RegisterCategories END - Result: %s", result ? L"SUCCESS" : L"FAILED");
 
     return result;
 }
 
 static void UnregisterCategories()
 {
-    DebugOut(logTag, L"UnregisterCategories START");
+    LogInfo(LogRegistration, L"UnregisterCategories START");
 
     ITfCategoryMgr* pCategoryMgr = NULL;
     HRESULT hr;
@@ -373,5 +386,5 @@ static void UnregisterCategories()
         pCategoryMgr->Release();
     }
 
-    DebugOut(logTag, L"UnregisterCategories END");
+    LogInfo(LogRegistration, L"UnregisterCategories END");
 }
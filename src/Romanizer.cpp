@@ -0,0 +1,522 @@
+﻿// Romanizer.cpp
+// Tamil to Anjal romanization, streaming - see Romanizer.h
+
+#include "../include/Romanizer.h"
+
+#include <cstring>
+
+// Syllable units past the consonants and clusters
+static const uint8_t c_romanUnitVowel = 0xFE;       // a vowel letter, or a sign with no consonant
+static const uint8_t c_romanUnitAytham = 0xFF;
+static const uint8_t c_romanPulli = 0xFF;
+
+static const char16_t c_tamilNa = 0x0BA8;           // ந
+static const char16_t c_tamilNnna = 0x0BA9;         // ன, typed n; ந at a word start
+static const char16_t c_tamilAA = 0x0BBE;           // ா
+
+// Vowel indices of the signs that join with ா or ௗ
+static const uint8_t c_vowelE = 6;                  // ெ
+static const uint8_t c_vowelEE = 7;                 // ே
+static const uint8_t c_vowelO = 9;                  // ொ
+static const uint8_t c_vowelOO = 10;                // ோ
+static const uint8_t c_vowelAU = 11;                // ௌ
+
+static_assert(c_tamilConsonantCount + c_romanClustersMax < c_romanUnitVowel, "units overlap");
+
+static bool IsConsonantUnit(uint8_t unit)
+{
+    return unit < c_tamilConsonantCount + c_romanClustersMax;
+}
+
+// Appends, or with fFirst puts in front
+static void AddCandidate(const char* roman, bool fFirst, const char** pRoman, uint8_t* pCount)
+{
+    if (*pCount == c_romanCandidatesMax)
+        return;
+    if (fFirst)
+    {
+        memmove(pRoman + 1, pRoman, *pCount * sizeof(const char*));
+        pRoman[0] = roman;
+    }
+    else
+    {
+        pRoman[*pCount] = roman;
+    }
+    (*pCount)++;
+}
+
+Romanizer::Romanizer()
+{
+    memset(_vowelRoman, 0, sizeof(_vowelRoman));
+    memset(_consonants, 0, sizeof(_consonants));
+    _aythamRoman = "";
+    _cClusters = 0;
+
+    // The first token in the table that types a letter is its romanization,
+    // and the next ones are what to fall back on when it would join the
+    // letters after it into another token
+    size_t cTokens;
+    const PhoneticToken* pTokens = PhoneticEngine::Tokens(&cTokens);
+    for (size_t i = 0; i < cTokens; i++)
+    {
+        const PhoneticToken& token = pTokens[i];
+        size_t cch = 0;
+        while (cch < 4 && token.text[cch])
+            cch++;
+
+        if (token.kind == PhoneticVowel)
+        {
+            if (!_vowelRoman[token.vowel])
+                _vowelRoman[token.vowel] = token.roman;
+        }
+        else if (token.kind == PhoneticSymbol)
+        {
+            if (cch == 1 && token.text[0] == c_tamilAytham && !*_aythamRoman)
+                _aythamRoman = token.roman;
+        }
+        else if (cch == 1)
+        {
+            uint8_t consonant = GetTamilCharInfo(token.text[0]).index;
+            Candidates& mid = _consonants[0][consonant];
+            AddCandidate(token.roman, false, mid.roman, &mid.count);
+
+            // The engine types ன's token as ந at a word start, and that is
+            // how ந is typed there
+            Candidates& start = (token.text[0] == c_tamilNnna) ? _consonants[1][GetTamilCharInfo(c_tamilNa).index] : _consonants[1][consonant];
+            AddCandidate(token.roman, token.text[0] == c_tamilNnna, start.roman, &start.count);
+        }
+        else if (cch == 3 && token.text[1] == c_tamilPulli && _cClusters < c_romanClustersMax)
+        {
+            Cluster& cluster = _clusters[_cClusters++];
+            memcpy(cluster.text, token.text, sizeof(cluster.text));
+            cluster.first = GetTamilCharInfo(token.text[0]).index;
+            cluster.second = GetTamilCharInfo(token.text[2]).index;
+            cluster.roman = token.roman;
+        }
+    }
+
+    // A consonant and vowel sign are a cell of the syllable matrix; its
+    // letters are the consonant's then the vowel's. Only a consonant with
+    // pulli is left to romanize as the text comes.
+    for (size_t fWordStart = 0; fWordStart < 2; fWordStart++)
+    {
+        for (size_t unit = 0; unit < c_tamilConsonantCount + _cClusters; unit++)
+        {
+            for (size_t v = 0; v < c_tamilVowelCount; v++)
+            {
+                RomanText& roman = _syllableRoman[fWordStart][unit][v];
+                size_t cchVowel = strlen(_vowelRoman[v]);
+                roman.cch = (uint8_t)_Unit((uint8_t)unit, fWordStart != 0, _vowelRoman[v], cchVowel, roman.text);
+                memcpy(roman.text + roman.cch, _vowelRoman[v], cchVowel);
+                roman.cch += (uint8_t)cchVowel;
+            }
+        }
+    }
+
+    Reset();
+}
+
+void Romanizer::Reset()
+{
+    _cSyllables = 0;
+    _fWordStart = true;
+    _cbSequence = 0;
+    _cbSequenceNeeded = 0;
+    _cpSequence = 0;
+    _cbHeld = 0;
+    _ibWritten = 0;
+}
+
+StreamResult Romanizer::Feed(const char* pbIn, size_t cbIn, size_t* pcbRead, char* pbOut, size_t cbOutMax, size_t* pcbWritten)
+{
+    *pcbWritten = 0;
+
+    size_t ib = 0;
+    for (;;)
+    {
+        // Every character starts with nothing final left unwritten, so the
+        // held buffer only ever holds what one character releases
+        if (!_Write(pbOut, cbOutMax, pcbWritten))
+        {
+            *pcbRead = ib;
+            return StreamOutputNeeded;
+        }
+        if (ib == cbIn)
+            break;
+
+        uint8_t b = (uint8_t)pbIn[ib];
+
+        if (_cbSequence == 0 && b < 0x80)
+        {
+            if (_cSyllables > 0)
+            {
+                _Step(b);
+                ib++;
+                continue;
+            }
+
+            // Nothing held and a run of ASCII: it is kept as it is
+            if (*pcbWritten == cbOutMax)
+            {
+                *pcbRead = ib;
+                return StreamOutputNeeded;
+            }
+
+            size_t ibEnd = ib + 1;
+            size_t ibLimit = ib + (cbOutMax - *pcbWritten);
+            if (ibLimit > cbIn)
+                ibLimit = cbIn;
+            while (ibEnd < ibLimit && (uint8_t)pbIn[ibEnd] < 0x80)
+                ibEnd++;
+
+            memcpy(pbOut + *pcbWritten, pbIn + ib, ibEnd - ib);
+            *pcbWritten += ibEnd - ib;
+            _fWordStart = true;
+            ib = ibEnd;
+            continue;
+        }
+
+        if (_cbSequence == 0 && b >= 0xE0 && b <= 0xEF && cbIn - ib >= 3 &&
+            ((uint8_t)pbIn[ib + 1] & 0xC0) == 0x80 && ((uint8_t)pbIn[ib + 2] & 0xC0) == 0x80)
+        {
+            // A whole three-byte sequence, as all of Tamil is, in one step
+            uint32_t cp = ((b & 0x0F) << 12) | (((uint8_t)pbIn[ib + 1] & 0x3F) << 6) | ((uint8_t)pbIn[ib + 2] & 0x3F);
+            if (cp >= 0x800 && (cp < 0xD800 || cp >= 0xE000))
+            {
+                ib += 3;
+                _Step(cp);
+                continue;
+            }
+        }
+
+        if (_cbSequence == 0)
+        {
+            // Lead byte of a multi-byte sequence
+            ib++;
+            if (b >= 0xC2 && b <= 0xDF)
+            {
+                _cbSequenceNeeded = 2;
+                _cpSequence = b & 0x1F;
+            }
+            else if (b >= 0xE0 && b <= 0xEF)
+            {
+                _cbSequenceNeeded = 3;
+                _cpSequence = b & 0x0F;
+            }
+            else if (b >= 0xF0 && b <= 0xF4)
+            {
+                _cbSequenceNeeded = 4;
+                _cpSequence = b & 0x07;
+            }
+            else
+            {
+                _Step(0xFFFD);
+                continue;
+            }
+            _cbSequence = 1;
+            continue;
+        }
+
+        if ((b & 0xC0) != 0x80)
+        {
+            // Cut short: the partial sequence is one U+FFFD, and this byte
+            // starts afresh on the next pass
+            _cbSequence = 0;
+            _Step(0xFFFD);
+            continue;
+        }
+
+        ib++;
+        _cpSequence = (_cpSequence << 6) | (b & 0x3F);
+        if (++_cbSequence < _cbSequenceNeeded)
+            continue;
+
+        // Overlong forms, surrogates and anything past U+10FFFF are malformed
+        uint32_t cp = _cpSequence;
+        bool fValid = (_cbSequenceNeeded == 2) ||
+            (_cbSequenceNeeded == 3 && cp >= 0x800 && (cp < 0xD800 || cp >= 0xE000)) ||
+            (_cbSequenceNeeded == 4 && cp >= 0x10000 && cp <= 0x10FFFF);
+        _cbSequence = 0;
+        _Step(fValid ? cp : 0xFFFD);
+    }
+
+    *pcbRead = ib;
+    return StreamDone;
+}
+
+StreamResult Romanizer::Finish(char* pbOut, size_t cbOutMax, size_t* pcbWritten)
+{
+    *pcbWritten = 0;
+    if (!_Write(pbOut, cbOutMax, pcbWritten))
+        return StreamOutputNeeded;
+
+    if (_cbSequence > 0)
+    {
+        _cbSequence = 0;
+        _Step(0xFFFD);
+        if (!_Write(pbOut, cbOutMax, pcbWritten))
+            return StreamOutputNeeded;
+    }
+
+    _Flush(_cSyllables);
+    if (!_Write(pbOut, cbOutMax, pcbWritten))
+        return StreamOutputNeeded;
+
+    Reset();
+    return StreamDone;
+}
+
+// Copies the final bytes not yet written, whole characters only. False
+// when pbOut is full first.
+bool Romanizer::_Write(char* pbOut, size_t cbOutMax, size_t* pcbWritten)
+{
+    while (_ibWritten < _cbHeld)
+    {
+        uint8_t b = (uint8_t)_held[_ibWritten];
+        size_t cb = (b < 0x80) ? 1 : (b < 0xE0) ? 2 : (b < 0xF0) ? 3 : 4;
+        if (cbOutMax - *pcbWritten < cb)
+            return false;
+
+        memcpy(pbOut + *pcbWritten, _held + _ibWritten, cb);
+        *pcbWritten += cb;
+        _ibWritten += cb;
+    }
+
+    _cbHeld = 0;
+    _ibWritten = 0;
+    return true;
+}
+
+// One character. Called only when everything final has been written.
+void Romanizer::_Step(uint32_t cp)
+{
+    TamilCharInfo info = GetTamilCharInfo((char16_t)((cp < 0x10000) ? cp : 0));
+    Syllable* pLast = (_cSyllables > 0) ? &_syllables[_cSyllables - 1] : nullptr;
+    bool fAfterConsonant = pLast != nullptr && IsConsonantUnit(pLast->unit);
+
+    switch (info.charClass)
+    {
+    case TamilClassConsonant:
+        if (info.index >= c_tamilConsonantCount)
+            break;
+
+        if (fAfterConsonant && pLast->ending == c_romanPulli)
+        {
+            // A cluster the scheme has a token for
+            for (size_t i = 0; i < _cClusters && pLast->unit < c_tamilConsonantCount; i++)
+            {
+                if (_clusters[i].first == pLast->unit && _clusters[i].second == info.index)
+                {
+                    pLast->unit = (uint8_t)(c_tamilConsonantCount + i);
+                    pLast->ending = 0;
+                    return;
+                }
+            }
+
+            // How a consonant with pulli is written depends on what follows,
+            // so it waits for the next syllable
+            if (_cSyllables == c_romanChainMax)
+                _Flush(1);
+        }
+        else
+        {
+            _Flush(_cSyllables);
+        }
+        _syllables[_cSyllables++] = { info.index, 0 };
+        return;
+
+    case TamilClassVowelSign:
+        if (fAfterConsonant && pLast->ending == 0 && cp != c_tamilAuLength)
+        {
+            pLast->ending = info.index;
+            return;
+        }
+
+        // Decomposed ொ ோ ௌ, and ஔ as ஒ + ௗ
+        if (pLast != nullptr && cp == c_tamilAA && fAfterConsonant && (pLast->ending == c_vowelE || pLast->ending == c_vowelEE))
+        {
+            pLast->ending = (pLast->ending == c_vowelE) ? c_vowelO : c_vowelOO;
+            return;
+        }
+        if (pLast != nullptr && cp == c_tamilAuLength &&
+            ((fAfterConsonant && pLast->ending == c_vowelE) || (pLast->unit == c_romanUnitVowel && pLast->ending == c_vowelO)))
+        {
+            pLast->ending = c_vowelAU;
+            return;
+        }
+
+        // A sign with no consonant to carry it reads as its vowel
+        _Flush(_cSyllables);
+        _syllables[_cSyllables++] = { c_romanUnitVowel, info.index };
+        return;
+
+    case TamilClassPulli:
+        if (fAfterConsonant && pLast->ending == 0)
+        {
+            pLast->ending = c_romanPulli;
+            return;
+        }
+        break;
+
+    case TamilClassVowel:
+        _Flush(_cSyllables);
+        _syllables[_cSyllables++] = { c_romanUnitVowel, info.index };
+        return;
+
+    case TamilClassAytham:
+        _Flush(_cSyllables);
+        _syllables[_cSyllables++] = { c_romanUnitAytham, 0 };
+        return;
+
+    default:
+        break;
+    }
+
+    // Not a Tamil letter: kept as it is, and the next letter starts a word
+    _Flush(_cSyllables);
+    _Append(cp);
+    _fWordStart = true;
+}
+
+// Writes out the first cSyllables held syllables. Each is romanized from
+// the last one back, so every consonant with pulli knows the letters that
+// follow it.
+void Romanizer::_Flush(size_t cSyllables)
+{
+    if (cSyllables == 0)
+        return;
+
+    char roman[c_romanChainMax][c_romanSyllableMax];
+    size_t cchRoman[c_romanChainMax];
+    char right[c_phoneticMaxToken];
+    size_t cchRight = 0;
+
+    for (size_t i = _cSyllables; i-- > 0; )
+    {
+        cchRoman[i] = _Romanize(_syllables[i], i == 0 && _fWordStart, right, cchRight, roman[i]);
+        if (i == 0)
+            break;
+
+        // Only the first few letters after a token can change it
+        char next[c_romanSyllableMax + c_phoneticMaxToken];
+        memcpy(next, roman[i], cchRoman[i]);
+        memcpy(next + cchRoman[i], right, cchRight);
+        cchRight = (cchRoman[i] + cchRight < c_phoneticMaxToken) ? cchRoman[i] + cchRight : c_phoneticMaxToken;
+        memcpy(right, next, cchRight);
+    }
+
+    for (size_t i = 0; i < cSyllables; i++)
+    {
+        memcpy(_held + _cbHeld, roman[i], cchRoman[i]);
+        _cbHeld += cchRoman[i];
+    }
+
+    memmove(_syllables, _syllables + cSyllables, (_cSyllables - cSyllables) * sizeof(Syllable));
+    _cSyllables -= cSyllables;
+    _fWordStart = false;
+}
+
+// The letters for one syllable, given the letters that follow it
+size_t Romanizer::_Romanize(const Syllable& syllable, bool fWordStart, const char* pchRight, size_t cchRight, char* pchOut) const
+{
+    if (syllable.unit == c_romanUnitVowel || syllable.unit == c_romanUnitAytham)
+    {
+        const char* roman = (syllable.unit == c_romanUnitVowel) ? _vowelRoman[syllable.ending] : _aythamRoman;
+        size_t cch = strlen(roman);
+        memcpy(pchOut, roman, cch);
+        return cch;
+    }
+
+    if (syllable.ending != c_romanPulli)
+    {
+        const RomanText& roman = _syllableRoman[fWordStart][syllable.unit][syllable.ending];
+        memcpy(pchOut, roman.text, roman.cch);
+        return roman.cch;
+    }
+
+    return _Unit(syllable.unit, fWordStart, pchRight, cchRight, pchOut);
+}
+
+// The letters for a consonant or cluster followed by pchRight[0..cchRight)
+size_t Romanizer::_Unit(uint8_t unit, bool fWordStart, const char* pchRight, size_t cchRight, char* pchOut) const
+{
+    if (unit < c_tamilConsonantCount)
+        return _Consonant(unit, fWordStart, pchRight, cchRight, pchOut);
+
+    const Cluster& cluster = _clusters[unit - c_tamilConsonantCount];
+    char joined[2 * c_phoneticMaxToken];
+    size_t cch = strlen(cluster.roman);
+    memcpy(joined, cluster.roman, cch);
+    memcpy(joined + cch, pchRight, cchRight);
+    if (PhoneticEngine::LongestToken(joined, cch + cchRight) == cch)
+    {
+        memcpy(pchOut, cluster.roman, cch);
+        return cch;
+    }
+
+    // The cluster's token would run into what follows: its letters
+    char second[c_phoneticMaxToken];
+    size_t cchSecond = _Consonant(cluster.second, false, pchRight, cchRight, second);
+    cch = _Consonant(cluster.first, fWordStart, second, cchSecond, pchOut);
+    memcpy(pchOut + cch, second, cchSecond);
+    return cch + cchSecond;
+}
+
+// The first token for a consonant that the letters after it do not join
+// into a longer one; the first token if every one of them would be
+size_t Romanizer::_Consonant(uint8_t consonant, bool fWordStart, const char* pchRight, size_t cchRight, char* pchOut) const
+{
+    const Candidates* pCandidates = &_consonants[fWordStart][consonant];
+    if (pCandidates->count == 0)
+        pCandidates = &_consonants[0][consonant];
+
+    size_t iChosen = 0;
+    for (size_t i = 0; i < pCandidates->count; i++)
+    {
+        char joined[2 * c_phoneticMaxToken];
+        size_t cch = strlen(pCandidates->roman[i]);
+        memcpy(joined, pCandidates->roman[i], cch);
+        memcpy(joined + cch, pchRight, cchRight);
+        if (PhoneticEngine::LongestToken(joined, cch + cchRight) == cch)
+        {
+            iChosen = i;
+            break;
+        }
+    }
+
+    size_t cch = strlen(pCandidates->roman[iChosen]);
+    memcpy(pchOut, pCandidates->roman[iChosen], cch);
+    return cch;
+}
+
+// A character kept as it is, as UTF-8
+void Romanizer::_Append(uint32_t cp)
+{
+    char* pb = _held + _cbHeld;
+    if (cp < 0x80)
+    {
+        pb[0] = (char)cp;
+        _cbHeld += 1;
+    }
+    else if (cp < 0x800)
+    {
+        pb[0] = (char)(0xC0 | (cp >> 6));
+        pb[1] = (char)(0x80 | (cp & 0x3F));
+        _cbHeld += 2;
+    }
+    else if (cp < 0x10000)
+    {
+        pb[0] = (char)(0xE0 | (cp >> 12));
+        pb[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        pb[2] = (char)(0x80 | (cp & 0x3F));
+        _cbHeld += 3;
+    }
+    else
+    {
+        pb[0] = (char)(0xF0 | (cp >> 18));
+        pb[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+        pb[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        pb[3] = (char)(0x80 | (cp & 0x3F));
+        _cbHeld += 4;
+    }
+}
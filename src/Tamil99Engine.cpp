@@ -0,0 +1,93 @@
+﻿// Tamil99Engine.cpp
+// Tamil99 composition rules - see Tamil99Engine.h
+
+#include "../include/Tamil99Engine.h"
+#include "../include/EngineImage.h"
+
+// Hard consonant that takes an automatic pulli after each soft consonant,
+// stored as consonant index + 1 (0 = no pair)
+static constexpr uint8_t c_softHardPartner[c_tamilConsonantCount] =
+{
+    0,      1,      0,      3,      0,      5,          // ங -> க, ஞ -> ச, ண -> ட
+    0,      7,      0,      9,      0,      0,          // ந -> த, ம -> ப
+    0,      0,      0,      0,      0,      17,         // ன -> ற
+    0,      0,      0,      0,
+};
+
+bool Tamil99Engine::ProcessKey(const char16_t* pchKey, size_t cchKey, EngineOutput* pOutput)
+{
+    pOutput->Clear();
+
+    if (cchKey == 0)
+        return false;
+
+    // Multi-unit keys such as க்ஷ are inserted as-is
+    if (cchKey > 1)
+    {
+        pOutput->Append(pchKey, cchKey);
+        _EnterFromText(pchKey, cchKey);
+        return true;
+    }
+
+    char16_t ch = pchKey[0];
+    TamilCharInfo info = GetTamilCharInfo(ch);
+
+    switch (info.charClass)
+    {
+    case TamilClassVowel:
+        if (_state != StateIdle)
+        {
+            // The consonant is already in the document; only the vowel sign is new
+            const TamilSyllable& syllable = EmbeddedImage().Syllables().cell[_consonant][info.index];
+            pOutput->Append(syllable.text + 1, syllable.cch - 1);
+            Reset();
+            return true;
+        }
+        pOutput->Append(ch);
+        return true;
+
+    case TamilClassConsonant:
+        if (info.index >= c_tamilConsonantCount)
+        {
+            pOutput->Append(ch);
+            Reset();
+            return true;
+        }
+
+        if (_state == StateConsonant &&
+            (info.index == _consonant || c_softHardPartner[_consonant] == info.index + 1))
+        {
+            pOutput->Append(c_tamilPulli);
+            pOutput->Append(ch);
+            _state = StateClusterEnd;
+        }
+        else
+        {
+            pOutput->Append(ch);
+            _state = StateConsonant;
+        }
+        _consonant = info.index;
+        return true;
+
+    default:
+        // Explicit pulli, aytham, digits and anything else end the syllable
+        pOutput->Append(ch);
+        Reset();
+        return true;
+    }
+}
+
+void Tamil99Engine::_EnterFromText(const char16_t* pch, size_t cch)
+{
+    TamilCharInfo info = GetTamilCharInfo(pch[cch - 1]);
+
+    if (info.charClass == TamilClassConsonant && info.index < c_tamilConsonantCount)
+    {
+        _state = StateConsonant;
+        _consonant = info.index;
+    }
+    else
+    {
+        Reset();
+    }
+}
@@ -0,0 +1,633 @@
+﻿// TamilScan.cpp
+// Tamil classification kernels and their runtime selection - see TamilScan.h
+//
+// All vector kernels reduce a unit to one byte: its offset into the Tamil
+// block, or 0x80 and up outside it. That byte indexes a 128-entry code
+// table, class in bits 0-2 and "continues a cluster" in bit 3. NEON looks
+// the byte up directly (TBL over 64 bytes, twice). SSSE3 and AVX2 shuffle
+// only 16 bytes at a time, so the table is split into bit planes: for each
+// code bit and each low nibble, a byte whose bit h says row h of the block
+// has that code bit set. The high nibble picks the row bit.
+
+#include "../include/TamilScan.h"
+
+#if defined(_M_ARM64) || defined(_M_ARM64EC) || defined(__aarch64__)
+#define TAMILSCAN_NEON
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#elif defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TAMILSCAN_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(TAMILSCAN_X86) && !defined(_MSC_VER)
+#define TAMILSCAN_TARGET(isa) __attribute__((target(isa)))
+#else
+#define TAMILSCAN_TARGET(isa)
+#endif
+
+static const uint8_t c_codeClassMask = 0x07;
+static const uint8_t c_codeContinues = 0x08;
+
+struct TamilScanTable
+{
+    uint8_t code[128];
+    uint8_t planes[4][16];
+    uint8_t rowBits[16];
+};
+
+constexpr TamilScanTable MakeTamilScanTable()
+{
+    TamilScanTable table = {};
+
+    for (size_t i = 0; i < 128; i++)
+    {
+        TamilCharClass charClass = c_tamilCharTable.info[i].charClass;
+        bool fContinues = charClass == TamilClassVowelSign || charClass == TamilClassPulli || i == 0x02;
+        table.code[i] = (uint8_t)(charClass | (fContinues ? c_codeContinues : 0));
+    }
+
+    for (size_t bit = 0; bit < 4; bit++)
+    {
+        for (size_t lo = 0; lo < 16; lo++)
+        {
+            for (size_t row = 0; row < 8; row++)
+            {
+                if (table.code[row * 16 + lo] & (1 << bit))
+                    table.planes[bit][lo] |= (uint8_t)(1 << row);
+            }
+        }
+    }
+
+    // Rows 8-15 are outside the block: no bit, so no plane matches
+    for (size_t row = 0; row < 8; row++)
+        table.rowBits[row] = (uint8_t)(1 << row);
+
+    return table;
+}
+
+static constexpr TamilScanTable c_scanTable = MakeTamilScanTable();
+
+static_assert(c_tamilBlockEnd - c_tamilBlockStart + 1 == 128, "the code table covers the block");
+static_assert(c_scanTable.code[c_tamilPulli - c_tamilBlockStart] == (TamilClassPulli | c_codeContinues), "pulli");
+
+static inline unsigned LowestBit(uint32_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctz(mask);
+#endif
+}
+
+//
+// Scalar
+//
+
+static void ScalarClassify(const char16_t* pch, size_t cch, uint8_t* pClasses)
+{
+    for (size_t i = 0; i < cch; i++)
+        pClasses[i] = GetTamilCharInfo(pch[i]).charClass;
+}
+
+static void ScalarClusterStarts(const char16_t* pch, size_t cch, char16_t chBefore, uint8_t* pfStarts)
+{
+    for (size_t i = 0; i < cch; i++)
+    {
+        pfStarts[i] = TamilContinuesCluster(chBefore, pch[i]) ? 0 : 1;
+        chBefore = pch[i];
+    }
+}
+
+static size_t ScalarFindAscii(const char16_t* pch, size_t cch)
+{
+    size_t i = 0;
+    while (i < cch && pch[i] >= 0x80)
+        i++;
+    return i;
+}
+
+static size_t ScalarWidenAscii(const uint8_t* pb, size_t cb, char16_t* pch)
+{
+    size_t i = 0;
+    for (; i < cb && pb[i] < 0x80; i++)
+        pch[i] = pb[i];
+    return i;
+}
+
+static size_t ScalarNarrowAscii(const char16_t* pch, size_t cch, uint8_t* pb)
+{
+    size_t i = 0;
+    for (; i < cch && pch[i] < 0x80; i++)
+        pb[i] = (uint8_t)pch[i];
+    return i;
+}
+
+static const TamilScanKernels c_scalarKernels =
+{
+    "scalar", ScalarClassify, ScalarClusterStarts, ScalarFindAscii, ScalarWidenAscii, ScalarNarrowAscii
+};
+
+#if defined(TAMILSCAN_X86)
+
+//
+// SSSE3: 16 units per step. SSE2 alone has no byte shuffle to look up with.
+//
+
+// Code bytes of 16 units
+TAMILSCAN_TARGET("ssse3") static inline __m128i Ssse3Codes(__m128i a, __m128i b)
+{
+    // Offset into the block, clamped to 0x80 (unsigned min through the
+    // signed one: flip the sign bit on the way in and out)
+    const __m128i blockStart = _mm_set1_epi16((short)c_tamilBlockStart);
+    const __m128i signBit = _mm_set1_epi16((short)0x8000);
+    const __m128i limit = _mm_set1_epi16((short)(0x80 ^ 0x8000));
+    __m128i offsetA = _mm_xor_si128(_mm_min_epi16(_mm_xor_si128(_mm_sub_epi16(a, blockStart), signBit), limit), signBit);
+    __m128i offsetB = _mm_xor_si128(_mm_min_epi16(_mm_xor_si128(_mm_sub_epi16(b, blockStart), signBit), limit), signBit);
+    __m128i offset = _mm_packus_epi16(offsetA, offsetB);
+
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    __m128i lo = _mm_and_si128(offset, nibble);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(offset, 4), nibble);
+    __m128i row = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)c_scanTable.rowBits), hi);
+
+    const __m128i zero = _mm_setzero_si128();
+    __m128i code = zero;
+    for (int bit = 0; bit < 4; bit++)
+    {
+        __m128i plane = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)c_scanTable.planes[bit]), lo);
+        __m128i miss = _mm_cmpeq_epi8(_mm_and_si128(plane, row), zero);
+        code = _mm_or_si128(code, _mm_andnot_si128(miss, _mm_set1_epi8((char)(1 << bit))));
+    }
+    return code;
+}
+
+// 0xFFFF where first <= v <= last
+TAMILSCAN_TARGET("ssse3") static inline __m128i Ssse3InRange(__m128i v, uint16_t first, uint16_t last)
+{
+    __m128i above = _mm_subs_epu16(_mm_sub_epi16(v, _mm_set1_epi16((short)first)), _mm_set1_epi16((short)(last - first)));
+    return _mm_cmpeq_epi16(above, _mm_setzero_si128());
+}
+
+// 0xFFFF where unit x continues its cluster for reasons outside the block
+TAMILSCAN_TARGET("ssse3") static inline __m128i Ssse3ContinuesOutside(__m128i x, __m128i before)
+{
+    __m128i marks = _mm_or_si128(_mm_or_si128(Ssse3InRange(x, 0x0300, 0x036F), Ssse3InRange(x, 0x200C, 0x200D)),
+        Ssse3InRange(x, 0xFE00, 0xFE0F));
+    __m128i pair = _mm_and_si128(Ssse3InRange(x, 0xDC00, 0xDFFF), Ssse3InRange(before, 0xD800, 0xDBFF));
+    __m128i crlf = _mm_and_si128(_mm_cmpeq_epi16(x, _mm_set1_epi16(0x0A)), _mm_cmpeq_epi16(before, _mm_set1_epi16(0x0D)));
+    return _mm_or_si128(marks, _mm_or_si128(pair, crlf));
+}
+
+TAMILSCAN_TARGET("ssse3") static void Ssse3Classify(const char16_t* pch, size_t cch, uint8_t* pClasses)
+{
+    const __m128i classMask = _mm_set1_epi8((char)c_codeClassMask);
+    size_t i = 0;
+    for (; i + 16 <= cch; i += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(pch + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(pch + i + 8));
+        _mm_storeu_si128((__m128i*)(pClasses + i), _mm_and_si128(Ssse3Codes(a, b), classMask));
+    }
+    ScalarClassify(pch + i, cch - i, pClasses + i);
+}
+
+TAMILSCAN_TARGET("ssse3") static void Ssse3ClusterStarts(const char16_t* pch, size_t cch, char16_t chBefore, uint8_t* pfStarts)
+{
+    if (cch == 0)
+        return;
+    ScalarClusterStarts(pch, 1, chBefore, pfStarts);
+
+    // From 1 on, the unit before is in the text
+    const __m128i continues = _mm_set1_epi8((char)c_codeContinues);
+    const __m128i one = _mm_set1_epi8(1);
+    size_t i = 1;
+    for (; i + 16 <= cch; i += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(pch + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(pch + i + 8));
+        __m128i beforeA = _mm_loadu_si128((const __m128i*)(pch + i - 1));
+        __m128i beforeB = _mm_loadu_si128((const __m128i*)(pch + i + 7));
+
+        __m128i inBlock = _mm_cmpeq_epi8(_mm_and_si128(Ssse3Codes(a, b), continues), continues);
+        __m128i outside = _mm_packs_epi16(Ssse3ContinuesOutside(a, beforeA), Ssse3ContinuesOutside(b, beforeB));
+        _mm_storeu_si128((__m128i*)(pfStarts + i), _mm_andnot_si128(_mm_or_si128(inBlock, outside), one));
+    }
+    ScalarClusterStarts(pch + i, cch - i, pch[i - 1], pfStarts + i);
+}
+
+TAMILSCAN_TARGET("ssse3") static size_t Ssse3FindAscii(const char16_t* pch, size_t cch)
+{
+    const __m128i high = _mm_set1_epi16((short)0xFF80);
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= cch; i += 8)
+    {
+        __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(_mm_loadu_si128((const __m128i*)(pch + i)), high), zero);
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(ascii);
+        if (mask != 0)
+            return i + LowestBit(mask) / 2;
+    }
+    return i + ScalarFindAscii(pch + i, cch - i);
+}
+
+// Whole blocks of 16 only; the block holding the run's end goes scalar
+TAMILSCAN_TARGET("ssse3") static size_t Ssse3WidenAscii(const uint8_t* pb, size_t cb, char16_t* pch)
+{
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= cb; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(pb + i));
+        if (_mm_movemask_epi8(v) != 0)
+            break;
+        _mm_storeu_si128((__m128i*)(pch + i), _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128((__m128i*)(pch + i + 8), _mm_unpackhi_epi8(v, zero));
+    }
+    return i + ScalarWidenAscii(pb + i, cb - i, pch + i);
+}
+
+TAMILSCAN_TARGET("ssse3") static size_t Ssse3NarrowAscii(const char16_t* pch, size_t cch, uint8_t* pb)
+{
+    const __m128i high = _mm_set1_epi16((short)0xFF80);
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= cch; i += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(pch + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(pch + i + 8));
+        __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(a, b), high), zero);
+        if (_mm_movemask_epi8(ascii) != 0xFFFF)
+            break;
+        _mm_storeu_si128((__m128i*)(pb + i), _mm_packus_epi16(a, b));
+    }
+    return i + ScalarNarrowAscii(pch + i, cch - i, pb + i);
+}
+
+static const TamilScanKernels c_ssse3Kernels =
+{
+    "ssse3", Ssse3Classify, Ssse3ClusterStarts, Ssse3FindAscii, Ssse3WidenAscii, Ssse3NarrowAscii
+};
+
+//
+// AVX2: the same, 32 units per step. Packing works within 128-bit lanes,
+// so the packed halves are put back in order.
+//
+
+TAMILSCAN_TARGET("avx2") static inline __m256i Avx2Codes(__m256i a, __m256i b)
+{
+    const __m256i blockStart = _mm256_set1_epi16((short)c_tamilBlockStart);
+    const __m256i limit = _mm256_set1_epi16(0x80);
+    __m256i offsetA = _mm256_min_epu16(_mm256_sub_epi16(a, blockStart), limit);
+    __m256i offsetB = _mm256_min_epu16(_mm256_sub_epi16(b, blockStart), limit);
+    __m256i offset = _mm256_permute4x64_epi64(_mm256_packus_epi16(offsetA, offsetB), 0xD8);
+
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    __m256i lo = _mm256_and_si256(offset, nibble);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(offset, 4), nibble);
+    __m256i row = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)c_scanTable.rowBits)), hi);
+
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i code = zero;
+    for (int bit = 0; bit < 4; bit++)
+    {
+        __m256i planes = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)c_scanTable.planes[bit]));
+        __m256i miss = _mm256_cmpeq_epi8(_mm256_and_si256(_mm256_shuffle_epi8(planes, lo), row), zero);
+        code = _mm256_or_si256(code, _mm256_andnot_si256(miss, _mm256_set1_epi8((char)(1 << bit))));
+    }
+    return code;
+}
+
+TAMILSCAN_TARGET("avx2") static inline __m256i Avx2InRange(__m256i v, uint16_t first, uint16_t last)
+{
+    __m256i offset = _mm256_sub_epi16(v, _mm256_set1_epi16((short)first));
+    return _mm256_cmpeq_epi16(_mm256_min_epu16(offset, _mm256_set1_epi16((short)(last - first))), offset);
+}
+
+TAMILSCAN_TARGET("avx2") static inline __m256i Avx2ContinuesOutside(__m256i x, __m256i before)
+{
+    __m256i marks = _mm256_or_si256(_mm256_or_si256(Avx2InRange(x, 0x0300, 0x036F), Avx2InRange(x, 0x200C, 0x200D)),
+        Avx2InRange(x, 0xFE00, 0xFE0F));
+    __m256i pair = _mm256_and_si256(Avx2InRange(x, 0xDC00, 0xDFFF), Avx2InRange(before, 0xD800, 0xDBFF));
+    __m256i crlf = _mm256_and_si256(_mm256_cmpeq_epi16(x, _mm256_set1_epi16(0x0A)), _mm256_cmpeq_epi16(before, _mm256_set1_epi16(0x0D)));
+    return _mm256_or_si256(marks, _mm256_or_si256(pair, crlf));
+}
+
+TAMILSCAN_TARGET("avx2") static void Avx2Classify(const char16_t* pch, size_t cch, uint8_t* pClasses)
+{
+    const __m256i classMask = _mm256_set1_epi8((char)c_codeClassMask);
+    size_t i = 0;
+    for (; i + 32 <= cch; i += 32)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(pch + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(pch + i + 16));
+        _mm256_storeu_si256((__m256i*)(pClasses + i), _mm256_and_si256(Avx2Codes(a, b), classMask));
+    }
+    Ssse3Classify(pch + i, cch - i, pClasses + i);
+}
+
+TAMILSCAN_TARGET("avx2") static void Avx2ClusterStarts(const char16_t* pch, size_t cch, char16_t chBefore, uint8_t* pfStarts)
+{
+    if (cch == 0)
+        return;
+    ScalarClusterStarts(pch, 1, chBefore, pfStarts);
+
+    const __m256i continues = _mm256_set1_epi8((char)c_codeContinues);
+    const __m256i one = _mm256_set1_epi8(1);
+    size_t i = 1;
+    for (; i + 32 <= cch; i += 32)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(pch + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(pch + i + 16));
+        __m256i beforeA = _mm256_loadu_si256((const __m256i*)(pch + i - 1));
+        __m256i beforeB = _mm256_loadu_si256((const __m256i*)(pch + i + 15));
+
+        __m256i inBlock = _mm256_cmpeq_epi8(_mm256_and_si256(Avx2Codes(a, b), continues), continues);
+        __m256i outside = _mm256_permute4x64_epi64(
+            _mm256_packs_epi16(Avx2ContinuesOutside(a, beforeA), Avx2ContinuesOutside(b, beforeB)), 0xD8);
+        _mm256_storeu_si256((__m256i*)(pfStarts + i), _mm256_andnot_si256(_mm256_or_si256(inBlock, outside), one));
+    }
+    if (i < cch)
+        Ssse3ClusterStarts(pch + i, cch - i, pch[i - 1], pfStarts + i);
+}
+
+TAMILSCAN_TARGET("avx2") static size_t Avx2FindAscii(const char16_t* pch, size_t cch)
+{
+    const __m256i high = _mm256_set1_epi16((short)0xFF80);
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= cch; i += 16)
+    {
+        __m256i ascii = _mm256_cmpeq_epi16(_mm256_and_si256(_mm256_loadu_si256((const __m256i*)(pch + i)), high), zero);
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(ascii);
+        if (mask != 0)
+            return i + LowestBit(mask) / 2;
+    }
+    return i + Ssse3FindAscii(pch + i, cch - i);
+}
+
+TAMILSCAN_TARGET("avx2") static size_t Avx2WidenAscii(const uint8_t* pb, size_t cb, char16_t* pch)
+{
+    size_t i = 0;
+    for (; i + 32 <= cb; i += 32)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(pb + i));
+        if (_mm256_movemask_epi8(v) != 0)
+            break;
+        _mm256_storeu_si256((__m256i*)(pch + i), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v)));
+        _mm256_storeu_si256((__m256i*)(pch + i + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1)));
+    }
+    return i + Ssse3WidenAscii(pb + i, cb - i, pch + i);
+}
+
+TAMILSCAN_TARGET("avx2") static size_t Avx2NarrowAscii(const char16_t* pch, size_t cch, uint8_t* pb)
+{
+    const __m256i high = _mm256_set1_epi16((short)0xFF80);
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= cch; i += 32)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(pch + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(pch + i + 16));
+        __m256i ascii = _mm256_cmpeq_epi16(_mm256_and_si256(_mm256_or_si256(a, b), high), zero);
+        if ((uint32_t)_mm256_movemask_epi8(ascii) != 0xFFFFFFFF)
+            break;
+        _mm256_storeu_si256((__m256i*)(pb + i), _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8));
+    }
+    return i + Ssse3NarrowAscii(pch + i, cch - i, pb + i);
+}
+
+static const TamilScanKernels c_avx2Kernels =
+{
+    "avx2", Avx2Classify, Avx2ClusterStarts, Avx2FindAscii, Avx2WidenAscii, Avx2NarrowAscii
+};
+
+static void Cpuid(int leaf, int regs[4])
+{
+#if defined(_MSC_VER)
+    __cpuidex(regs, leaf, 0);
+#else
+    unsigned int a, b, c, d;
+    __cpuid_count(leaf, 0, a, b, c, d);
+    regs[0] = (int)a;
+    regs[1] = (int)b;
+    regs[2] = (int)c;
+    regs[3] = (int)d;
+#endif
+}
+
+static bool HasSsse3()
+{
+    int regs[4];
+    Cpuid(1, regs);
+    return (regs[2] & (1 << 9)) != 0;
+}
+
+// AVX2 in the CPU and YMM state saved by the OS
+static bool HasAvx2()
+{
+    int regs[4];
+    Cpuid(0, regs);
+    if (regs[0] < 7)
+        return false;
+
+    Cpuid(1, regs);
+    bool fOsSaves = (regs[2] & (1 << 27)) != 0 && (regs[2] & (1 << 28)) != 0;
+    if (!fOsSaves)
+        return false;
+
+#if defined(_MSC_VER)
+    uint64_t xcr0 = _xgetbv(0);
+#else
+    uint32_t xcr0Low, xcr0High;
+    __asm__("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+    uint64_t xcr0 = ((uint64_t)xcr0High << 32) | xcr0Low;
+#endif
+    if ((xcr0 & 0x6) != 0x6)
+        return false;
+
+    Cpuid(7, regs);
+    return (regs[1] & (1 << 5)) != 0;
+}
+
+#endif // TAMILSCAN_X86
+
+#if defined(TAMILSCAN_NEON)
+
+//
+// NEON: 16 units per step; TBL looks the code table up directly
+//
+
+static inline uint8x16_t NeonCodes(uint16x8_t a, uint16x8_t b, const uint8x16x4_t& tableLow, const uint8x16x4_t& tableHigh)
+{
+    // Offset into the block, saturated to 255 outside it
+    const uint16x8_t blockStart = vdupq_n_u16(c_tamilBlockStart);
+    uint8x16_t offset = vcombine_u8(vqmovn_u16(vsubq_u16(a, blockStart)), vqmovn_u16(vsubq_u16(b, blockStart)));
+
+    // Offsets 0-63 from the first half; 64-127 from the second, and
+    // anything else keeps the 0 the first lookup gave it
+    uint8x16_t code = vqtbl4q_u8(tableLow, offset);
+    return vqtbx4q_u8(code, tableHigh, vsubq_u8(offset, vdupq_n_u8(64)));
+}
+
+static inline void NeonLoadTable(uint8x16x4_t* pTableLow, uint8x16x4_t* pTableHigh)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        pTableLow->val[i] = vld1q_u8(c_scanTable.code + 16 * i);
+        pTableHigh->val[i] = vld1q_u8(c_scanTable.code + 64 + 16 * i);
+    }
+}
+
+static inline uint16x8_t NeonInRange(uint16x8_t v, uint16_t first, uint16_t last)
+{
+    return vcleq_u16(vsubq_u16(v, vdupq_n_u16(first)), vdupq_n_u16((uint16_t)(last - first)));
+}
+
+static inline uint16x8_t NeonContinuesOutside(uint16x8_t x, uint16x8_t before)
+{
+    uint16x8_t marks = vorrq_u16(vorrq_u16(NeonInRange(x, 0x0300, 0x036F), NeonInRange(x, 0x200C, 0x200D)), NeonInRange(x, 0xFE00, 0xFE0F));
+    uint16x8_t pair = vandq_u16(NeonInRange(x, 0xDC00, 0xDFFF), NeonInRange(before, 0xD800, 0xDBFF));
+    uint16x8_t crlf = vandq_u16(vceqq_u16(x, vdupq_n_u16(0x0A)), vceqq_u16(before, vdupq_n_u16(0x0D)));
+    return vorrq_u16(marks, vorrq_u16(pair, crlf));
+}
+
+static void NeonClassify(const char16_t* pch, size_t cch, uint8_t* pClasses)
+{
+    uint8x16x4_t tableLow;
+    uint8x16x4_t tableHigh;
+    NeonLoadTable(&tableLow, &tableHigh);
+
+    const uint8x16_t classMask = vdupq_n_u8(c_codeClassMask);
+    size_t i = 0;
+    for (; i + 16 <= cch; i += 16)
+    {
+        uint16x8_t a = vld1q_u16((const uint16_t*)(pch + i));
+        uint16x8_t b = vld1q_u16((const uint16_t*)(pch + i + 8));
+        vst1q_u8(pClasses + i, vandq_u8(NeonCodes(a, b, tableLow, tableHigh), classMask));
+    }
+    ScalarClassify(pch + i, cch - i, pClasses + i);
+}
+
+static void NeonClusterStarts(const char16_t* pch, size_t cch, char16_t chBefore, uint8_t* pfStarts)
+{
+    if (cch == 0)
+        return;
+    ScalarClusterStarts(pch, 1, chBefore, pfStarts);
+
+    uint8x16x4_t tableLow;
+    uint8x16x4_t tableHigh;
+    NeonLoadTable(&tableLow, &tableHigh);
+
+    const uint8x16_t continues = vdupq_n_u8(c_codeContinues);
+    const uint8x16_t one = vdupq_n_u8(1);
+    size_t i = 1;
+    for (; i + 16 <= cch; i += 16)
+    {
+        uint16x8_t a = vld1q_u16((const uint16_t*)(pch + i));
+        uint16x8_t b = vld1q_u16((const uint16_t*)(pch + i + 8));
+        uint16x8_t beforeA = vld1q_u16((const uint16_t*)(pch + i - 1));
+        uint16x8_t beforeB = vld1q_u16((const uint16_t*)(pch + i + 7));
+
+        uint8x16_t inBlock = vtstq_u8(NeonCodes(a, b, tableLow, tableHigh), continues);
+        uint8x16_t outside = vcombine_u8(vmovn_u16(NeonContinuesOutside(a, beforeA)), vmovn_u16(NeonContinuesOutside(b, beforeB)));
+        vst1q_u8(pfStarts + i, vbicq_u8(one, vorrq_u8(inBlock, outside)));
+    }
+    ScalarClusterStarts(pch + i, cch - i, pch[i - 1], pfStarts + i);
+}
+
+static size_t NeonFindAscii(const char16_t* pch, size_t cch)
+{
+    const uint16x8_t ascii = vdupq_n_u16(0x80);
+    size_t i = 0;
+    for (; i + 8 <= cch; i += 8)
+    {
+        // One byte per unit, 0xFF where it is ASCII
+        uint16x8_t below = vcltq_u16(vld1q_u16((const uint16_t*)(pch + i)), ascii);
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vmovn_u16(below)), 0);
+        if (mask != 0)
+        {
+            uint32_t maskLow = (uint32_t)mask;
+            return i + ((maskLow != 0) ? LowestBit(maskLow) : 32 + LowestBit((uint32_t)(mask >> 32))) / 8;
+        }
+    }
+    return i + ScalarFindAscii(pch + i, cch - i);
+}
+
+static size_t NeonWidenAscii(const uint8_t* pb, size_t cb, char16_t* pch)
+{
+    size_t i = 0;
+    for (; i + 16 <= cb; i += 16)
+    {
+        uint8x16_t v = vld1q_u8(pb + i);
+        if (vmaxvq_u8(v) >= 0x80)
+            break;
+        vst1q_u16((uint16_t*)(pch + i), vmovl_u8(vget_low_u8(v)));
+        vst1q_u16((uint16_t*)(pch + i + 8), vmovl_u8(vget_high_u8(v)));
+    }
+    return i + ScalarWidenAscii(pb + i, cb - i, pch + i);
+}
+
+static size_t NeonNarrowAscii(const char16_t* pch, size_t cch, uint8_t* pb)
+{
+    size_t i = 0;
+    for (; i + 16 <= cch; i += 16)
+    {
+        uint16x8_t a = vld1q_u16((const uint16_t*)(pch + i));
+        uint16x8_t b = vld1q_u16((const uint16_t*)(pch + i + 8));
+        if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80)
+            break;
+        vst1q_u8(pb + i, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+    }
+    return i + ScalarNarrowAscii(pch + i, cch - i, pb + i);
+}
+
+static const TamilScanKernels c_neonKernels =
+{
+    "neon", NeonClassify, NeonClusterStarts, NeonFindAscii, NeonWidenAscii, NeonNarrowAscii
+};
+
+#endif // TAMILSCAN_NEON
+
+size_t TamilScanAvailable(const TamilScanKernels** ppKernels, size_t cMax)
+{
+    size_t c = 0;
+    if (c < cMax)
+        ppKernels[c++] = &c_scalarKernels;
+
+#if defined(TAMILSCAN_X86)
+    if (c < cMax && HasSsse3())
+        ppKernels[c++] = &c_ssse3Kernels;
+    if (c < cMax && HasSsse3() && HasAvx2())
+        ppKernels[c++] = &c_avx2Kernels;
+#elif defined(TAMILSCAN_NEON)
+    // Part of every ARM64 CPU
+    if (c < cMax)
+        ppKernels[c++] = &c_neonKernels;
+#endif
+
+    return c;
+}
+
+const TamilScanKernels& TamilScan()
+{
+    // Thread-safe initialization; the CPU does not change under us
+    static const TamilScanKernels* s_pKernels = []()
+    {
+        const TamilScanKernels* apKernels[4];
+        size_t c = TamilScanAvailable(apKernels, 4);
+        return apKernels[c - 1];
+    }();
+    return *s_pKernels;
+}
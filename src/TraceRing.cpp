@@ -0,0 +1,176 @@
+﻿// TraceRing.cpp
+// Per-thread ring registration and the collector thread - see TraceRing.h
+
+#include "../include/TraceRing.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+std::atomic<bool> g_traceEnabled(false);
+TraceRingTable g_traceRings = {};
+
+static std::mutex s_drainLock;
+
+// Collector state, guarded by s_collectorLock
+static std::mutex s_collectorLock;
+static std::condition_variable s_collectorWake;
+static std::thread s_collector;
+static FILE* s_pTraceFile = nullptr;
+static int s_collectorRefs = 0;
+static bool s_collectorStop = false;
+
+// How often the collector empties the rings. A ring holds
+// c_traceRingRecords records, far more than a typist produces in this time.
+static const std::chrono::milliseconds c_traceDrainInterval(50);
+
+// Marks the ring retired when its thread exits so the collector can free it
+class TraceThreadSlot
+{
+public:
+    ~TraceThreadSlot()
+    {
+        if (pRing)
+            pRing->Retire();
+    }
+
+    TraceRing* pRing = nullptr;
+    bool full = false;
+};
+
+static thread_local TraceThreadSlot t_traceSlot;
+
+TraceRing* TraceThreadRing()
+{
+    TraceThreadSlot& slot = t_traceSlot;
+    if (slot.pRing || slot.full)
+        return slot.pRing;
+
+    for (uint32_t i = 0; i < c_traceMaxThreads; i++)
+    {
+        if (g_traceRings.slots[i].load(std::memory_order_relaxed))
+            continue;
+
+        TraceRing* pRing = new TraceRing(i);
+        TraceRing* pExpected = nullptr;
+        if (g_traceRings.slots[i].compare_exchange_strong(pExpected, pRing, std::memory_order_acq_rel))
+        {
+            slot.pRing = pRing;
+            return pRing;
+        }
+        delete pRing;
+    }
+
+    // No slot left - this thread stays untraced
+    slot.full = true;
+    return nullptr;
+}
+
+void TraceLockDrain()
+{
+    s_drainLock.lock();
+}
+
+void TraceUnlockDrain()
+{
+    s_drainLock.unlock();
+}
+
+static void WriteDrained(FILE* pFile)
+{
+    TraceDrainAll([pFile](const TraceRecord& record)
+    {
+        fwrite(&record, sizeof(record), 1, pFile);
+    });
+}
+
+static void CollectorMain(FILE* pFile)
+{
+    std::unique_lock<std::mutex> lock(s_collectorLock);
+    while (!s_collectorStop)
+    {
+        s_collectorWake.wait_for(lock, c_traceDrainInterval);
+
+        lock.unlock();
+        WriteDrained(pFile);
+        lock.lock();
+    }
+}
+
+bool TraceStart(FILE* pFile)
+{
+    std::lock_guard<std::mutex> lock(s_collectorLock);
+
+    if (s_collectorRefs++ > 0)
+    {
+        if (pFile && pFile != s_pTraceFile)
+            fclose(pFile);
+        return s_pTraceFile != nullptr;
+    }
+
+    if (!pFile)
+    {
+        s_collectorRefs = 0;
+        return false;
+    }
+
+    TraceFileHeader header = {};
+    header.magic = c_traceFileMagic;
+    header.version = c_traceFileVersion;
+    header.recordSize = sizeof(TraceRecord);
+    header.ticksPerSecond = (uint64_t)(std::chrono::steady_clock::period::den / std::chrono::steady_clock::period::num);
+    fwrite(&header, sizeof(header), 1, pFile);
+
+    s_pTraceFile = pFile;
+    s_collectorStop = false;
+    s_collector = std::thread(CollectorMain, pFile);
+    g_traceEnabled.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void TraceStop()
+{
+    std::thread collector;
+    FILE* pFile = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(s_collectorLock);
+        if (s_collectorRefs == 0 || --s_collectorRefs > 0)
+            return;
+
+        g_traceEnabled.store(false, std::memory_order_relaxed);
+        s_collectorStop = true;
+        collector = std::move(s_collector);
+        pFile = s_pTraceFile;
+        s_pTraceFile = nullptr;
+    }
+
+    s_collectorWake.notify_all();
+    if (collector.joinable())
+        collector.join();
+
+    // Whatever was pushed before tracing was switched off
+    WriteDrained(pFile);
+    fclose(pFile);
+}
+
+void TraceProcessExit()
+{
+    // The other threads are gone, the collector with them, possibly in the
+    // middle of a drain: wait for nothing and take no lock it may have held.
+    // It writes the file only while holding the drain lock, so if that lock
+    // is free the file's own lock is too.
+    if (!s_collector.joinable())
+        return;
+
+    g_traceEnabled.store(false, std::memory_order_relaxed);
+    s_collector.detach();
+    if (s_drainLock.try_lock())
+    {
+        s_drainLock.unlock();
+        WriteDrained(s_pTraceFile);
+        fclose(s_pTraceFile);
+    }
+    s_pTraceFile = nullptr;
+    s_collectorRefs = 0;
+}
@@ -0,0 +1,107 @@
+﻿// Transliterator.cpp
+// Bulk conversion through the keystroke engine - see Transliterator.h
+
+#include "../include/Transliterator.h"
+#include "../include/TamilScan.h"
+
+bool UsKeyForChar(char16_t ch, uint8_t* pvk, KeyLayer* pLayer)
+{
+    if (ch == '\t' || ch == '\r' || ch == '\n')
+    {
+        *pvk = (ch == '\t') ? 0x09 : 0x0D;      // VK_TAB, VK_RETURN
+        *pLayer = KeyLayerBase;
+        return true;
+    }
+    return UsKeyForAscii(ch, pvk, pLayer);
+}
+
+Transliterator::Transliterator(LayoutId layout)
+{
+    _engine.SetLayout(&g_layouts[layout]);
+
+    for (char16_t ch = 0; ch < 0x80; ch++)
+    {
+        uint8_t vk;
+        KeyLayer layer;
+        _codes[ch] = UsKeyForChar(ch, &vk, &layer) ? _engine.MapKey(layer, vk) : 0;
+    }
+}
+
+size_t Transliterator::Convert(const char16_t* pchIn, size_t cchIn, char16_t* pchOut, size_t cchOutMax) const
+{
+    const TamilScanKernels& scan = TamilScan();
+    KeyboardEngine engine = _engine;
+    bool fReset = true;             // engine is at its reset state
+    size_t cchOut = 0;
+    size_t cchNeeded = 0;
+
+    size_t i = 0;
+    while (i < cchIn)
+    {
+        char16_t ch = pchIn[i];
+        char16_t code = (ch < 0x80) ? _codes[ch] : 0;
+
+        if (code == 0)
+        {
+            // A run that passes through: the first character ends the
+            // syllable, and the whole run is kept as it is. Tamil and other
+            // non-ASCII text is skipped a vector at a time.
+            size_t iEnd = i + 1;
+            for (;;)
+            {
+                if (iEnd < cchIn && pchIn[iEnd] >= 0x80)
+                    iEnd += scan.pfnFindAscii(pchIn + iEnd, cchIn - iEnd);
+                if (iEnd == cchIn || _codes[pchIn[iEnd]] != 0)
+                    break;
+                iEnd++;
+            }
+
+            if (!fReset)
+            {
+                engine.Reset();
+                fReset = true;
+            }
+
+            size_t cchRun = iEnd - i;
+            if (pchOut != nullptr)
+            {
+                if (cchOut + cchRun > cchOutMax)
+                    return c_transliterateNoRoom;
+                for (size_t j = 0; j < cchRun; j++)
+                    pchOut[cchOut + j] = pchIn[i + j];
+            }
+            cchOut += cchRun;
+            if (cchOut > cchNeeded)
+                cchNeeded = cchOut;
+
+            i = iEnd;
+            continue;
+        }
+
+        EngineOutput output;
+        fReset = false;
+        if (!engine.ProcessKey(code, &output))
+        {
+            // Not eaten: the application types the character itself
+            output.Clear();
+            output.Append(ch);
+        }
+
+        // Engines only delete what they emitted within the open syllable
+        cchOut -= (output.cchDelete < cchOut) ? output.cchDelete : cchOut;
+        if (pchOut != nullptr)
+        {
+            if (cchOut + output.cchText > cchOutMax)
+                return c_transliterateNoRoom;
+            for (size_t j = 0; j < output.cchText; j++)
+                pchOut[cchOut + j] = output.text[j];
+        }
+        cchOut += output.cchText;
+        if (cchOut > cchNeeded)
+            cchNeeded = cchOut;
+
+        i++;
+    }
+
+    return (pchOut != nullptr) ? cchOut : cchNeeded;
+}
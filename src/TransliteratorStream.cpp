@@ -0,0 +1,270 @@
+﻿// TransliteratorStream.cpp
+// Push-style conversion of fragmented UTF-8 - see TransliteratorStream.h
+
+#include "../include/TransliteratorStream.h"
+
+#include <cstring>
+
+static_assert(c_streamHeldMax >= 2 * c_engineMaxOutput + 2, "held buffer must fit an open syllable and one key");
+
+TransliteratorStream::TransliteratorStream(const Transliterator& transliterator)
+{
+    _pTransliterator = &transliterator;
+    Reset();
+}
+
+void TransliteratorStream::Reset()
+{
+    _engine = _pTransliterator->ResetEngine();
+    _fReset = true;
+    _cbSequence = 0;
+    _cbSequenceNeeded = 0;
+    _cpSequence = 0;
+    _cchHeld = 0;
+    _cchFinal = 0;
+    _ichWritten = 0;
+}
+
+StreamResult TransliteratorStream::Feed(const char* pbIn, size_t cbIn, size_t* pcbRead, char* pbOut, size_t cbOutMax, size_t* pcbWritten)
+{
+    *pcbWritten = 0;
+
+    size_t ib = 0;
+    for (;;)
+    {
+        // Every key starts with nothing final left unwritten, so the held
+        // buffer only ever holds the open syllable and one key's output
+        if (!_Write(pbOut, cbOutMax, pcbWritten))
+        {
+            *pcbRead = ib;
+            return StreamOutputNeeded;
+        }
+        if (ib == cbIn)
+            break;
+
+        uint8_t b = (uint8_t)pbIn[ib];
+
+        if (_cbSequence == 0 && b < 0x80)
+        {
+            if (_cchHeld > _cchFinal || _pTransliterator->KeyCode(b) != 0)
+            {
+                _Step(b);
+                ib++;
+                continue;
+            }
+
+            // Nothing held and a run that passes through: it ends the
+            // syllable and goes straight to the output
+            if (*pcbWritten == cbOutMax)
+            {
+                *pcbRead = ib;
+                return StreamOutputNeeded;
+            }
+            if (!_fReset)
+            {
+                _engine.Reset();
+                _fReset = true;
+            }
+
+            size_t ibEnd = ib + 1;
+            size_t ibLimit = ib + (cbOutMax - *pcbWritten);
+            if (ibLimit > cbIn)
+                ibLimit = cbIn;
+            while (ibEnd < ibLimit && (uint8_t)pbIn[ibEnd] < 0x80 && _pTransliterator->KeyCode((uint8_t)pbIn[ibEnd]) == 0)
+                ibEnd++;
+
+            memcpy(pbOut + *pcbWritten, pbIn + ib, ibEnd - ib);
+            *pcbWritten += ibEnd - ib;
+            _cchHeld = 0;
+            _cchFinal = 0;
+            _ichWritten = 0;
+            ib = ibEnd;
+            continue;
+        }
+
+        if (_cbSequence == 0)
+        {
+            // Lead byte of a multi-byte sequence
+            ib++;
+            if (b >= 0xC2 && b <= 0xDF)
+            {
+                _cbSequenceNeeded = 2;
+                _cpSequence = b & 0x1F;
+            }
+            else if (b >= 0xE0 && b <= 0xEF)
+            {
+                _cbSequenceNeeded = 3;
+                _cpSequence = b & 0x0F;
+            }
+            else if (b >= 0xF0 && b <= 0xF4)
+            {
+                _cbSequenceNeeded = 4;
+                _cpSequence = b & 0x07;
+            }
+            else
+            {
+                _Step(0xFFFD);
+                continue;
+            }
+            _cbSequence = 1;
+            continue;
+        }
+
+        if ((b & 0xC0) != 0x80)
+        {
+            // Cut short: the partial sequence is one U+FFFD, and this byte
+            // starts afresh on the next pass
+            _cbSequence = 0;
+            _Step(0xFFFD);
+            continue;
+        }
+
+        ib++;
+        _cpSequence = (_cpSequence << 6) | (b & 0x3F);
+        if (++_cbSequence < _cbSequenceNeeded)
+            continue;
+
+        // Overlong forms, surrogates and anything past U+10FFFF are malformed
+        uint32_t cp = _cpSequence;
+        bool fValid = (_cbSequenceNeeded == 2) ||
+            (_cbSequenceNeeded == 3 && cp >= 0x800 && (cp < 0xD800 || cp >= 0xE000)) ||
+            (_cbSequenceNeeded == 4 && cp >= 0x10000 && cp <= 0x10FFFF);
+        _cbSequence = 0;
+        _Step(fValid ? cp : 0xFFFD);
+    }
+
+    *pcbRead = ib;
+    return StreamDone;
+}
+
+StreamResult TransliteratorStream::Finish(char* pbOut, size_t cbOutMax, size_t* pcbWritten)
+{
+    *pcbWritten = 0;
+    if (!_Write(pbOut, cbOutMax, pcbWritten))
+        return StreamOutputNeeded;
+
+    if (_cbSequence > 0)
+    {
+        _cbSequence = 0;
+        _Step(0xFFFD);
+    }
+
+    // Nothing can rewrite the open syllable now
+    if (!_fReset)
+    {
+        _engine.Reset();
+        _fReset = true;
+    }
+    _cchFinal = _cchHeld;
+
+    if (!_Write(pbOut, cbOutMax, pcbWritten))
+        return StreamOutputNeeded;
+
+    Reset();
+    return StreamDone;
+}
+
+// Encodes the final units not yet written. False when pbOut is full first.
+bool TransliteratorStream::_Write(char* pbOut, size_t cbOutMax, size_t* pcbWritten)
+{
+    while (_ichWritten < _cchFinal)
+    {
+        uint32_t cp = _held[_ichWritten];
+        size_t cch = 1;
+        if (cp >= 0xD800 && cp < 0xDC00 && _ichWritten + 1 < _cchFinal &&
+            _held[_ichWritten + 1] >= 0xDC00 && _held[_ichWritten + 1] < 0xE000)
+        {
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (_held[_ichWritten + 1] - 0xDC00);
+            cch = 2;
+        }
+        else if (cp >= 0xD800 && cp < 0xE000)
+        {
+            cp = 0xFFFD;
+        }
+
+        size_t cb = (cp < 0x80) ? 1 : (cp < 0x800) ? 2 : (cp < 0x10000) ? 3 : 4;
+        if (cbOutMax - *pcbWritten < cb)
+            return false;
+
+        char* pb = pbOut + *pcbWritten;
+        if (cb == 1)
+        {
+            pb[0] = (char)cp;
+        }
+        else if (cb == 2)
+        {
+            pb[0] = (char)(0xC0 | (cp >> 6));
+            pb[1] = (char)(0x80 | (cp & 0x3F));
+        }
+        else if (cb == 3)
+        {
+            pb[0] = (char)(0xE0 | (cp >> 12));
+            pb[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+            pb[2] = (char)(0x80 | (cp & 0x3F));
+        }
+        else
+        {
+            pb[0] = (char)(0xF0 | (cp >> 18));
+            pb[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+            pb[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+            pb[3] = (char)(0x80 | (cp & 0x3F));
+        }
+        *pcbWritten += cb;
+        _ichWritten += cch;
+    }
+    return true;
+}
+
+// One character through the engine, as Transliterator::Convert does. Called
+// only when every final unit has been written.
+void TransliteratorStream::_Step(uint32_t cp)
+{
+    if (_cchFinal > 0)
+    {
+        memmove(_held, _held + _cchFinal, (_cchHeld - _cchFinal) * sizeof(char16_t));
+        _cchHeld -= _cchFinal;
+        _cchFinal = 0;
+        _ichWritten = 0;
+    }
+
+    char16_t code = _pTransliterator->KeyCode((char16_t)((cp < 0x80) ? cp : 0));
+    if (code == 0)
+    {
+        if (!_fReset)
+        {
+            _engine.Reset();
+            _fReset = true;
+        }
+
+        if (cp >= 0x10000)
+        {
+            _held[_cchHeld++] = (char16_t)(0xD800 + ((cp - 0x10000) >> 10));
+            _held[_cchHeld++] = (char16_t)(0xDC00 + ((cp - 0x10000) & 0x3FF));
+        }
+        else
+        {
+            _held[_cchHeld++] = (char16_t)cp;
+        }
+        _cchFinal = _cchHeld;
+        return;
+    }
+
+    EngineOutput output;
+    _fReset = false;
+    if (!_engine.ProcessKey(code, &output))
+    {
+        output.Clear();
+        output.Append((char16_t)cp);
+    }
+
+    _cchHeld -= (output.cchDelete < _cchHeld) ? output.cchDelete : _cchHeld;
+    memcpy(_held + _cchHeld, output.text, output.cchText * sizeof(char16_t));
+    _cchHeld += output.cchText;
+
+    // Everything before the open syllable is final. Engines keep a few
+    // units open at most; the cap only guards the buffer.
+    size_t cchOpen = _engine.ComposingLength();
+    if (cchOpen > c_streamHeldMax - c_engineMaxOutput - 2)
+        cchOpen = c_streamHeldMax - c_engineMaxOutput - 2;
+    _cchFinal = (cchOpen < _cchHeld) ? _cchHeld - cchOpen : 0;
+}
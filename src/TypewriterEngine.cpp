@@ -0,0 +1,83 @@
+﻿// TypewriterEngine.cpp
+// Visual-to-logical reordering for glyph-order layouts - see TypewriterEngine.h
+
+#include "../include/TypewriterEngine.h"
+
+static const char16_t c_signE = 0x0BC6;     // ெ
+static const char16_t c_signEE = 0x0BC7;    // ே
+static const char16_t c_signAI = 0x0BC8;    // ை
+static const char16_t c_signAA = 0x0BBE;    // ா
+
+static inline bool IsPrefixSign(char16_t ch)
+{
+    return ch == c_signE || ch == c_signEE || ch == c_signAI;
+}
+
+bool TypewriterEngine::ProcessKey(const char16_t* pchKey, size_t cchKey, EngineOutput* pOutput)
+{
+    pOutput->Clear();
+
+    if (cchKey == 0)
+        return false;
+
+    char16_t ch = pchKey[0];
+    char16_t lastSign = _lastSign;
+    _lastSign = 0;
+
+    if (cchKey == 1 && IsPrefixSign(ch))
+    {
+        // A second prefix in a row: the first one had no consonant
+        if (_prefixSign)
+            pOutput->Append(_prefixSign);
+        _prefixSign = ch;
+        return true;
+    }
+
+    if (cchKey == 1 && lastSign)
+    {
+        if (ch == c_signAA)
+        {
+            pOutput->cchDelete = 1;
+            pOutput->Append(lastSign == c_signE ? (char16_t)0x0BCA : (char16_t)0x0BCB);    // ொ ோ
+            return true;
+        }
+        if (ch == c_tamilAuLength && lastSign == c_signE)
+        {
+            pOutput->cchDelete = 1;
+            pOutput->Append(0x0BCC);    // ௌ
+            return true;
+        }
+    }
+
+    // The prefix attaches to a key ending in a bare consonant (க, க்ஷ)
+    if (_prefixSign && GetTamilCharInfo(pchKey[cchKey - 1]).charClass == TamilClassConsonant)
+    {
+        pOutput->Append(pchKey, cchKey);
+        pOutput->Append(_prefixSign);
+        if (_prefixSign != c_signAI)
+            _lastSign = _prefixSign;
+        _prefixSign = 0;
+        return true;
+    }
+
+    if (_prefixSign)
+    {
+        pOutput->Append(_prefixSign);
+        _prefixSign = 0;
+    }
+
+    pOutput->Append(pchKey, cchKey);
+    return true;
+}
+
+void TypewriterEngine::Resume(const char16_t* pchBefore, size_t cchBefore)
+{
+    Reset();
+
+    if (cchBefore >= 2 &&
+        (pchBefore[cchBefore - 1] == c_signE || pchBefore[cchBefore - 1] == c_signEE) &&
+        GetTamilCharInfo(pchBefore[cchBefore - 2]).charClass == TamilClassConsonant)
+    {
+        _lastSign = pchBefore[cchBefore - 1];
+    }
+}
@@ -0,0 +1,259 @@
+// AllocCheck.cpp
+// Checks that typing does not touch the heap. A counting global operator
+// new (every form, aligned and nothrow included) watches the portable part
+// of the key path while generated input is typed on every layout, with a
+// layout switch every few thousand keys:
+//   - ModifierTracker for Shift, the key tables and KeyboardEngine;
+//   - WordCompletion, fed with every key's output;
+//   - PendingOutputQueue, with the edit sessions run every few keys: Take,
+//     CompositionBuffer, SurroundingText and its OnEndEdit, Complete;
+//   - LatencyScope and LatencyStats::Record for every stage, Dump at the end;
+//   - the trace points, with tracing on and the collector writing a file.
+// The first pass over every layout is warm-up (the calling thread's trace
+// ring is allocated then, and the collector thread started); any
+// allocation after it fails the check.
+//
+// Build:  cl /std:c++17 /EHsc /O2 tools\AllocCheck.cpp src\KeyboardEngine.cpp src\Tamil99Engine.cpp src\TypewriterEngine.cpp src\PhoneticEngine.cpp src\LayoutRegistry.cpp src\KeyMap*.cpp src\EngineImage.cpp src\EngineImageData.cpp src\Dictionary.cpp src\LatencyHistogram.cpp src\TraceRing.cpp
+//    or:  g++ -std=c++17 -O2 -pthread tools/AllocCheck.cpp src/KeyboardEngine.cpp src/Tamil99Engine.cpp src/TypewriterEngine.cpp src/PhoneticEngine.cpp src/LayoutRegistry.cpp src/KeyMap*.cpp src/EngineImage.cpp src/EngineImageData.cpp src/Dictionary.cpp src/LatencyHistogram.cpp src/TraceRing.cpp -o AllocCheck
+// Run:    AllocCheck [keys]
+
+#include "../include/Completion.h"
+#include "../include/CompositionBuffer.h"
+#include "../include/KeyboardEngine.h"
+#include "../include/LatencyHistogram.h"
+#include "../include/ModifierTracker.h"
+#include "../include/PendingOutput.h"
+#include "../include/SurroundingText.h"
+#include "../include/TraceRing.h"
+#include "BenchUtil.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <string>
+
+static const size_t c_defaultKeys = 1000000;
+static const size_t c_warmUpKeys = 10000;
+static const size_t c_keysPerSession = 3;
+static const size_t c_keysPerLayoutSwitch = 5000;
+static const intptr_t c_lParamLShift = 0x2A << 16;
+
+// Every operator new in the process, the collector thread's included
+static std::atomic<size_t> s_cAllocations(0);
+
+static void* CountedAlloc(size_t cb)
+{
+    s_cAllocations.fetch_add(1, std::memory_order_relaxed);
+    return malloc(cb ? cb : 1);
+}
+
+static void* CountedAlignedAlloc(size_t cb, std::align_val_t alignment)
+{
+    s_cAllocations.fetch_add(1, std::memory_order_relaxed);
+    size_t cbAlign = (size_t)alignment;
+#ifdef _WIN32
+    return _aligned_malloc(cb ? cb : 1, cbAlign);
+#else
+    void* p = nullptr;
+    return (posix_memalign(&p, cbAlign < sizeof(void*) ? sizeof(void*) : cbAlign, cb ? cb : 1) == 0) ? p : nullptr;
+#endif
+}
+
+static void AlignedFree(void* p)
+{
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+void* operator new(size_t cb)
+{
+    void* p = CountedAlloc(cb);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t cb) { return operator new(cb); }
+void* operator new(size_t cb, const std::nothrow_t&) noexcept { return CountedAlloc(cb); }
+void* operator new[](size_t cb, const std::nothrow_t&) noexcept { return CountedAlloc(cb); }
+
+void* operator new(size_t cb, std::align_val_t alignment)
+{
+    void* p = CountedAlignedAlloc(cb, alignment);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t cb, std::align_val_t alignment) { return operator new(cb, alignment); }
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { AlignedFree(p); }
+
+// The portable state one text service keeps for the key path
+struct KeyPath
+{
+    ModifierTracker modifiers;
+    KeyboardEngine engine;
+    WordCompletion completion;
+    PendingOutputQueue pending;
+    CompositionBuffer composition;
+    SurroundingText surrounding;
+    uint32_t sessions[c_pendingBatchCount];
+    size_t cSessions = 0;
+    size_t cchDocument = 0;
+
+    // DoEditSession for every requested session, then their OnEndEdit
+    void RunSessions()
+    {
+        for (size_t i = 0; i < cSessions; i++)
+        {
+            uint64_t startNs = LatencyNow();
+            PendingBatch* pBatch = pending.Take(sessions[i]);
+            if (!pBatch)
+                continue;
+            ANJAL_TRACE(TraceEditSessionBegin, pBatch->cchDelete, pBatch->cchText, pBatch->keyCount);
+
+            CompositionUpdate update;
+            composition.Apply(pBatch->cchDelete, pBatch->text, pBatch->cchText, pBatch->cchComposing, &update);
+            composition.Commit();
+            cchDocument += update.cchText;
+            surrounding.Apply(this, pBatch->cchDelete, pBatch->text, pBatch->cchText);
+
+            uint64_t endNs = LatencyNow();
+            g_latencyStats.Record(LatencyEditSession, startNs, endNs);
+            g_latencyStats.Record(LatencyKeyToText, pBatch->keyDownNs, endNs);
+            ANJAL_TRACE(TraceEditSessionEnd, 0);
+            pending.Complete(sessions[i]);
+            surrounding.OnEndEdit(this);
+        }
+        cSessions = 0;
+    }
+
+    // OnKeyDown for one character of the input
+    void Key(char ch)
+    {
+        LatencyScope keyDownScope(LatencyKeyDown);
+        ANJAL_TRACE(TraceKeyDown, (uint8_t)ch, 0);
+
+        uint8_t vk;
+        KeyLayer layer;
+        if (!UsKeyForAscii((char16_t)ch, &vk, &layer))
+        {
+            engine.Reset();
+            composition.Clear();
+            completion.Reset();
+            ANJAL_TRACE(TraceKeyReset, (uint8_t)ch);
+            return;
+        }
+
+        bool fShift = (layer == KeyLayerShift);
+        if (fShift)
+            modifiers.OnKeyDown(c_vkShift, c_lParamLShift);
+        modifiers.OnKeyDown(vk, 1);
+
+        EngineOutput output;
+        char16_t code = modifiers.Layer(&layer) ? engine.MapKey(layer, vk) : 0;
+        if (code != 0)
+        {
+            LatencyScope mappingScope(LatencyMapping);
+            ANJAL_TRACE(TraceKeyMapped, code);
+            if (engine.ProcessKey(code, &output))
+            {
+                ANJAL_TRACE(TraceEngineOutput, output.cchDelete, output.cchText, output.text[0]);
+                completion.Apply(output.cchDelete, output.text, output.cchText);
+
+                uint32_t serial;
+                if (pending.Append(this, output.cchDelete, output.text, output.cchText, engine.ComposingLength(),
+                    keyDownScope.StartNs(), &serial) == PendingNewBatch)
+                {
+                    sessions[cSessions++] = serial;
+                    ANJAL_TRACE(TraceEditSessionRequest, 0, 0);
+                }
+            }
+        }
+
+        modifiers.OnKeyUp(vk, 1);
+        if (fShift)
+            modifiers.OnKeyUp(c_vkShift, c_lParamLShift);
+    }
+};
+
+// Types keys[layout] on every layout in turn, keys at a time. Returns the
+// allocations made meanwhile.
+static size_t Type(KeyPath* pPath, const std::string (&keys)[LayoutCount], size_t cKeys)
+{
+    size_t cBefore = s_cAllocations.load();
+    for (size_t l = 0; l < LayoutCount; l++)
+    {
+        const std::string& input = keys[l];
+        for (size_t i = 0; i < cKeys; i++)
+        {
+            if (i % c_keysPerLayoutSwitch == 0)
+            {
+                pPath->RunSessions();
+                pPath->engine.SetLayout(&g_layouts[l]);
+                pPath->composition.Clear();
+                ANJAL_TRACE(TraceLayoutSwitch, l);
+            }
+
+            pPath->Key(input[i % input.size()]);
+            if (pPath->cSessions == c_pendingBatchCount || i % c_keysPerSession == c_keysPerSession - 1)
+                pPath->RunSessions();
+        }
+        pPath->RunSessions();
+    }
+    return s_cAllocations.load() - cBefore;
+}
+
+int main(int argc, char** argv)
+{
+    size_t cKeys = (argc > 1) ? strtoul(argv[1], NULL, 10) : c_defaultKeys;
+    if (cKeys == 0)
+    {
+        fprintf(stderr, "usage: AllocCheck [keys]\n");
+        return 2;
+    }
+
+    // Everything allocated up front: input, the trace file and collector
+    std::string keys[LayoutCount];
+    for (size_t l = 0; l < LayoutCount; l++)
+        keys[l] = MakeKeys((LayoutId)l, cKeys);
+
+    std::string tracePath = (std::filesystem::temp_directory_path() / "AllocCheck.trace").string();
+    FILE* pTraceFile = fopen(tracePath.c_str(), "wb");
+    if (!pTraceFile || !TraceStart(pTraceFile))
+    {
+        fprintf(stderr, "AllocCheck: cannot trace to %s\n", tracePath.c_str());
+        return 2;
+    }
+
+    static KeyPath s_path;
+    size_t cWarmUp = Type(&s_path, keys, c_warmUpKeys);
+    size_t cTyping = Type(&s_path, keys, cKeys);
+
+    char dump[4096];
+    size_t cBefore = s_cAllocations.load();
+    size_t cchDump = g_latencyStats.Dump(dump, sizeof(dump));
+    size_t cDump = s_cAllocations.load() - cBefore;
+
+    TraceStop();
+    std::filesystem::remove(tracePath);
+
+    printf("warm-up      %zu keys per layout, %zu allocations\n", c_warmUpKeys, cWarmUp);
+    printf("typing       %zu keys per layout, %zu allocations (%zu units written, %zu-byte stats dump)\n", cKeys, cTyping,
+        s_path.cchDocument, cchDump);
+    printf("stats dump   %zu allocations\n", cDump);
+    return (cTyping || cDump) ? 1 : 0;
+}
@@ -0,0 +1,195 @@
+﻿// BenchUtil.h
+// What the checks and benchmarks in tools/ share: the deterministic random
+// source, UTF-8 conversion, word lists read from a file or generated, and
+// generated key input for the layouts. Offline tools only - uses the
+// standard library freely; nothing here is linked into the DLL. Everything
+// is inline, so a tool links only what it calls.
+
+#pragma once
+
+#include "../include/KeyboardEngine.h"
+#include "../include/TamilScript.h"
+#include "DictionaryBuilder.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// xorshift64 from a fixed seed: every run sees the same sequence, so runs
+// are comparable. SeedRandom starts the sequence over.
+inline uint64_t s_random = 0x9E3779B97F4A7C15ull;
+
+inline void SeedRandom()
+{
+    s_random = 0x9E3779B97F4A7C15ull;
+}
+
+inline uint64_t NextRandom64()
+{
+    s_random ^= s_random << 13;
+    s_random ^= s_random >> 7;
+    s_random ^= s_random << 17;
+    return s_random;
+}
+
+inline uint32_t NextRandom()
+{
+    return (uint32_t)NextRandom64();
+}
+
+// Well-formed UTF-8 only; a truncated sequence at the end is cut short
+inline std::u16string ToUtf16(const std::string& in)
+{
+    std::u16string text;
+    for (size_t i = 0; i < in.size(); )
+    {
+        uint8_t b = (uint8_t)in[i];
+        size_t cb = (b < 0x80) ? 1 : (b < 0xE0) ? 2 : (b < 0xF0) ? 3 : 4;
+        uint32_t cp = (cb == 1) ? b : (cb == 2) ? (b & 0x1F) : (cb == 3) ? (b & 0x0F) : (b & 0x07);
+        for (size_t j = 1; j < cb && i + j < in.size(); j++)
+            cp = (cp << 6) | (in[i + j] & 0x3F);
+        if (cp >= 0x10000)
+        {
+            text.push_back((char16_t)(0xD800 + ((cp - 0x10000) >> 10)));
+            text.push_back((char16_t)(0xDC00 + ((cp - 0x10000) & 0x3FF)));
+        }
+        else
+        {
+            text.push_back((char16_t)cp);
+        }
+        i += cb;
+    }
+    return text;
+}
+
+// Well-formed UTF-16 only: surrogates come in pairs
+inline std::string ToUtf8(const std::u16string& text)
+{
+    std::string out;
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        uint32_t cp = text[i];
+        if (cp >= 0xD800 && cp < 0xDC00 && i + 1 < text.size())
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (text[++i] - 0xDC00);
+        if (cp < 0x80)
+        {
+            out.push_back((char)cp);
+        }
+        else if (cp < 0x800)
+        {
+            out.push_back((char)(0xC0 | (cp >> 6)));
+            out.push_back((char)(0x80 | (cp & 0x3F)));
+        }
+        else if (cp < 0x10000)
+        {
+            out.push_back((char)(0xE0 | (cp >> 12)));
+            out.push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back((char)(0x80 | (cp & 0x3F)));
+        }
+        else
+        {
+            out.push_back((char)(0xF0 | (cp >> 18)));
+            out.push_back((char)(0x80 | ((cp >> 12) & 0x3F)));
+            out.push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back((char)(0x80 | (cp & 0x3F)));
+        }
+    }
+    return out;
+}
+
+// The non-ASCII words of a word list (word<TAB>frequency) or of plain text,
+// in file order; '#' lines are comments
+inline std::vector<std::string> ReadWords(const char* path)
+{
+    std::vector<std::string> words;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+        size_t ib = 0;
+        while (ib < line.size())
+        {
+            size_t ibEnd = line.find_first_of(" \t\r", ib);
+            if (ibEnd == std::string::npos)
+                ibEnd = line.size();
+            if (ibEnd > ib && (uint8_t)line[ib] >= 0x80)
+                words.push_back(line.substr(ib, ibEnd - ib));
+            ib = ibEnd + 1;
+        }
+    }
+    return words;
+}
+
+// Words of 2-8 syllables: a vowel or uyirmei first, then uyirmei, with a
+// pulli ending now and then. Frequencies fall off roughly as 1/rank. With
+// pBreaks, each word's syllable boundaries are kept as well, for typing it.
+inline void MakeSyntheticWords(size_t cWords, std::vector<DictionaryWord>* pWords,
+    std::vector<std::vector<size_t>>* pBreaks = nullptr)
+{
+    while (pWords->size() < cWords)
+    {
+        DictionaryWord word;
+        std::vector<size_t> breaks;
+        size_t cSyllables = 2 + NextRandom() % 7;
+        for (size_t i = 0; i < cSyllables; i++)
+        {
+            if (i == 0 && NextRandom() % 8 == 0)
+            {
+                word.text += c_tamilVowels[NextRandom() % c_tamilVowelCount];
+            }
+            else
+            {
+                const TamilSyllable& syllable = c_tamilSyllables.cell[NextRandom() % c_tamilConsonantCount][NextRandom() % c_tamilVowelCount];
+                word.text.append(syllable.text, syllable.cch);
+            }
+            breaks.push_back(word.text.size());
+        }
+        if (NextRandom() % 4 == 0)
+        {
+            word.text += c_tamilConsonants[NextRandom() % c_tamilConsonantCount];
+            word.text += c_tamilPulli;
+            breaks.push_back(word.text.size());
+        }
+        if (!IsDictionaryWord(word.text))
+            continue;
+
+        word.frequency = (uint32_t)(1000000 / (pWords->size() + 1)) + 1;
+        pWords->push_back(word);
+        if (pBreaks)
+            pBreaks->push_back(breaks);
+    }
+}
+
+// Generated keys for a layout: words in romanized form for the phonetic
+// layouts, random letter and punctuation keys for the others, one space
+// between words
+inline std::string MakeKeys(LayoutId layout, size_t cKeys)
+{
+    static const char* const c_syllables[] =
+    {
+        "ka", "ngaa", "si", "nji", "du", "NNuu", "the", "nee", "pai", "mo", "yoo", "rau", "la", "vaa", "zhi", "LL", "Ru", "n", "m"
+    };
+    static const char c_keys[] = "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzQWERTYUIOPASDFGHJKL;',./[]";
+
+    std::string keys;
+    keys.reserve(cKeys + 16);
+    while (keys.size() < cKeys)
+    {
+        if (g_layouts[layout].engine == LayoutEnginePhonetic)
+        {
+            for (size_t i = 1 + NextRandom() % 4; i > 0; i--)
+                keys.append(c_syllables[NextRandom() % (sizeof(c_syllables) / sizeof(c_syllables[0]))]);
+        }
+        else
+        {
+            for (size_t i = 2 + NextRandom() % 6; i > 0; i--)
+                keys.push_back(c_keys[NextRandom() % (sizeof(c_keys) - 1)]);
+        }
+        keys.push_back(' ');
+    }
+    keys.resize(cKeys);
+    return keys;
+}
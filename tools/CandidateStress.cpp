@@ -0,0 +1,223 @@
+﻿// CandidateStress.cpp
+// Stress test for the candidate worker (see include/CandidateWorker.h).
+// The main thread plays the UI thread: it types synthetic Tamil words a
+// syllable at a time, posting every prefix, cancelling now and then, and
+// stopping and restarting the worker every few thousand keys. It calls
+// Receive only when the ready callback has fired - as the text service does
+// - so a lost callback shows up as a word that never gets its completions.
+//
+// Checks that every result Receive returns is for the current generation
+// and matches a synchronous CandidateRanker for the prefix posted with it,
+// and that the last prefix of every word is answered within a second.
+// Reports the Post latency on the UI thread and the worker's counters.
+//
+// Build:  cl /std:c++17 /EHsc /O2 tools\CandidateStress.cpp src\CandidateWorker.cpp src\CandidateRanker.cpp src\Dictionary.cpp src\LatencyHistogram.cpp
+//    or:  g++ -std=c++17 -O2 -pthread tools/CandidateStress.cpp src/CandidateWorker.cpp src/CandidateRanker.cpp src/Dictionary.cpp src/LatencyHistogram.cpp -o CandidateStress
+//         (add -fsanitize=thread -g to check the hand-off for data races)
+// Run:    CandidateStress [keys]
+
+#include "DictionaryBuilder.h"
+#include "BenchUtil.h"
+#include "../include/CandidateWorker.h"
+#include "../include/LatencyHistogram.h"
+#include "../include/TamilScript.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+static const size_t c_syntheticWords = 200000;
+static const size_t c_defaultKeys = 1000000;
+static const size_t c_keysPerRestart = 20000;
+
+// Set by the worker thread; the main thread's "message loop" polls it
+static std::atomic<bool> s_fReady(false);
+static std::atomic<uint64_t> s_cCallbacks(0);
+
+static void OnReady(void*)
+{
+    s_cCallbacks.fetch_add(1, std::memory_order_relaxed);
+    s_fReady.store(true, std::memory_order_release);
+}
+
+// Same frequencies in the same order, and every text starts with the prefix.
+// Equal frequencies may come out in either order.
+static bool SameCandidates(const CandidateList& list, const CandidateList& expected, const char16_t* pchPrefix, size_t cchPrefix)
+{
+    if (list.cCandidates != expected.cCandidates)
+        return false;
+
+    for (size_t i = 0; i < list.cCandidates; i++)
+    {
+        if (list.candidates[i].frequency != expected.candidates[i].frequency ||
+            list.candidates[i].cchWord < cchPrefix)
+            return false;
+
+        const char16_t* pch = list.Text(i);
+        for (size_t ich = 0; ich < cchPrefix; ich++)
+        {
+            if (pch[ich] != pchPrefix[ich])
+                return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    size_t cKeys = (argc > 1) ? strtoul(argv[1], NULL, 10) : c_defaultKeys;
+    if (cKeys == 0)
+    {
+        fprintf(stderr, "usage: CandidateStress [keys]\n");
+        return 1;
+    }
+
+    std::vector<DictionaryWord> words;
+    std::vector<std::vector<size_t>> breaks;
+    MakeSyntheticWords(c_syntheticWords, &words, &breaks);
+
+    DictionaryBuilder builder;
+    std::vector<uint8_t> blob = builder.Build(words);
+    std::vector<uint32_t> image((blob.size() + 3) / 4);
+    memcpy(image.data(), blob.data(), blob.size());
+
+    Dictionary dictionary;
+    if (!dictionary.Attach(image.data(), image.size() * sizeof(uint32_t)))
+    {
+        fprintf(stderr, "CandidateStress: no usable words\n");
+        return 1;
+    }
+
+    CandidateWorker worker;
+    if (!worker.Start(&dictionary, OnReady, NULL))
+    {
+        fprintf(stderr, "CandidateStress: worker did not start\n");
+        return 1;
+    }
+
+    CandidateRanker reference;
+    CandidateList expected;
+    CandidateResult result;
+    LatencyHistogram postLatency;
+
+    // What the current generation asked for
+    const char16_t* pchPosted = NULL;
+    size_t cchPosted = 0;
+    uint32_t postedGeneration = 0;
+    bool fAnswered = true;
+
+    size_t cReceived = 0;
+    size_t cMismatches = 0;
+    size_t cWrongGeneration = 0;
+    size_t cUnanswered = 0;
+    size_t cRestarts = 0;
+    size_t cWords = 0;
+
+    // Receive, as the window procedure would
+    auto Pump = [&]()
+    {
+        if (!s_fReady.exchange(false, std::memory_order_acquire))
+            return;
+        if (!worker.Receive(&result))
+            return;
+
+        cReceived++;
+        if (result.generation != worker.Generation() || result.generation != postedGeneration)
+        {
+            cWrongGeneration++;
+            return;
+        }
+
+        reference.Rank(dictionary, pchPosted, cchPosted);
+        reference.GetList(&expected);
+        if (!SameCandidates(result.list, expected, pchPosted, cchPosted))
+            cMismatches++;
+        fAnswered = true;
+    };
+
+    size_t iKey = 0;
+    while (iKey < cKeys)
+    {
+        const DictionaryWord& word = words[NextRandom() % words.size()];
+        const std::vector<size_t>& wordBreaks = breaks[&word - words.data()];
+        cWords++;
+
+        for (size_t iBreak = 0; iBreak < wordBreaks.size() && iKey < cKeys; iBreak++, iKey++)
+        {
+            uint32_t action = NextRandom() % 16;
+            if (action == 0)
+            {
+                // A key that changes the word without a request
+                worker.Cancel();
+                fAnswered = true;
+            }
+            else
+            {
+                uint64_t startNs = LatencyNow();
+                postedGeneration = worker.Post(word.text.data(), wordBreaks[iBreak]);
+                postLatency.Record(LatencyNow() - startNs);
+                pchPosted = word.text.data();
+                cchPosted = wordBreaks[iBreak];
+                fAnswered = false;
+            }
+
+            // Typing speed varies from a burst to a pause long enough for
+            // the worker to answer
+            uint32_t cSpin = NextRandom() % 2048;
+            for (uint32_t i = 0; i < cSpin; i++)
+            {
+                if (i % 256 == 0)
+                    Pump();
+            }
+            if (NextRandom() % 64 == 0)
+                std::this_thread::sleep_for(std::chrono::microseconds(NextRandom() % 200));
+            Pump();
+
+            if (iKey > 0 && iKey % c_keysPerRestart == 0)
+            {
+                worker.Stop();
+                if (!worker.Start(&dictionary, OnReady, NULL))
+                {
+                    fprintf(stderr, "CandidateStress: worker did not restart\n");
+                    return 1;
+                }
+                cRestarts++;
+                fAnswered = true;
+            }
+        }
+
+        // The word is finished; its last request must be answered
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (!fAnswered && std::chrono::steady_clock::now() < deadline)
+        {
+            Pump();
+            std::this_thread::yield();
+        }
+        if (!fAnswered)
+        {
+            cUnanswered++;
+            fAnswered = true;
+        }
+    }
+
+    CandidateWorkerStats stats = worker.Stats();
+    worker.Stop();
+
+    printf("keys       %zu in %zu words, %zu restarts\n", iKey, cWords, cRestarts);
+    printf("post       mean=%.3fus p50=%.3fus p99=%.3fus p999=%.3fus max=%.3fus\n",
+        postLatency.Mean() / 1000.0,
+        postLatency.Percentile(0.50) / 1000.0,
+        postLatency.Percentile(0.99) / 1000.0,
+        postLatency.Percentile(0.999) / 1000.0,
+        postLatency.Max() / 1000.0);
+    printf("worker     posted=%llu held=%llu skipped=%llu ranked=%llu stale=%llu\n",
+        (unsigned long long)stats.posted, (unsigned long long)stats.held, (unsigned long long)stats.skipped,
+        (unsigned long long)stats.ranked, (unsigned long long)stats.stale);
+    printf("callbacks  %llu, %zu results received\n", (unsigned long long)s_cCallbacks.load(), cReceived);
+    printf("wrong generation %zu, mismatches %zu, unanswered %zu\n", cWrongGeneration, cMismatches, cUnanswered);
+
+    return (cWrongGeneration || cMismatches || cUnanswered) ? 1 : 0;
+}
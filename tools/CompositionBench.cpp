@@ -0,0 +1,276 @@
+// CompositionBench.cpp
+// Document reads per 1,000 keys with the composition buffer (see
+// include/CompositionBuffer.h), against a mock ITfContext that counts what
+// an edit session does to it: GetText calls (the cross-process reads),
+// SetText calls and sessions. Generated input is typed on every layout
+// through KeyboardEngine and PendingOutputQueue, and the context runs the
+// sessions queued for it every N keys, as a busy application does.
+//
+// Each run is done twice. The read-back path is what DoEditSession would
+// need without the buffer: to rewrite a syllable it reads the text it
+// replaces from the document, then writes the new text. The composition
+// path keeps the open syllable in a composition range mirrored by
+// CompositionBuffer and replaces the whole range with one SetText, with
+// no read. Both must leave the document as applying each key's output on
+// its own does, and no key may delete more than the engine's previous
+// ComposingLength - what makes the buffer enough.
+//
+// Build:  cl /std:c++17 /EHsc /O2 tools\CompositionBench.cpp src\KeyboardEngine.cpp src\Tamil99Engine.cpp src\TypewriterEngine.cpp src\PhoneticEngine.cpp src\LayoutRegistry.cpp src\KeyMap*.cpp src\EngineImage.cpp src\EngineImageData.cpp src\Dictionary.cpp
+//    or:  g++ -std=c++17 -O2 tools/CompositionBench.cpp src/KeyboardEngine.cpp src/Tamil99Engine.cpp src/TypewriterEngine.cpp src/PhoneticEngine.cpp src/LayoutRegistry.cpp src/KeyMap*.cpp src/EngineImage.cpp src/EngineImageData.cpp src/Dictionary.cpp -o CompositionBench
+// Run:    CompositionBench [keys]
+
+#include "../include/CompositionBuffer.h"
+#include "../include/KeyboardEngine.h"
+#include "../include/PendingOutput.h"
+#include "BenchUtil.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+static const size_t c_defaultKeys = 1000000;
+static const size_t c_sessionDelays[] = { 1, 2, 4, 8 };
+static const char* const c_layoutNames[LayoutCount] = { "tamil99", "anjal", "typewriter", "bamini" };
+
+// The document behind the mock ITfContext. The caret is always at the end;
+// the composition range, when there is one, runs from compositionStart to
+// the caret.
+struct MockContext
+{
+    std::u16string text;
+    size_t compositionStart = SIZE_MAX;
+    size_t cReads = 0;
+    size_t cchRead = 0;
+    size_t cSetText = 0;
+    size_t cSessions = 0;
+
+    // ITfRange::GetText over the cch units before the caret
+    std::u16string GetText(size_t cch)
+    {
+        cReads++;
+        cchRead += cch;
+        return text.substr(text.size() - cch);
+    }
+
+    // ITfRange::SetText over [ich, caret)
+    void SetText(size_t ich, const char16_t* pch, size_t cch)
+    {
+        cSetText++;
+        text.resize(ich);
+        text.append(pch, cch);
+    }
+};
+
+// One text service: engine, queue, the sessions it requested, and the
+// composition mirror when fComposition
+struct Service
+{
+    bool fComposition;
+    KeyboardEngine engine;
+    PendingOutputQueue pending;
+    CompositionBuffer composition;
+    MockContext context;
+    uint32_t sessions[c_pendingBatchCount];
+    size_t cSessions = 0;
+    size_t cchComposingQueued = 0;
+    size_t cFailures = 0;
+
+    void RunSessions()
+    {
+        for (size_t i = 0; i < cSessions; i++)
+        {
+            PendingBatch* pBatch = pending.Take(sessions[i]);
+            if (!pBatch)
+                continue;
+            context.cSessions++;
+
+            if (fComposition && (pBatch->cchComposing > 0 || context.compositionStart != SIZE_MAX))
+                _UpdateComposition(*pBatch);
+            else if (pBatch->cchDelete > 0 || pBatch->cchText > 0)
+                _Insert(*pBatch);
+            pending.Complete(sessions[i]);
+        }
+        cSessions = 0;
+    }
+
+    void Queue(size_t cchDelete, const char16_t* pch, size_t cch, size_t cchComposing)
+    {
+        uint32_t serial;
+        switch (pending.Append(&context, cchDelete, pch, cch, cchComposing, 0, &serial))
+        {
+        case PendingNewBatch:
+            sessions[cSessions++] = serial;
+            break;
+        case PendingFull:
+            cFailures++;
+            break;
+        case PendingMerged:
+            break;
+        }
+        cchComposingQueued = cchComposing;
+        if (cSessions == c_pendingBatchCount)
+            RunSessions();
+    }
+
+private:
+    // Insert at the selection. A rewrite reads what it replaces first,
+    // unless the composition has it.
+    void _Insert(const PendingBatch& batch)
+    {
+        size_t cchDelete = (batch.cchDelete < context.text.size()) ? batch.cchDelete : context.text.size();
+        if (cchDelete > 0 && !fComposition)
+            context.GetText(cchDelete);
+        context.SetText(context.text.size() - cchDelete, batch.text, batch.cchText);
+    }
+
+    // The whole composition range replaced from the mirror, no read
+    void _UpdateComposition(const PendingBatch& batch)
+    {
+        if (context.compositionStart == SIZE_MAX)
+            context.compositionStart = context.text.size();
+
+        CompositionUpdate update;
+        composition.Apply(batch.cchDelete, batch.text, batch.cchText, batch.cchComposing, &update);
+        if (update.cchDeleteBefore > context.compositionStart)
+        {
+            cFailures++;
+            update.cchDeleteBefore = (uint32_t)context.compositionStart;
+        }
+        context.compositionStart -= update.cchDeleteBefore;
+        if (batch.cchDelete > 0 || batch.cchText > 0)
+            context.SetText(context.compositionStart, update.text, update.cchText);
+
+        // The committed prefix leaves the composition
+        if (update.cchCommit == update.cchText)
+            context.compositionStart = SIZE_MAX;
+        else
+            context.compositionStart += update.cchCommit;
+        composition.Commit();
+
+        size_t cchRange = (context.compositionStart == SIZE_MAX) ? 0 : context.text.size() - context.compositionStart;
+        if (cchRange != composition.Length())
+            cFailures++;
+    }
+};
+
+// Types keys with sessions run every delay keys; the service keeps the
+// counters, and the document is checked against expected.
+static void Run(Service* pService, LayoutId layout, const std::string& keys, size_t delay, const std::u16string& expected)
+{
+    pService->engine.SetLayout(&g_layouts[layout]);
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        uint8_t vk;
+        KeyLayer layer;
+        char16_t code = UsKeyForAscii((char16_t)keys[i], &vk, &layer) ? pService->engine.MapKey(layer, vk) : 0;
+
+        size_t cchComposingBefore = pService->engine.ComposingLength();
+        EngineOutput output;
+        if (code != 0 && pService->engine.ProcessKey(code, &output))
+        {
+            if (output.cchDelete > cchComposingBefore)
+                pService->cFailures++;
+
+            size_t cchComposing = pService->engine.ComposingLength();
+            if (output.cchText > 0 || output.cchDelete > 0 || cchComposing != pService->cchComposingQueued)
+                pService->Queue(output.cchDelete, output.text, output.cchText, cchComposing);
+        }
+        else
+        {
+            // Not eaten: the syllable is committed, then the application
+            // inserts the key itself
+            pService->engine.Reset();
+            if (pService->cchComposingQueued > 0)
+                pService->Queue(0, nullptr, 0, 0);
+            pService->RunSessions();
+            pService->context.text.push_back((char16_t)keys[i]);
+        }
+
+        if (i % delay == delay - 1)
+            pService->RunSessions();
+    }
+    if (pService->cchComposingQueued > 0)
+        pService->Queue(0, nullptr, 0, 0);
+    pService->RunSessions();
+
+    if (pService->context.text != expected || pService->context.compositionStart != SIZE_MAX)
+        pService->cFailures++;
+}
+
+// The document when every key's output is applied on its own
+static std::u16string Expected(LayoutId layout, const std::string& keys)
+{
+    KeyboardEngine engine;
+    engine.SetLayout(&g_layouts[layout]);
+    std::u16string text;
+    for (char ch : keys)
+    {
+        uint8_t vk;
+        KeyLayer layer;
+        char16_t code = UsKeyForAscii((char16_t)ch, &vk, &layer) ? engine.MapKey(layer, vk) : 0;
+
+        EngineOutput output;
+        if (code != 0 && engine.ProcessKey(code, &output))
+        {
+            text.resize(text.size() - output.cchDelete);
+            text.append(output.text, output.cchText);
+        }
+        else
+        {
+            engine.Reset();
+            text.push_back((char16_t)ch);
+        }
+    }
+    return text;
+}
+
+int main(int argc, char** argv)
+{
+    size_t cKeys = (argc > 1) ? strtoul(argv[1], NULL, 10) : c_defaultKeys;
+    if (cKeys == 0)
+    {
+        fprintf(stderr, "usage: CompositionBench [keys]\n");
+        return 2;
+    }
+
+    size_t cFailures = 0;
+    printf("per 1000 keys          read-back: reads (units) SetText sessions   composition: reads SetText sessions\n");
+    for (size_t l = 0; l < LayoutCount; l++)
+    {
+        std::string keys = MakeKeys((LayoutId)l, cKeys);
+        std::u16string expected = Expected((LayoutId)l, keys);
+
+        for (size_t delay : c_sessionDelays)
+        {
+            static Service s_readBack;
+            static Service s_composition;
+            s_readBack = Service();
+            s_readBack.fComposition = false;
+            s_composition = Service();
+            s_composition.fComposition = true;
+
+            Run(&s_readBack, (LayoutId)l, keys, delay, expected);
+            Run(&s_composition, (LayoutId)l, keys, delay, expected);
+
+            for (const Service* pService : { &s_readBack, &s_composition })
+            {
+                if (pService->cFailures)
+                {
+                    fprintf(stderr, "%s, sessions every %zu keys, %s: %zu failures\n", c_layoutNames[l], delay,
+                        pService->fComposition ? "composition" : "read-back", pService->cFailures);
+                    cFailures += pService->cFailures;
+                }
+            }
+
+            double scale = 1000.0 / keys.size();
+            const MockContext& readBack = s_readBack.context;
+            const MockContext& composition = s_composition.context;
+            printf("%-10s every %zu   %9.0f (%5.0f) %7.0f %8.0f   %17.0f %7.0f %8.0f\n", c_layoutNames[l], delay,
+                readBack.cReads * scale, readBack.cchRead * scale, readBack.cSetText * scale, readBack.cSessions * scale,
+                composition.cReads * scale, composition.cSetText * scale, composition.cSessions * scale);
+        }
+    }
+
+    printf("failures     %zu\n", cFailures);
+    return cFailures ? 1 : 0;
+}
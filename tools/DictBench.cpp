@@ -0,0 +1,300 @@
+﻿// DictBench.cpp
+// Prefix lookup benchmark for the dictionary (see include/Dictionary.h).
+// Builds a blob from a word list - or, without one, from 500,000 synthetic
+// Tamil words, a few of them repeated - then times Complete() over random
+// prefixes and checks one in 16 against a plain scan of the sorted list.
+// Reports the latency percentiles, the blob size and the process's
+// resident memory. For a real list, see the README: the Tamil UI strings
+// of Chrome and of the gettext catalogs give about 22,000 words.
+//
+// Then replays typing sessions - words typed a syllable at a time, with a
+// syllable backspaced and retyped now and then - through CandidateRanker,
+// once incrementally and once from scratch at every step, and compares the
+// two latencies. Results are checked against a full sort by frequency.
+//
+// Build:  cl /std:c++17 /EHsc /O2 tools\DictBench.cpp src\Dictionary.cpp src\CandidateRanker.cpp src\LatencyHistogram.cpp
+//    or:  g++ -std=c++17 -O2 tools/DictBench.cpp src/Dictionary.cpp src/CandidateRanker.cpp src/LatencyHistogram.cpp -o DictBench
+// Run:    DictBench [word list] [lookups]
+
+#include "DictionaryBuilder.h"
+#include "../include/CandidateRanker.h"
+#include "../include/LatencyHistogram.h"
+#include "../include/TamilScript.h"
+#include "BenchUtil.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const size_t c_syntheticWords = 500000;
+static const size_t c_defaultLookups = 1000000;
+static const size_t c_matchesMax = 8;
+static const size_t c_sessionWords = 100000;
+
+// Resident set size in bytes, 0 where it cannot be read
+static size_t ResidentBytes()
+{
+    size_t cb = 0;
+#ifdef __linux__
+    FILE* pFile = fopen("/proc/self/status", "r");
+    if (pFile)
+    {
+        char achLine[256];
+        while (fgets(achLine, sizeof(achLine), pFile))
+        {
+            if (strncmp(achLine, "VmRSS:", 6) == 0)
+            {
+                cb = (size_t)strtoull(achLine + 6, nullptr, 10) * 1024;
+                break;
+            }
+        }
+        fclose(pFile);
+    }
+#endif
+    return cb;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 3)
+    {
+        fprintf(stderr, "usage: DictBench [word list] [lookups]\n");
+        return 2;
+    }
+
+    std::vector<DictionaryWord> words;
+    if (argc >= 2 && strcmp(argv[1], "-") != 0)
+    {
+        if (!ReadDictionaryWords(argv[1], &words))
+        {
+            fprintf(stderr, "DictBench: cannot read %s\n", argv[1]);
+            return 1;
+        }
+    }
+    else
+    {
+        MakeSyntheticWords(c_syntheticWords, &words);
+    }
+    size_t cLookups = (argc == 3) ? (size_t)strtoull(argv[2], nullptr, 10) : c_defaultLookups;
+
+    size_t cbResidentBefore = ResidentBytes();
+
+    DictionaryBuilder builder;
+    std::vector<uint8_t> blob = builder.Build(words);
+
+    // The DLL's blob is 4-byte aligned read-only data; copy into the same
+    std::vector<uint32_t> image((blob.size() + 3) / 4);
+    if (!blob.empty())
+        memcpy(image.data(), blob.data(), blob.size());
+    blob = std::vector<uint8_t>();
+
+    Dictionary dictionary;
+    if (!dictionary.Attach(image.data(), image.size() * sizeof(uint32_t)))
+    {
+        fprintf(stderr, "DictBench: no usable words\n");
+        return 1;
+    }
+
+    // The reference: every word, sorted in code unit order like Complete(),
+    // each with the frequency the builder kept
+    std::vector<DictionaryWord> sorted;
+    sorted.reserve(words.size());
+    for (const DictionaryWord& word : words)
+    {
+        if (IsDictionaryWord(word.text))
+            sorted.push_back({ word.text, std::max<uint32_t>(word.frequency, 1) });
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const DictionaryWord& a, const DictionaryWord& b)
+    {
+        return (a.text != b.text) ? a.text < b.text : a.frequency > b.frequency;
+    });
+    sorted.erase(std::unique(sorted.begin(), sorted.end(),
+        [](const DictionaryWord& a, const DictionaryWord& b) { return a.text == b.text; }), sorted.end());
+
+    LatencyHistogram histogram;
+    DictionaryMatch matches[c_matchesMax];
+    char16_t achText[c_matchesMax * c_dictionaryMaxWord];
+    size_t cMismatches = 0;
+    uint64_t cMatchesTotal = 0;
+
+    for (size_t iLookup = 0; iLookup < cLookups; iLookup++)
+    {
+        // Prefixes of real words, cut at any length, as typing produces them
+        const std::u16string& source = sorted[NextRandom() % sorted.size()].text;
+        size_t cchPrefix = 1 + NextRandom() % source.size();
+
+        uint64_t startNs = LatencyNow();
+        size_t cMatches = dictionary.Complete(source.data(), cchPrefix, matches, c_matchesMax, achText, sizeof(achText) / sizeof(achText[0]));
+        histogram.Record(LatencyNow() - startNs);
+        cMatchesTotal += cMatches;
+
+        // Spot-check one lookup in 16 against the scan
+        if (iLookup % 16 != 0)
+            continue;
+
+        std::u16string prefix = source.substr(0, cchPrefix);
+        auto it = std::lower_bound(sorted.begin(), sorted.end(), prefix,
+            [](const DictionaryWord& word, const std::u16string& text) { return word.text < text; });
+        size_t cExpected = 0;
+        bool fMatch = true;
+        for (; it != sorted.end() && it->text.compare(0, cchPrefix, prefix) == 0 && cExpected < c_matchesMax; ++it, cExpected++)
+        {
+            if (cExpected >= cMatches ||
+                it->text.compare(0, std::u16string::npos, achText + matches[cExpected].ichWord, matches[cExpected].cchWord) != 0)
+            {
+                fMatch = false;
+            }
+        }
+        if (!fMatch || cExpected != cMatches)
+            cMismatches++;
+    }
+
+    size_t cbResidentAfter = ResidentBytes();
+
+    // Typing sessions. Frequent words are typed more often.
+    std::vector<size_t> byFrequency(sorted.size());
+    for (size_t i = 0; i < sorted.size(); i++)
+        byFrequency[i] = i;
+    std::stable_sort(byFrequency.begin(), byFrequency.end(),
+        [&](size_t a, size_t b) { return sorted[a].frequency > sorted[b].frequency; });
+
+    struct Step
+    {
+        uint32_t iWord;
+        uint16_t cchPrefix;
+        uint16_t fFirst;        // first syllable of the word: nothing to narrow
+    };
+    std::vector<Step> steps;
+
+    for (size_t iSession = 0; iSession < c_sessionWords; iSession++)
+    {
+        double u = (NextRandom() & 0xFFFFFF) / (double)0x1000000;
+        uint32_t iWord = (uint32_t)byFrequency[(size_t)(u * u * u * byFrequency.size())];
+        const std::u16string& text = sorted[iWord].text;
+
+        // Syllable ends: a sign or pulli stays with its consonant
+        std::vector<uint32_t> ends;
+        for (size_t i = 1; i <= text.size(); i++)
+        {
+            TamilCharClass charClass = (i < text.size()) ? GetTamilCharInfo(text[i]).charClass : TamilClassNone;
+            if (charClass != TamilClassVowelSign && charClass != TamilClassPulli)
+                ends.push_back((uint32_t)i);
+        }
+
+        // The prefix after each syllable, with a backspace and a retype now and then
+        for (size_t i = 0; i < ends.size(); i++)
+        {
+            steps.push_back({ iWord, (uint16_t)ends[i], i == 0 });
+            if (i > 0 && NextRandom() % 8 == 0)
+            {
+                steps.push_back({ iWord, (uint16_t)ends[i - 1], 0 });
+                steps.push_back({ iWord, (uint16_t)ends[i], 0 });
+            }
+        }
+    }
+
+    // Each ranker replays all steps on its own, so neither warms the
+    // cache for the other
+    CandidateRanker incremental;
+    LatencyHistogram incrementalHistograms[2];     // later syllables, all steps
+    std::vector<uint32_t> results(steps.size() * (c_candidateTopK + 1));
+
+    for (size_t iStep = 0; iStep < steps.size(); iStep++)
+    {
+        const Step& step = steps[iStep];
+        uint64_t startNs = LatencyNow();
+        size_t cResults = incremental.Rank(dictionary, sorted[step.iWord].text.data(), step.cchPrefix);
+        uint64_t ns = LatencyNow() - startNs;
+        incrementalHistograms[1].Record(ns);
+        if (!step.fFirst)
+            incrementalHistograms[0].Record(ns);
+
+        uint32_t* pResults = &results[iStep * (c_candidateTopK + 1)];
+        pResults[0] = (uint32_t)cResults;
+        for (size_t i = 0; i < cResults; i++)
+            pResults[1 + i] = incremental.Frequency(i);
+    }
+
+    CandidateRanker scratch;
+    LatencyHistogram scratchHistograms[2];
+    size_t cRankMismatches = 0;
+    std::vector<uint32_t> expected;
+
+    for (size_t iStep = 0; iStep < steps.size(); iStep++)
+    {
+        const Step& step = steps[iStep];
+        const std::u16string& text = sorted[step.iWord].text;
+        uint64_t startNs = LatencyNow();
+        scratch.Reset();
+        size_t cResults = scratch.Rank(dictionary, text.data(), step.cchPrefix);
+        uint64_t ns = LatencyNow() - startNs;
+        scratchHistograms[1].Record(ns);
+        if (!step.fFirst)
+            scratchHistograms[0].Record(ns);
+
+        const uint32_t* pResults = &results[iStep * (c_candidateTopK + 1)];
+        bool fMatch = (pResults[0] == cResults);
+        for (size_t i = 0; fMatch && i < cResults; i++)
+            fMatch = (pResults[1 + i] == scratch.Frequency(i));
+
+        // Spot-check one step in 32 against every word under the prefix
+        if (fMatch && iStep % 32 == 0)
+        {
+            std::u16string prefix = text.substr(0, step.cchPrefix);
+            auto it = std::lower_bound(sorted.begin(), sorted.end(), prefix,
+                [](const DictionaryWord& word, const std::u16string& text) { return word.text < text; });
+            expected.clear();
+            for (; it != sorted.end() && it->text.compare(0, step.cchPrefix, prefix) == 0; ++it)
+                expected.push_back(it->frequency);
+            std::sort(expected.begin(), expected.end(), std::greater<uint32_t>());
+            if (expected.size() > c_candidateTopK)
+                expected.resize(c_candidateTopK);
+
+            fMatch = (expected.size() == cResults);
+            for (size_t i = 0; fMatch && i < cResults; i++)
+                fMatch = (pResults[1 + i] == expected[i]);
+        }
+
+        if (!fMatch)
+            cRankMismatches++;
+    }
+
+    printf("words      %u\n", dictionary.WordCount());
+    printf("blob       %zu bytes (%.1f per word)\n", dictionary.BlobSize(), (double)dictionary.BlobSize() / dictionary.WordCount());
+    printf("resident   %zu bytes before build, %zu after lookups\n", cbResidentBefore, cbResidentAfter);
+    printf("lookups    %zu, %.2f matches each\n", cLookups, cLookups ? (double)cMatchesTotal / cLookups : 0.0);
+    printf("latency    mean=%.3fus p50=%.3fus p99=%.3fus p999=%.3fus max=%.3fus\n",
+        histogram.Mean() / 1000.0,
+        histogram.Percentile(0.50) / 1000.0,
+        histogram.Percentile(0.99) / 1000.0,
+        histogram.Percentile(0.999) / 1000.0,
+        histogram.Max() / 1000.0);
+    printf("mismatches %zu\n", cMismatches);
+
+    const CandidateRankStats& stats = incremental.Stats();
+    size_t cSteps = steps.size();
+    printf("\ntop-%zu ranking, %zu session words, %zu steps\n", c_candidateTopK, c_sessionWords, cSteps);
+    const char* const c_stepNames[2] = { "later syllables", "all steps" };
+    for (size_t iHistogram = 0; iHistogram < 2; iHistogram++)
+    {
+        const LatencyHistogram* apHistograms[2] = { &incrementalHistograms[iHistogram], &scratchHistograms[iHistogram] };
+        for (size_t iRanker = 0; iRanker < 2; iRanker++)
+        {
+            const LatencyHistogram& histogram = *apHistograms[iRanker];
+            printf("%-11s %-15s mean=%.3fus p50=%.3fus p99=%.3fus p999=%.3fus max=%.3fus\n",
+                iRanker ? "scratch" : "incremental", c_stepNames[iHistogram],
+                histogram.Mean() / 1000.0,
+                histogram.Percentile(0.50) / 1000.0,
+                histogram.Percentile(0.99) / 1000.0,
+                histogram.Percentile(0.999) / 1000.0,
+                histogram.Max() / 1000.0);
+        }
+    }
+    printf("incremental restored=%llu narrowed=%llu restarted=%llu, %.1f subtrees opened per step (scratch %.1f)\n",
+        (unsigned long long)stats.restored, (unsigned long long)stats.narrowed, (unsigned long long)stats.restarted,
+        cSteps ? (double)stats.expanded / cSteps : 0.0,
+        cSteps ? (double)scratch.Stats().expanded / cSteps : 0.0);
+    printf("mismatches %zu\n", cRankMismatches);
+
+    return (cMismatches || cRankMismatches) ? 1 : 0;
+}
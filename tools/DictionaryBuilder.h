@@ -0,0 +1,395 @@
+﻿// DictionaryBuilder.h
+// Builds the dictionary blob read by include/Dictionary.h from a word list.
+// Offline tools only (ImageBuild, DictBench) - uses the standard library
+// freely; nothing here is linked into the DLL.
+
+#pragma once
+
+#include "../include/Dictionary.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct DictionaryWord
+{
+    std::u16string text;
+    uint32_t frequency;
+};
+
+// Words outside the Tamil block, empty or longer than the enumeration depth
+// are rejected
+inline bool IsDictionaryWord(const std::u16string& text)
+{
+    if (text.empty() || text.size() >= c_dictionaryMaxWord)
+        return false;
+
+    for (char16_t ch : text)
+    {
+        if (ch < c_dictionaryFirstUnit || ch >= c_dictionaryFirstUnit + c_dictionaryUnitRange)
+            return false;
+    }
+    return true;
+}
+
+class DictionaryBuilder
+{
+public:
+    // Returns the blob, or an empty vector if no word was usable or the
+    // trie needs more slots or tails than 24 bits can number.
+    // Duplicates keep their highest frequency; frequencies are at least 1.
+    std::vector<uint8_t> Build(std::vector<DictionaryWord> words)
+    {
+        words.erase(std::remove_if(words.begin(), words.end(),
+            [](const DictionaryWord& word) { return !IsDictionaryWord(word.text); }), words.end());
+
+        std::sort(words.begin(), words.end(), [](const DictionaryWord& a, const DictionaryWord& b)
+        {
+            return (a.text != b.text) ? a.text < b.text : a.frequency > b.frequency;
+        });
+        words.erase(std::unique(words.begin(), words.end(),
+            [](const DictionaryWord& a, const DictionaryWord& b) { return a.text == b.text; }), words.end());
+
+        if (words.empty())
+            return std::vector<uint8_t>();
+
+        _words = &words;
+        _MakeAlphabet();
+        _MakeDoubleArray();
+        bool fFits = _units.size() <= c_dictionaryIndexMask && _tails.size() <= c_dictionaryIndexMask;
+        if (fFits)
+            _MakeTailSymbols();
+
+        DictionaryHeader header = {};
+        header.magic = c_dictionaryMagic;
+        header.version = c_dictionaryVersion;
+        header.symbolCount = _symbolCount;
+        header.wordCount = (uint32_t)words.size();
+        header.unitCount = (uint32_t)_units.size();
+        header.tailCount = (uint32_t)_tails.size();
+        header.tailSymbolCount = (uint32_t)_tailSymbols.size();
+        memcpy(header.symbolOf, _symbolOf, sizeof(_symbolOf));
+        memcpy(header.unitOf, _unitOf, sizeof(_unitOf));
+
+        std::vector<uint8_t> blob;
+        if (fFits)
+        {
+            size_t cbUnits = _units.size() * sizeof(DictionaryUnit);
+            size_t cbTails = _tails.size() * sizeof(DictionaryTail);
+            blob.resize(sizeof(header) + cbUnits + cbTails + _tailSymbols.size());
+            memcpy(blob.data(), &header, sizeof(header));
+
+            DictionaryUnit* pUnits = (DictionaryUnit*)(blob.data() + sizeof(header));
+            for (size_t i = 0; i < _units.size(); i++)
+                pUnits[i] = _Pack(_units[i]);
+
+            DictionaryTail* pTails = (DictionaryTail*)(blob.data() + sizeof(header) + cbUnits);
+            for (size_t i = 0; i < _tails.size(); i++)
+                pTails[i] = { _tails[i].frequency, _tails[i].iSymbol };
+
+            memcpy(blob.data() + sizeof(header) + cbUnits + cbTails, _tailSymbols.data(), _tailSymbols.size());
+        }
+
+        _words = nullptr;
+        _units.clear();
+        _tails.clear();
+        _tailSymbols.clear();
+        return blob;
+    }
+
+private:
+    // A slot as it is built; _Pack lays it out as a DictionaryUnit
+    struct Slot
+    {
+        int32_t base;                           // base, word frequency or tail index
+        int32_t check;                          // parent state, -1 = free
+        uint16_t info;                          // DictionaryEncodeFrequency or c_dictionaryTailInfo
+    };
+
+    // A single-word subtree: the symbols after its slot, end symbol included
+    struct Tail
+    {
+        std::vector<uint8_t> symbols;
+        uint32_t frequency;
+        uint32_t iSymbol;
+    };
+
+    static DictionaryUnit _Pack(const Slot& slot)
+    {
+        uint32_t check = (slot.check < 0) ? c_dictionaryFreeSlot : (uint32_t)slot.check;
+        return { (uint32_t)slot.base | (uint32_t)(slot.info & 0xFF) << 24, check | (uint32_t)(slot.info >> 8) << 24 };
+    }
+
+    // Symbols in code unit order, so sorted words visit children in symbol order
+    void _MakeAlphabet()
+    {
+        bool used[c_dictionaryUnitRange] = {};
+        for (const DictionaryWord& word : *_words)
+        {
+            for (char16_t ch : word.text)
+                used[ch - c_dictionaryFirstUnit] = true;
+        }
+
+        memset(_symbolOf, 0, sizeof(_symbolOf));
+        memset(_unitOf, 0, sizeof(_unitOf));
+        _symbolCount = 1;
+        for (size_t i = 0; i < c_dictionaryUnitRange; i++)
+        {
+            if (used[i])
+            {
+                _symbolOf[i] = (uint8_t)_symbolCount;
+                _unitOf[_symbolCount] = (char16_t)(c_dictionaryFirstUnit + i);
+                _symbolCount++;
+            }
+        }
+    }
+
+    uint8_t _SymbolAt(const DictionaryWord& word, size_t depth) const
+    {
+        return (depth == word.text.size()) ? c_dictionaryEndSymbol : _symbolOf[word.text[depth] - c_dictionaryFirstUnit];
+    }
+
+    void _Reserve(size_t cUnits)
+    {
+        if (_units.size() < cUnits)
+        {
+            Slot freeSlot = { 0, -1, 0 };
+            _units.resize(cUnits, freeSlot);
+        }
+    }
+
+    // Each state covers a range of the sorted words sharing its path; its
+    // children are placed at the lowest base where every slot is free. A
+    // state other than the root with one word is a tail: the rest of the
+    // word goes to the tail table instead of a slot per unit.
+    void _MakeDoubleArray()
+    {
+        struct Pending
+        {
+            int32_t state;
+            size_t first;
+            size_t last;
+            size_t depth;
+        };
+
+        _units.clear();
+        _tails.clear();
+        _Reserve(1);
+        _units[0].check = 0;
+        _nextCheck = 1;
+
+        std::vector<Pending> queue;
+        queue.push_back({ 0, 0, _words->size(), 0 });
+
+        std::vector<std::pair<uint8_t, std::pair<size_t, size_t>>> children;
+        for (size_t iQueue = 0; iQueue < queue.size(); iQueue++)
+        {
+            Pending node = queue[iQueue];
+
+            if (node.state != 0 && node.last - node.first == 1)
+            {
+                const DictionaryWord& word = (*_words)[node.first];
+                Tail tail;
+                for (size_t depth = node.depth; depth <= word.text.size(); depth++)
+                    tail.symbols.push_back(_SymbolAt(word, depth));
+                tail.frequency = _Frequency(word);
+                tail.iSymbol = 0;
+
+                _units[node.state].base = (int32_t)_tails.size();
+                _units[node.state].info = c_dictionaryTailInfo;
+                _tails.push_back(std::move(tail));
+                continue;
+            }
+
+            children.clear();
+            for (size_t i = node.first; i < node.last; i++)
+            {
+                uint8_t symbol = _SymbolAt((*_words)[i], node.depth);
+                if (children.empty() || children.back().first != symbol)
+                    children.push_back({ symbol, { i, i + 1 } });
+                else
+                    children.back().second.second = i + 1;
+            }
+
+            int32_t base = _FindBase(children);
+            _units[node.state].base = base;
+            _units[node.state].info = DictionaryEncodeFrequency(_MaxFrequency(node.first, node.last));
+
+            for (size_t i = 0; i < children.size(); i++)
+            {
+                uint8_t symbol = children[i].first;
+                Slot& child = _units[base + symbol];
+                child.check = node.state;
+
+                if (symbol == c_dictionaryEndSymbol)
+                {
+                    child.base = (int32_t)_Frequency((*_words)[children[i].second.first]);
+                }
+                else
+                {
+                    queue.push_back({ base + symbol, children[i].second.first, children[i].second.second, node.depth + 1 });
+                }
+            }
+        }
+
+        while (_units.size() > 1 && _units.back().check == -1)
+            _units.pop_back();
+    }
+
+    // Tails laid end to end, each stored once: sorted by their reversed
+    // symbols, a tail that ends the one before it points into that one
+    void _MakeTailSymbols()
+    {
+        std::vector<uint32_t> order(_tails.size());
+        for (size_t i = 0; i < order.size(); i++)
+            order[i] = (uint32_t)i;
+        std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b)
+        {
+            const std::vector<uint8_t>& symbolsA = _tails[a].symbols;
+            const std::vector<uint8_t>& symbolsB = _tails[b].symbols;
+            return std::lexicographical_compare(symbolsB.rbegin(), symbolsB.rend(), symbolsA.rbegin(), symbolsA.rend());
+        });
+
+        _tailSymbols.clear();
+        const Tail* pPrevious = nullptr;
+        for (uint32_t i : order)
+        {
+            Tail& tail = _tails[i];
+            if (pPrevious && tail.symbols.size() <= pPrevious->symbols.size() &&
+                std::equal(tail.symbols.rbegin(), tail.symbols.rend(), pPrevious->symbols.rbegin()))
+            {
+                tail.iSymbol = pPrevious->iSymbol + (uint32_t)(pPrevious->symbols.size() - tail.symbols.size());
+                continue;
+            }
+
+            tail.iSymbol = (uint32_t)_tailSymbols.size();
+            _tailSymbols.insert(_tailSymbols.end(), tail.symbols.begin(), tail.symbols.end());
+            pPrevious = &tail;
+        }
+    }
+
+    static uint32_t _Frequency(const DictionaryWord& word)
+    {
+        return std::min<uint32_t>(std::max<uint32_t>(word.frequency, 1), INT32_MAX);
+    }
+
+    uint32_t _MaxFrequency(size_t first, size_t last) const
+    {
+        uint32_t frequency = 0;
+        for (size_t i = first; i < last; i++)
+            frequency = std::max(frequency, _Frequency((*_words)[i]));
+        return frequency;
+    }
+
+    template <typename Children>
+    int32_t _FindBase(const Children& children)
+    {
+        uint8_t firstSymbol = children.front().first;
+        uint8_t lastSymbol = children.back().first;
+
+        size_t pos = std::max<size_t>(_nextCheck, (size_t)firstSymbol + 1);
+        size_t cOccupied = 0;
+        bool fFirstFree = true;
+        size_t start = pos;
+
+        for (;; pos++)
+        {
+            _Reserve(pos + 1);
+            if (_units[pos].check != -1)
+            {
+                cOccupied++;
+                continue;
+            }
+            if (fFirstFree)
+            {
+                _nextCheck = pos;
+                fFirstFree = false;
+            }
+
+            size_t base = pos - firstSymbol;
+            if (base == 0)
+                continue;
+
+            _Reserve(base + lastSymbol + 1);
+            bool fFits = true;
+            for (const auto& child : children)
+            {
+                if (_units[base + child.first].check != -1)
+                {
+                    fFits = false;
+                    break;
+                }
+            }
+
+            if (fFits)
+            {
+                // Skip over densely packed space on later searches
+                if (cOccupied * 20 >= (pos - start + 1) * 19)
+                    _nextCheck = pos;
+                return (int32_t)base;
+            }
+        }
+    }
+
+    const std::vector<DictionaryWord>* _words = nullptr;
+    std::vector<Slot> _units;
+    std::vector<Tail> _tails;
+    std::vector<uint8_t> _tailSymbols;
+    size_t _nextCheck = 1;
+    uint8_t _symbolOf[c_dictionaryUnitRange];
+    char16_t _unitOf[c_dictionaryUnitRange];
+    uint16_t _symbolCount = 0;
+};
+
+// Word list reader shared by the tools: UTF-8, one word per line, an
+// optional tab and frequency after it. Lines starting with # are comments.
+inline bool ReadDictionaryWords(const char* pszPath, std::vector<DictionaryWord>* pWords)
+{
+    FILE* pFile = fopen(pszPath, "rb");
+    if (!pFile)
+        return false;
+
+    char achLine[1024];
+    while (fgets(achLine, sizeof(achLine), pFile))
+    {
+        if (achLine[0] == '#')
+            continue;
+
+        DictionaryWord word;
+        word.frequency = 1;
+
+        const unsigned char* p = (const unsigned char*)achLine;
+        if (p[0] == 0xEF && p[1] == 0xBB && p[2] == 0xBF)
+            p += 3;     // BOM
+
+        while (*p && *p != '\t' && *p != '\r' && *p != '\n' && *p != ' ')
+        {
+            // Tamil is in the BMP: 1-3 byte sequences only
+            uint32_t ch = *p++;
+            if (ch >= 0xE0 && p[0] && p[1])
+            {
+                ch = ((ch & 0x0F) << 12) | ((p[0] & 0x3F) << 6) | (p[1] & 0x3F);
+                p += 2;
+            }
+            else if (ch >= 0xC0 && p[0])
+            {
+                ch = ((ch & 0x1F) << 6) | (p[0] & 0x3F);
+                p += 1;
+            }
+            word.text += (char16_t)ch;
+        }
+
+        if (*p == '\t')
+            word.frequency = (uint32_t)strtoul((const char*)p + 1, nullptr, 10);
+
+        if (!word.text.empty())
+            pWords->push_back(word);
+    }
+
+    fclose(pFile);
+    return true;
+}
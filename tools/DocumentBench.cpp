@@ -0,0 +1,160 @@
+// DocumentBench.cpp
+// Focus-switch cost of the per-document state map (see include/DocumentMap.h).
+// Keeps a set of live documents and moves focus between random pairs the
+// way OnSetFocus does: the document losing focus saves the engine state,
+// the one gaining it is looked up. Every few switches a document closes and
+// a new one opens (OnUninitDocumentMgr / OnInitDocumentMgr), so removal
+// and reuse are exercised too. Checks every lookup against a std::map and
+// reports the switch latency, and whether the table stayed inline.
+//
+// Build:  cl /std:c++17 /EHsc /O2 tools\DocumentBench.cpp src\DocumentMap.cpp src\LatencyHistogram.cpp src\LayoutRegistry.cpp src\KeyMap*.cpp src\PhoneticEngine.cpp
+//    or:  g++ -std=c++17 -O2 tools/DocumentBench.cpp src/DocumentMap.cpp src/LatencyHistogram.cpp src/LayoutRegistry.cpp src/KeyMap*.cpp src/PhoneticEngine.cpp -o DocumentBench
+// Run:    DocumentBench [documents] [switches]
+
+#include "../include/DocumentMap.h"
+#include "../include/LatencyHistogram.h"
+#include "BenchUtil.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+static const size_t c_defaultDocuments = 1000;
+static const size_t c_defaultSwitches = 1000000;
+static const size_t c_switchesPerChurn = 16;
+
+// Stand-in for an ITfDocumentMgr: only its address is used
+struct FakeDocument
+{
+    uint64_t padding[4];
+};
+
+int main(int argc, char** argv)
+{
+    size_t cDocuments = (argc > 1) ? strtoul(argv[1], NULL, 10) : c_defaultDocuments;
+    size_t cSwitches = (argc > 2) ? strtoul(argv[2], NULL, 10) : c_defaultSwitches;
+    if (cDocuments < 2 || cSwitches == 0)
+    {
+        fprintf(stderr, "usage: DocumentBench [documents >= 2] [switches]\n");
+        return 1;
+    }
+
+    // Twice the live set, so a closed document's slot is reused later
+    std::vector<FakeDocument> storage(cDocuments * 2);
+    std::vector<const void*> live;
+    std::vector<const void*> closed;
+    for (size_t i = 0; i < storage.size(); i++)
+        (i < cDocuments ? live : closed).push_back(&storage[i]);
+
+    DocumentMap documents;
+    std::map<const void*, uint32_t> reference;      // document -> stamp of the text it saved
+    for (const void* pDocument : live)
+        documents.Insert(pDocument);
+
+    LatencyHistogram switchLatency;
+    size_t cMismatches = 0;
+    size_t cRestored = 0;
+    KeyboardEngine engine;
+    SurroundingText textBefore;
+    const void* pFocus = live[0];
+
+    // What is "typed" in the focused document: the switch number, so a
+    // restored state shows which save it came from
+    uint32_t stamp = 0;
+    auto Type = [&]()
+    {
+        char16_t achStamp[2] = { (char16_t)(stamp & 0xFFFF), (char16_t)(stamp >> 16) };
+        textBefore.Fill(pFocus, achStamp, 2, false);
+    };
+    Type();
+
+    for (size_t iSwitch = 0; iSwitch < cSwitches; iSwitch++)
+    {
+        const void* pNext = live[NextRandom() % live.size()];
+        if (pNext == pFocus)
+            continue;
+
+        uint64_t startNs = LatencyNow();
+
+        DocumentState* pPrev = documents.Insert(pFocus);
+        if (pPrev != NULL)
+        {
+            pPrev->engine = engine;
+            pPrev->textBefore = textBefore;
+            pPrev->fSaved = true;
+        }
+
+        const DocumentState* pState = documents.Find(pNext);
+        bool fSaved = pState != NULL && pState->fSaved;
+        if (fSaved)
+        {
+            engine = pState->engine;
+            textBefore = pState->textBefore;
+        }
+        else
+        {
+            engine = KeyboardEngine();
+            textBefore.Invalidate();
+        }
+
+        switchLatency.Record(LatencyNow() - startNs);
+
+        if (pPrev != NULL)
+            reference[pFocus] = stamp;
+        std::map<const void*, uint32_t>::const_iterator it = reference.find(pNext);
+        if (fSaved != (it != reference.end()) ||
+            (fSaved && (textBefore.Length() != 2 || (uint32_t)(textBefore.Text()[0] | (textBefore.Text()[1] << 16)) != it->second)))
+        {
+            cMismatches++;
+        }
+        cRestored += fSaved;
+
+        pFocus = pNext;
+        stamp = (uint32_t)iSwitch;
+        Type();
+
+        // A document closes and another opens
+        if (iSwitch % c_switchesPerChurn == 0)
+        {
+            size_t iClose = NextRandom() % live.size();
+            if (live[iClose] != pFocus)
+            {
+                documents.Remove(live[iClose]);
+                reference.erase(live[iClose]);
+                size_t iOpen = NextRandom() % closed.size();
+                std::swap(live[iClose], closed[iOpen]);
+                documents.Insert(live[iClose]);
+                if (documents.Find(closed[iOpen]) != NULL)
+                    cMismatches++;
+            }
+        }
+    }
+
+    // Everything live is still there, nothing closed is
+    for (const void* pDocument : live)
+        cMismatches += documents.Find(pDocument) == NULL;
+    for (const void* pDocument : closed)
+        cMismatches += documents.Find(pDocument) != NULL;
+    if (documents.Count() != live.size())
+        cMismatches++;
+
+    // A few documents stay in the inline table
+    DocumentMap few;
+    for (size_t i = 0; i < 8; i++)
+        few.Insert(&storage[i]);
+
+    printf("documents  %zu live, table %zu slots (%s)\n", documents.Count(), documents.Capacity(),
+        documents.IsInline() ? "inline" : "heap");
+    printf("switches   %llu, %zu restored a saved state\n", (unsigned long long)switchLatency.Count(), cRestored);
+    printf("switch     mean=%.1fns p50=%.1fns p99=%.1fns p999=%.1fns max=%.1fns\n",
+        (double)switchLatency.Mean(),
+        (double)switchLatency.Percentile(0.50),
+        (double)switchLatency.Percentile(0.99),
+        (double)switchLatency.Percentile(0.999),
+        (double)switchLatency.Max());
+    printf("8 documents: table %zu slots (%s)\n", few.Capacity(), few.IsInline() ? "inline, no heap" : "heap");
+    printf("mismatches %zu\n", cMismatches);
+
+    return (cMismatches || !few.IsInline()) ? 1 : 0;
+}
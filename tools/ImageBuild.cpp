@@ -0,0 +1,83 @@
+﻿// ImageBuild.cpp
+// Turns a word list and the compiled layout tables into
+// src/EngineImageData.cpp, the engine image the DLL embeds (see
+// include/EngineImage.h). The word list is UTF-8, one word per line with an
+// optional tab and frequency. Rerun after changing a layout or the words.
+//
+// Build:  cl /std:c++17 /EHsc /O2 tools\ImageBuild.cpp src\EngineImage.cpp src\Dictionary.cpp src\LayoutRegistry.cpp src\KeyMapTamil99.cpp src\KeyMapAnjal.cpp src\KeyMapTypewriter.cpp
+//    or:  g++ -std=c++17 -O2 tools/ImageBuild.cpp src/EngineImage.cpp src/Dictionary.cpp src/LayoutRegistry.cpp src/KeyMap*.cpp -o ImageBuild
+// Run:    ImageBuild tools\TamilWords.txt src\EngineImageData.cpp
+
+#include "DictionaryBuilder.h"
+#include "../include/EngineImage.h"
+
+#include <cstdio>
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "usage: ImageBuild <word list> <output .cpp>\n");
+        return 2;
+    }
+
+    std::vector<DictionaryWord> words;
+    if (!ReadDictionaryWords(argv[1], &words))
+    {
+        fprintf(stderr, "ImageBuild: cannot read %s\n", argv[1]);
+        return 1;
+    }
+
+    DictionaryBuilder builder;
+    std::vector<uint8_t> blob = builder.Build(words);
+
+    Dictionary dictionary;
+    if (!dictionary.Attach(blob.data(), blob.size()))
+    {
+        fprintf(stderr, "ImageBuild: no usable words in %s\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<uint8_t> image(WriteEngineImage(nullptr, 0, blob.data(), blob.size()));
+    WriteEngineImage(image.data(), image.size(), blob.data(), blob.size());
+
+    FILE* pFile = fopen(argv[2], "wb");
+    if (!pFile)
+    {
+        fprintf(stderr, "ImageBuild: cannot write %s\n", argv[2]);
+        return 1;
+    }
+
+    // Same layout as the hand-written sources: BOM, file name comment
+    const char* pszName = argv[2];
+    for (const char* p = argv[2]; *p; p++)
+    {
+        if (*p == '/' || *p == '\\')
+            pszName = p + 1;
+    }
+
+    fprintf(pFile, "\xEF\xBB\xBF// %s\n", pszName);
+    fprintf(pFile, "// Embedded engine image - %u layouts, %u words, %u bytes.\n", (unsigned)LayoutCount,
+        dictionary.WordCount(), (unsigned)image.size());
+    fprintf(pFile, "// Generated by tools/ImageBuild.cpp - do not edit.\n\n");
+    fprintf(pFile, "#include \"../include/EngineImage.h\"\n\n");
+    fprintf(pFile, "// Page-aligned and whole pages long: no other data shares these pages\n");
+    fprintf(pFile, "alignas(c_engineImagePage) const uint32_t g_engineImage[] =\n{\n");
+
+    size_t cWords = image.size() / 4;
+    for (size_t i = 0; i < cWords; i++)
+    {
+        uint32_t value;
+        memcpy(&value, image.data() + i * 4, 4);
+        fprintf(pFile, "%s0x%08X,%s", (i % 8 == 0) ? "    " : " ", value, (i % 8 == 7 || i + 1 == cWords) ? "\n" : "");
+    }
+
+    fprintf(pFile, "};\n\nconst size_t g_cbEngineImage = sizeof(g_engineImage);\n");
+    fclose(pFile);
+
+    const DictionaryHeader* pHeader = (const DictionaryHeader*)blob.data();
+    printf("%u words, %u symbols, %u units, %u tails (%u symbols), %u dictionary bytes, %u image bytes\n",
+        dictionary.WordCount(), (unsigned)pHeader->symbolCount, (unsigned)pHeader->unitCount, (unsigned)pHeader->tailCount,
+        (unsigned)pHeader->tailSymbolCount, (unsigned)blob.size(), (unsigned)image.size());
+    return 0;
+}
@@ -0,0 +1,212 @@
+﻿// ImageShare.cpp
+// Checks that an engine image (see include/EngineImage.h) mapped by several
+// processes is resident once. Builds an image - the compiled layouts plus
+// 300,000 synthetic Tamil words, or a word list - writes it to a file, and
+// forks processes that each map the file read-only, attach it, and touch
+// every page through real lookups. With all of them still mapped, each
+// reads its Rss and Pss for the mapping from /proc/self/smaps. Pss divides
+// a shared page among its users, so the total across processes is about one
+// image when the pages are shared and one image per process when they are not.
+//
+// Linux only (fork, mmap, /proc).
+// Build:  g++ -std=c++17 -O2 tools/ImageShare.cpp src/EngineImage.cpp src/Dictionary.cpp src/LayoutRegistry.cpp src/KeyMap*.cpp -o ImageShare
+// Run:    ImageShare [processes] [word list]
+
+#include "DictionaryBuilder.h"
+#include "../include/EngineImage.h"
+#include "BenchUtil.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static const size_t c_syntheticWords = 300000;
+static const int c_defaultProcesses = 8;
+static const int c_processesMax = 64;
+
+// What one process reports back, in kB
+struct ShareReport
+{
+    int ok;
+    long rssKb;
+    long pssKb;
+};
+
+// Rss and Pss of the mapping that starts at pv
+static bool ReadMappingUsage(const void* pv, long* pRssKb, long* pPssKb)
+{
+    FILE* pFile = fopen("/proc/self/smaps", "r");
+    if (!pFile)
+        return false;
+
+    char achLine[512];
+    bool fInMapping = false;
+    bool fFound = false;
+    *pRssKb = 0;
+    *pPssKb = 0;
+    while (fgets(achLine, sizeof(achLine), pFile))
+    {
+        unsigned long start, end;
+        // A mapping's first line starts with its address range
+        if (sscanf(achLine, "%lx-%lx ", &start, &end) == 2)
+        {
+            fInMapping = (start == (unsigned long)(uintptr_t)pv);
+            fFound |= fInMapping;
+            continue;
+        }
+
+        if (fInMapping)
+        {
+            sscanf(achLine, "Rss: %ld kB", pRssKb);
+            sscanf(achLine, "Pss: %ld kB", pPssKb);
+        }
+    }
+
+    fclose(pFile);
+    return fFound;
+}
+
+// Child: map, attach, walk everything, report once all are mapped, then
+// stay mapped until told to go
+static int RunChild(const char* pszPath, size_t cbImage, int fdGo, int fdReport)
+{
+    ShareReport report = {};
+
+    int fd = open(pszPath, O_RDONLY);
+    void* pv = (fd >= 0) ? mmap(nullptr, cbImage, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    EngineImage image;
+    if (pv != MAP_FAILED && image.Attach(pv, cbImage) && image.MatchesSources())
+    {
+        // Real lookups reach some pages; a read of every page reaches the rest
+        const Dictionary& dictionary = image.GetDictionary();
+        DictionaryMatch aMatches[8];
+        char16_t achText[8 * c_dictionaryMaxWord];
+        for (size_t c = 0; c < c_tamilConsonantCount; c++)
+        {
+            const TamilSyllable& syllable = image.Syllables().cell[c][0];
+            dictionary.Complete(syllable.text, syllable.cch, aMatches, 8, achText, sizeof(achText) / sizeof(achText[0]));
+        }
+
+        volatile uint8_t sum = 0;
+        for (size_t ib = 0; ib < cbImage; ib += 4096)
+            sum += ((const uint8_t*)pv)[ib];
+        (void)sum;
+
+        report.ok = image.KeyMap(LayoutTamil99).Lookup(KeyLayerBase, 'H') == 0x0B95;
+    }
+
+    char ch;
+    if (write(fdReport, "r", 1) != 1 || read(fdGo, &ch, 1) != 1)
+        return 1;
+
+    if (report.ok)
+        report.ok = ReadMappingUsage(pv, &report.rssKb, &report.pssKb);
+    if (write(fdReport, &report, sizeof(report)) != (ssize_t)sizeof(report) || read(fdGo, &ch, 1) != 1)
+        return 1;
+
+    return report.ok ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+    int cProcesses = (argc > 1) ? atoi(argv[1]) : c_defaultProcesses;
+    if (cProcesses < 2 || cProcesses > c_processesMax)
+    {
+        fprintf(stderr, "usage: ImageShare [processes 2-%d] [word list]\n", c_processesMax);
+        return 2;
+    }
+
+    std::vector<DictionaryWord> words;
+    if (argc > 2)
+    {
+        if (!ReadDictionaryWords(argv[2], &words))
+        {
+            fprintf(stderr, "ImageShare: cannot read %s\n", argv[2]);
+            return 1;
+        }
+    }
+    else
+    {
+        MakeSyntheticWords(c_syntheticWords, &words);
+    }
+
+    DictionaryBuilder builder;
+    std::vector<uint8_t> blob = builder.Build(words);
+    std::vector<uint8_t> image(WriteEngineImage(nullptr, 0, blob.data(), blob.size()));
+    WriteEngineImage(image.data(), image.size(), blob.data(), blob.size());
+
+    char szPath[] = "/tmp/AnjalImageXXXXXX";
+    int fd = mkstemp(szPath);
+    if (fd < 0 || write(fd, image.data(), image.size()) != (ssize_t)image.size())
+    {
+        fprintf(stderr, "ImageShare: cannot write the image file\n");
+        return 1;
+    }
+    close(fd);
+
+    // One report pipe for all; one go pipe per child
+    int fdReport[2];
+    int fdGo[c_processesMax][2];
+    pid_t pids[c_processesMax];
+    if (pipe(fdReport) != 0)
+        return 1;
+
+    for (int i = 0; i < cProcesses; i++)
+    {
+        if (pipe(fdGo[i]) != 0)
+            return 1;
+
+        pids[i] = fork();
+        if (pids[i] == 0)
+            _exit(RunChild(szPath, image.size(), fdGo[i][0], fdReport[1]));
+    }
+
+    // All mapped and touched, then all measure while all are still mapped
+    char ch;
+    for (int i = 0; i < cProcesses; i++)
+    {
+        if (read(fdReport[0], &ch, 1) != 1)
+            return 1;
+    }
+    for (int i = 0; i < cProcesses; i++)
+    {
+        if (write(fdGo[i][1], "g", 1) != 1)
+            return 1;
+    }
+
+    long rssTotalKb = 0;
+    long pssTotalKb = 0;
+    int cFailed = 0;
+    for (int i = 0; i < cProcesses; i++)
+    {
+        ShareReport report;
+        if (read(fdReport[0], &report, sizeof(report)) != (ssize_t)sizeof(report))
+            return 1;
+        cFailed += !report.ok;
+        rssTotalKb += report.rssKb;
+        pssTotalKb += report.pssKb;
+    }
+
+    for (int i = 0; i < cProcesses; i++)
+    {
+        if (write(fdGo[i][1], "x", 1) != 1)
+            return 1;
+        int status;
+        waitpid(pids[i], &status, 0);
+    }
+    unlink(szPath);
+
+    long imageKb = (long)(image.size() / 1024);
+    printf("image      %ld kB (%u words), %d processes\n", imageKb, (unsigned)words.size(), cProcesses);
+    printf("rss        %ld kB total, %ld kB per process\n", rssTotalKb, rssTotalKb / cProcesses);
+    printf("pss        %ld kB total (%.2f images)\n", pssTotalKb, (double)pssTotalKb / imageKb);
+
+    // Pss rounds per process; allow a page per process
+    bool fShared = cFailed == 0 && pssTotalKb <= imageKb + 4 * cProcesses;
+    printf("%s\n", fShared ? "shared: yes" : (cFailed ? "failed: a process could not map or attach the image" : "shared: NO"));
+    return fShared ? 0 : 1;
+}
@@ -0,0 +1,232 @@
+// KeyMapCheck.cpp
+// Checks the generated Tamil99 tables (src/KeyMapTamil99.cpp, see
+// include/KeyMap.h) against the mapping documented in README.md, under
+// "Current Character Mapping":
+//   - every row of the base-layer table: the key must type the character
+//     shown, and the Unicode column must name that same character;
+//   - the "Shift layer:" list, multi-unit keys (க்ஷ, ஸ்ரீ) included;
+//   - the "AltGr layer:" range of digits;
+// and the other way round: every key the tables map, on any layer, must be
+// documented there. Nothing else in the README is read.
+//
+// Build:  cl /std:c++17 /EHsc tools\KeyMapCheck.cpp src\KeyMapTamil99.cpp
+//    or:  g++ -std=c++17 -O2 tools/KeyMapCheck.cpp src/KeyMapTamil99.cpp -o KeyMapCheck
+// Run:    KeyMapCheck [README.md]      (from the repository root)
+
+#include "../include/KeyMap.h"
+#include "BenchUtil.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static const char* const c_defaultReadme = "README.md";
+static const char* const c_layerNames[KeyLayerCount] = { "base", "Shift", "AltGr" };
+
+// One documented key: what it types on one layer
+struct DocumentedKey
+{
+    KeyLayer layer;
+    uint8_t vk;
+    std::u16string text;
+    size_t line;
+};
+
+static std::string Trim(const std::string& s)
+{
+    size_t ib = s.find_first_not_of(" \t\r");
+    size_t ibEnd = s.find_last_not_of(" \t\r");
+    return (ib == std::string::npos) ? std::string() : s.substr(ib, ibEnd - ib + 1);
+}
+
+static std::vector<std::string> Split(const std::string& s, char separator)
+{
+    std::vector<std::string> parts;
+    size_t ib = 0;
+    for (;;)
+    {
+        size_t ibEnd = s.find(separator, ib);
+        parts.push_back(Trim(s.substr(ib, ibEnd - ib)));
+        if (ibEnd == std::string::npos)
+            return parts;
+        ib = ibEnd + 1;
+    }
+}
+
+// The key as the README names it - the character on the unshifted key,
+// letters in capitals as printed on the keycap
+static bool KeyFromName(const std::string& name, uint8_t* pvk)
+{
+    if (name.size() != 1)
+        return false;
+
+    char ch = name[0];
+    if (ch >= 'A' && ch <= 'Z')
+        ch = (char)(ch - 'A' + 'a');
+
+    KeyLayer layer;
+    return UsKeyForAscii((char16_t)ch, pvk, &layer) && layer == KeyLayerBase;
+}
+
+// Reads the documented keys. Returns false, with a message, when the
+// section is missing or a line in it cannot be read.
+static bool ReadReadme(const char* pszPath, std::vector<DocumentedKey>* pKeys)
+{
+    std::ifstream file(pszPath);
+    if (!file)
+    {
+        fprintf(stderr, "KeyMapCheck: cannot open %s\n", pszPath);
+        return false;
+    }
+
+    bool fSection = false;
+    bool fTable = false;
+    bool fShift = false;
+    bool fAltGr = false;
+    std::string line;
+    for (size_t iLine = 1; std::getline(file, line); iLine++)
+    {
+        if (line.compare(0, 3, "## ") == 0)
+        {
+            fSection = (line.find("Current Character Mapping") != std::string::npos);
+            continue;
+        }
+        if (!fSection)
+            continue;
+
+        if (line.compare(0, 2, "| ") == 0)
+        {
+            // | Key | Tamil Character | Unicode | Description |
+            std::vector<std::string> cells = Split(line, '|');
+            if (cells.size() < 5 || cells[1] == "Key" || cells[1].compare(0, 3, "---") == 0)
+                continue;
+
+            DocumentedKey key = { KeyLayerBase, 0, ToUtf16(cells[2]), iLine };
+            unsigned long cp = (cells[3].compare(0, 2, "U+") == 0) ? strtoul(cells[3].c_str() + 2, NULL, 16) : 0;
+            if (!KeyFromName(cells[1], &key.vk) || key.text.size() != 1 || cp == 0)
+            {
+                fprintf(stderr, "README.md:%zu: cannot read the row\n", iLine);
+                return false;
+            }
+            if (key.text[0] != cp)
+            {
+                fprintf(stderr, "README.md:%zu: %s is not U+%04lX\n", iLine, cells[2].c_str(), cp);
+                return false;
+            }
+            pKeys->push_back(key);
+            fTable = true;
+        }
+        else if (line.compare(0, 12, "Shift layer:") == 0)
+        {
+            // Shift layer: Q ஸ, W ஷ, ... F ஃ.
+            std::string list = Trim(line.substr(12));
+            if (!list.empty() && list.back() == '.')
+                list.pop_back();
+
+            for (const std::string& entry : Split(list, ','))
+            {
+                size_t ibSpace = entry.find(' ');
+                DocumentedKey key = { KeyLayerShift, 0, u"", iLine };
+                if (ibSpace == std::string::npos || !KeyFromName(entry.substr(0, ibSpace), &key.vk))
+                {
+                    fprintf(stderr, "README.md:%zu: cannot read \"%s\"\n", iLine, entry.c_str());
+                    return false;
+                }
+                key.text = ToUtf16(Trim(entry.substr(ibSpace + 1)));
+                pKeys->push_back(key);
+            }
+            fShift = true;
+        }
+        else if (line.compare(0, 12, "AltGr layer:") == 0)
+        {
+            // AltGr layer: 0-9 produce the Tamil digits ௦-௯.
+            std::vector<std::string> words = Split(Trim(line.substr(12)), ' ');
+            std::string keys = words.front();
+            std::u16string text = ToUtf16(words.back());
+            if (!text.empty() && text.back() == '.')
+                text.pop_back();
+
+            if (keys.size() != 3 || keys[1] != '-' || text.size() != 3 || text[1] != '-' ||
+                keys[2] - keys[0] != text[2] - text[0])
+            {
+                fprintf(stderr, "README.md:%zu: cannot read the AltGr range\n", iLine);
+                return false;
+            }
+
+            for (int i = 0; i <= keys[2] - keys[0]; i++)
+            {
+                DocumentedKey key = { KeyLayerAltGr, 0, std::u16string(1, (char16_t)(text[0] + i)), iLine };
+                if (!KeyFromName(std::string(1, (char)(keys[0] + i)), &key.vk))
+                {
+                    fprintf(stderr, "README.md:%zu: cannot read the AltGr range\n", iLine);
+                    return false;
+                }
+                pKeys->push_back(key);
+            }
+            fAltGr = true;
+        }
+    }
+
+    if (!fTable || !fShift || !fAltGr)
+    {
+        fprintf(stderr, "KeyMapCheck: %s has no Tamil99 table, Shift list or AltGr range\n", pszPath);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<DocumentedKey> keys;
+    if (!ReadReadme((argc > 1) ? argv[1] : c_defaultReadme, &keys))
+        return 2;
+
+    const KeyMapTables& tables = g_keyMapTamil99;
+    size_t cMismatches = 0;
+    bool documented[KeyLayerCount][256] = {};
+
+    // README -> tables
+    for (const DocumentedKey& key : keys)
+    {
+        char16_t achText[c_keySequenceLength];
+        size_t cch = tables.Expand(tables.Lookup(key.layer, key.vk), achText);
+        std::u16string text(achText, cch);
+        if (text != key.text)
+        {
+            fprintf(stderr, "README.md:%zu: %s key 0x%02X types \"%s\", documented as \"%s\"\n", key.line,
+                c_layerNames[key.layer], key.vk, ToUtf8(text).c_str(), ToUtf8(key.text).c_str());
+            cMismatches++;
+        }
+        if (documented[key.layer][key.vk])
+        {
+            fprintf(stderr, "README.md:%zu: %s key 0x%02X documented twice\n", key.line, c_layerNames[key.layer], key.vk);
+            cMismatches++;
+        }
+        documented[key.layer][key.vk] = true;
+    }
+
+    // Tables -> README
+    size_t cMapped = 0;
+    for (size_t layer = 0; layer < KeyLayerCount; layer++)
+    {
+        for (size_t vk = 0; vk < 256; vk++)
+        {
+            if (tables.Lookup((KeyLayer)layer, vk) == 0)
+                continue;
+            cMapped++;
+            if (!documented[layer][vk])
+            {
+                char16_t achText[c_keySequenceLength];
+                size_t cch = tables.Expand(tables.Lookup((KeyLayer)layer, vk), achText);
+                fprintf(stderr, "%s key 0x%02zX types \"%s\" but is not in README.md\n", c_layerNames[layer], vk,
+                    ToUtf8(std::u16string(achText, cch)).c_str());
+                cMismatches++;
+            }
+        }
+    }
+
+    printf("tamil99      %zu documented keys, %zu mapped keys, %zu mismatches\n", keys.size(), cMapped, cMismatches);
+    return cMismatches ? 1 : 0;
+}
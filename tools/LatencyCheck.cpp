@@ -0,0 +1,253 @@
+// LatencyCheck.cpp
+// Runtime checks for the latency histograms (see include/LatencyHistogram.h),
+// beyond the static_asserts there:
+//   - every bucket: its bounds map back to it, and it is at most 1/16 wide;
+//   - Percentile against the exact sample of the same rank, over random
+//     sample sets: rank rounding, the bucket upper bound, the cap at Max;
+//   - the edge cases: empty, one sample, q of 0 and 1, the overflow bucket;
+//   - Mean, Reset, LatencyScope;
+//   - LatencyStats::Dump at every buffer size, truncation included.
+//
+// Build:  cl /std:c++17 /EHsc /O2 tools\LatencyCheck.cpp src\LatencyHistogram.cpp
+//    or:  g++ -std=c++17 -O2 tools/LatencyCheck.cpp src/LatencyHistogram.cpp -o LatencyCheck
+// Run:    LatencyCheck
+
+#include "../include/LatencyHistogram.h"
+#include "BenchUtil.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+static const size_t c_randomSets = 2000;
+static const double c_quantiles[] = { 0, 0.001, 0.01, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 1 };
+
+static size_t s_cChecks = 0;
+static size_t s_cFailures = 0;
+
+static void Check(const char* pszWhat, uint64_t actual, uint64_t expected)
+{
+    s_cChecks++;
+    if (actual != expected)
+    {
+        fprintf(stderr, "%s: got %llu, expected %llu\n", pszWhat, (unsigned long long)actual, (unsigned long long)expected);
+        s_cFailures++;
+    }
+}
+
+// The value Percentile(q) must return for samples: the sample of rank
+// q * n rounded to nearest, clamped to 1..n, reported as the upper bound
+// of its bucket but never above the largest sample
+static uint64_t ExpectedPercentile(std::vector<uint64_t> samples, double q)
+{
+    if (samples.empty())
+        return 0;
+
+    std::sort(samples.begin(), samples.end());
+    uint64_t rank = (uint64_t)(q * (double)samples.size() + 0.5);
+    rank = std::min<uint64_t>(std::max<uint64_t>(rank, 1), samples.size());
+    uint64_t upper = LatencyBucketUpperBound(LatencyBucketIndex(samples[rank - 1]));
+    return std::min(upper, samples.back());
+}
+
+static void CheckBuckets()
+{
+    for (size_t i = 0; i < c_latencyBucketCount; i++)
+    {
+        uint64_t lower = LatencyBucketLowerBound(i);
+        uint64_t upper = LatencyBucketUpperBound(i);
+        Check("lower bound maps back", LatencyBucketIndex(lower), i);
+        Check("upper bound maps back", LatencyBucketIndex(upper), i);
+        if (i + 1 < c_latencyBucketCount)
+        {
+            Check("buckets are contiguous", LatencyBucketLowerBound(i + 1), upper + 1);
+            Check("bucket within 1/16", (upper - lower) <= lower / c_latencySubBuckets, true);
+        }
+    }
+
+    for (size_t i = 0; i < 100000; i++)
+    {
+        uint64_t value = NextRandom64() >> (NextRandom64() % 64);
+        size_t index = LatencyBucketIndex(value);
+        Check("value inside its bucket", LatencyBucketLowerBound(index) <= value && value <= LatencyBucketUpperBound(index), true);
+    }
+}
+
+static void CheckPercentiles()
+{
+    // On the heap: a histogram is about 3 KB of counters
+    std::unique_ptr<LatencyHistogram> pHistogram(new LatencyHistogram());
+    LatencyHistogram& histogram = *pHistogram;
+
+    Check("empty count", histogram.Count(), 0);
+    Check("empty max", histogram.Max(), 0);
+    Check("empty mean", histogram.Mean(), 0);
+    Check("empty p50", histogram.Percentile(0.5), 0);
+    Check("empty p100", histogram.Percentile(1), 0);
+
+    // One sample inside a wide bucket: every quantile is capped at it
+    histogram.Record(1000);
+    Check("one sample p0", histogram.Percentile(0), 1000);
+    Check("one sample p50", histogram.Percentile(0.5), 1000);
+    Check("one sample p100", histogram.Percentile(1), 1000);
+    Check("one sample mean", histogram.Mean(), 1000);
+
+    // Rank rounding: 0.5 * 3 + 0.5 = 2, 0.5 * 4 + 0.5 = 2.5 -> 2
+    histogram.Reset();
+    for (uint64_t value : { 10, 20, 30 })
+        histogram.Record(value);
+    Check("p50 of 3", histogram.Percentile(0.5), 20);
+    Check("p0 of 3 is the smallest", histogram.Percentile(0), 10);
+    Check("p16 of 3 clamps to rank 1", histogram.Percentile(0.16), 10);
+    Check("p83 of 3 rounds down to rank 2", histogram.Percentile(0.83), 20);
+    Check("p84 of 3 rounds up to rank 3", histogram.Percentile(0.84), 30);
+    Check("mean of 3", histogram.Mean(), 20);
+    histogram.Record(40);
+    Check("p50 of 4 is rank 2", histogram.Percentile(0.5), 20);
+    Check("p99 of 4 is the largest", histogram.Percentile(0.99), 40);
+
+    // p999 of 1000 is rank 999, not the largest
+    histogram.Reset();
+    for (uint64_t value = 1; value <= 1000; value++)
+        histogram.Record(value < 1000 ? 5 : 1000000);
+    Check("p999 of 1000", histogram.Percentile(0.999), 5);
+    Check("p100 of 1000", histogram.Percentile(1), 1000000);
+
+    // Integer mean: (1 + 2) / 2
+    histogram.Reset();
+    histogram.Record(1);
+    histogram.Record(2);
+    Check("mean rounds down", histogram.Mean(), 1);
+
+    // Past the last bucket: reported as the largest sample, not UINT64_MAX
+    histogram.Reset();
+    uint64_t huge = 1ull << 60;
+    histogram.Record(huge);
+    histogram.Record(7);
+    Check("overflow bucket p100", histogram.Percentile(1), huge);
+    Check("overflow bucket max", histogram.Max(), huge);
+    Check("below the overflow", histogram.Percentile(0.25), 7);
+
+    // Reset leaves nothing behind
+    histogram.Reset();
+    Check("reset count", histogram.Count(), 0);
+    Check("reset max", histogram.Max(), 0);
+    Check("reset mean", histogram.Mean(), 0);
+    Check("reset p50", histogram.Percentile(0.5), 0);
+
+    // Random sets, small and large, short and long tails
+    for (size_t set = 0; set < c_randomSets; set++)
+    {
+        size_t cSamples = 1 + NextRandom64() % ((set % 4 == 0) ? 10 : 2000);
+        unsigned maxBits = 4 + NextRandom64() % 40;
+        std::vector<uint64_t> samples;
+        uint64_t sum = 0;
+        histogram.Reset();
+        for (size_t i = 0; i < cSamples; i++)
+        {
+            uint64_t value = NextRandom64() >> (64 - 1 - NextRandom64() % maxBits);
+            samples.push_back(value);
+            sum += value;
+            histogram.Record(value);
+        }
+
+        Check("random count", histogram.Count(), cSamples);
+        Check("random max", histogram.Max(), *std::max_element(samples.begin(), samples.end()));
+        Check("random mean", histogram.Mean(), sum / cSamples);
+        for (double q : c_quantiles)
+        {
+            uint64_t expected = ExpectedPercentile(samples, q);
+            s_cChecks++;
+            if (histogram.Percentile(q) != expected)
+            {
+                fprintf(stderr, "random set %zu (%zu samples): p%g is %llu, expected %llu\n", set, cSamples, q * 100,
+                    (unsigned long long)histogram.Percentile(q), (unsigned long long)expected);
+                s_cFailures++;
+            }
+        }
+    }
+}
+
+static void CheckScope()
+{
+    g_latencyStats.Reset();
+    {
+        LatencyScope scope(LatencyKeyDown);
+    }
+    {
+        LatencyScope scope(LatencyMapping, false);
+    }
+    Check("scope records", g_latencyStats.stages[LatencyKeyDown].Count(), 1);
+    Check("scope without recording", g_latencyStats.stages[LatencyMapping].Count(), 0);
+    g_latencyStats.Reset();
+}
+
+static void CheckDump()
+{
+    std::unique_ptr<LatencyStats> pStats(new LatencyStats());
+    LatencyStats& stats = *pStats;
+
+    char buffer[4096];
+    memset(buffer, 'x', sizeof(buffer));
+    Check("empty dump", stats.Dump(buffer, sizeof(buffer)), 0);
+    Check("empty dump terminated", buffer[0], 0);
+    Check("zero-length buffer", stats.Dump(buffer, 0), 0);
+
+    std::vector<uint64_t> keyDown;
+    for (uint64_t value = 1; value <= 1000; value++)
+    {
+        keyDown.push_back(value * 1000);
+        stats.stages[LatencyKeyDown].Record(value * 1000);
+    }
+    stats.stages[LatencyEditSession].Record(2500);
+    stats.stages[LatencyFirstKey].Record(123456789);
+
+    size_t cchFull = stats.Dump(buffer, sizeof(buffer));
+    std::string full(buffer, cchFull);
+    Check("full dump length", strlen(buffer), cchFull);
+    Check("three lines", std::count(full.begin(), full.end(), '\n'), 3);
+    Check("stage order", full.find("KeyDown ") < full.find("EditSession ") && full.find("EditSession ") < full.find("FirstKey "), true);
+
+    char line[256];
+    snprintf(line, sizeof(line), "KeyDown            n=1000 mean=500.5us p50=%.1fus p99=%.1fus p999=%.1fus max=1000.0us\n",
+        ExpectedPercentile(keyDown, 0.5) / 1000.0, ExpectedPercentile(keyDown, 0.99) / 1000.0,
+        ExpectedPercentile(keyDown, 0.999) / 1000.0);
+    s_cChecks++;
+    if (full.compare(0, strlen(line), line) != 0)
+    {
+        fprintf(stderr, "key-down line: got \"%s\", expected \"%s\"\n", full.substr(0, full.find('\n')).c_str(), line);
+        s_cFailures++;
+    }
+
+    // Every size: the prefix that fits, terminated, nothing written past it
+    for (size_t cch = 1; cch <= cchFull + 2; cch++)
+    {
+        memset(buffer, 'x', sizeof(buffer));
+        size_t cchWritten = stats.Dump(buffer, cch);
+        size_t cchExpected = std::min(cchFull, cch - 1);
+        s_cChecks++;
+        if (cchWritten != cchExpected || strlen(buffer) != cchExpected || full.compare(0, cchExpected, buffer) != 0 ||
+            buffer[cch] != 'x')
+        {
+            fprintf(stderr, "dump into %zu: returned %zu, expected %zu\n", cch, cchWritten, cchExpected);
+            s_cFailures++;
+        }
+    }
+
+    stats.Reset();
+    Check("dump after reset", stats.Dump(buffer, sizeof(buffer)), 0);
+}
+
+int main()
+{
+    CheckBuckets();
+    CheckPercentiles();
+    CheckScope();
+    CheckDump();
+
+    printf("latency      %zu checks, %zu failures\n", s_cChecks, s_cFailures);
+    return s_cFailures ? 1 : 0;
+}
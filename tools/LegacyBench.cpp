@@ -0,0 +1,463 @@
+// LegacyBench.cpp
+// Round-trip check and throughput for the font-encoding converters (see
+// include/LegacyConverter.h). For every encoding:
+//   - generated Tamil text - every consonant with every vowel sign, vowels,
+//     pulli, grantha, க்ஷ and ஸ்ரீ, and the digits, punctuation and Latin
+//     text the encoding carries - must survive Encode then Decode;
+//   - random glyph streams in visual order must decode to text that encodes
+//     and decodes back to itself;
+//   - random bytes must decode the same when split after any pass-through
+//     byte, and measuring must give the length written;
+//   - for Bamini, the decoded text must equal typing the same bytes on the
+//     Bamini keyboard layout (both are built from one glyph list);
+//   - on Linux, TSCII is compared with glibc's converter: every sequence of
+//     up to three bytes, then the generated text both ways. glibc leaves
+//     prefix signs after the grantha letters, so those sequences and words
+//     are left out; it draws ௌ as ே...ௗ where Unicode decomposes it as
+//     ெ + ௗ, and composes ெ ா even with no consonant between them, so
+//     decoded signs are composed before comparing; and it writes இ as 0xFE
+//     rather than 0xAD. ஸு ஸூ ஹு ஹூ are two-byte glyphs in both.
+// Then generated text is encoded and decoded and the throughput reported,
+// for Tamil prose and for mostly-ASCII text with Tamil words in it.
+//
+// Build:  cl /std:c++17 /EHsc /O2 tools\LegacyBench.cpp src\LegacyConverter.cpp src\Transliterator.cpp src\TamilScan.cpp src\KeyboardEngine.cpp src\Tamil99Engine.cpp src\TypewriterEngine.cpp src\PhoneticEngine.cpp src\LayoutRegistry.cpp src\KeyMap*.cpp src\EngineImage.cpp src\EngineImageData.cpp src\Dictionary.cpp
+//    or:  g++ -std=c++17 -O2 tools/LegacyBench.cpp src/LegacyConverter.cpp src/Transliterator.cpp src/TamilScan.cpp src/KeyboardEngine.cpp src/Tamil99Engine.cpp src/TypewriterEngine.cpp src/PhoneticEngine.cpp src/LayoutRegistry.cpp src/KeyMap*.cpp src/EngineImage.cpp src/EngineImageData.cpp src/Dictionary.cpp -o LegacyBench
+// Run:    LegacyBench [MiB]
+
+#include "../include/LegacyConverter.h"
+#include "../include/Transliterator.h"
+#include "BenchUtil.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <iconv.h>
+#endif
+
+static const size_t c_defaultMiB = 64;
+static const size_t c_roundTripUnits = 4 * 1024 * 1024;
+static const size_t c_iconvBlock = 256;
+static const size_t c_randomRuns = 100000;
+static const size_t c_benchRepeats = 3;
+
+static const char* const c_encodingNames[LegacyEncodingCount] = { "tscii", "bamini" };
+
+// One generated word: syllables from the matrix, vowels, pulli, ஃ, the
+// conjuncts, and digits or Latin words now and then
+static void AppendWord(bool fMostlyAscii, std::u16string* pText)
+{
+    static const char16_t* const c_extras[] =
+    {
+        u"க்ஷ", u"க்ஷொ", u"ஸ்ரீ",
+        u"ஃ", u"௧௯௪௭", u"‘", u"”", u"©", u"2024", u"-", u"!", u".",
+    };
+    static const char16_t* const c_latin[] = { u"the", u"Tamil", u"Unicode", u"font", u"(TSCII)", u"e-mail", u"1999" };
+
+    if (fMostlyAscii ? NextRandom() % 8 != 0 : NextRandom() % 16 == 0)
+    {
+        pText->append(c_latin[NextRandom() % (sizeof(c_latin) / sizeof(c_latin[0]))]);
+        return;
+    }
+
+    if (NextRandom() % 4 == 0)
+        pText->push_back(c_tamilVowels[NextRandom() % c_tamilVowelCount]);
+    for (size_t i = 1 + NextRandom() % 4; i > 0; i--)
+    {
+        const TamilSyllable& syllable = c_tamilSyllables.cell[NextRandom() % c_tamilConsonantCount][NextRandom() % c_tamilVowelCount];
+        pText->append(syllable.text, syllable.cch);
+    }
+    uint32_t kind = NextRandom() % 8;
+    if (kind < 3)
+    {
+        pText->push_back(c_tamilConsonants[NextRandom() % c_tamilConsonantCount]);
+        pText->push_back(c_tamilPulli);
+    }
+    else if (kind == 3)
+    {
+        pText->append(c_extras[NextRandom() % (sizeof(c_extras) / sizeof(c_extras[0]))]);
+    }
+}
+
+// Words the encoding has glyphs for, separated by spaces and line ends
+static void MakeText(const LegacyConverter& converter, size_t cch, bool fMostlyAscii, std::u16string* pText)
+{
+    pText->clear();
+    std::u16string word;
+    std::string scratch;
+    while (pText->size() < cch)
+    {
+        word.clear();
+        AppendWord(fMostlyAscii, &word);
+
+        size_t cUnmapped = 0;
+        scratch.resize(LegacyConverter::MaxEncoded(word.size()));
+        converter.Encode(word.data(), word.size(), &scratch[0], scratch.size(), &cUnmapped);
+        if (cUnmapped != 0)
+            continue;
+
+        pText->append(word);
+        pText->push_back(NextRandom() % 12 == 0 ? u'\n' : u' ');
+    }
+}
+
+// An encoding's glyph bytes by the part they play in a visual syllable
+struct VisualGlyphs
+{
+    std::vector<uint8_t> prefixes;      // ெ ே ை
+    std::vector<uint8_t> consonants;    // glyphs ending in a consonant
+    std::vector<uint8_t> others;
+    std::vector<uint8_t> plain;         // bytes that are not glyphs
+    int bAA = -1;                       // ா
+    int bAuLength = -1;                 // ௗ
+};
+
+static void SortGlyphs(const LegacyEncodingTable& table, VisualGlyphs* pGlyphs)
+{
+    for (size_t b = 0; b < 256; b++)
+    {
+        if (table.cch[b] == 0)
+        {
+            pGlyphs->plain.push_back((uint8_t)b);
+            continue;
+        }
+        char16_t chLast = table.text[b][table.cch[b] - 1];
+        if (table.cch[b] == 1 && chLast >= 0x0BC6 && chLast <= 0x0BC8)
+            pGlyphs->prefixes.push_back((uint8_t)b);
+        else if (GetTamilCharInfo(chLast).charClass == TamilClassConsonant)
+            pGlyphs->consonants.push_back((uint8_t)b);
+        else
+            pGlyphs->others.push_back((uint8_t)b);
+        if (table.cch[b] == 1 && chLast == 0x0BBE)
+            pGlyphs->bAA = (int)b;
+        if (table.cch[b] == 1 && chLast == c_tamilAuLength)
+            pGlyphs->bAuLength = (int)b;
+    }
+}
+
+// A visual-order syllable: a prefix sign before a glyph ending in a
+// consonant, with ா or ௗ after it where they combine; or any other glyph;
+// or a byte that is not a glyph
+static void AppendVisualSyllable(const LegacyEncodingTable& table, const VisualGlyphs& glyphs, std::string* pBytes)
+{
+    uint32_t kind = NextRandom() % 8;
+    if (kind < 3)
+    {
+        uint8_t bPrefix = glyphs.prefixes[NextRandom() % glyphs.prefixes.size()];
+        pBytes->push_back((char)bPrefix);
+        pBytes->push_back((char)glyphs.consonants[NextRandom() % glyphs.consonants.size()]);
+        if (table.text[bPrefix][0] != 0x0BC8 && glyphs.bAA >= 0 && NextRandom() % 2 == 0)
+            pBytes->push_back((char)glyphs.bAA);
+        else if (table.text[bPrefix][0] == 0x0BC6 && glyphs.bAuLength >= 0 && NextRandom() % 4 == 0)
+            pBytes->push_back((char)glyphs.bAuLength);
+    }
+    else if (kind < 5)
+    {
+        pBytes->push_back((char)glyphs.consonants[NextRandom() % glyphs.consonants.size()]);
+    }
+    else if (kind < 7)
+    {
+        pBytes->push_back((char)glyphs.others[NextRandom() % glyphs.others.size()]);
+    }
+    else
+    {
+        pBytes->push_back((char)glyphs.plain[NextRandom() % glyphs.plain.size()]);
+    }
+}
+
+// glibc's TSCII converter reorders around the 18 Tamil consonants only,
+// composes the halves of ொ ோ even with no consonant between them, and
+// draws ௌ as ே...ௗ. These compare text the way it would.
+static bool GlibcComparable(const std::string& bytes)
+{
+    for (size_t i = 0; i + 1 < bytes.size(); i++)
+    {
+        if ((uint8_t)bytes[i] >= 0xA6 && (uint8_t)bytes[i] <= 0xA8 && (uint8_t)bytes[i + 1] >= 0x83 && (uint8_t)bytes[i + 1] <= 0x87)
+            return false;
+    }
+    return true;
+}
+
+static std::u16string ComposeSigns(const std::u16string& text)
+{
+    std::u16string composed;
+    for (char16_t ch : text)
+    {
+        char16_t chLast = composed.empty() ? 0 : composed.back();
+        if (ch == 0x0BBE && (chLast == 0x0BC6 || chLast == 0x0BC7))
+            composed.back() = (chLast == 0x0BC6) ? 0x0BCA : 0x0BCB;
+        else if (ch == c_tamilAuLength && (chLast == 0x0BC6 || chLast == 0x0BC7))
+            composed.back() = 0x0BCC;
+        else
+            composed.push_back(ch);
+    }
+    return composed;
+}
+
+static bool GlibcComparable(const std::u16string& word)
+{
+    for (size_t i = 0; i < word.size(); i++)
+    {
+        if (word[i] == 0x0BCC)
+            return false;
+        if (i > 0 && word[i] >= 0x0BC6 && word[i] <= 0x0BCB &&
+            (word[i - 1] == 0x0B9C || (word[i - 1] >= 0x0BB7 && word[i - 1] <= 0x0BB9)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::u16string Decode(const LegacyConverter& converter, const std::string& bytes)
+{
+    std::u16string text(LegacyConverter::MaxDecoded(bytes.size()), 0);
+    size_t cch = converter.Decode(bytes.data(), bytes.size(), &text[0], text.size());
+    text.resize(cch);
+    return text;
+}
+
+static std::string Encode(const LegacyConverter& converter, const std::u16string& text, size_t* pcUnmapped)
+{
+    std::string bytes(LegacyConverter::MaxEncoded(text.size()), 0);
+    size_t cb = converter.Encode(text.data(), text.size(), &bytes[0], bytes.size(), pcUnmapped);
+    bytes.resize(cb);
+    return bytes;
+}
+
+#if defined(__linux__)
+// glibc's converter between TSCII and UTF-16LE, the other way round when
+// fToTscii; false when it has none or stops short
+static bool Iconv(bool fToTscii, const char* pbIn, size_t cbIn, std::string* pOut)
+{
+    iconv_t cd = fToTscii ? iconv_open("TSCII", "UTF-16LE") : iconv_open("UTF-16LE", "TSCII");
+    if (cd == (iconv_t)-1)
+        return false;
+
+    // glibc's TSCII decoder drops the end of a multi-letter glyph when its
+    // internal buffer fills part way through, so the input goes in pieces
+    // ending at a space, small enough never to fill it
+    std::vector<char> block(c_iconvBlock * 4 + 16);
+    pOut->clear();
+    char* pIn = (char*)pbIn;
+    size_t cbLeft = cbIn;
+    size_t result = 0;
+    while (result != (size_t)-1)
+    {
+        size_t cbUnit = fToTscii ? 2 : 1;
+        size_t cbPiece = cbLeft;
+        if (cbPiece > c_iconvBlock)
+        {
+            cbPiece = c_iconvBlock;
+            while (cbPiece > cbUnit && (pIn[cbPiece - cbUnit] != ' ' || pIn[cbPiece - 1] != (cbUnit == 1 ? ' ' : 0)))
+                cbPiece -= cbUnit;
+            if (cbPiece == cbUnit)
+                cbPiece = c_iconvBlock;
+        }
+
+        // The last call, with no input, writes out what glibc holds
+        char* pOutNext = block.data();
+        size_t cbRoom = block.size();
+        size_t cbPieceLeft = cbPiece;
+        result = (cbLeft == 0) ? iconv(cd, NULL, NULL, &pOutNext, &cbRoom) : iconv(cd, &pIn, &cbPieceLeft, &pOutNext, &cbRoom);
+        pOut->append(block.data(), pOutNext - block.data());
+        if (cbLeft == 0)
+            break;
+        cbLeft -= cbPiece - cbPieceLeft;
+    }
+    iconv_close(cd);
+
+    return result != (size_t)-1 && cbLeft == 0;
+}
+#endif
+
+int main(int argc, char** argv)
+{
+    size_t cbBench = c_defaultMiB * 1024 * 1024;
+    if (argc > 1)
+        cbBench = strtoul(argv[1], NULL, 10) * 1024 * 1024;
+
+    size_t cMismatches = 0;
+
+    for (size_t e = 0; e < LegacyEncodingCount; e++)
+    {
+        LegacyConverter converter((LegacyEncodingId)e);
+        const LegacyEncodingTable& table = g_legacyEncodings[e];
+        VisualGlyphs glyphs;
+        SortGlyphs(table, &glyphs);
+
+        // Generated text round trip, through buffers sized by measuring
+        std::u16string text;
+        MakeText(converter, c_roundTripUnits, false, &text);
+        size_t cUnmapped = 0;
+        std::string bytes = Encode(converter, text, &cUnmapped);
+        cMismatches += cUnmapped;
+        cMismatches += converter.Encode(text.data(), text.size(), NULL, 0, NULL) != bytes.size();
+        cMismatches += converter.Decode(bytes.data(), bytes.size(), NULL, 0) != text.size();
+        std::u16string decoded = Decode(converter, bytes);
+        cMismatches += decoded != text;
+
+        // Too small by one: no room, whichever way
+        std::u16string shortText(text.size() - 1, 0);
+        cMismatches += converter.Decode(bytes.data(), bytes.size(), &shortText[0], shortText.size()) != c_legacyNoRoom;
+        std::string shortBytes(bytes.size() - 1, 0);
+        cMismatches += converter.Encode(text.data(), text.size(), &shortBytes[0], shortBytes.size(), NULL) != c_legacyNoRoom;
+        printf("%-8s round trip  %zu units -> %zu bytes\n", c_encodingNames[e], text.size(), bytes.size());
+
+        // Visual-order glyph streams decode to stable text. Random bytes
+        // decode the same split after a pass-through byte, and measure
+        // what they write.
+        size_t cUnstable = 0;
+        for (size_t r = 0; r < c_randomRuns; r++)
+        {
+            std::string visual;
+            for (size_t i = 1 + NextRandom() % 16; i > 0; i--)
+                AppendVisualSyllable(table, glyphs, &visual);
+            std::u16string once = Decode(converter, visual);
+            std::u16string twice = Decode(converter, Encode(converter, once, &cUnmapped));
+            cUnstable += twice != once;
+
+            std::string random(1 + NextRandom() % 48, 0);
+            for (char& b : random)
+                b = (char)NextRandom();
+            once = Decode(converter, random);
+            cMismatches += converter.Decode(random.data(), random.size(), NULL, 0) != once.size();
+            cMismatches += converter.Encode(once.data(), once.size(), NULL, 0, NULL) != Encode(converter, once, NULL).size();
+
+            std::u16string split;
+            size_t ibStart = 0;
+            for (size_t ib = 0; ib < random.size(); ib++)
+            {
+                if (table.cch[(uint8_t)random[ib]] == 0 && NextRandom() % 2 == 0)
+                {
+                    split += Decode(converter, random.substr(ibStart, ib + 1 - ibStart));
+                    ibStart = ib + 1;
+                }
+            }
+            split += Decode(converter, random.substr(ibStart));
+            cMismatches += split != once;
+        }
+        cMismatches += cUnstable;
+        printf("%-8s random      %zu runs, %zu unstable\n", c_encodingNames[e], c_randomRuns, cUnstable);
+
+        // The Bamini layout types what the converter reads
+        if (e == LegacyEncodingBamini)
+        {
+            Transliterator transliterator(LayoutBamini);
+            std::u16string keys(bytes.size(), 0);
+            for (size_t i = 0; i < bytes.size(); i++)
+                keys[i] = (uint8_t)bytes[i];
+            std::u16string typed(Transliterator::MaxOutput(keys.size()), 0);
+            typed.resize(transliterator.Convert(keys.data(), keys.size(), &typed[0], typed.size()));
+            cMismatches += typed != text;
+            printf("%-8s keyboard    %s\n", c_encodingNames[e], (typed == text) ? "same text" : "DIFFERS");
+        }
+
+#if defined(__linux__)
+        if (e == LegacyEncodingTscii)
+        {
+            // Every sequence of up to three bytes from 0x80 up, and 'a' to
+            // stand for ASCII; glibc rejects the ones with 0xA0 or 0xFF
+            std::string expected;
+            size_t cDiffer = 0;
+            size_t cCompared = 0;
+            bool fIconv = true;
+            std::string sequence;
+            for (size_t cb = 1; cb <= 3 && fIconv; cb++)
+            {
+                size_t cSequences = 1;
+                for (size_t i = 0; i < cb; i++)
+                    cSequences *= 129;
+
+                sequence.resize(cb);
+                for (size_t n = 0; n < cSequences; n++)
+                {
+                    for (size_t i = 0, rest = n; i < cb; i++, rest /= 129)
+                        sequence[i] = (char)((rest % 129 == 128) ? 'a' : 0x80 + rest % 129);
+                    if (!GlibcComparable(sequence) || !Iconv(false, sequence.data(), cb, &expected))
+                        continue;
+
+                    std::u16string glibcText((const char16_t*)expected.data(), expected.size() / 2);
+                    cDiffer += ComposeSigns(glibcText) != ComposeSigns(Decode(converter, sequence));
+                    cCompared++;
+                }
+                fIconv = cCompared > 0;
+            }
+
+            // The generated words glibc reorders the same way
+            std::u16string comparable;
+            size_t iWord = 0;
+            for (size_t i = 0; i <= text.size(); i++)
+            {
+                if (i == text.size() || text[i] == ' ' || text[i] == '\n')
+                {
+                    std::u16string word = text.substr(iWord, i - iWord);
+                    if (GlibcComparable(word))
+                        comparable += word + u" ";
+                    iWord = i + 1;
+                }
+            }
+            std::string comparableBytes = Encode(converter, comparable, NULL);
+
+            std::string glibcBytes;
+            fIconv = Iconv(true, (const char*)comparable.data(), comparable.size() * 2, &glibcBytes);
+            if (fIconv)
+            {
+                // glibc writes இ as its second code, 0xFE
+                std::replace(glibcBytes.begin(), glibcBytes.end(), '\xFE', '\xAD');
+                cDiffer += glibcBytes != comparableBytes;
+                fIconv = Iconv(false, comparableBytes.data(), comparableBytes.size(), &expected);
+                std::u16string glibcText((const char16_t*)expected.data(), expected.size() / 2);
+                cDiffer += !fIconv || ComposeSigns(glibcText) != ComposeSigns(comparable);
+            }
+
+            if (fIconv)
+                printf("%-8s glibc       %zu sequences and the text, %s\n", c_encodingNames[e], cCompared, cDiffer ? "DIFFERS" : "same");
+            else
+                printf("%-8s glibc       no TSCII converter\n", c_encodingNames[e]);
+            cMismatches += cDiffer;
+        }
+#endif
+    }
+    printf("mismatches  %zu\n", cMismatches);
+
+    // Throughput, in legacy bytes
+    for (size_t e = 0; e < LegacyEncodingCount; e++)
+    {
+        LegacyConverter converter((LegacyEncodingId)e);
+        for (int fMostlyAscii = 0; fMostlyAscii < 2; fMostlyAscii++)
+        {
+            // Text that encodes to about cbBench bytes
+            std::u16string text;
+            MakeText(converter, cbBench * 3 / 4, fMostlyAscii != 0, &text);
+            std::string bytes(LegacyConverter::MaxEncoded(text.size()), 0);
+            std::u16string decoded(LegacyConverter::MaxDecoded(text.size() * 2), 0);
+
+            double seconds[2] = { 1e9, 1e9 };
+            size_t cb = 0;
+            for (size_t repeat = 0; repeat < c_benchRepeats; repeat++)
+            {
+                auto start = std::chrono::steady_clock::now();
+                cb = converter.Encode(text.data(), text.size(), &bytes[0], bytes.size(), NULL);
+                auto encoded = std::chrono::steady_clock::now();
+                size_t cch = converter.Decode(bytes.data(), cb, &decoded[0], decoded.size());
+                auto done = std::chrono::steady_clock::now();
+                cMismatches += cch != text.size();
+
+                seconds[0] = std::min(seconds[0], std::chrono::duration<double>(encoded - start).count());
+                seconds[1] = std::min(seconds[1], std::chrono::duration<double>(done - encoded).count());
+            }
+
+            printf("%-8s %-8s  %5zu MiB   encode %7.1f MB/s   decode %7.1f MB/s\n",
+                c_encodingNames[e], fMostlyAscii ? "mixed" : "tamil", cb >> 20,
+                cb / seconds[0] / 1e6, cb / seconds[1] / 1e6);
+        }
+    }
+
+    return cMismatches ? 1 : 0;
+}
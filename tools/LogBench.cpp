@@ -0,0 +1,128 @@
+// LogBench.cpp
+// Cost per key of the leveled logging in include/Debug.h. Runs a stand-in
+// for the keystroke path with the log calls OnKeyDown and the edit session
+// make for one key - mostly verbose, a few info, one warning and one error,
+// each with the arguments the real calls pass - at every runtime threshold
+// from none up to the compiled-in maximum, and once with the keystroke and
+// edit-session categories masked out. The same path without any log calls
+// is the baseline. Build once per ANJAL_LOG_MAX_LEVEL to see what each
+// compile-time level costs: with 0 every call is gone, and a level that is
+// compiled in but filtered at runtime should cost a compare per call.
+//
+// Lines that pass the filter go to OutputDebugString; run it outside a
+// debugger and without DebugView, as users do, or that cost dominates.
+//
+// Build:  cl /std:c++17 /EHsc /O2 /DANJAL_LOG_MAX_LEVEL=4 tools\LogBench.cpp     (0-4)
+// Run:    LogBench [keys]
+
+#include "../include/Debug.h"
+#include "BenchUtil.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+static const size_t c_defaultKeys = 100000;
+
+// Log calls per key, by level, in the stand-in below
+static const size_t c_callsPerKey[] = { 0, 1, 1, 2, 20 };
+static const char* const c_levelNames[] = { "none", "error", "warning", "info", "verbose" };
+
+static volatile uint32_t s_sink;
+
+// The work the key path does between its log calls, so the calls are
+// measured in place rather than in an empty loop
+static uint32_t Work(uint32_t key)
+{
+    return (key * 2654435761u) >> 7;
+}
+
+static void KeyWithoutLogging(uint32_t key)
+{
+    uint32_t code = Work(key);
+    uint32_t cch = code & 3;
+    uint32_t hr = Work(code);
+    s_sink = code ^ cch ^ hr;
+}
+
+static void KeyWithLogging(uint32_t key, void* pContext)
+{
+    LogVerbose(LogKeystroke, L"=== OnKeyDown ===");
+    LogVerbose(LogKeystroke, L"  Context: %p", pContext);
+    LogVerbose(LogKeystroke, L"  Virtual Key Code (wParam): 0x%02X (%d)", key & 0xFF, key & 0xFF);
+    LogVerbose(LogKeystroke, L"  lParam: 0x%08X", key);
+    LogVerbose(LogKeystroke, L"    Scan Code: 0x%02X (%d)", (key >> 16) & 0xFF, (key >> 16) & 0xFF);
+    LogVerbose(LogKeystroke, L"    Extended: %d", (key >> 24) & 0x01);
+    LogVerbose(LogKeystroke, L"    Alt Down: %d", (key >> 29) & 0x01);
+    LogInfo(LogKeystroke, L"  Layer: %u", (key >> 30) & 0x03);
+
+    uint32_t code = Work(key);
+    LogVerbose(LogKeystroke, L"  Layout Mapping: U+%04X ('%c')", code & 0xFFFF, code & 0xFFFF);
+    LogVerbose(LogKeystroke, L"  pContext valid: 0x%p", pContext);
+    LogVerbose(LogKeystroke, L"  _tfClientId: 0x%08X", code);
+
+    uint32_t cch = code & 3;
+    LogVerbose(LogKeystroke, L"  Engine output: %d code unit(s)", cch);
+    LogWarning(LogKeystroke, L"  Pending output queue: %u batch(es)", cch);
+
+    uint32_t hr = Work(code);
+    LogVerbose(LogEditSession, L"      DoEditSession START: %u key(s)", cch);
+    LogVerbose(LogEditSession, L"        QI ITfInsertAtSelection: 0x%08X", hr);
+    LogVerbose(LogEditSession, L"        Method: QUERYONLY + SetText + Move cursor");
+    LogVerbose(LogEditSession, L"        InsertTextAtSelection(QUERYONLY): 0x%08X", hr);
+    LogVerbose(LogEditSession, L"        Collapse to START: 0x%08X", hr);
+    LogVerbose(LogEditSession, L"        ShiftStart(-%d chars): 0x%08X, moved=%d", cch, hr, cch);
+    LogError(LogEditSession, L"        SetText: 0x%08X", hr);
+    LogInfo(LogEditSession, L"      Committed: %u unit(s)", cch);
+    LogVerbose(LogEditSession, L"      DoEditSession END: 0x%08X", hr);
+    LogVerbose(LogKeystroke, L"  Action: Successfully inserted Tamil char, ate key");
+    LogVerbose(LogKeystroke, L"=== End OnKeyDown ===");
+    s_sink = code ^ cch ^ hr;
+}
+
+// ns per key of cKeys random keys
+template <typename KeyFunction>
+static double Measure(size_t cKeys, KeyFunction key)
+{
+    SeedRandom();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < cKeys; i++)
+        key(NextRandom());
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / cKeys;
+}
+
+int main(int argc, char** argv)
+{
+    size_t cKeys = (argc > 1) ? strtoul(argv[1], NULL, 10) : c_defaultKeys;
+    if (cKeys == 0)
+    {
+        fprintf(stderr, "usage: LogBench [keys]\n");
+        return 2;
+    }
+
+    int dummy;
+    void* pContext = &dummy;
+    printf("ANJAL_LOG_MAX_LEVEL %d (%s), %zu keys per run\n", ANJAL_LOG_MAX_LEVEL, c_levelNames[ANJAL_LOG_MAX_LEVEL], cKeys);
+
+    double nsBaseline = Measure(cKeys, [](uint32_t key) { KeyWithoutLogging(key); });
+    printf("%-12s %8.1f ns/key\n", "no calls", nsBaseline);
+
+    for (int level = LogLevelNone; level <= ANJAL_LOG_MAX_LEVEL; level++)
+    {
+        size_t cLines = 0;
+        for (int i = LogLevelError; i <= level; i++)
+            cLines += c_callsPerKey[i];
+
+        Debug::SetThreshold((LogLevel)level);
+        Debug::SetCategories(LogAllCategories);
+        double ns = Measure(cKeys, [pContext](uint32_t key) { KeyWithLogging(key, pContext); });
+        printf("%-12s %8.1f ns/key, %+.1f ns over no calls, %zu line(s)/key\n", c_levelNames[level], ns, ns - nsBaseline, cLines);
+    }
+
+    // Everything compiled in passes the threshold, but not the category mask
+    Debug::SetThreshold((LogLevel)ANJAL_LOG_MAX_LEVEL);
+    Debug::SetCategories(LogRegistration | LogLifecycle);
+    double ns = Measure(cKeys, [pContext](uint32_t key) { KeyWithLogging(key, pContext); });
+    printf("%-12s %8.1f ns/key, %+.1f ns over no calls, 0 line(s)/key\n", "masked", ns, ns - nsBaseline);
+    return 0;
+}
@@ -0,0 +1,301 @@
+// ModifierCheck.cpp
+// Runtime checks for the modifier tracker (see include/ModifierTracker.h),
+// beyond the static_asserts there. Events are built as Windows sends them
+// (virtual key plus lParam scan code and flags), and every event may be
+// delivered twice, as TSF does with OnTestKeyDown then OnKeyDown:
+//   - left and right Shift: every sequence of up to 6 presses and releases
+//     in any order, through VK_SHIFT and through VK_LSHIFT / VK_RSHIFT,
+//     with auto-repeat while held, against the set of keys held;
+//   - AltGr arriving as a fake left Ctrl plus right Alt, in both orders of
+//     release, with and without Shift, next to real Ctrl+Alt and the
+//     shortcuts that must not be mapped;
+//   - Caps Lock toggling exactly once per press however long it repeats;
+//   - focus loss: key-ups missed while another window had focus, and state
+//     changed there, repaired by Reset from the system state - including a
+//     press after it that repeats the last event seen.
+//
+// Build:  cl /std:c++17 /EHsc /O2 tools\ModifierCheck.cpp
+//    or:  g++ -std=c++17 -O2 tools/ModifierCheck.cpp -o ModifierCheck
+// Run:    ModifierCheck
+
+#include "../include/ModifierTracker.h"
+
+#include <cstdio>
+#include <string>
+
+static const size_t c_maxShiftEvents = 6;
+
+// Scan codes
+static const uint32_t c_scanLShift = 0x2A;
+static const uint32_t c_scanCtrl = 0x1D;
+static const uint32_t c_scanAlt = 0x38;
+static const uint32_t c_scanCapsLock = 0x3A;
+static const uint32_t c_scanA = 0x1E;
+
+static size_t s_cChecks = 0;
+static size_t s_cFailures = 0;
+
+static void Check(const std::string& what, uint32_t actual, uint32_t expected)
+{
+    s_cChecks++;
+    if (actual != expected)
+    {
+        fprintf(stderr, "%s: bits 0x%02X, expected 0x%02X\n", what.c_str(), actual, expected);
+        s_cFailures++;
+    }
+}
+
+// The layer a character key would use, or -1 for a shortcut
+static int LayerOf(const ModifierTracker& tracker)
+{
+    KeyLayer layer;
+    return tracker.Layer(&layer) ? (int)layer : -1;
+}
+
+static void CheckLayer(const std::string& what, const ModifierTracker& tracker, int expected)
+{
+    s_cChecks++;
+    if (LayerOf(tracker) != expected)
+    {
+        fprintf(stderr, "%s: layer %d, expected %d\n", what.c_str(), LayerOf(tracker), expected);
+        s_cFailures++;
+    }
+}
+
+static intptr_t KeyLParam(uint32_t scan, bool fExtended = false, bool fWasDown = false)
+{
+    return (intptr_t)(scan << 16) | (fExtended ? c_keyFlagExtended : 0) | (fWasDown ? c_keyFlagWasDown : 0);
+}
+
+// One key event, delivered once or twice
+static void Down(ModifierTracker* pTracker, uintptr_t vk, intptr_t lParam, bool fTwice)
+{
+    pTracker->OnKeyDown(vk, lParam);
+    if (fTwice)
+        pTracker->OnKeyDown(vk, lParam);
+}
+
+static void Up(ModifierTracker* pTracker, uintptr_t vk, intptr_t lParam, bool fTwice)
+{
+    pTracker->OnKeyUp(vk, lParam);
+    if (fTwice)
+        pTracker->OnKeyUp(vk, lParam);
+}
+
+// Every sequence of left/right Shift presses and releases. A press of a key
+// already held is an auto-repeat, flagged as Windows flags it.
+static void CheckShift()
+{
+    // Events: 0 left down, 1 left up, 2 right down, 3 right up
+    size_t cSequences = 1;
+    for (size_t cEvents = 1; cEvents <= c_maxShiftEvents; cEvents++)
+    {
+        cSequences *= 4;
+        for (size_t sequence = 0; sequence < cSequences; sequence++)
+        {
+            for (int form = 0; form < 4; form++)
+            {
+                bool fGeneric = (form & 1) != 0;
+                bool fTwice = (form & 2) != 0;
+                ModifierTracker tracker;
+                bool held[2] = {};
+                std::string name = fGeneric ? "VK_SHIFT" : "VK_LSHIFT/VK_RSHIFT";
+
+                size_t events = sequence;
+                for (size_t i = 0; i < cEvents; i++, events /= 4)
+                {
+                    size_t side = (events % 4) / 2;
+                    bool fDown = (events % 2) == 0;
+                    uintptr_t vk = fGeneric ? c_vkShift : (side ? c_vkRShift : c_vkLShift);
+                    intptr_t lParam = KeyLParam(side ? c_scanRShift : c_scanLShift, false, fDown && held[side]);
+
+                    if (fDown)
+                        Down(&tracker, vk, lParam, fTwice);
+                    else
+                        Up(&tracker, vk, lParam, fTwice);
+                    held[side] = fDown;
+                    name += side ? (fDown ? " R+" : " R-") : (fDown ? " L+" : " L-");
+
+                    bool fShift = held[0] || held[1];
+                    Check(name, tracker.Bits(), fShift ? (uint32_t)ModifierShift : 0u);
+                    CheckLayer(name, tracker, fShift ? KeyLayerShift : KeyLayerBase);
+                }
+            }
+        }
+    }
+}
+
+static void CheckAltGr()
+{
+    for (int form = 0; form < 4; form++)
+    {
+        bool fTwice = (form & 1) != 0;
+        bool fSpecific = (form & 2) != 0;
+        uintptr_t vkCtrl = fSpecific ? c_vkLControl : c_vkControl;
+        uintptr_t vkAlt = fSpecific ? c_vkRMenu : c_vkMenu;
+        intptr_t lParamCtrl = KeyLParam(c_scanCtrl);
+        intptr_t lParamAlt = KeyLParam(c_scanAlt, true);
+        std::string name = std::string(fSpecific ? "VK_LCONTROL + VK_RMENU" : "VK_CONTROL + VK_MENU") + (fTwice ? " twice" : "");
+
+        for (int release = 0; release < 2; release++)
+        {
+            ModifierTracker tracker;
+            Down(&tracker, vkCtrl, lParamCtrl, fTwice);
+            Down(&tracker, vkAlt, lParamAlt, fTwice);
+            Check(name + ": AltGr", tracker.Bits(), ModifierCtrl | ModifierAlt | ModifierAltGr);
+            CheckLayer(name + ": AltGr", tracker, KeyLayerAltGr);
+
+            // A character while AltGr is held arrives as WM_KEYDOWN, Alt flag clear
+            Down(&tracker, 'A', KeyLParam(c_scanA), fTwice);
+            Up(&tracker, 'A', KeyLParam(c_scanA), fTwice);
+            Check(name + ": AltGr + key", tracker.Bits(), ModifierCtrl | ModifierAlt | ModifierAltGr);
+
+            // Repeats while held
+            Down(&tracker, vkAlt, lParamAlt | c_keyFlagWasDown, fTwice);
+            Down(&tracker, vkCtrl, lParamCtrl | c_keyFlagWasDown, fTwice);
+            CheckLayer(name + ": AltGr repeating", tracker, KeyLayerAltGr);
+
+            // Shift with AltGr still types the AltGr layer
+            Down(&tracker, c_vkShift, KeyLParam(c_scanLShift), fTwice);
+            CheckLayer(name + ": Shift + AltGr", tracker, KeyLayerAltGr);
+            Up(&tracker, c_vkShift, KeyLParam(c_scanLShift), fTwice);
+
+            if (release == 0)
+            {
+                Up(&tracker, vkAlt, lParamAlt, fTwice);
+                Check(name + ": right Alt up first", tracker.Bits(), ModifierCtrl);
+                CheckLayer(name + ": right Alt up first", tracker, -1);
+                Up(&tracker, vkCtrl, lParamCtrl, fTwice);
+            }
+            else
+            {
+                Up(&tracker, vkCtrl, lParamCtrl, fTwice);
+                Check(name + ": fake Ctrl up first", tracker.Bits(), ModifierAlt | ModifierAltGr);
+                CheckLayer(name + ": fake Ctrl up first", tracker, KeyLayerAltGr);
+                Up(&tracker, vkAlt, lParamAlt, fTwice);
+            }
+            Check(name + ": released", tracker.Bits(), 0);
+            CheckLayer(name + ": released", tracker, KeyLayerBase);
+        }
+    }
+
+    // Left Ctrl + left Alt is AltGr too, as Windows treats it
+    ModifierTracker tracker;
+    tracker.OnKeyDown(c_vkControl, KeyLParam(c_scanCtrl));
+    CheckLayer("Ctrl alone is a shortcut", tracker, -1);
+    tracker.OnKeyDown(c_vkMenu, KeyLParam(c_scanAlt) | c_keyFlagAltDown);
+    Check("Ctrl + left Alt", tracker.Bits(), ModifierCtrl | ModifierAlt);
+    CheckLayer("Ctrl + left Alt", tracker, KeyLayerAltGr);
+    tracker.OnKeyUp(c_vkControl, KeyLParam(c_scanCtrl) | c_keyFlagAltDown);
+    CheckLayer("left Alt alone is a shortcut", tracker, -1);
+    tracker.OnKeyUp(c_vkMenu, KeyLParam(c_scanAlt));
+    Check("Ctrl + left Alt released", tracker.Bits(), 0);
+
+    // Right Ctrl is extended; with right Alt it is still AltGr
+    tracker.OnKeyDown(c_vkControl, KeyLParam(c_scanCtrl, true));
+    tracker.OnKeyDown(c_vkMenu, KeyLParam(c_scanAlt, true));
+    CheckLayer("right Ctrl + right Alt", tracker, KeyLayerAltGr);
+    tracker.OnKeyUp(c_vkControl, KeyLParam(c_scanCtrl, true));
+    tracker.OnKeyUp(c_vkMenu, KeyLParam(c_scanAlt, true));
+    Check("right Ctrl + right Alt released", tracker.Bits(), 0);
+}
+
+static void CheckCapsLock()
+{
+    for (int form = 0; form < 2; form++)
+    {
+        bool fTwice = (form == 1);
+        for (bool fStartOn : { false, true })
+        {
+            ModifierTracker tracker;
+            tracker.Reset(0, fStartOn);
+            bool fOn = fStartOn;
+            for (size_t press = 0; press < 8; press++)
+            {
+                std::string name = "Caps Lock press " + std::to_string(press + 1) + " with " + std::to_string(press) +
+                    " repeats" + (fTwice ? ", delivered twice" : "");
+
+                Down(&tracker, c_vkCapital, KeyLParam(c_scanCapsLock), fTwice);
+                fOn = !fOn;
+                for (size_t repeat = 0; repeat < press; repeat++)
+                {
+                    Down(&tracker, c_vkCapital, KeyLParam(c_scanCapsLock, false, true), fTwice);
+                    Check(name, tracker.Bits(), fOn ? (uint32_t)ModifierCapsLock : 0u);
+                }
+                Up(&tracker, c_vkCapital, KeyLParam(c_scanCapsLock), fTwice);
+                Check(name, tracker.Bits(), fOn ? (uint32_t)ModifierCapsLock : 0u);
+                CheckLayer(name + ": layer", tracker, KeyLayerBase);
+            }
+        }
+    }
+
+    // Caps Lock with Shift held toggles the same way and leaves Shift alone
+    ModifierTracker tracker;
+    tracker.OnKeyDown(c_vkShift, KeyLParam(c_scanLShift));
+    tracker.OnKeyDown(c_vkCapital, KeyLParam(c_scanCapsLock));
+    tracker.OnKeyUp(c_vkCapital, KeyLParam(c_scanCapsLock));
+    Check("Shift + Caps Lock", tracker.Bits(), ModifierShift | ModifierCapsLock);
+}
+
+// Focus leaves while keys are held; their releases, and anything pressed
+// meanwhile, go to another window. OnSetFocus then re-seeds from the
+// system state, as the text service does with GetKeyState.
+static void CheckFocusLoss()
+{
+    ModifierTracker tracker;
+    tracker.OnKeyDown(c_vkShift, KeyLParam(c_scanLShift));
+    tracker.OnKeyDown(c_vkControl, KeyLParam(c_scanCtrl));
+    tracker.OnKeyDown(c_vkMenu, KeyLParam(c_scanAlt, true));
+    Check("held when focus leaves", tracker.Bits(), ModifierShift | ModifierCtrl | ModifierAlt | ModifierAltGr);
+
+    // Without the re-seed the missed releases stick
+    tracker.Reset(0, false);
+    Check("all released elsewhere", tracker.Bits(), 0);
+    CheckLayer("all released elsewhere", tracker, KeyLayerBase);
+
+    // Caps Lock toggled in the other window
+    tracker.Reset(0, true);
+    Check("Caps Lock toggled elsewhere", tracker.Bits(), ModifierCapsLock);
+
+    // Right Shift still held on return, released here
+    tracker.Reset(ModifierTracker::ModifierKeyRShift, true);
+    Check("right Shift held on return", tracker.Bits(), ModifierShift | ModifierCapsLock);
+    CheckLayer("right Shift held on return", tracker, KeyLayerShift);
+    tracker.OnKeyUp(c_vkShift, KeyLParam(c_scanRShift));
+    Check("right Shift released after return", tracker.Bits(), ModifierCapsLock);
+
+    // AltGr held on return
+    tracker.Reset(ModifierTracker::ModifierKeyLCtrl | ModifierTracker::ModifierKeyRAlt, false);
+    CheckLayer("AltGr held on return", tracker, KeyLayerAltGr);
+    tracker.OnKeyUp(c_vkMenu, KeyLParam(c_scanAlt, true));
+    tracker.OnKeyUp(c_vkControl, KeyLParam(c_scanCtrl));
+    Check("AltGr released after return", tracker.Bits(), 0);
+
+    // The last event seen before focus left was a Caps Lock press whose
+    // release went elsewhere. The next press here has the same vk and
+    // lParam; it is a new keystroke, not a second delivery.
+    tracker.Reset(0, false);
+    tracker.OnKeyDown(c_vkCapital, KeyLParam(c_scanCapsLock));
+    Check("Caps Lock before focus leaves", tracker.Bits(), ModifierCapsLock);
+    tracker.Reset(0, true);
+    tracker.OnKeyDown(c_vkCapital, KeyLParam(c_scanCapsLock));
+    tracker.OnKeyDown(c_vkCapital, KeyLParam(c_scanCapsLock));
+    Check("Caps Lock press after return", tracker.Bits(), 0);
+
+    // A letter sent as WM_SYSKEYDOWN proves an Alt press was missed
+    tracker.Reset(0, false);
+    tracker.OnKeyDown('F', KeyLParam(0x21) | c_keyFlagAltDown);
+    Check("Alt press missed", tracker.Bits(), ModifierAlt);
+    CheckLayer("Alt press missed", tracker, -1);
+}
+
+int main()
+{
+    CheckShift();
+    CheckAltGr();
+    CheckCapsLock();
+    CheckFocusLoss();
+
+    printf("modifiers    %zu checks, %zu failures\n", s_cChecks, s_cFailures);
+    return s_cFailures ? 1 : 0;
+}
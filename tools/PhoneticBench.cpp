@@ -0,0 +1,151 @@
+// PhoneticBench.cpp
+// Throughput of the Anjal phonetic engine (see include/PhoneticEngine.h) on
+// multi-megabyte romanized input. The input is real words: the word list,
+// or the Tamil words of the file given, romanized by Romanizer (see
+// include/Romanizer.h). Words the Anjal layout cannot type back to
+// themselves are left out, so the output must equal the Tamil text the
+// input came from - a check that longest match and the backtracking after
+// a failed longer match carry nothing across tokens or words.
+//
+// The input is typed key by key as OnKeyDown does: mapped through the
+// Anjal key tables and fed to the engine, one engine for the whole input;
+// spaces and punctuation are not mapped, end the syllable and are kept.
+// Reports MiB/s of romanized input and ns per key.
+//
+// Build:  cl /std:c++17 /EHsc /O2 tools\PhoneticBench.cpp src\Romanizer.cpp src\KeyboardEngine.cpp src\Tamil99Engine.cpp src\TypewriterEngine.cpp src\PhoneticEngine.cpp src\LayoutRegistry.cpp src\KeyMap*.cpp src\EngineImage.cpp src\EngineImageData.cpp src\Dictionary.cpp
+//    or:  g++ -std=c++17 -O2 tools/PhoneticBench.cpp src/Romanizer.cpp src/KeyboardEngine.cpp src/Tamil99Engine.cpp src/TypewriterEngine.cpp src/PhoneticEngine.cpp src/LayoutRegistry.cpp src/KeyMap*.cpp src/EngineImage.cpp src/EngineImageData.cpp src/Dictionary.cpp -o PhoneticBench
+// Run:    PhoneticBench [MiB [corpus.txt]]     (from the repository root)
+
+#include "../include/KeyboardEngine.h"
+#include "../include/Romanizer.h"
+#include "BenchUtil.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static const size_t c_defaultMiB = 64;
+static const char* const c_defaultCorpus = "tools/TamilWords.txt";
+static const size_t c_wordsPerLine = 12;
+
+static std::string Romanize(Romanizer* pRomanizer, const std::string& word)
+{
+    char buffer[1024];
+    size_t cbRead;
+    size_t cbWritten;
+    std::string roman;
+    pRomanizer->Feed(word.data(), word.size(), &cbRead, buffer, sizeof(buffer), &cbWritten);
+    roman.append(buffer, cbWritten);
+    pRomanizer->Finish(buffer, sizeof(buffer), &cbWritten);
+    roman.append(buffer, cbWritten);
+    return roman;
+}
+
+// Types pchKeys[0..cchKeys) on the engine, writing the document to pchOut,
+// which must have room; returns its length
+static size_t Type(KeyboardEngine* pEngine, const char* pchKeys, size_t cchKeys, char16_t* pchOut)
+{
+    char16_t* pch = pchOut;
+    for (size_t i = 0; i < cchKeys; i++)
+    {
+        uint8_t vk;
+        KeyLayer layer;
+        char16_t code = UsKeyForAscii((char16_t)pchKeys[i], &vk, &layer) ? pEngine->MapKey(layer, vk) : 0;
+
+        EngineOutput output;
+        if (code != 0 && pEngine->ProcessKey(code, &output))
+        {
+            pch -= output.cchDelete;
+            memcpy(pch, output.text, output.cchText * sizeof(char16_t));
+            pch += output.cchText;
+        }
+        else
+        {
+            pEngine->Reset();
+            *pch++ = (char16_t)(uint8_t)pchKeys[i];
+        }
+    }
+    return pch - pchOut;
+}
+
+int main(int argc, char** argv)
+{
+    size_t cbBench = ((argc > 1) ? strtoul(argv[1], NULL, 10) : c_defaultMiB) * 1024 * 1024;
+    const char* corpusPath = (argc > 2) ? argv[2] : c_defaultCorpus;
+
+    std::vector<std::string> corpusWords = ReadWords(corpusPath);
+    if (corpusWords.empty())
+    {
+        fprintf(stderr, "no words in %s\n", corpusPath);
+        return 1;
+    }
+
+    // Romanized words that type back to themselves
+    Romanizer romanizer;
+    KeyboardEngine engine;
+    engine.SetLayout(&g_layouts[LayoutAnjal]);
+
+    std::vector<std::string> romanWords;
+    std::vector<std::u16string> tamilWords;
+    for (const std::string& word : corpusWords)
+    {
+        std::string roman = Romanize(&romanizer, word);
+        std::u16string tamil = ToUtf16(word);
+        std::vector<char16_t> typed(roman.size() * c_engineMaxOutput);
+
+        engine.Reset();
+        size_t cchTyped = Type(&engine, roman.data(), roman.size(), typed.data());
+        if (tamil.compare(0, tamil.size(), typed.data(), cchTyped) == 0)
+        {
+            romanWords.push_back(roman);
+            tamilWords.push_back(tamil);
+        }
+    }
+    if (romanWords.empty())
+    {
+        fprintf(stderr, "no word in %s can be typed on the Anjal layout\n", corpusPath);
+        return 1;
+    }
+
+    // The input and the text it must give
+    std::string input;
+    std::u16string expected;
+    size_t cWords = 0;
+    while (input.size() < cbBench)
+    {
+        size_t i = NextRandom() % romanWords.size();
+        const char* pszSeparator = (++cWords % c_wordsPerLine == 0) ? ".\n" : " ";
+        input += romanWords[i];
+        input += pszSeparator;
+        expected += tamilWords[i];
+        expected.append(pszSeparator, pszSeparator + strlen(pszSeparator));
+    }
+
+    // Every key yields at least one unit less what it deletes, so the
+    // document never outgrows the input
+    std::vector<char16_t> document(input.size() + c_engineMaxOutput);
+    engine.Reset();
+    auto start = std::chrono::steady_clock::now();
+    size_t cchDocument = Type(&engine, input.data(), input.size(), document.data());
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t cMismatches = 0;
+    if (expected.compare(0, expected.size(), document.data(), cchDocument) != 0)
+    {
+        size_t ich = 0;
+        while (ich < expected.size() && ich < cchDocument && expected[ich] == document[ich])
+            ich++;
+        fprintf(stderr, "output differs from the source text at unit %zu\n", ich);
+        cMismatches++;
+    }
+
+    printf("corpus       %zu of %zu words from %s type back, %.1f MiB romanized -> %zu units\n",
+        romanWords.size(), corpusWords.size(), corpusPath, input.size() / 1048576.0, cchDocument);
+    printf("anjal        %.1f MiB/s, %.2f ns/key\n", input.size() / 1048576.0 / seconds, seconds * 1e9 / input.size());
+    printf("mismatches   %zu\n", cMismatches);
+    return cMismatches ? 1 : 0;
+}
@@ -0,0 +1,335 @@
+// RomanizeBench.cpp
+// Round-trip check and throughput for Romanizer (see include/Romanizer.h).
+//   - Words of every one and two syllables, three-syllable words of
+//     consonants with pulli, அ and ஐ, and random longer words are
+//     romanized and typed back on the Anjal layout through Transliterator;
+//     every word the layout can type must come back to itself. The ones it
+//     cannot (a vowel letter inside a word, a word-initial ன, ன்த, ன்ஜ)
+//     are counted apart.
+//   - Decomposed ொ ோ ௌ ஔ must romanize as the composed letters.
+//   - Test texts cut at every byte offset, and into random fragments, fed
+//     through output buffers from 4 bytes up, must equal feeding them whole.
+// Then a Tamil corpus - words from the word list, or from the file given -
+// is romanized in 64 KiB pieces and the throughput reported.
+//
+// Build:  cl /std:c++17 /EHsc /O2 tools\RomanizeBench.cpp src\Romanizer.cpp src\TransliteratorStream.cpp src\Transliterator.cpp src\TamilScan.cpp src\KeyboardEngine.cpp src\Tamil99Engine.cpp src\TypewriterEngine.cpp src\PhoneticEngine.cpp src\LayoutRegistry.cpp src\KeyMap*.cpp src\EngineImage.cpp src\EngineImageData.cpp src\Dictionary.cpp
+//    or:  g++ -std=c++17 -O2 tools/RomanizeBench.cpp src/Romanizer.cpp src/TransliteratorStream.cpp src/Transliterator.cpp src/TamilScan.cpp src/KeyboardEngine.cpp src/Tamil99Engine.cpp src/TypewriterEngine.cpp src/PhoneticEngine.cpp src/LayoutRegistry.cpp src/KeyMap*.cpp src/EngineImage.cpp src/EngineImageData.cpp src/Dictionary.cpp -o RomanizeBench
+// Run:    RomanizeBench [MiB [corpus.txt]]     (from the repository root)
+
+#include "../include/Romanizer.h"
+#include "BenchUtil.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static const size_t c_defaultMiB = 64;
+static const char* const c_defaultCorpus = "tools/TamilWords.txt";
+static const size_t c_pieceBytes = 64 * 1024;
+static const size_t c_randomWords = 1000000;
+static const size_t c_randomSplits = 2000;
+
+// Test texts for the split check: Tamil prose, decomposed signs, clusters
+// that fall back to letters, Latin and Tamil digits, a character outside
+// the BMP, and malformed UTF-8 (a stray continuation, an overlong form, a
+// surrogate, and a sequence cut off by the end of the text)
+static const char* const c_texts[] =
+{
+    "வணக்கம், என்னுடைய பெயர் குமார். நான் சென்னையில் இருக்கிறேன்.\r\nஉங்கள் பெயர் என்ன? 2024-இல் தமிழ் கற்கிறேன்!",
+    "கொ கோ கௌ ஔ பண்ட்ர ஸ்ரீ க்ஷ அஃது ட்ஹ ச்ஹ ந்ட் நந்தன் \xF0\x9F\x98\x80 ௧௨௩ abc",
+    "bad \x80 bytes \xC0\xAF over\xED\xA0\x80long கா\xE0\xAE cut \xE0\xAE",
+};
+
+// Feeds in[0..) in the fragments that end at cuts (ascending, ending with
+// in.size()) through an output buffer of cbOut bytes, then finishes
+static std::string FeedSplit(Romanizer* pRomanizer, const std::string& in, const std::vector<size_t>& cuts, size_t cbOut)
+{
+    std::vector<char> buffer(cbOut);
+    std::string out;
+    size_t ib = 0;
+    for (size_t ibCut : cuts)
+    {
+        while (ib < ibCut)
+        {
+            size_t cbRead;
+            size_t cbWritten;
+            pRomanizer->Feed(in.data() + ib, ibCut - ib, &cbRead, buffer.data(), cbOut, &cbWritten);
+            out.append(buffer.data(), cbWritten);
+            ib += cbRead;
+        }
+    }
+
+    size_t cbWritten;
+    while (pRomanizer->Finish(buffer.data(), cbOut, &cbWritten) == StreamOutputNeeded)
+        out.append(buffer.data(), cbWritten);
+    out.append(buffer.data(), cbWritten);
+    return out;
+}
+
+// A syllable of a generated word: a consonant with a vowel or pulli, a
+// vowel letter, or ஃ
+struct WordSyllable
+{
+    int consonant;      // index into c_tamilConsonants, -1 for a vowel letter, -2 for ஃ
+    int vowel;          // index into c_tamilVowels, -1 for pulli
+};
+
+static void AppendSyllable(const WordSyllable& syllable, std::u16string* pText)
+{
+    if (syllable.consonant == -2)
+    {
+        pText->push_back(c_tamilAytham);
+    }
+    else if (syllable.consonant == -1)
+    {
+        pText->push_back(c_tamilVowels[syllable.vowel]);
+    }
+    else
+    {
+        pText->push_back(c_tamilConsonants[syllable.consonant]);
+        if (syllable.vowel < 0)
+            pText->push_back(c_tamilPulli);
+        else if (c_tamilVowelSigns[syllable.vowel])
+            pText->push_back(c_tamilVowelSigns[syllable.vowel]);
+    }
+}
+
+// False for words the Anjal layout cannot type: a vowel letter after a
+// letter (the two join, as "a" "i" is ai), ன starting a word (typed n, it
+// is ந there), and ன் before த or ஜ (n th is nth, n j is nj)
+static bool Typable(const std::vector<WordSyllable>& word)
+{
+    static const int c_consonantNnna = 17;     // ன
+    static const int c_consonantTha = 6;       // த
+    static const int c_consonantJa = 18;       // ஜ
+
+    for (size_t i = 0; i < word.size(); i++)
+    {
+        if (i > 0 && word[i].consonant == -1 && word[i - 1].consonant != -2)
+            return false;
+        if (i == 0 && word[i].consonant == c_consonantNnna)
+            return false;
+        if (i > 0 && word[i - 1].consonant == c_consonantNnna && word[i - 1].vowel < 0 &&
+            (word[i].consonant == c_consonantTha || word[i].consonant == c_consonantJa))
+            return false;
+    }
+    return true;
+}
+
+// Romanizes the words, space-separated, and types the result back on the
+// Anjal layout. Returns the typable words that did not come back.
+static size_t RoundTrip(Romanizer* pRomanizer, const Transliterator& anjal, const std::vector<std::vector<WordSyllable>>& words, size_t* pcUntypable)
+{
+    std::u16string text;
+    for (const std::vector<WordSyllable>& word : words)
+    {
+        for (const WordSyllable& syllable : word)
+            AppendSyllable(syllable, &text);
+        text.push_back(' ');
+    }
+
+    std::string roman = FeedSplit(pRomanizer, ToUtf8(text), { ToUtf8(text).size() }, c_pieceBytes);
+    std::u16string keys(roman.begin(), roman.end());
+    std::u16string typed(Transliterator::MaxOutput(keys.size()), 0);
+    typed.resize(anjal.Convert(keys.data(), keys.size(), &typed[0], typed.size()));
+
+    // Spaces pass through both ways, so the words line up
+    size_t cFailed = 0;
+    size_t ichText = 0;
+    size_t ichTyped = 0;
+    size_t ibRoman = 0;
+    for (const std::vector<WordSyllable>& word : words)
+    {
+        size_t ichTextEnd = text.find(' ', ichText);
+        size_t ichTypedEnd = typed.find(' ', ichTyped);
+        size_t ibRomanEnd = roman.find(' ', ibRoman);
+        if (ichTypedEnd == std::u16string::npos)
+            return cFailed + 1;
+
+        if (!Typable(word))
+        {
+            (*pcUntypable)++;
+        }
+        else if (text.compare(ichText, ichTextEnd - ichText, typed, ichTyped, ichTypedEnd - ichTyped) != 0)
+        {
+            if (cFailed < 10)
+            {
+                fprintf(stderr, "round trip: %s -> %s -> %s\n", ToUtf8(text.substr(ichText, ichTextEnd - ichText)).c_str(),
+                    roman.substr(ibRoman, ibRomanEnd - ibRoman).c_str(), ToUtf8(typed.substr(ichTyped, ichTypedEnd - ichTyped)).c_str());
+            }
+            cFailed++;
+        }
+        ichText = ichTextEnd + 1;
+        ichTyped = ichTypedEnd + 1;
+        ibRoman = ibRomanEnd + 1;
+    }
+    return cFailed;
+}
+
+int main(int argc, char** argv)
+{
+    size_t cbBench = ((argc > 1) ? strtoul(argv[1], NULL, 10) : c_defaultMiB) * 1024 * 1024;
+    const char* corpusPath = (argc > 2) ? argv[2] : c_defaultCorpus;
+    static const size_t c_outputSizes[] = { 4, 5, 7, 64, 4096 };
+
+    Romanizer romanizer;
+    Transliterator anjal(LayoutAnjal);
+    size_t cMismatches = 0;
+
+    // Every syllable
+    std::vector<WordSyllable> syllables;
+    for (int v = 0; v < (int)c_tamilVowelCount; v++)
+        syllables.push_back({ -1, v });
+    for (int c = 0; c < (int)c_tamilConsonantCount; c++)
+    {
+        syllables.push_back({ c, -1 });
+        for (int v = 0; v < (int)c_tamilVowelCount; v++)
+            syllables.push_back({ c, v });
+    }
+    syllables.push_back({ -2, 0 });
+
+    std::vector<std::vector<WordSyllable>> words;
+    size_t cUntypable = 0;
+    size_t cWords = 0;
+    for (const WordSyllable& first : syllables)
+    {
+        words.push_back({ first });
+        for (const WordSyllable& second : syllables)
+            words.push_back({ first, second });
+    }
+    cMismatches += RoundTrip(&romanizer, anjal, words, &cUntypable);
+    cWords += words.size();
+
+    // Three consonants in a row, with pulli, அ or ஐ
+    words.clear();
+    std::vector<WordSyllable> consonants;
+    for (const WordSyllable& syllable : syllables)
+    {
+        if (syllable.consonant >= 0 && (syllable.vowel == -1 || syllable.vowel == 0 || syllable.vowel == 8))
+            consonants.push_back(syllable);
+    }
+    for (const WordSyllable& first : consonants)
+    {
+        for (const WordSyllable& second : consonants)
+        {
+            for (const WordSyllable& third : consonants)
+                words.push_back({ first, second, third });
+        }
+    }
+    cMismatches += RoundTrip(&romanizer, anjal, words, &cUntypable);
+    cWords += words.size();
+
+    words.clear();
+    for (size_t i = 0; i < c_randomWords; i++)
+    {
+        std::vector<WordSyllable> word;
+        for (size_t j = 3 + NextRandom() % 6; j > 0; j--)
+            word.push_back(syllables[NextRandom() % syllables.size()]);
+        words.push_back(word);
+    }
+    cMismatches += RoundTrip(&romanizer, anjal, words, &cUntypable);
+    cWords += words.size();
+    printf("round trip   %zu words, %zu the layout cannot type\n", cWords, cUntypable);
+
+    // Decomposed and composed signs
+    static const char* const c_decomposed[][2] =
+    {
+        { "\xE0\xAE\x95\xE0\xAF\x86\xE0\xAE\xBE", "\xE0\xAE\x95\xE0\xAF\x8A" },    // க ெ ா, கொ
+        { "\xE0\xAE\x95\xE0\xAF\x87\xE0\xAE\xBE", "\xE0\xAE\x95\xE0\xAF\x8B" },    // க ே ா, கோ
+        { "\xE0\xAE\x95\xE0\xAF\x86\xE0\xAF\x97", "\xE0\xAE\x95\xE0\xAF\x8C" },    // க ெ ௗ, கௌ
+        { "\xE0\xAE\x92\xE0\xAF\x97", "\xE0\xAE\x94" },                        // ஒ ௗ, ஔ
+    };
+    for (const auto& pair : c_decomposed)
+    {
+        std::string decomposed = pair[0];
+        std::string composed = pair[1];
+        if (FeedSplit(&romanizer, decomposed, { decomposed.size() }, 4096) != FeedSplit(&romanizer, composed, { composed.size() }, 4096))
+        {
+            fprintf(stderr, "decomposed signs romanize differently\n");
+            cMismatches++;
+        }
+    }
+
+    // Every byte offset, through every output size, and many fragments
+    size_t cRuns = 0;
+    for (size_t t = 0; t < sizeof(c_texts) / sizeof(c_texts[0]); t++)
+    {
+        std::string in = c_texts[t];
+        std::string whole = FeedSplit(&romanizer, in, { in.size() }, 4096);
+        for (size_t ibCut = 0; ibCut <= in.size(); ibCut++)
+        {
+            for (size_t cbOut : c_outputSizes)
+            {
+                cRuns++;
+                if (FeedSplit(&romanizer, in, { ibCut, in.size() }, cbOut) != whole)
+                {
+                    fprintf(stderr, "text %zu: differs when cut at %zu with %zu-byte output\n", t, ibCut, cbOut);
+                    cMismatches++;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < c_randomSplits; i++)
+        {
+            std::vector<size_t> cuts;
+            size_t ib = 0;
+            while (ib < in.size())
+            {
+                ib += NextRandom() % 8;
+                cuts.push_back(ib < in.size() ? ib : in.size());
+            }
+            cuts.push_back(in.size());
+
+            cRuns++;
+            if (FeedSplit(&romanizer, in, cuts, c_outputSizes[i % 5]) != whole)
+            {
+                fprintf(stderr, "text %zu: differs on random fragments (run %zu)\n", t, i);
+                cMismatches++;
+            }
+        }
+    }
+    printf("split check  %zu runs\n", cRuns);
+    printf("mismatches   %zu\n", cMismatches);
+
+    // Throughput: the corpus in pieces through an output buffer of the same size
+    std::vector<std::string> corpusWords = ReadWords(corpusPath);
+    if (corpusWords.empty())
+    {
+        fprintf(stderr, "no words in %s\n", corpusPath);
+        return 1;
+    }
+
+    std::string corpus;
+    size_t cCorpusWords = 0;
+    while (corpus.size() < cbBench)
+    {
+        corpus += corpusWords[NextRandom() % corpusWords.size()];
+        corpus += (++cCorpusWords % 12 == 0) ? ".\n" : " ";
+    }
+
+    std::vector<char> buffer(c_pieceBytes);
+    uint64_t cbOut = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t ib = 0; ib < corpus.size(); )
+    {
+        size_t cbRead;
+        size_t cbWritten;
+        romanizer.Feed(corpus.data() + ib, std::min(c_pieceBytes, corpus.size() - ib), &cbRead, buffer.data(), buffer.size(), &cbWritten);
+        cbOut += cbWritten;
+        ib += cbRead;
+    }
+    size_t cbWritten;
+    while (romanizer.Finish(buffer.data(), buffer.size(), &cbWritten) == StreamOutputNeeded)
+        cbOut += cbWritten;
+    cbOut += cbWritten;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("corpus       %zu words from %s, %.1f MiB -> %.1f MiB\n", corpusWords.size(), corpusPath, corpus.size() / 1048576.0, cbOut / 1048576.0);
+    printf("romanize     %.1f MiB/s (%zu-byte pieces and output)\n", corpus.size() / 1048576.0 / seconds, c_pieceBytes);
+
+    return cMismatches ? 1 : 0;
+}
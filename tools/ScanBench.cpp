@@ -0,0 +1,304 @@
+// ScanBench.cpp
+// Equivalence check and benchmark for the Tamil scanning kernels (see
+// include/TamilScan.h). Every kernel set this CPU runs is checked against
+// the scalar one:
+//   - classes of all 65,536 code units, at every alignment;
+//   - cluster starts for every unit after every unit (all 2^32 pairs);
+//   - the ASCII search for every unit at every vector lane;
+//   - ASCII widening and narrowing for every byte / unit at every lane;
+//   - random mixed text of every length up to 256, at random offsets.
+// Then each set classifies, marks clusters in, and searches generated Tamil
+// text, and widens and narrows ASCII; throughput is reported next to the
+// scalar kernels'.
+//
+// Build:  cl /std:c++17 /EHsc /O2 tools\ScanBench.cpp src\TamilScan.cpp
+//    or:  g++ -std=c++17 -O2 tools/ScanBench.cpp src/TamilScan.cpp -o ScanBench
+// Run:    ScanBench [units]        (-q skips the 2^32 pair sweep)
+
+#include "../include/TamilScan.h"
+#include "BenchUtil.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static const size_t c_defaultUnits = 16 * 1024 * 1024;
+static const size_t c_maxKernels = 4;
+static const size_t c_randomRuns = 200000;
+static const size_t c_benchRepeats = 5;
+
+// Units that exercise the rules: the Tamil block, ASCII, CR LF, the other
+// combining ranges and their edges, surrogates, and anything at all
+static char16_t RandomUnit()
+{
+    static const char16_t c_edges[] =
+    {
+        0x0D, 0x0A, 0x7F, 0x80, 0x02FF, 0x0300, 0x036F, 0x0370, 0x0B7F, 0x0B80, 0x0B82, 0x0BFF, 0x0C00,
+        0x200B, 0x200C, 0x200D, 0x200E, 0xD7FF, 0xD800, 0xDBFF, 0xDC00, 0xDFFF, 0xE000, 0xFDFF, 0xFE00, 0xFE0F, 0xFE10, 0xFFFF
+    };
+
+    uint32_t kind = NextRandom() % 8;
+    if (kind < 3)
+        return (char16_t)(c_tamilBlockStart + NextRandom() % 128);
+    if (kind == 3)
+        return (char16_t)(NextRandom() % 128);
+    if (kind < 6)
+        return c_edges[NextRandom() % (sizeof(c_edges) / sizeof(c_edges[0]))];
+    return (char16_t)NextRandom();
+}
+
+static size_t ReferenceFindAscii(const char16_t* pch, size_t cch)
+{
+    size_t i = 0;
+    while (i < cch && pch[i] >= 0x80)
+        i++;
+    return i;
+}
+
+// Generated text: Tamil words from the syllable matrix, with pulli, some
+// ASCII punctuation and digits, and line ends
+static void MakeText(size_t cch, std::vector<char16_t>* pText)
+{
+    pText->clear();
+    while (pText->size() < cch)
+    {
+        for (size_t i = 1 + NextRandom() % 4; i > 0; i--)
+        {
+            const TamilSyllable& syllable = c_tamilSyllables.cell[NextRandom() % c_tamilConsonantCount][NextRandom() % c_tamilVowelCount];
+            pText->insert(pText->end(), syllable.text, syllable.text + syllable.cch);
+        }
+        if (NextRandom() % 3 == 0)
+        {
+            pText->push_back(c_tamilConsonants[NextRandom() % c_tamilConsonantCount]);
+            pText->push_back(c_tamilPulli);
+        }
+
+        uint32_t kind = NextRandom() % 16;
+        if (kind == 0)
+            pText->push_back(',');
+        else if (kind == 1)
+            pText->push_back('1');
+        pText->push_back(NextRandom() % 12 == 0 ? '\n' : ' ');
+    }
+    pText->resize(cch);
+}
+
+int main(int argc, char** argv)
+{
+    size_t cchBench = c_defaultUnits;
+    bool fPairs = true;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-q") == 0)
+            fPairs = false;
+        else
+            cchBench = strtoul(argv[i], NULL, 10);
+    }
+
+    const TamilScanKernels* apKernels[c_maxKernels];
+    size_t cKernels = TamilScanAvailable(apKernels, c_maxKernels);
+    printf("kernels     ");
+    for (size_t k = 0; k < cKernels; k++)
+        printf("%s%s", apKernels[k]->name, (apKernels[k] == &TamilScan()) ? " (selected) " : " ");
+    printf("\n");
+
+    size_t cMismatches = 0;
+
+    // Classes of every unit, at every alignment and with every tail length
+    std::vector<char16_t> all(65536 + 64);
+    for (size_t i = 0; i < all.size(); i++)
+        all[i] = (char16_t)i;
+    std::vector<uint8_t> classes(all.size());
+    std::vector<uint8_t> expected(all.size());
+    for (size_t k = 0; k < cKernels; k++)
+    {
+        for (size_t ich = 0; ich < 64; ich++)
+        {
+            size_t cch = 65536 - (ich & 31);
+            apKernels[k]->pfnClassify(all.data() + ich, cch, classes.data());
+            for (size_t i = 0; i < cch; i++)
+                cMismatches += classes[i] != GetTamilCharInfo(all[ich + i]).charClass;
+        }
+    }
+    printf("classes     all units, 64 offsets\n");
+
+    // Cluster starts for every pair: for each unit before, every unit after
+    // it, interleaved. An odd unit before gets one more unit in front, so
+    // the pairs land on odd lanes as well as even ones.
+    if (fPairs)
+    {
+        std::vector<char16_t> pairs(2 * 65536 + 1);
+        std::vector<uint8_t> starts(pairs.size());
+        for (uint32_t before = 0; before < 65536; before++)
+        {
+            size_t ich = before & 1;
+            for (uint32_t ch = 0; ch < 65536; ch++)
+            {
+                pairs[ich + 2 * ch] = (char16_t)before;
+                pairs[ich + 2 * ch + 1] = (char16_t)ch;
+            }
+            if (ich == 1)
+                pairs[0] = (char16_t)NextRandom();
+
+            // The scalar rule is the reference
+            for (uint32_t ch = 0; ch < 65536; ch++)
+                expected[ch] = TamilContinuesCluster((char16_t)before, (char16_t)ch) ? 0 : 1;
+            for (size_t k = 1; k < cKernels; k++)
+            {
+                apKernels[k]->pfnClusterStarts(pairs.data(), pairs.size() - 1 + ich, 0, starts.data());
+                for (uint32_t ch = 0; ch < 65536; ch++)
+                    cMismatches += starts[ich + 2 * ch + 1] != expected[ch];
+            }
+        }
+        printf("clusters    all 2^32 pairs\n");
+    }
+
+    // The ASCII search, for every unit at every lane of the widest kernel
+    std::vector<char16_t> run(48, 0x0B95);
+    for (size_t k = 0; k < cKernels; k++)
+    {
+        for (uint32_t ch = 0; ch < 65536; ch++)
+        {
+            for (size_t i = 0; i < 40; i++)
+            {
+                run[i] = (char16_t)ch;
+                size_t found = apKernels[k]->pfnFindAscii(run.data(), 40);
+                cMismatches += found != ((ch < 0x80) ? i : 40);
+                run[i] = 0x0B95;
+            }
+        }
+    }
+    printf("ascii       all units, 40 lanes\n");
+
+    // Widening and narrowing stop at the first byte / unit past ASCII and
+    // write nothing beyond it: every unit at a lane of its own, the edges
+    // at every lane
+    std::vector<uint8_t> bytes(72);
+    std::vector<char16_t> units(72);
+    for (size_t i = 0; i < 72; i++)
+    {
+        bytes[i] = (uint8_t)(' ' + i);
+        units[i] = (char16_t)(' ' + i);
+    }
+    std::vector<uint8_t> narrowed(72);
+    std::vector<char16_t> widened(72);
+    static const char16_t c_asciiEdges[] = { 0x00, 0x7F, 0x80, 0xFF, 0x100, 0x0B95, 0x7F7F, 0x8080, 0xFF7F, 0xFFFF };
+    for (size_t k = 0; k < cKernels; k++)
+    {
+        for (uint32_t n = 0; n < 65536 + 72 * 10; n++)
+        {
+            char16_t ch = (n < 65536) ? (char16_t)n : c_asciiEdges[(n - 65536) / 72];
+            size_t i = (n < 65536) ? n % 72 : (n - 65536) % 72;
+            size_t expectedRun = (ch < 0x80) ? 72 : i;
+
+            units[i] = ch;
+            std::fill(narrowed.begin(), narrowed.end(), 0xEE);
+            cMismatches += apKernels[k]->pfnNarrowAscii(units.data(), 72, narrowed.data()) != expectedRun;
+            for (size_t j = 0; j < 72; j++)
+                cMismatches += narrowed[j] != ((j < expectedRun) ? (uint8_t)units[j] : 0xEE);
+            units[i] = (char16_t)(' ' + i);
+
+            if (ch < 256)
+            {
+                bytes[i] = (uint8_t)ch;
+                std::fill(widened.begin(), widened.end(), 0xEEEE);
+                cMismatches += apKernels[k]->pfnWidenAscii(bytes.data(), 72, widened.data()) != expectedRun;
+                for (size_t j = 0; j < 72; j++)
+                    cMismatches += widened[j] != ((j < expectedRun) ? (char16_t)bytes[j] : 0xEEEE);
+                bytes[i] = (uint8_t)(' ' + i);
+            }
+        }
+    }
+    printf("widen       all bytes and units, edges at 72 lanes\n");
+
+    // Random mixed text, every length, random offset and unit before
+    std::vector<char16_t> text(256 + 32);
+    std::vector<uint8_t> got(text.size());
+    for (size_t r = 0; r < c_randomRuns; r++)
+    {
+        for (char16_t& ch : text)
+            ch = RandomUnit();
+        size_t ich = NextRandom() % 32;
+        size_t cch = r % 257;
+        char16_t chBefore = (r & 1) ? RandomUnit() : 0;
+
+        for (size_t i = 0; i < cch; i++)
+            expected[i] = TamilContinuesCluster(i ? text[ich + i - 1] : chBefore, text[ich + i]) ? 0 : 1;
+        size_t expectedAscii = ReferenceFindAscii(text.data() + ich, cch);
+        size_t expectedRun = 0;
+        while (expectedRun < cch && text[ich + expectedRun] < 0x80)
+            expectedRun++;
+
+        for (size_t k = 0; k < cKernels; k++)
+        {
+            apKernels[k]->pfnClassify(text.data() + ich, cch, got.data());
+            for (size_t i = 0; i < cch; i++)
+                cMismatches += got[i] != GetTamilCharInfo(text[ich + i]).charClass;
+
+            apKernels[k]->pfnClusterStarts(text.data() + ich, cch, chBefore, got.data());
+            cMismatches += memcmp(got.data(), expected.data(), cch) != 0;
+
+            cMismatches += apKernels[k]->pfnFindAscii(text.data() + ich, cch) != expectedAscii;
+
+            cMismatches += apKernels[k]->pfnNarrowAscii(text.data() + ich, cch, got.data()) != expectedRun;
+            for (size_t i = 0; i < expectedRun; i++)
+                cMismatches += got[i] != text[ich + i];
+        }
+    }
+    printf("random      %zu runs\n", c_randomRuns);
+    printf("mismatches  %zu\n", cMismatches);
+
+    // Throughput on generated text; the ASCII search runs over Tamil only
+    std::vector<char16_t> bench;
+    MakeText(cchBench, &bench);
+    std::vector<char16_t> tamil(cchBench, 0x0B95);
+    std::vector<uint8_t> out(cchBench);
+    std::vector<uint8_t> ascii(cchBench);
+    for (size_t i = 0; i < cchBench; i++)
+        ascii[i] = (uint8_t)(' ' + i % 95);
+    std::vector<char16_t> asciiUnits(cchBench);
+
+    double scalarSeconds[5] = {};
+    for (size_t k = 0; k < cKernels; k++)
+    {
+        double seconds[5] = { 1e9, 1e9, 1e9, 1e9, 1e9 };
+        for (size_t repeat = 0; repeat < c_benchRepeats; repeat++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            apKernels[k]->pfnClassify(bench.data(), bench.size(), out.data());
+            auto classified = std::chrono::steady_clock::now();
+            apKernels[k]->pfnClusterStarts(bench.data(), bench.size(), 0, out.data());
+            auto marked = std::chrono::steady_clock::now();
+            size_t found = apKernels[k]->pfnFindAscii(tamil.data(), tamil.size());
+            auto searched = std::chrono::steady_clock::now();
+            cMismatches += found != tamil.size();
+            cMismatches += apKernels[k]->pfnWidenAscii(ascii.data(), ascii.size(), asciiUnits.data()) != ascii.size();
+            auto widenedAll = std::chrono::steady_clock::now();
+            cMismatches += apKernels[k]->pfnNarrowAscii(asciiUnits.data(), asciiUnits.size(), out.data()) != ascii.size();
+            auto narrowedAll = std::chrono::steady_clock::now();
+
+            seconds[0] = std::min(seconds[0], std::chrono::duration<double>(classified - start).count());
+            seconds[1] = std::min(seconds[1], std::chrono::duration<double>(marked - classified).count());
+            seconds[2] = std::min(seconds[2], std::chrono::duration<double>(searched - marked).count());
+            seconds[3] = std::min(seconds[3], std::chrono::duration<double>(widenedAll - searched).count());
+            seconds[4] = std::min(seconds[4], std::chrono::duration<double>(narrowedAll - widenedAll).count());
+        }
+        if (k == 0)
+            memcpy(scalarSeconds, seconds, sizeof(seconds));
+
+        printf("%-10s  classify %6.2f Gunit/s (x%4.1f)   clusters %6.2f Gunit/s (x%4.1f)   ascii %6.2f Gunit/s (x%4.1f)\n",
+            apKernels[k]->name,
+            cchBench / seconds[0] / 1e9, scalarSeconds[0] / seconds[0],
+            cchBench / seconds[1] / 1e9, scalarSeconds[1] / seconds[1],
+            cchBench / seconds[2] / 1e9, scalarSeconds[2] / seconds[2]);
+        printf("%-10s  widen    %6.2f Gunit/s (x%4.1f)   narrow   %6.2f Gunit/s (x%4.1f)\n",
+            "",
+            cchBench / seconds[3] / 1e9, scalarSeconds[3] / seconds[3],
+            cchBench / seconds[4] / 1e9, scalarSeconds[4] / seconds[4]);
+    }
+
+    return cMismatches ? 1 : 0;
+}
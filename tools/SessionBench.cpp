@@ -0,0 +1,146 @@
+// SessionBench.cpp
+// Edit sessions per 1,000 keys with the pending-output queue (see
+// include/PendingOutput.h). Generated input is typed on every layout
+// through KeyboardEngine into a mock context that, like a busy
+// application, runs the edit sessions queued for it only every N keys.
+// Each key's engine output goes into the queue as OnKeyDown does: merged
+// into the newest batch while its session has not started, else a new
+// batch and a new session request. A session takes its batch, applies it
+// to the document with one replace and completes it. Keys the layout does
+// not map are not eaten; the mock application runs the sessions it owes,
+// then inserts the key itself.
+//
+// Checks that the document always ends up as it does when each key's
+// output is applied on its own, and that the queue never overflows.
+// Reports sessions (one SetText each) per 1,000 keys, for N from 1 (the
+// application keeps up) to 64.
+//
+// Build:  cl /std:c++17 /EHsc /O2 tools\SessionBench.cpp src\KeyboardEngine.cpp src\Tamil99Engine.cpp src\TypewriterEngine.cpp src\PhoneticEngine.cpp src\LayoutRegistry.cpp src\KeyMap*.cpp src\EngineImage.cpp src\EngineImageData.cpp src\Dictionary.cpp
+//    or:  g++ -std=c++17 -O2 tools/SessionBench.cpp src/KeyboardEngine.cpp src/Tamil99Engine.cpp src/TypewriterEngine.cpp src/PhoneticEngine.cpp src/LayoutRegistry.cpp src/KeyMap*.cpp src/EngineImage.cpp src/EngineImageData.cpp src/Dictionary.cpp -o SessionBench
+// Run:    SessionBench [keys]
+
+#include "../include/KeyboardEngine.h"
+#include "../include/PendingOutput.h"
+#include "BenchUtil.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <string>
+
+static const size_t c_defaultKeys = 1000000;
+static const size_t c_sessionDelays[] = { 1, 2, 4, 8, 16, 64 };
+static const char* const c_layoutNames[LayoutCount] = { "tamil99", "anjal", "typewriter", "bamini" };
+
+// The context: its document, the sessions requested on it, and the queue
+// those sessions apply
+struct MockContext
+{
+    std::u16string document;
+    std::deque<uint32_t> sessions;
+    PendingOutputQueue queue;
+    size_t cSessions = 0;
+    size_t cBadDeletes = 0;     // sessions deleting more than the document has
+
+    // What the application does when it grants the text service a lock
+    void RunSessions()
+    {
+        while (!sessions.empty())
+        {
+            uint32_t serial = sessions.front();
+            sessions.pop_front();
+
+            PendingBatch* pBatch = queue.Take(serial);
+            if (!pBatch)
+                continue;
+            if (pBatch->cchDelete > document.size())
+                cBadDeletes++;
+            document.erase(document.size() - std::min<size_t>(pBatch->cchDelete, document.size()));
+            document.append(pBatch->text, pBatch->cchText);
+            queue.Complete(serial);
+            cSessions++;
+        }
+    }
+};
+
+int main(int argc, char** argv)
+{
+    size_t cKeys = (argc > 1) ? strtoul(argv[1], NULL, 10) : c_defaultKeys;
+    if (cKeys == 0)
+    {
+        fprintf(stderr, "usage: SessionBench [keys]\n");
+        return 2;
+    }
+
+    size_t cMismatches = 0;
+    for (size_t l = 0; l < LayoutCount; l++)
+    {
+        std::string keys = MakeKeys((LayoutId)l, cKeys);
+        printf("%-12s", c_layoutNames[l]);
+
+        for (size_t delay : c_sessionDelays)
+        {
+            KeyboardEngine engine;
+            engine.SetLayout(&g_layouts[l]);
+            MockContext context;
+            std::u16string expected;
+            size_t cFull = 0;
+
+            for (size_t i = 0; i < keys.size(); i++)
+            {
+                uint8_t vk;
+                KeyLayer layer;
+                char16_t code = UsKeyForAscii((char16_t)keys[i], &vk, &layer) ? engine.MapKey(layer, vk) : 0;
+
+                EngineOutput output;
+                if (code != 0 && engine.ProcessKey(code, &output))
+                {
+                    expected.erase(expected.size() - output.cchDelete);
+                    expected.append(output.text, output.cchText);
+
+                    uint32_t serial;
+                    if (output.cchText > 0 || output.cchDelete > 0)
+                    {
+                        switch (context.queue.Append(&context, output.cchDelete, output.text, output.cchText,
+                            engine.ComposingLength(), 0, &serial))
+                        {
+                        case PendingNewBatch:
+                            context.sessions.push_back(serial);
+                            break;
+                        case PendingFull:
+                            cFull++;
+                            break;
+                        case PendingMerged:
+                            break;
+                        }
+                    }
+                }
+                else
+                {
+                    engine.Reset();
+                    context.RunSessions();
+                    context.document.push_back((char16_t)keys[i]);
+                    expected.push_back((char16_t)keys[i]);
+                }
+
+                if (i % delay == delay - 1)
+                    context.RunSessions();
+            }
+            context.RunSessions();
+
+            if (context.document != expected || cFull != 0 || context.cBadDeletes != 0)
+            {
+                fprintf(stderr, "%s, sessions every %zu keys: %s, %zu keys dropped on a full queue, %zu deletes past the start\n",
+                    c_layoutNames[l], delay, (context.document == expected) ? "text identical" : "text differs", cFull,
+                    context.cBadDeletes);
+                cMismatches++;
+            }
+            printf("  every %zu: %.0f", delay, context.cSessions * 1000.0 / keys.size());
+        }
+        printf(" sessions per 1000 keys\n");
+    }
+
+    printf("mismatches   %zu\n", cMismatches);
+    return cMismatches ? 1 : 0;
+}
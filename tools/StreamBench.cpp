@@ -0,0 +1,214 @@
+// StreamBench.cpp
+// Split check and throughput for TransliteratorStream (see
+// include/TransliteratorStream.h). For every layout, each test text is cut
+// in two at every byte offset, and into random fragments, and fed through
+// output buffers from 4 bytes up; every result must equal feeding it whole.
+// For well-formed texts that in turn must equal Transliterator::Convert.
+// Then generated input is fed in network-sized fragments through a small
+// output buffer and the throughput reported next to Convert's.
+//
+// Build:  cl /std:c++17 /EHsc /O2 tools\StreamBench.cpp src\TransliteratorStream.cpp src\Transliterator.cpp src\TamilScan.cpp src\KeyboardEngine.cpp src\Tamil99Engine.cpp src\TypewriterEngine.cpp src\PhoneticEngine.cpp src\LayoutRegistry.cpp src\KeyMap*.cpp src\EngineImage.cpp src\EngineImageData.cpp src\Dictionary.cpp
+//    or:  g++ -std=c++17 -O2 tools/StreamBench.cpp src/TransliteratorStream.cpp src/Transliterator.cpp src/TamilScan.cpp src/KeyboardEngine.cpp src/Tamil99Engine.cpp src/TypewriterEngine.cpp src/PhoneticEngine.cpp src/LayoutRegistry.cpp src/KeyMap*.cpp src/EngineImage.cpp src/EngineImageData.cpp src/Dictionary.cpp -o StreamBench
+// Run:    StreamBench [MiB]
+
+#include "../include/TransliteratorStream.h"
+#include "BenchUtil.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static const size_t c_defaultMiB = 64;
+static const size_t c_fragmentBytes = 1460;         // one TCP segment
+static const size_t c_outputBytes = 16 * 1024;
+static const size_t c_randomSplits = 2000;
+
+static const char* const c_layoutNames[LayoutCount] = { "tamil99", "anjal", "typewriter", "bamini" };
+
+// Test texts: romanized and keyed text, Tamil already in it, digits and
+// punctuation, line ends, a character outside the BMP, and for the last
+// two malformed UTF-8 (a stray continuation, an overlong form, a surrogate,
+// and a sequence cut off by the end of the text)
+static const char* const c_texts[] =
+{
+    "vanakkam, ennudaiya peyar kumaar. naan chennaiyil irukkiREn.\r\nungaL peyar enna? 2024-il thamizh kaRkiREn!",
+    "kaa kii kuu kee kai koo kau ngaa njaa NNaa nhaa Rraa zhaa LLaa shaa sri ksha jaa haa... aH aaH q",
+    "hjkl;'asdf gfdsa qwert yuiop[] zxcvb nm,./ QWERTY ASDF ZXCV {}|:\"<>? 1234567890 !@#$%^&*() -=_+ `~",
+    "தமிழ் vaazhga! நன்றி, ammaa. \xF0\x9F\x98\x80 emoji \tkaNini\nmozhi",
+    "bad \x80 bytes \xC0\xAF over\xED\xA0\x80long kaa\xE0\xAE cut \xE0 short",
+    "thamizh \xF4\x90\x80\x80 high \xF0\x9F\x98",
+};
+static const size_t c_wellFormedTexts = 4;
+
+// Feeds in[0..) in the fragments that end at cuts (ascending, ending with
+// in.size()) through an output buffer of cbOut bytes, then finishes
+static std::string FeedSplit(const Transliterator& transliterator, const std::string& in, const std::vector<size_t>& cuts, size_t cbOut)
+{
+    TransliteratorStream stream(transliterator);
+    std::vector<char> buffer(cbOut);
+    std::string out;
+    size_t ib = 0;
+    for (size_t ibCut : cuts)
+    {
+        while (ib < ibCut)
+        {
+            size_t cbRead;
+            size_t cbWritten;
+            stream.Feed(in.data() + ib, ibCut - ib, &cbRead, buffer.data(), cbOut, &cbWritten);
+            out.append(buffer.data(), cbWritten);
+            ib += cbRead;
+        }
+    }
+
+    size_t cbWritten;
+    while (stream.Finish(buffer.data(), cbOut, &cbWritten) == StreamOutputNeeded)
+        out.append(buffer.data(), cbWritten);
+    out.append(buffer.data(), cbWritten);
+    return out;
+}
+
+// Generated input: words in romanized or keyed form with some Tamil
+static void MakeInput(LayoutId layout, size_t cb, std::string* pBytes)
+{
+    static const char* const c_syllables[] =
+    {
+        "ka", "ngaa", "si", "nji", "du", "NNuu", "the", "nee", "pai", "mo", "yoo", "rau", "la", "vaa", "zhi", "LL", "Ru", "n", "m"
+    };
+    static const char c_keys[] = "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzQWERTYUIOPASDFGHJKL;',./[]";
+
+    pBytes->clear();
+    size_t cWords = 0;
+    while (pBytes->size() < cb)
+    {
+        if (NextRandom() % 20 == 0)
+        {
+            pBytes->append("தமிழ்");
+        }
+        else if (g_layouts[layout].engine == LayoutEnginePhonetic)
+        {
+            for (size_t i = 1 + NextRandom() % 4; i > 0; i--)
+                pBytes->append(c_syllables[NextRandom() % (sizeof(c_syllables) / sizeof(c_syllables[0]))]);
+        }
+        else
+        {
+            for (size_t i = 2 + NextRandom() % 6; i > 0; i--)
+                pBytes->push_back(c_keys[NextRandom() % (sizeof(c_keys) - 1)]);
+        }
+        pBytes->push_back(++cWords % 12 == 0 ? '\n' : ' ');
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t cbBench = ((argc > 1) ? strtoul(argv[1], NULL, 10) : c_defaultMiB) * 1024 * 1024;
+    static const size_t c_outputSizes[] = { 4, 5, 7, 64, 4096 };
+
+    size_t cMismatches = 0;
+    size_t cRuns = 0;
+    for (size_t l = 0; l < LayoutCount; l++)
+    {
+        Transliterator transliterator((LayoutId)l);
+        for (size_t t = 0; t < sizeof(c_texts) / sizeof(c_texts[0]); t++)
+        {
+            std::string in = c_texts[t];
+            std::string whole = FeedSplit(transliterator, in, { in.size() }, 4096);
+
+            if (t < c_wellFormedTexts)
+            {
+                std::u16string text = ToUtf16(in);
+                std::u16string converted(Transliterator::MaxOutput(text.size()), 0);
+                converted.resize(transliterator.Convert(text.data(), text.size(), &converted[0], converted.size()));
+                if (ToUtf8(converted) != whole)
+                {
+                    fprintf(stderr, "%s, text %zu: stream differs from Convert\n", c_layoutNames[l], t);
+                    cMismatches++;
+                }
+            }
+
+            // Every byte offset, through every output size
+            for (size_t ibCut = 0; ibCut <= in.size(); ibCut++)
+            {
+                for (size_t cbOut : c_outputSizes)
+                {
+                    cRuns++;
+                    if (FeedSplit(transliterator, in, { ibCut, in.size() }, cbOut) != whole)
+                    {
+                        fprintf(stderr, "%s, text %zu: differs when cut at %zu with %zu-byte output\n", c_layoutNames[l], t, ibCut, cbOut);
+                        cMismatches++;
+                    }
+                }
+            }
+
+            // Many fragments, some empty
+            for (size_t i = 0; i < c_randomSplits; i++)
+            {
+                std::vector<size_t> cuts;
+                size_t ib = 0;
+                while (ib < in.size())
+                {
+                    ib += NextRandom() % 8;
+                    cuts.push_back(ib < in.size() ? ib : in.size());
+                }
+                cuts.push_back(in.size());
+
+                cRuns++;
+                if (FeedSplit(transliterator, in, cuts, c_outputSizes[i % 5]) != whole)
+                {
+                    fprintf(stderr, "%s, text %zu: differs on random fragments (run %zu)\n", c_layoutNames[l], t, i);
+                    cMismatches++;
+                }
+            }
+        }
+    }
+    printf("split check  %zu runs, %zu mismatches\n", cRuns, cMismatches);
+
+    // Throughput: network fragments in, a small output buffer out
+    for (size_t l = 0; l < LayoutCount; l++)
+    {
+        Transliterator transliterator((LayoutId)l);
+        std::string in;
+        MakeInput((LayoutId)l, cbBench, &in);
+
+        std::vector<char> buffer(c_outputBytes);
+        TransliteratorStream stream(transliterator);
+        uint64_t cbOut = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t ib = 0; ib < in.size(); )
+        {
+            size_t cbFragment = std::min(c_fragmentBytes, in.size() - ib);
+            size_t ibFragment = 0;
+            while (ibFragment < cbFragment)
+            {
+                size_t cbRead;
+                size_t cbWritten;
+                stream.Feed(in.data() + ib + ibFragment, cbFragment - ibFragment, &cbRead, buffer.data(), buffer.size(), &cbWritten);
+                cbOut += cbWritten;
+                ibFragment += cbRead;
+            }
+            ib += cbFragment;
+        }
+        size_t cbWritten;
+        while (stream.Finish(buffer.data(), buffer.size(), &cbWritten) == StreamOutputNeeded)
+            cbOut += cbWritten;
+        cbOut += cbWritten;
+        double streamSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Convert on the same text, already in UTF-16, in one call
+        std::u16string text = ToUtf16(in);
+        std::u16string converted(text.size() * 3, 0);
+        start = std::chrono::steady_clock::now();
+        size_t cchOut = transliterator.Convert(text.data(), text.size(), &converted[0], converted.size());
+        double convertSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (cchOut == c_transliterateNoRoom || ToUtf8(converted.substr(0, cchOut)).size() != cbOut)
+            cMismatches++;
+
+        printf("%-10s   stream %.1f MiB/s (%zu-byte fragments, %zu-byte output), Convert %.1f MiB/s\n", c_layoutNames[l],
+            in.size() / 1048576.0 / streamSeconds, c_fragmentBytes, c_outputBytes, in.size() / 1048576.0 / convertSeconds);
+    }
+
+    printf("mismatches   %zu\n", cMismatches);
+    return cMismatches ? 1 : 0;
+}
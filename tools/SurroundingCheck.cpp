@@ -0,0 +1,212 @@
+// SurroundingCheck.cpp
+// Runtime checks for the surrounding-text window (see
+// include/SurroundingText.h). The text edit sink is on one context, so its
+// OnEndEdit calls only ever name that context, while our edit sessions may
+// still be finishing on another one after a focus change:
+//   - the replays that must invalidate: an edit of ours on another context,
+//     then a foreign edit on the sink context; and a foreign edit arriving
+//     after our own edit's OnEndEdit was consumed;
+//   - own edits on the sink context keep the window valid, whatever was
+//     done on other contexts around them;
+//   - truncation: filling past the window, deleting past it, inserting
+//     more than it holds;
+//   - random replays against two mock documents: own and foreign edits on
+//     both contexts, with the window refilled after every invalidation. The
+//     window must be valid exactly when no foreign edit hit the sink
+//     context since the fill, and then be a suffix of that document - all
+//     of it when AtStart.
+//
+// Build:  cl /std:c++17 /EHsc /O2 tools\SurroundingCheck.cpp
+//    or:  g++ -std=c++17 -O2 tools/SurroundingCheck.cpp -o SurroundingCheck
+// Run:    SurroundingCheck
+
+#include "../include/SurroundingText.h"
+#include "BenchUtil.h"
+
+#include <cstdio>
+#include <string>
+
+static const size_t c_randomEvents = 1000000;
+
+static size_t s_cChecks = 0;
+static size_t s_cFailures = 0;
+
+static void Check(const char* pszWhat, bool fActual, bool fExpected)
+{
+    s_cChecks++;
+    if (fActual != fExpected)
+    {
+        fprintf(stderr, "%s: %s, expected %s\n", pszWhat, fActual ? "true" : "false", fExpected ? "true" : "false");
+        s_cFailures++;
+    }
+}
+
+static std::u16string Window(const SurroundingText& surrounding)
+{
+    return std::u16string(surrounding.Text(), surrounding.Length());
+}
+
+// Fills the window from the end of document, as the read-only session does
+static void Fill(SurroundingText* pSurrounding, const void* pContext, const std::u16string& document)
+{
+    size_t cch = (document.size() < c_surroundingTextMax) ? document.size() : c_surroundingTextMax;
+    pSurrounding->Fill(pContext, document.data() + document.size() - cch, cch, cch == document.size());
+}
+
+static void CheckReplays()
+{
+    int contextA = 0;
+    int contextB = 0;
+    const char16_t text[] = u"க";
+    std::u16string document = u"வணக்கம் ";
+
+    // Ours on B, then someone else's on A: A's window is stale
+    SurroundingText surrounding;
+    Fill(&surrounding, &contextA, document);
+    surrounding.Apply(&contextB, 0, text, 1);
+    surrounding.OnEndEdit(&contextA);
+    Check("foreign edit after an edit on another context", surrounding.IsValid(&contextA), false);
+
+    // The same, with B's OnEndEdit delivered as well
+    Fill(&surrounding, &contextA, document);
+    surrounding.Apply(&contextB, 0, text, 1);
+    surrounding.OnEndEdit(&contextB);
+    Check("edit on another context", surrounding.IsValid(&contextA), true);
+    surrounding.OnEndEdit(&contextA);
+    Check("foreign edit after another context's OnEndEdit", surrounding.IsValid(&contextA), false);
+
+    // Ours on A, consumed, then someone else's on A
+    Fill(&surrounding, &contextA, document);
+    surrounding.Apply(&contextA, 0, text, 1);
+    surrounding.OnEndEdit(&contextA);
+    Check("own edit", surrounding.IsValid(&contextA), true);
+    Check("own edit applied", Window(surrounding) == document + text, true);
+    surrounding.OnEndEdit(&contextA);
+    Check("foreign edit after an own edit", surrounding.IsValid(&contextA), false);
+
+    // Ours on A with an edit on B between it and its OnEndEdit
+    Fill(&surrounding, &contextA, document);
+    surrounding.Apply(&contextA, 0, text, 1);
+    surrounding.Apply(&contextB, 1, text, 1);
+    surrounding.OnEndEdit(&contextB);
+    surrounding.OnEndEdit(&contextA);
+    Check("own edit around another context's", surrounding.IsValid(&contextA), true);
+    surrounding.OnEndEdit(&contextA);
+    Check("foreign edit after both", surrounding.IsValid(&contextA), false);
+
+    // Nothing counted while invalid: the refill starts clean
+    surrounding.Apply(&contextA, 0, text, 1);
+    Fill(&surrounding, &contextA, document);
+    surrounding.OnEndEdit(&contextA);
+    Check("foreign edit after a refill", surrounding.IsValid(&contextA), false);
+}
+
+static void CheckTruncation()
+{
+    int context = 0;
+    std::u16string document = u"அஆஇஈஉஊஎஏஐஒஓஔகஙசஞடணதநபமயரலவ";
+    SurroundingText surrounding;
+
+    Fill(&surrounding, &context, document);
+    Check("long fill keeps the window", Window(surrounding) == document.substr(document.size() - c_surroundingTextMax), true);
+    Check("long fill not at start", surrounding.AtStart(), false);
+
+    surrounding.Fill(&context, document.data(), document.size(), true);
+    Check("truncated fill not at start", surrounding.AtStart(), false);
+
+    Fill(&surrounding, &context, u"கா");
+    Check("short fill at start", surrounding.AtStart(), true);
+    surrounding.Apply(&context, 5, u"ம", 1);
+    surrounding.OnEndEdit(&context);
+    Check("delete past the window", Window(surrounding) == u"ம", true);
+    Check("delete past the window not at start", surrounding.AtStart(), false);
+
+    Fill(&surrounding, &context, u"கா");
+    surrounding.Apply(&context, 0, document.data(), document.size());
+    surrounding.OnEndEdit(&context);
+    Check("insert past the window", Window(surrounding) == document.substr(document.size() - c_surroundingTextMax), true);
+    Check("insert past the window not at start", surrounding.AtStart(), false);
+    Check("valid after own edits", surrounding.IsValid(&context), true);
+}
+
+// A random edit: a few units deleted before the caret, a few inserted
+static void RandomEdit(std::u16string* pDocument, size_t* pcchDelete, std::u16string* pText)
+{
+    size_t cchDelete = NextRandom() % 4;
+    if (cchDelete > pDocument->size())
+        cchDelete = pDocument->size();
+
+    pText->clear();
+    for (size_t i = NextRandom() % ((NextRandom() % 50 == 0) ? 40 : 5); i > 0; i--)
+        pText->push_back((char16_t)(0x0B80 + NextRandom() % 0x80));
+
+    pDocument->resize(pDocument->size() - cchDelete);
+    pDocument->append(*pText);
+    *pcchDelete = cchDelete;
+}
+
+static void CheckRandom()
+{
+    int contexts[2] = { 0, 0 };
+    std::u16string documents[2] = { u"வணக்கம் உலகம்", u"" };
+    SurroundingText surrounding;
+    Fill(&surrounding, &contexts[0], documents[0]);
+    bool fValid = true;
+
+    for (size_t i = 0; i < c_randomEvents; i++)
+    {
+        // The sink is on contexts[0]; OnEndEdit for the other one is
+        // delivered only sometimes, as a stale sink would
+        size_t context = (NextRandom() % 4 == 0) ? 1 : 0;
+        bool fOwn = (NextRandom() % 16 != 0);
+        bool fDelivered = (context == 0) || (NextRandom() % 2 == 0);
+
+        size_t cchDelete;
+        std::u16string text;
+        RandomEdit(&documents[context], &cchDelete, &text);
+        if (fOwn)
+            surrounding.Apply(&contexts[context], cchDelete, text.data(), text.size());
+        if (fDelivered)
+            surrounding.OnEndEdit(&contexts[context]);
+        if (!fOwn && context == 0)
+            fValid = false;
+
+        s_cChecks++;
+        if (surrounding.IsValid(&contexts[0]) != fValid)
+        {
+            fprintf(stderr, "event %zu (%s edit on context %zu): valid %d, expected %d\n", i, fOwn ? "own" : "foreign",
+                context, surrounding.IsValid(&contexts[0]), fValid);
+            s_cFailures++;
+            return;
+        }
+
+        if (fValid)
+        {
+            std::u16string window = Window(surrounding);
+            const std::u16string& document = documents[0];
+            s_cChecks++;
+            if (window.size() > document.size() || document.compare(document.size() - window.size(), window.size(), window) != 0 ||
+                (surrounding.AtStart() && window != document))
+            {
+                fprintf(stderr, "event %zu: window is not the text before the caret\n", i);
+                s_cFailures++;
+                return;
+            }
+        }
+        else
+        {
+            Fill(&surrounding, &contexts[0], documents[0]);
+            fValid = true;
+        }
+    }
+}
+
+int main()
+{
+    CheckReplays();
+    CheckTruncation();
+    CheckRandom();
+
+    printf("surrounding  %zu checks, %zu failures\n", s_cChecks, s_cFailures);
+    return s_cFailures ? 1 : 0;
+}
@@ -0,0 +1,260 @@
+// Tamil99Bench.cpp
+// Rule check and per-key cost for Tamil99Engine (see include/Tamil99Engine.h).
+// Every rule is checked over every letter it applies to:
+//   - each consonant, grantha included, with each vowel: the uyirmei, and
+//     அ absorbed as the inherent vowel;
+//   - each consonant with an explicit pulli, after which a vowel stands alone;
+//   - each ordered pair of consonants: an automatic pulli for the same
+//     consonant twice and for the six soft-hard pairs, none otherwise, and
+//     the third consonant of a run not doubled again;
+//   - க்ஷ and ஸ்ரீ keys, vowel letters alone, ஃ and digits ending the
+//     syllable, and resuming from the text before the caret;
+//   - a few words typed on the Tamil99 key tables, Shift layer included.
+// Then the engine is fed key mixes that exercise each rule and the cost per
+// key reported; it should not depend on the mix.
+//
+// The engine builds as a static library on its own:
+// Build:  g++ -std=c++17 -O2 -c src/Tamil99Engine.cpp src/EngineImage.cpp src/EngineImageData.cpp src/Dictionary.cpp src/LayoutRegistry.cpp src/KeyMapTamil99.cpp src/KeyMapAnjal.cpp src/KeyMapTypewriter.cpp src/PhoneticEngine.cpp
+//         ar rcs libtamil99.a Tamil99Engine.o EngineImage.o EngineImageData.o Dictionary.o LayoutRegistry.o KeyMap*.o PhoneticEngine.o
+//         g++ -std=c++17 -O2 tools/Tamil99Bench.cpp libtamil99.a -o Tamil99Bench
+//    or:  cl /std:c++17 /EHsc /O2 tools\Tamil99Bench.cpp src\Tamil99Engine.cpp src\EngineImage.cpp src\EngineImageData.cpp src\Dictionary.cpp src\LayoutRegistry.cpp src\KeyMap*.cpp src\PhoneticEngine.cpp
+// Run:    Tamil99Bench [million keys]
+
+#include "../include/Tamil99Engine.h"
+#include "../include/KeyMap.h"
+#include "BenchUtil.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static const size_t c_defaultMillionKeys = 50;
+
+// Soft consonant and the hard consonant that takes a pulli after it, as
+// the Tamil99 standard lists them
+static const char16_t c_softHardPairs[][2] =
+{
+    { 0x0B99, 0x0B95 },     // ங்க
+    { 0x0B9E, 0x0B9A },     // ஞ்ச
+    { 0x0BA3, 0x0B9F },     // ண்ட
+    { 0x0BA8, 0x0BA4 },     // ந்த
+    { 0x0BAE, 0x0BAA },     // ம்ப
+    { 0x0BA9, 0x0BB1 },     // ன்ற
+};
+
+static const char16_t* const c_ksha = u"க்ஷ";
+static const char16_t* const c_shri = u"ஸ்ரீ";
+
+static size_t s_cChecks = 0;
+static size_t s_cFailures = 0;
+
+// Feeds each key's text to a fresh engine, after resuming from pBefore,
+// and returns the document: the text before plus everything emitted
+static std::u16string Type(const std::vector<std::u16string>& keys, const char16_t* pBefore = u"")
+{
+    Tamil99Engine engine;
+    std::u16string document = pBefore;
+    engine.Resume(document.data(), document.size());
+
+    for (const std::u16string& key : keys)
+    {
+        EngineOutput output;
+        if (!engine.ProcessKey(key.data(), key.size(), &output))
+        {
+            engine.Reset();
+            continue;
+        }
+        document.resize(document.size() - output.cchDelete);
+        document.append(output.text, output.cchText);
+    }
+    return document;
+}
+
+// The same, typed as characters on a US keyboard through the Tamil99 tables
+static std::u16string TypeKeys(const char* pszKeys)
+{
+    std::vector<std::u16string> keys;
+    for (const char* pch = pszKeys; *pch; pch++)
+    {
+        uint8_t vk;
+        KeyLayer layer;
+        char16_t achText[c_keySequenceLength];
+        size_t cch = 0;
+        if (UsKeyForAscii((char16_t)*pch, &vk, &layer))
+            cch = g_keyMapTamil99.Expand(g_keyMapTamil99.Lookup(layer, vk), achText);
+        keys.push_back(std::u16string(achText, cch));
+    }
+    return Type(keys);
+}
+
+static void Check(const char* pszRule, const std::u16string& actual, const std::u16string& expected)
+{
+    s_cChecks++;
+    if (actual != expected)
+    {
+        fprintf(stderr, "%s: got \"%s\", expected \"%s\"\n", pszRule, ToUtf8(actual).c_str(), ToUtf8(expected).c_str());
+        s_cFailures++;
+    }
+}
+
+static std::u16string Letter(char16_t ch)
+{
+    return std::u16string(1, ch);
+}
+
+static bool IsSoftHardPair(char16_t soft, char16_t hard)
+{
+    for (const char16_t (&pair)[2] : c_softHardPairs)
+    {
+        if (pair[0] == soft && pair[1] == hard)
+            return true;
+    }
+    return false;
+}
+
+static void CheckRules()
+{
+    const std::u16string pulli = Letter(c_tamilPulli);
+
+    for (size_t c = 0; c < c_tamilConsonantCount; c++)
+    {
+        std::u16string consonant = Letter(c_tamilConsonants[c]);
+
+        // 1, 2: consonant + vowel -> uyirmei, அ inherent
+        for (size_t v = 0; v < c_tamilVowelCount; v++)
+        {
+            std::u16string vowel = Letter(c_tamilVowels[v]);
+            std::u16string syllable = consonant;
+            if (c_tamilVowelSigns[v])
+                syllable.push_back(c_tamilVowelSigns[v]);
+
+            Check("consonant + vowel", Type({ consonant, vowel }), syllable);
+            Check("uyirmei + vowel", Type({ consonant, vowel, vowel }), syllable + vowel);
+        }
+
+        // Explicit pulli ends the syllable
+        Check("consonant + pulli", Type({ consonant, pulli }), consonant + pulli);
+        Check("pulli + vowel", Type({ consonant, pulli, u"ஆ" }), consonant + pulli + u"ஆ");
+
+        // 3, 4, 5: automatic pulli
+        for (size_t c2 = 0; c2 < c_tamilConsonantCount; c2++)
+        {
+            std::u16string second = Letter(c_tamilConsonants[c2]);
+            bool fPulli = (c == c2) || IsSoftHardPair(c_tamilConsonants[c], c_tamilConsonants[c2]);
+            Check(fPulli ? "automatic pulli" : "no automatic pulli", Type({ consonant, second }),
+                fPulli ? consonant + pulli + second : consonant + second);
+            if (fPulli)
+                Check("cluster + vowel", Type({ consonant, second, u"இ" }), consonant + pulli + second + u"ி");
+        }
+        Check("third of a run", Type({ consonant, consonant, consonant }), consonant + pulli + consonant + consonant);
+        Check("fourth of a run", Type({ consonant, consonant, consonant, consonant }),
+            consonant + pulli + consonant + consonant + pulli + consonant);
+
+        // A consonant before the caret takes the vowel as its sign
+        Check("resume after consonant", Type({ u"ஈ" }, consonant.c_str()), consonant + u"ீ");
+        Check("resume after pulli", Type({ u"ஈ" }, (consonant + pulli).c_str()), consonant + pulli + u"ஈ");
+    }
+
+    // Vowels on their own, and after the syllable is ended
+    for (size_t v = 0; v < c_tamilVowelCount; v++)
+    {
+        std::u16string vowel = Letter(c_tamilVowels[v]);
+        Check("vowel", Type({ vowel }), vowel);
+        Check("vowel + vowel", Type({ vowel, vowel }), vowel + vowel);
+        Check("aytham ends the syllable", Type({ u"க", u"ஃ", vowel }), u"கஃ" + vowel);
+        Check("digit ends the syllable", Type({ u"க", u"௧", vowel }), u"க௧" + vowel);
+    }
+
+    // Grantha sequences: க்ஷ takes a sign, ஸ்ரீ already has one
+    Check("ksha + vowel", Type({ c_ksha, u"ஆ" }), std::u16string(c_ksha) + u"ா");
+    Check("ksha + a", Type({ c_ksha, u"அ" }), c_ksha);
+    Check("shri + vowel", Type({ c_shri, u"அ" }), std::u16string(c_shri) + u"அ");
+    Check("consonant + shri", Type({ u"ஸ", c_shri }), std::u16string(u"ஸ") + c_shri);
+
+    // Through the key tables
+    Check("keys hq", TypeKeys("hq"), u"கா");
+    Check("keys hhq", TypeKeys("hhq"), u"க்கா");
+    Check("keys bh", TypeKeys("bh"), u"ங்க");
+    Check("keys ;ls", TypeKeys(";ls"), u"ந்தி");
+    Check("keys kfkq", TypeKeys("kfkq"), u"ம்மா");
+    Check("keys lks/f", TypeKeys("lks/f"), u"தமிழ்");
+    Check("keys Ed", TypeKeys("Ed"), u"ஜு");
+    Check("keys Tq", TypeKeys("Tq"), std::u16string(c_ksha) + u"ா");
+    Check("keys Ya", TypeKeys("Ya"), std::u16string(c_shri) + u"அ");
+}
+
+// A key mix for the benchmark: the text of each key, repeated
+struct KeyMix
+{
+    const char* name;
+    std::vector<std::u16string> keys;
+};
+
+static std::vector<KeyMix> MakeMixes()
+{
+    std::vector<KeyMix> mixes(5);
+    mixes[0].name = "vowels";
+    mixes[1].name = "consonant + vowel";
+    mixes[2].name = "doubled consonants";
+    mixes[3].name = "soft-hard pairs";
+    mixes[4].name = "random keys";
+
+    for (size_t i = 0; i < 4096; i++)
+    {
+        std::u16string consonant = Letter(c_tamilConsonants[NextRandom() % c_tamilConsonantCount]);
+        std::u16string vowel = Letter(c_tamilVowels[NextRandom() % c_tamilVowelCount]);
+        const char16_t (&pair)[2] = c_softHardPairs[NextRandom() % 6];
+
+        mixes[0].keys.push_back(vowel);
+        mixes[1].keys.insert(mixes[1].keys.end(), { consonant, vowel });
+        mixes[2].keys.insert(mixes[2].keys.end(), { consonant, consonant, vowel });
+        mixes[3].keys.insert(mixes[3].keys.end(), { Letter(pair[0]), Letter(pair[1]), vowel });
+
+        // Any key of the base and Shift layers
+        for (;;)
+        {
+            char16_t achText[c_keySequenceLength];
+            KeyLayer layer = (NextRandom() % 8 == 0) ? KeyLayerShift : KeyLayerBase;
+            size_t cch = g_keyMapTamil99.Expand(g_keyMapTamil99.Lookup(layer, NextRandom() % 256), achText);
+            if (cch > 0)
+            {
+                mixes[4].keys.push_back(std::u16string(achText, cch));
+                break;
+            }
+        }
+    }
+    return mixes;
+}
+
+int main(int argc, char** argv)
+{
+    size_t cKeys = ((argc > 1) ? strtoul(argv[1], NULL, 10) : c_defaultMillionKeys) * 1000000;
+
+    CheckRules();
+    printf("rules        %zu checks, %zu failures\n", s_cChecks, s_cFailures);
+
+    for (const KeyMix& mix : MakeMixes())
+    {
+        Tamil99Engine engine;
+        EngineOutput output;
+        uint64_t cchOut = 0;
+        size_t iKey = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < cKeys; i++)
+        {
+            const std::u16string& key = mix.keys[iKey];
+            if (++iKey == mix.keys.size())
+                iKey = 0;
+            engine.ProcessKey(key.data(), key.size(), &output);
+            cchOut += output.cchText;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        printf("%-20s %.2f ns/key (%llu units out)\n", mix.name, seconds * 1e9 / cKeys, (unsigned long long)cchOut);
+    }
+
+    return s_cFailures ? 1 : 0;
+}
@@ -0,0 +1,78 @@
+﻿// TraceDecode.cpp
+// Offline decoder for binary trace files written by the text service
+// (see include/TraceRing.h). Prints one line per record:
+//   <microseconds since first record> <thread slot> <event> <arguments>
+//
+// Build:  cl /std:c++17 /EHsc tools\TraceDecode.cpp
+//    or:  g++ -std=c++17 -O2 tools/TraceDecode.cpp -o TraceDecode
+
+#include "../include/TraceRing.h"
+
+#include <cstdio>
+#include <cstdint>
+
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: TraceDecode <trace file>\n");
+        return 2;
+    }
+
+    FILE* pFile = fopen(argv[1], "rb");
+    if (!pFile)
+    {
+        fprintf(stderr, "TraceDecode: cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    TraceFileHeader header;
+    if (fread(&header, sizeof(header), 1, pFile) != 1 ||
+        header.magic != c_traceFileMagic ||
+        header.version != c_traceFileVersion ||
+        header.recordSize != sizeof(TraceRecord) ||
+        header.ticksPerSecond == 0)
+    {
+        fprintf(stderr, "TraceDecode: %s is not a version %u trace file\n", argv[1], c_traceFileVersion);
+        fclose(pFile);
+        return 1;
+    }
+
+    // Records are grouped per ring drain, so times are not globally sorted.
+    // First pass finds the earliest timestamp; sort the output on the first
+    // column if a merged timeline is needed.
+    TraceRecord record;
+    uint64_t first = UINT64_MAX;
+    long recordsStart = ftell(pFile);
+    while (fread(&record, sizeof(record), 1, pFile) == 1)
+    {
+        if (record.timestamp < first)
+            first = record.timestamp;
+    }
+    fseek(pFile, recordsStart, SEEK_SET);
+
+    size_t count = 0;
+    while (fread(&record, sizeof(record), 1, pFile) == 1)
+    {
+        double us = (double)(record.timestamp - first) * 1e6 / (double)header.ticksPerSecond;
+        const TraceEventInfo* pInfo = (record.eventId < TraceEventCount) ? &c_traceEvents[record.eventId] : nullptr;
+
+        printf("%12.1f %2u %-20s ", us, record.thread, pInfo ? pInfo->name : "?");
+        if (pInfo)
+        {
+            printf(pInfo->format,
+                (unsigned long long)record.args[0], (unsigned long long)record.args[1],
+                (unsigned long long)record.args[2], (unsigned long long)record.args[3]);
+        }
+        else
+        {
+            printf("id=%u", record.eventId);
+        }
+        printf("\n");
+        count++;
+    }
+
+    fclose(pFile);
+    fprintf(stderr, "TraceDecode: %zu record(s)\n", count);
+    return 0;
+}
@@ -0,0 +1,208 @@
+// TraceStress.cpp
+// Stress test for the binary trace (see include/TraceRing.h). Producer
+// threads push events as fast as they can through ANJAL_TRACE while the
+// collector drains their rings to a trace file; the file is then decoded
+// and checked:
+//   - every record is whole: its arguments carry the producer, a sequence
+//     number, a random value and a checksum over the three;
+//   - each producer's sequence numbers only go up, and its timestamps
+//     never go back;
+//   - nothing is lost: per producer, the records in the file plus the
+//     drops the collector reported for its ring add up to what it pushed.
+// Full speed outruns the collector, so drops are expected there; a second
+// run pushes in bursts smaller than a ring and should see none. Reports
+// ns per event on the producers - wall time, so with more threads than
+// cores it includes waiting for one - and the cost of a trace point while
+// tracing is off.
+//
+// Build:  cl /std:c++17 /EHsc /O2 tools\TraceStress.cpp src\TraceRing.cpp
+//    or:  g++ -std=c++17 -O2 -pthread tools/TraceStress.cpp src/TraceRing.cpp -o TraceStress
+//         (add -fsanitize=thread -g to check the rings for data races)
+// Run:    TraceStress [threads [events per thread]]
+
+#include "../include/TraceRing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const size_t c_defaultThreads = 8;
+static const size_t c_defaultEvents = 1000000;
+
+// Paced run: a burst this size, then a pause of several drain intervals
+static const size_t c_burstEvents = c_traceRingRecords / 4;
+static const std::chrono::milliseconds c_burstPause(20);
+
+static uint64_t Checksum(uint64_t producer, uint64_t sequence, uint64_t value)
+{
+    uint64_t sum = producer * 0x9E3779B97F4A7C15ull ^ sequence * 0xC2B2AE3D27D4EB4Full ^ value;
+    return sum ^ (sum >> 29);
+}
+
+// Per producer, what it pushed and what the file says about it
+struct Producer
+{
+    uint64_t pushed = 0;
+    double seconds = 0;
+    uint32_t slot = UINT32_MAX;
+    uint64_t received = 0;
+    uint64_t lastSequence = 0;
+    uint64_t lastTimestamp = 0;
+};
+
+static void Produce(uint32_t index, size_t cEvents, bool fPaced, Producer* pProducer)
+{
+    uint64_t random = 0x9E3779B97F4A7C15ull + index;
+    auto start = std::chrono::steady_clock::now();
+    double secondsPaused = 0;
+    for (size_t i = 0; i < cEvents; i++)
+    {
+        if (fPaced && i != 0 && i % c_burstEvents == 0)
+        {
+            auto pause = std::chrono::steady_clock::now();
+            std::this_thread::sleep_for(c_burstPause);
+            secondsPaused += std::chrono::duration<double>(std::chrono::steady_clock::now() - pause).count();
+        }
+
+        random ^= random << 13;
+        random ^= random >> 7;
+        random ^= random << 17;
+        uint64_t sequence = i + 1;
+        ANJAL_TRACE(TraceKeyDown, index, sequence, random, Checksum(index, sequence, random));
+    }
+    pProducer->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() - secondsPaused;
+    pProducer->pushed = cEvents;
+}
+
+// Runs the producers into a trace file at path, then decodes and checks
+// it. Returns the number of failures.
+static size_t Run(const char* pszName, const std::string& path, size_t cThreads, size_t cEvents, bool fPaced)
+{
+    FILE* pFile = fopen(path.c_str(), "wb");
+    if (!pFile || !TraceStart(pFile))
+    {
+        fprintf(stderr, "%s: cannot trace to %s\n", pszName, path.c_str());
+        return 1;
+    }
+
+    std::vector<Producer> producers(cThreads);
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < cThreads; i++)
+        threads.emplace_back(Produce, i, cEvents, fPaced, &producers[i]);
+    for (std::thread& thread : threads)
+        thread.join();
+    TraceStop();
+
+    pFile = fopen(path.c_str(), "rb");
+    TraceFileHeader header;
+    if (!pFile || fread(&header, sizeof(header), 1, pFile) != 1 ||
+        header.magic != c_traceFileMagic || header.recordSize != sizeof(TraceRecord))
+    {
+        fprintf(stderr, "%s: %s is not a trace file\n", pszName, path.c_str());
+        if (pFile)
+            fclose(pFile);
+        return 1;
+    }
+
+    size_t cFailures = 0;
+    uint64_t dropped[c_traceMaxThreads] = {};
+    uint64_t cRecords = 0;
+    TraceRecord record;
+    while (fread(&record, sizeof(record), 1, pFile) == 1)
+    {
+        cRecords++;
+        if (record.thread >= c_traceMaxThreads)
+        {
+            fprintf(stderr, "%s: record %llu has ring slot %u\n", pszName, (unsigned long long)cRecords, record.thread);
+            cFailures++;
+            continue;
+        }
+        if (record.eventId == TraceDropped)
+        {
+            dropped[record.thread] += record.args[0];
+            continue;
+        }
+
+        uint64_t index = record.args[0];
+        if (record.eventId != TraceKeyDown || record.argCount != 4 || index >= cThreads ||
+            record.args[3] != Checksum(index, record.args[1], record.args[2]))
+        {
+            fprintf(stderr, "%s: record %llu is torn\n", pszName, (unsigned long long)cRecords);
+            cFailures++;
+            continue;
+        }
+
+        Producer& producer = producers[index];
+        if (producer.slot == UINT32_MAX)
+            producer.slot = record.thread;
+        if (record.thread != producer.slot || record.args[1] <= producer.lastSequence ||
+            record.timestamp < producer.lastTimestamp)
+        {
+            fprintf(stderr, "%s: producer %llu: event %llu out of order\n", pszName,
+                (unsigned long long)index, (unsigned long long)record.args[1]);
+            cFailures++;
+        }
+        producer.lastSequence = record.args[1];
+        producer.lastTimestamp = record.timestamp;
+        producer.received++;
+    }
+    fclose(pFile);
+
+    uint64_t cPushed = 0;
+    uint64_t cReceived = 0;
+    uint64_t cDropped = 0;
+    double seconds = 0;
+    for (size_t i = 0; i < cThreads; i++)
+    {
+        const Producer& producer = producers[i];
+        uint64_t droppedHere = (producer.slot < c_traceMaxThreads) ? dropped[producer.slot] : 0;
+        if (producer.received + droppedHere != producer.pushed)
+        {
+            fprintf(stderr, "%s: producer %zu pushed %llu, file has %llu and %llu dropped\n", pszName, i,
+                (unsigned long long)producer.pushed, (unsigned long long)producer.received, (unsigned long long)droppedHere);
+            cFailures++;
+        }
+        cPushed += producer.pushed;
+        cReceived += producer.received;
+        cDropped += droppedHere;
+        seconds += producer.seconds;
+    }
+
+    printf("%-12s %zu threads, %llu events: %llu written, %llu dropped, %.1f ns/event, %zu failures\n", pszName, cThreads,
+        (unsigned long long)cPushed, (unsigned long long)cReceived, (unsigned long long)cDropped,
+        seconds * 1e9 / (double)cPushed, cFailures);
+    return cFailures;
+}
+
+int main(int argc, char** argv)
+{
+    size_t cThreads = (argc > 1) ? strtoul(argv[1], NULL, 10) : c_defaultThreads;
+    size_t cEvents = (argc > 2) ? strtoul(argv[2], NULL, 10) : c_defaultEvents;
+    if (cThreads == 0 || cThreads > c_traceMaxThreads || cEvents == 0)
+    {
+        fprintf(stderr, "usage: TraceStress [threads (1-%zu) [events per thread]]\n", c_traceMaxThreads);
+        return 2;
+    }
+
+    // A trace point with tracing off: the one relaxed load
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < cEvents; i++)
+        ANJAL_TRACE(TraceKeyDown, i);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%-12s %.2f ns/event\n", "off", seconds * 1e9 / (double)cEvents);
+
+    std::string path = (std::filesystem::temp_directory_path() / "TraceStress.trace").string();
+    size_t cFailures = Run("full speed", path, cThreads, cEvents, false);
+
+    // Enough bursts to span a few seconds at most
+    size_t cPacedEvents = std::min(cEvents, c_burstEvents * 100);
+    cFailures += Run("paced", path, cThreads, cPacedEvents, true);
+
+    std::filesystem::remove(path);
+    return cFailures ? 1 : 0;
+}
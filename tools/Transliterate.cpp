@@ -0,0 +1,554 @@
+// Transliterate.cpp
+// Bulk conversion of UTF-8 text through the keystroke engine (see
+// include/Transliterator.h) - romanized chat logs, form submissions.
+//
+// Input is read in blocks and each block cut into chunks of about a MiB, at
+// characters that end any syllable. The chunks are independent, so they are
+// converted in parallel on a work-stealing pool: each worker owns a range of
+// chunk indices in one atomic word and takes from its front; a worker that
+// runs dry steals the back half of another's range. Output is written in
+// input order.
+//
+// -v also replays the whole input key by key, the way OnKeyDown does - one
+// engine for the whole stream, no cutting, no pass-through runs - and
+// checks the output against it unit for unit. -b converts generated input
+// instead of a file and reports throughput.
+//
+// Build:  cl /std:c++17 /EHsc /O2 tools\Transliterate.cpp src\Transliterator.cpp src\TamilScan.cpp src\KeyboardEngine.cpp src\Tamil99Engine.cpp src\TypewriterEngine.cpp src\PhoneticEngine.cpp src\LayoutRegistry.cpp src\KeyMap*.cpp src\EngineImage.cpp src\EngineImageData.cpp src\Dictionary.cpp
+//    or:  g++ -std=c++17 -O2 -pthread tools/Transliterate.cpp src/Transliterator.cpp src/TamilScan.cpp src/KeyboardEngine.cpp src/Tamil99Engine.cpp src/TypewriterEngine.cpp src/PhoneticEngine.cpp src/LayoutRegistry.cpp src/KeyMap*.cpp src/EngineImage.cpp src/EngineImageData.cpp src/Dictionary.cpp -o Transliterate
+// Run:    Transliterate [-l tamil99|anjal|typewriter|bamini] [-j threads] [-v] [input [output]]
+//         Transliterate -b MiB [-l layout] [-j threads] [-v]
+
+#include "../include/Transliterator.h"
+#include "BenchUtil.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const size_t c_blockBytes = 64 * 1024 * 1024;
+static const size_t c_chunkBytes = 1024 * 1024;
+static const size_t c_verifyTail = 64;          // units the replay may still delete
+
+static const char* const c_layoutNames[LayoutCount] = { "tamil99", "anjal", "typewriter", "bamini" };
+
+//
+// UTF-8 <-> UTF-16. Malformed input becomes U+FFFD.
+//
+static void DecodeUtf8(const char* pb, size_t cb, std::u16string* pText)
+{
+    pText->clear();
+    const uint8_t* p = (const uint8_t*)pb;
+    const uint8_t* pEnd = p + cb;
+    while (p < pEnd)
+    {
+        uint32_t cp = *p++;
+        if (cp < 0x80)
+        {
+            pText->push_back((char16_t)cp);
+            continue;
+        }
+
+        size_t cbMore = (cp >= 0xF0 && cp < 0xF5) ? 3 : (cp >= 0xE0) ? 2 : (cp >= 0xC2 && cp < 0xE0) ? 1 : 0;
+        if (cbMore == 0 || cp >= 0xF5 || (size_t)(pEnd - p) < cbMore)
+        {
+            pText->push_back(0xFFFD);
+            continue;
+        }
+
+        cp &= (cbMore == 1) ? 0x1F : (cbMore == 2) ? 0x0F : 0x07;
+        bool fValid = true;
+        for (size_t i = 0; i < cbMore; i++)
+        {
+            if ((p[i] & 0xC0) != 0x80)
+            {
+                fValid = false;
+                break;
+            }
+            cp = (cp << 6) | (p[i] & 0x3F);
+        }
+        if (!fValid || (cbMore == 2 && (cp < 0x800 || (cp >= 0xD800 && cp < 0xE000))) ||
+            (cbMore == 3 && (cp < 0x10000 || cp > 0x10FFFF)))
+        {
+            pText->push_back(0xFFFD);
+            continue;
+        }
+        p += cbMore;
+
+        if (cp >= 0x10000)
+        {
+            cp -= 0x10000;
+            pText->push_back((char16_t)(0xD800 + (cp >> 10)));
+            pText->push_back((char16_t)(0xDC00 + (cp & 0x3FF)));
+        }
+        else
+        {
+            pText->push_back((char16_t)cp);
+        }
+    }
+}
+
+static void EncodeUtf8(const char16_t* pch, size_t cch, std::string* pBytes)
+{
+    pBytes->clear();
+    for (size_t i = 0; i < cch; i++)
+    {
+        uint32_t cp = pch[i];
+        if (cp >= 0xD800 && cp < 0xDC00 && i + 1 < cch && pch[i + 1] >= 0xDC00 && pch[i + 1] < 0xE000)
+        {
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (pch[++i] - 0xDC00);
+        }
+        else if (cp >= 0xD800 && cp < 0xE000)
+        {
+            cp = 0xFFFD;
+        }
+
+        if (cp < 0x80)
+        {
+            pBytes->push_back((char)cp);
+        }
+        else if (cp < 0x800)
+        {
+            pBytes->push_back((char)(0xC0 | (cp >> 6)));
+            pBytes->push_back((char)(0x80 | (cp & 0x3F)));
+        }
+        else if (cp < 0x10000)
+        {
+            pBytes->push_back((char)(0xE0 | (cp >> 12)));
+            pBytes->push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+            pBytes->push_back((char)(0x80 | (cp & 0x3F)));
+        }
+        else
+        {
+            pBytes->push_back((char)(0xF0 | (cp >> 18)));
+            pBytes->push_back((char)(0x80 | ((cp >> 12) & 0x3F)));
+            pBytes->push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+            pBytes->push_back((char)(0x80 | (cp & 0x3F)));
+        }
+    }
+}
+
+//
+// Work-stealing pool. Worker w owns tasks [next, end) packed into one
+// atomic word; taking from the front is one compare-exchange. A worker
+// whose range is empty steals the back half of the next non-empty range
+// and makes it its own. Tasks in flight between two ranges are never lost:
+// the thief runs them, so a worker that finds every range empty is done.
+//
+class TaskPool
+{
+public:
+    explicit TaskPool(size_t cWorkers) : _cWorkers(cWorkers), _ranges(cWorkers), _steals(0) {}
+
+    template <typename Fn>
+    void Run(size_t cTasks, Fn fn)
+    {
+        // Contiguous starting ranges, so neighbouring chunks stay on one worker
+        for (size_t w = 0; w < _cWorkers; w++)
+            _ranges[w].store(Pack(cTasks * w / _cWorkers, cTasks * (w + 1) / _cWorkers), std::memory_order_relaxed);
+
+        std::vector<std::thread> threads;
+        for (size_t w = 1; w < _cWorkers; w++)
+            threads.emplace_back([this, w, &fn]() { _Work(w, fn); });
+        _Work(0, fn);
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    uint64_t Steals() const { return _steals.load(); }
+
+private:
+    static uint64_t Pack(uint64_t next, uint64_t end) { return (next << 32) | end; }
+
+    bool _TakeOwn(size_t w, size_t* piTask)
+    {
+        uint64_t range = _ranges[w].load(std::memory_order_acquire);
+        for (;;)
+        {
+            uint64_t next = range >> 32;
+            uint64_t end = range & 0xFFFFFFFF;
+            if (next >= end)
+                return false;
+            if (_ranges[w].compare_exchange_weak(range, Pack(next + 1, end), std::memory_order_acq_rel))
+            {
+                *piTask = (size_t)next;
+                return true;
+            }
+        }
+    }
+
+    bool _Steal(size_t w)
+    {
+        for (size_t i = 1; i < _cWorkers; i++)
+        {
+            size_t victim = (w + i) % _cWorkers;
+            uint64_t range = _ranges[victim].load(std::memory_order_acquire);
+            for (;;)
+            {
+                uint64_t next = range >> 32;
+                uint64_t end = range & 0xFFFFFFFF;
+                if (next >= end)
+                    break;
+
+                uint64_t mid = next + (end - next) / 2;
+                if (_ranges[victim].compare_exchange_weak(range, Pack(next, mid), std::memory_order_acq_rel))
+                {
+                    _ranges[w].store(Pack(mid, end), std::memory_order_release);
+                    _steals.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    template <typename Fn>
+    void _Work(size_t w, Fn& fn)
+    {
+        size_t iTask;
+        do
+        {
+            while (_TakeOwn(w, &iTask))
+                fn(iTask, w);
+        } while (_Steal(w));
+    }
+
+    size_t _cWorkers;
+    std::vector<std::atomic<uint64_t>> _ranges;
+    std::atomic<uint64_t> _steals;
+};
+
+// Per-worker buffers, reused across chunks
+struct WorkerScratch
+{
+    std::u16string input;
+    std::u16string output;
+};
+
+struct Chunk
+{
+    size_t ibStart;
+    size_t cb;
+    std::string output;
+};
+
+// Ends of chunks: each cut follows a character that ends any syllable, so
+// a chunk starts on a reset engine. UTF-8 never has an ASCII byte inside a
+// sequence, so a cut after one is also a character boundary.
+static void CutChunks(const Transliterator& transliterator, const char* pb, size_t cb, std::vector<Chunk>* pChunks)
+{
+    pChunks->clear();
+    size_t ibStart = 0;
+    while (ibStart < cb)
+    {
+        size_t ibCut = cb;
+        for (size_t ib = ibStart + c_chunkBytes; ib < cb; ib++)
+        {
+            if ((uint8_t)pb[ib] < 0x80 && transliterator.IsBoundary((char16_t)pb[ib]))
+            {
+                ibCut = ib + 1;
+                break;
+            }
+        }
+
+        Chunk chunk;
+        chunk.ibStart = ibStart;
+        chunk.cb = ibCut - ibStart;
+        pChunks->push_back(chunk);
+        ibStart = ibCut;
+    }
+}
+
+// Where the block may end: after its last boundary character. 0 if none.
+static size_t LastCut(const Transliterator& transliterator, const char* pb, size_t cb)
+{
+    for (size_t ib = cb; ib > 0; ib--)
+    {
+        if ((uint8_t)pb[ib - 1] < 0x80 && transliterator.IsBoundary((char16_t)pb[ib - 1]))
+            return ib;
+    }
+    return 0;
+}
+
+static void ConvertChunk(const Transliterator& transliterator, const char* pb, Chunk* pChunk, WorkerScratch* pScratch)
+{
+    DecodeUtf8(pb + pChunk->ibStart, pChunk->cb, &pScratch->input);
+
+    // Most text needs a few units per input unit; measure only when not
+    size_t cchIn = pScratch->input.size();
+    pScratch->output.resize(cchIn * 2 + c_engineMaxOutput);
+    size_t cchOut = transliterator.Convert(pScratch->input.data(), cchIn, &pScratch->output[0], pScratch->output.size());
+    if (cchOut == c_transliterateNoRoom)
+    {
+        pScratch->output.resize(transliterator.Convert(pScratch->input.data(), cchIn, nullptr, 0));
+        cchOut = transliterator.Convert(pScratch->input.data(), cchIn, &pScratch->output[0], pScratch->output.size());
+    }
+
+    EncodeUtf8(pScratch->output.data(), cchOut, &pChunk->output);
+}
+
+// Key by key, as OnKeyDown does: the layout's own lookup, the engine's own
+// reset, one engine for the whole stream
+static void Replay(KeyboardEngine* pEngine, const char16_t* pch, size_t cch, std::u16string* pOut)
+{
+    for (size_t i = 0; i < cch; i++)
+    {
+        uint8_t vk;
+        KeyLayer layer;
+        char16_t code = UsKeyForChar(pch[i], &vk, &layer) ? pEngine->MapKey(layer, vk) : 0;
+        EngineOutput output;
+        if (code == 0)
+        {
+            pEngine->Reset();
+            pOut->push_back(pch[i]);
+        }
+        else if (!pEngine->ProcessKey(code, &output))
+        {
+            pOut->push_back(pch[i]);
+        }
+        else
+        {
+            pOut->resize(pOut->size() - std::min((size_t)output.cchDelete, pOut->size()));
+            pOut->append(output.text, output.cchText);
+        }
+    }
+}
+
+// Generated input: lines of words typed for the layout, with some numbers,
+// punctuation and Tamil already in the text
+static void MakeInput(LayoutId layout, size_t cb, std::string* pBytes)
+{
+    static const char* const c_romanConsonants[] =
+    {
+        "k", "ng", "s", "nj", "d", "N", "th", "n", "p", "m", "y", "r", "l", "v", "zh", "L", "R", "n", "j", "sh", "h"
+    };
+    static const char* const c_romanVowels[] = { "a", "aa", "i", "ii", "u", "uu", "e", "ee", "ai", "o", "oo", "au", "" };
+    static const char* const c_tamilWords[] = { "தமிழ்", "வணக்கம்", "நன்றி", "அம்மா", "கணினி" };
+    static const char* const c_other[] = { "2024", "10:30", "(ok)", "-", "\"", "!", "http://x.org" };
+
+    pBytes->clear();
+    size_t cWords = 0;
+    while (pBytes->size() < cb)
+    {
+        uint32_t kind = NextRandom() % 20;
+        if (kind == 0)
+        {
+            pBytes->append(c_tamilWords[NextRandom() % 5]);
+        }
+        else if (kind == 1)
+        {
+            pBytes->append(c_other[NextRandom() % 7]);
+        }
+        else if (g_layouts[layout].engine == LayoutEnginePhonetic)
+        {
+            size_t cSyllables = 1 + NextRandom() % 4;
+            for (size_t i = 0; i < cSyllables; i++)
+            {
+                pBytes->append(c_romanConsonants[NextRandom() % (sizeof(c_romanConsonants) / sizeof(c_romanConsonants[0]))]);
+                pBytes->append(c_romanVowels[NextRandom() % (sizeof(c_romanVowels) / sizeof(c_romanVowels[0]))]);
+            }
+        }
+        else
+        {
+            // Key layouts: letters and the punctuation keys they use
+            static const char c_keys[] = "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzQWERTYUIOPASDFGHJKL;',./[]";
+            size_t cKeys = 2 + NextRandom() % 6;
+            for (size_t i = 0; i < cKeys; i++)
+                pBytes->push_back(c_keys[NextRandom() % (sizeof(c_keys) - 1)]);
+        }
+
+        pBytes->push_back(++cWords % 12 == 0 ? '\n' : ' ');
+    }
+}
+
+int main(int argc, char** argv)
+{
+    LayoutId layout = LayoutAnjal;
+    size_t cThreads = std::max(1u, std::thread::hardware_concurrency());
+    bool fVerify = false;
+    size_t cbBench = 0;
+    const char* pszIn = NULL;
+    const char* pszOut = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-l") == 0 && i + 1 < argc)
+        {
+            const char* pszLayout = argv[++i];
+            size_t l = 0;
+            while (l < LayoutCount && strcmp(pszLayout, c_layoutNames[l]) != 0)
+                l++;
+            if (l == LayoutCount)
+            {
+                fprintf(stderr, "Transliterate: unknown layout %s\n", pszLayout);
+                return 2;
+            }
+            layout = (LayoutId)l;
+        }
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            cThreads = std::max(1ul, strtoul(argv[++i], NULL, 10));
+        }
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+        {
+            cbBench = strtoul(argv[++i], NULL, 10) * 1024 * 1024;
+        }
+        else if (strcmp(argv[i], "-v") == 0)
+        {
+            fVerify = true;
+        }
+        else if (argv[i][0] == '-' && argv[i][1] != 0)
+        {
+            fprintf(stderr, "usage: Transliterate [-l tamil99|anjal|typewriter|bamini] [-j threads] [-v] [input [output]]\n"
+                "       Transliterate -b MiB [-l layout] [-j threads] [-v]\n");
+            return 2;
+        }
+        else if (pszIn == NULL)
+        {
+            pszIn = argv[i];
+        }
+        else
+        {
+            pszOut = argv[i];
+        }
+    }
+
+    FILE* pIn = NULL;
+    FILE* pOut = NULL;
+    if (cbBench == 0)
+    {
+        pIn = (pszIn && strcmp(pszIn, "-") != 0) ? fopen(pszIn, "rb") : stdin;
+        pOut = (pszOut && strcmp(pszOut, "-") != 0) ? fopen(pszOut, "wb") : stdout;
+        if (!pIn || !pOut)
+        {
+            fprintf(stderr, "Transliterate: cannot open %s\n", !pIn ? pszIn : pszOut);
+            return 1;
+        }
+    }
+
+    Transliterator transliterator(layout);
+    TaskPool pool(cThreads);
+    std::vector<WorkerScratch> scratch(cThreads);
+    std::vector<Chunk> chunks;
+
+    KeyboardEngine replayEngine;
+    replayEngine.SetLayout(&g_layouts[layout]);
+    std::u16string replayOut;
+    std::u16string input;
+    std::u16string converted;
+    size_t cchMismatchAt = SIZE_MAX;
+    size_t cchCompared = 0;
+
+    std::string block;
+    size_t cbCarry = 0;
+    bool fEnd = false;
+    uint64_t cbIn = 0;
+    uint64_t cbOut = 0;
+    double convertSeconds = 0;
+    size_t cChunks = 0;
+
+    while (!fEnd)
+    {
+        // Fill the block after what the last one carried over
+        size_t cbBlock;
+        if (cbBench > 0)
+        {
+            std::string generated;
+            MakeInput(layout, std::min(c_blockBytes, (size_t)(cbBench - cbIn)), &generated);
+            block = generated;
+            cbBlock = block.size();
+            fEnd = cbIn + cbBlock >= cbBench;
+        }
+        else
+        {
+            block.resize(std::max(c_blockBytes, cbCarry * 2));
+            size_t cbRead = fread(&block[cbCarry], 1, block.size() - cbCarry, pIn);
+            cbBlock = cbCarry + cbRead;
+            fEnd = cbRead < block.size() - cbCarry;
+        }
+
+        // A block without a single cut waits for more input
+        size_t cbUse = fEnd ? cbBlock : LastCut(transliterator, block.data(), cbBlock);
+        if (cbUse == 0)
+        {
+            cbCarry = cbBlock;
+            continue;
+        }
+
+        CutChunks(transliterator, block.data(), cbUse, &chunks);
+        cChunks += chunks.size();
+
+        auto start = std::chrono::steady_clock::now();
+        pool.Run(chunks.size(), [&](size_t iChunk, size_t iWorker)
+        {
+            ConvertChunk(transliterator, block.data(), &chunks[iChunk], &scratch[iWorker]);
+        });
+        convertSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        for (const Chunk& chunk : chunks)
+        {
+            cbOut += chunk.output.size();
+            if (pOut && fwrite(chunk.output.data(), 1, chunk.output.size(), pOut) != chunk.output.size())
+            {
+                fprintf(stderr, "Transliterate: write failed\n");
+                return 1;
+            }
+        }
+
+        if (fVerify && cchMismatchAt == SIZE_MAX)
+        {
+            // Replay this block's input on the stream's engine; compare all
+            // but the tail the replay could still delete
+            DecodeUtf8(block.data(), cbUse, &input);
+            Replay(&replayEngine, input.data(), input.size(), &replayOut);
+            for (const Chunk& chunk : chunks)
+            {
+                std::u16string text;
+                DecodeUtf8(chunk.output.data(), chunk.output.size(), &text);
+                converted += text;
+            }
+
+            size_t cch = fEnd ? replayOut.size() : (replayOut.size() > c_verifyTail ? replayOut.size() - c_verifyTail : 0);
+            if (fEnd && converted.size() != replayOut.size())
+                cchMismatchAt = cchCompared + std::min(converted.size(), replayOut.size());
+            for (size_t i = 0; i < cch && cchMismatchAt == SIZE_MAX; i++)
+            {
+                if (i >= converted.size() || converted[i] != replayOut[i])
+                    cchMismatchAt = cchCompared + i;
+            }
+            cchCompared += cch;
+            replayOut.erase(0, cch);
+            converted.erase(0, std::min(cch, converted.size()));
+        }
+
+        cbIn += cbUse;
+        cbCarry = cbBlock - cbUse;
+        if (cbCarry > 0)
+            memmove(&block[0], &block[cbUse], cbCarry);
+    }
+
+    if (pIn && pIn != stdin)
+        fclose(pIn);
+    if (pOut && pOut != stdout)
+        fclose(pOut);
+
+    fprintf(stderr, "layout     %s, %zu thread(s), %zu chunks, %llu steals\n", c_layoutNames[layout], cThreads, cChunks,
+        (unsigned long long)pool.Steals());
+    fprintf(stderr, "converted  %.1f MiB in, %.1f MiB out, %.3f s, %.1f MiB/s\n", cbIn / 1048576.0, cbOut / 1048576.0,
+        convertSeconds, convertSeconds > 0 ? cbIn / 1048576.0 / convertSeconds : 0.0);
+    if (fVerify)
+    {
+        if (cchMismatchAt == SIZE_MAX)
+            fprintf(stderr, "verify     matches key-by-key replay (%zu units)\n", cchCompared);
+        else
+            fprintf(stderr, "verify     MISMATCH at output unit %zu\n", cchMismatchAt);
+    }
+
+    return (fVerify && cchMismatchAt != SIZE_MAX) ? 1 : 0;
+}
@@ -0,0 +1,384 @@
+// WarmCacheCheck.cpp
+// Runtime checks for the warm cache's park policy (see include/WarmCache.h),
+// with the clock injected: every call is given the time from a test clock
+// that only moves when a check advances it.
+//   - slot cap: the ninth thread's entry pushes out the least recently
+//     parked, and a reattached entry parked again counts as new;
+//   - byte cap: entries go oldest first until the new one fits, one over
+//     the cap alone is refused and nothing is let go of;
+//   - same thread: parking again replaces the thread's entry, Take hands
+//     it back once and to that thread only, Remove drops it unreleased;
+//   - idle trim: an entry goes at exactly c_warmCacheIdleMs, from Trim and
+//     from the Park and Take calls that trim on the way;
+//   - random replays against a plain model of the policy, counters and
+//     byte total included.
+//
+// Build:  cl /std:c++17 /EHsc /O2 tools\WarmCacheCheck.cpp
+//    or:  g++ -std=c++17 -O2 tools/WarmCacheCheck.cpp -o WarmCacheCheck
+// Run:    WarmCacheCheck
+
+#include "../include/WarmCache.h"
+#include "BenchUtil.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+static const size_t c_randomEvents = 1000000;
+static const size_t c_randomThreads = 12;
+
+struct Instance
+{
+    uint32_t threadId;
+};
+
+typedef WarmCache<Instance> Cache;
+
+// The time every call is given; moved only by Advance
+struct TestClock
+{
+    uint64_t nowMs = 1000;
+
+    uint64_t Advance(uint64_t ms)
+    {
+        nowMs += ms;
+        return nowMs;
+    }
+};
+
+static size_t s_cChecks = 0;
+static size_t s_cFailures = 0;
+
+static void Check(const char* pszWhat, uint64_t actual, uint64_t expected)
+{
+    s_cChecks++;
+    if (actual != expected)
+    {
+        fprintf(stderr, "%s: got %llu, expected %llu\n", pszWhat, (unsigned long long)actual, (unsigned long long)expected);
+        s_cFailures++;
+    }
+}
+
+// Whether released holds exactly the instances in expected, in any order
+static bool SameReleased(const Cache::Released& released, std::vector<const Instance*> expected)
+{
+    std::vector<const Instance*> actual(released.ap, released.ap + released.c);
+    std::sort(actual.begin(), actual.end());
+    std::sort(expected.begin(), expected.end());
+    return actual == expected;
+}
+
+static void CheckSlotCap()
+{
+    Cache cache;
+    TestClock clock;
+    Instance instances[c_warmCacheSlots + 2];
+    Cache::Released released;
+
+    for (size_t i = 0; i < c_warmCacheSlots; i++)
+    {
+        instances[i].threadId = (uint32_t)i;
+        cache.Park(&instances[i], instances[i].threadId, 1000, clock.Advance(1), &released);
+        Check("released while slots are free", released.c, 0);
+    }
+    Check("entries at the slot cap", cache.Stats().cEntries, c_warmCacheSlots);
+
+    // Thread 0 was parked first
+    instances[c_warmCacheSlots].threadId = c_warmCacheSlots;
+    cache.Park(&instances[c_warmCacheSlots], c_warmCacheSlots, 1000, clock.Advance(1), &released);
+    Check("one past the slot cap evicts the oldest", SameReleased(released, { &instances[0] }), true);
+
+    // Thread 1 reattaches and parks again: thread 2 is now the oldest
+    Check("reattach", cache.Take(1, clock.Advance(1), &released) == &instances[1], true);
+    cache.Park(&instances[1], 1, 1000, clock.Advance(1), &released);
+    Check("park into the slot Take freed", released.c, 0);
+    instances[c_warmCacheSlots + 1].threadId = c_warmCacheSlots + 1;
+    cache.Park(&instances[c_warmCacheSlots + 1], c_warmCacheSlots + 1, 1000, clock.Advance(1), &released);
+    Check("a parked-again entry is not the oldest", SameReleased(released, { &instances[2] }), true);
+
+    // Then the rest in parking order, thread 1 last but one
+    const size_t order[] = { 3, 4, 5, 6, 7, c_warmCacheSlots, 1, c_warmCacheSlots + 1 };
+    Instance newcomers[c_warmCacheSlots];
+    for (size_t i = 0; i < c_warmCacheSlots; i++)
+    {
+        newcomers[i].threadId = (uint32_t)(100 + i);
+        cache.Park(&newcomers[i], newcomers[i].threadId, 1000, clock.Advance(1), &released);
+        Check("eviction in parking order", SameReleased(released, { &instances[order[i]] }), true);
+    }
+
+    WarmCacheStats stats = cache.Stats();
+    Check("slot cap entries", stats.cEntries, c_warmCacheSlots);
+    Check("slot cap evicted", stats.evicted, 10);
+    Check("slot cap reattached", stats.reattached, 1);
+}
+
+static void CheckByteCap()
+{
+    Cache cache;
+    TestClock clock;
+    Instance a = { 1 };
+    Instance b = { 2 };
+    Instance c = { 3 };
+    Instance d = { 4 };
+    Cache::Released released;
+    const size_t cbThird = c_warmCacheBytesMax / 3;
+
+    cache.Park(&a, a.threadId, cbThird, clock.Advance(1), &released);
+    cache.Park(&b, b.threadId, cbThird, clock.Advance(1), &released);
+    cache.Park(&c, c.threadId, cbThird, clock.Advance(1), &released);
+    Check("three thirds fit", released.c, 0);
+    Check("bytes held", cache.Stats().cbEntries, 3 * cbThird);
+
+    // A half needs two of the thirds gone, oldest first
+    cache.Park(&d, d.threadId, c_warmCacheBytesMax / 2, clock.Advance(1), &released);
+    Check("bytes over the cap evict the oldest until it fits", SameReleased(released, { &a, &b }), true);
+    Check("bytes after the eviction", cache.Stats().cbEntries, cbThird + c_warmCacheBytesMax / 2);
+
+    // Over the cap alone: refused, nothing let go of, nothing counted
+    Instance huge = { 5 };
+    Check("over the cap alone is refused", cache.Park(&huge, huge.threadId, c_warmCacheBytesMax + 1, clock.Advance(1), &released), false);
+    Check("refusal releases nothing", released.c, 0);
+    Check("refusal keeps the entries", cache.Stats().cEntries, 2);
+    Check("refused entry not held", cache.Take(huge.threadId, clock.Advance(1), &released) == nullptr, true);
+
+    // Exactly the cap fits, alone
+    Check("exactly the cap is kept", cache.Park(&huge, huge.threadId, c_warmCacheBytesMax, clock.Advance(1), &released), true);
+    Check("exactly the cap evicts the rest", SameReleased(released, { &c, &d }), true);
+    Check("bytes at the cap", cache.Stats().cbEntries, c_warmCacheBytesMax);
+
+    // Take and Remove give the bytes back
+    Check("take the cap-sized entry", cache.Take(huge.threadId, clock.Advance(1), &released) == &huge, true);
+    Check("bytes after Take", cache.Stats().cbEntries, 0);
+    cache.Park(&a, a.threadId, cbThird, clock.Advance(1), &released);
+    Check("remove a parked entry", cache.Remove(&a), true);
+    Check("remove it again", cache.Remove(&a), false);
+    Check("bytes after Remove", cache.Stats().cbEntries, 0);
+}
+
+static void CheckSameThread()
+{
+    Cache cache;
+    TestClock clock;
+    Instance first = { 7 };
+    Instance second = { 7 };
+    Instance other = { 8 };
+    Cache::Released released;
+
+    cache.Park(&first, 7, 100, clock.Advance(1), &released);
+    cache.Park(&other, 8, 100, clock.Advance(1), &released);
+    cache.Park(&second, 7, 200, clock.Advance(1), &released);
+    Check("parking again replaces the thread's entry", SameReleased(released, { &first }), true);
+    Check("one entry per thread", cache.Stats().cEntries, 2);
+    Check("replaced bytes given back", cache.Stats().cbEntries, 300);
+
+    Check("another thread does not get it", cache.Take(9, clock.Advance(1), &released) == nullptr, true);
+    Check("the thread gets its latest entry", cache.Take(7, clock.Advance(1), &released) == &second, true);
+    Check("only once", cache.Take(7, clock.Advance(1), &released) == nullptr, true);
+    Check("the other thread's entry stays", cache.Take(8, clock.Advance(1), &released) == &other, true);
+
+    WarmCacheStats stats = cache.Stats();
+    Check("same thread parked", stats.parked, 3);
+    Check("same thread evicted", stats.evicted, 1);
+    Check("same thread reattached", stats.reattached, 2);
+    Check("same thread missed", stats.missed, 2);
+    Check("same thread left empty", stats.cEntries + stats.cbEntries, 0);
+}
+
+static void CheckTrim()
+{
+    Cache cache;
+    TestClock clock;
+    Instance old = { 1 };
+    Instance recent = { 2 };
+    Cache::Released released;
+
+    uint64_t oldMs = clock.Advance(1);
+    cache.Park(&old, old.threadId, 100, oldMs, &released);
+    cache.Park(&recent, recent.threadId, 100, clock.Advance(60 * 1000), &released);
+
+    cache.Trim(oldMs + c_warmCacheIdleMs - 1, &released);
+    Check("kept until the idle limit", released.c, 0);
+    cache.Trim(oldMs + c_warmCacheIdleMs, &released);
+    Check("trimmed at the idle limit", SameReleased(released, { &old }), true);
+    Check("the recent entry stays", cache.Stats().cEntries, 1);
+
+    // Take trims first, its own thread's entry included
+    clock.nowMs = oldMs + c_warmCacheIdleMs;
+    cache.Park(&old, old.threadId, 100, clock.nowMs, &released);
+    Check("an idle entry is not reattached", cache.Take(recent.threadId, clock.Advance(60 * 1000), &released) == nullptr, true);
+    Check("Take trims the idle entry", SameReleased(released, { &recent }), true);
+
+    // So does Park
+    cache.Park(&recent, recent.threadId, 100, clock.Advance(c_warmCacheIdleMs), &released);
+    Check("Park trims the idle entry", SameReleased(released, { &old }), true);
+    Check("entries after the trims", cache.Stats().cEntries, 1);
+    Check("bytes after the trims", cache.Stats().cbEntries, 100);
+    Check("trimmed count", cache.Stats().trimmed, 3);
+    Check("not counted as evicted", cache.Stats().evicted, 0);
+
+    cache.Trim(clock.nowMs, &released);
+    Check("trim with nothing idle", released.c, 0);
+}
+
+// The policy as WarmCache.h states it, over a plain list
+struct ModelEntry
+{
+    const Instance* p;
+    uint32_t threadId;
+    uint64_t parkedMs;
+    size_t cb;
+};
+
+struct Model
+{
+    std::vector<ModelEntry> entries;
+    WarmCacheStats stats = {};
+
+    size_t Bytes() const
+    {
+        size_t cb = 0;
+        for (const ModelEntry& entry : entries)
+            cb += entry.cb;
+        return cb;
+    }
+
+    void TrimIdle(uint64_t nowMs, std::vector<const Instance*>* pReleased)
+    {
+        for (size_t i = 0; i < entries.size(); )
+        {
+            if (nowMs - entries[i].parkedMs >= c_warmCacheIdleMs)
+            {
+                pReleased->push_back(entries[i].p);
+                entries.erase(entries.begin() + i);
+                stats.trimmed++;
+            }
+            else
+            {
+                i++;
+            }
+        }
+    }
+
+    bool Park(const Instance* p, uint32_t threadId, size_t cb, uint64_t nowMs, std::vector<const Instance*>* pReleased)
+    {
+        if (cb > c_warmCacheBytesMax)
+            return false;
+        TrimIdle(nowMs, pReleased);
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            if (entries[i].threadId == threadId)
+            {
+                pReleased->push_back(entries[i].p);
+                entries.erase(entries.begin() + i);
+                stats.evicted++;
+                break;
+            }
+        }
+        while (entries.size() == c_warmCacheSlots || Bytes() + cb > c_warmCacheBytesMax)
+        {
+            auto oldest = std::min_element(entries.begin(), entries.end(),
+                [](const ModelEntry& a, const ModelEntry& b) { return a.parkedMs < b.parkedMs; });
+            pReleased->push_back(oldest->p);
+            entries.erase(oldest);
+            stats.evicted++;
+        }
+        entries.push_back({ p, threadId, nowMs, cb });
+        stats.parked++;
+        return true;
+    }
+
+    const Instance* Take(uint32_t threadId, uint64_t nowMs, std::vector<const Instance*>* pReleased)
+    {
+        TrimIdle(nowMs, pReleased);
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            if (entries[i].threadId == threadId)
+            {
+                const Instance* p = entries[i].p;
+                entries.erase(entries.begin() + i);
+                stats.reattached++;
+                return p;
+            }
+        }
+        stats.missed++;
+        return nullptr;
+    }
+};
+
+static void CheckRandom()
+{
+    Cache cache;
+    Model model;
+    TestClock clock;
+    // Two instances per thread, parked in turn, so parking again replaces
+    // the other one and never holds the same instance twice
+    Instance instances[c_randomThreads][2];
+    size_t iNext[c_randomThreads] = {};
+    for (size_t i = 0; i < c_randomThreads; i++)
+        instances[i][0].threadId = instances[i][1].threadId = (uint32_t)i;
+
+    for (size_t i = 0; i < c_randomEvents; i++)
+    {
+        // Mostly short steps, now and then a long idle; never a tie, so the
+        // oldest entry is always the same one in both
+        uint64_t nowMs = clock.Advance(1 + ((NextRandom() % 64 == 0) ? NextRandom() % (2 * c_warmCacheIdleMs) : NextRandom() % 20000));
+        uint32_t threadId = NextRandom() % c_randomThreads;
+
+        Cache::Released released;
+        std::vector<const Instance*> expected;
+        bool fActual = true;
+        bool fExpected = true;
+        const char* pszWhat;
+        switch (NextRandom() % 8)
+        {
+        case 0:
+            pszWhat = "Trim";
+            cache.Trim(nowMs, &released);
+            model.TrimIdle(nowMs, &expected);
+            break;
+        case 1:
+        case 2:
+        case 3:
+            pszWhat = "Take";
+            fActual = cache.Take(threadId, nowMs, &released) != nullptr;
+            fExpected = model.Take(threadId, nowMs, &expected) != nullptr;
+            break;
+        default:
+        {
+            // Sizes around a slot's share of the cap, and now and then past it
+            size_t cb = (NextRandom() % 100 == 0) ? c_warmCacheBytesMax + 1 : NextRandom() % (c_warmCacheBytesMax / 3);
+            Instance* pInstance = &instances[threadId][iNext[threadId]];
+            iNext[threadId] ^= 1;
+            pszWhat = "Park";
+            fActual = cache.Park(pInstance, threadId, cb, nowMs, &released);
+            fExpected = model.Park(pInstance, threadId, cb, nowMs, &expected);
+            break;
+        }
+        }
+
+        WarmCacheStats stats = cache.Stats();
+        s_cChecks++;
+        if (fActual != fExpected || !SameReleased(released, expected) || stats.cEntries != model.entries.size() ||
+            stats.cbEntries != model.Bytes() || stats.parked != model.stats.parked || stats.evicted != model.stats.evicted ||
+            stats.trimmed != model.stats.trimmed || stats.reattached != model.stats.reattached ||
+            stats.missed != model.stats.missed)
+        {
+            fprintf(stderr, "event %zu (%s on thread %u at %llu ms): cache and model differ\n", i, pszWhat, threadId,
+                (unsigned long long)nowMs);
+            s_cFailures++;
+            return;
+        }
+    }
+}
+
+int main()
+{
+    CheckSlotCap();
+    CheckByteCap();
+    CheckSameThread();
+    CheckTrim();
+    CheckRandom();
+
+    printf("warm cache   %zu checks, %zu failures\n", s_cChecks, s_cFailures);
+    return s_cFailures ? 1 : 0;
+}